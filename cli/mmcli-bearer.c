@@ -287,6 +287,7 @@ print_bearer_info (MMBearer *bearer)
         gchar   *total_bytes_tx = NULL;
         gchar   *uplink_speed = NULL;
         gchar   *downlink_speed = NULL;
+        gchar   *detection_latency = NULL;
 
         if (stats) {
             guint64 val;
@@ -323,6 +324,9 @@ print_bearer_info (MMBearer *bearer)
             val = mm_bearer_stats_get_downlink_speed (stats);
             if (val)
                 downlink_speed = g_strdup_printf ("%" G_GUINT64_FORMAT, val);
+            val = mm_bearer_stats_get_detection_latency (stats);
+            if (val)
+                detection_latency = g_strdup_printf ("%" G_GUINT64_FORMAT, val);
         }
 
         if (start_date)
@@ -337,6 +341,7 @@ print_bearer_info (MMBearer *bearer)
         mmcli_output_string_take (MMC_F_BEARER_STATS_TOTAL_BYTES_TX,  total_bytes_tx);
         mmcli_output_string_take (MMC_F_BEARER_STATS_UPLINK_SPEED,    uplink_speed);
         mmcli_output_string_take (MMC_F_BEARER_STATS_DOWNLINK_SPEED,  downlink_speed);
+        mmcli_output_string_take (MMC_F_BEARER_STATS_DETECTION_LATENCY, detection_latency);
     }
 
     mmcli_output_dump ();
@@ -269,6 +269,7 @@ static FieldInfo field_infos[] = {
     [MMC_F_BEARER_STATS_TOTAL_DURATION]              = { "bearer.stats.total-duration",                     "total-duration",           MMC_S_BEARER_STATS,               },
     [MMC_F_BEARER_STATS_TOTAL_BYTES_RX]              = { "bearer.stats.total-bytes-rx",                     "total-bytes rx",           MMC_S_BEARER_STATS,               },
     [MMC_F_BEARER_STATS_TOTAL_BYTES_TX]              = { "bearer.stats.total-bytes-tx",                     "total-bytes tx",           MMC_S_BEARER_STATS,               },
+    [MMC_F_BEARER_STATS_DETECTION_LATENCY]           = { "bearer.stats.detection-latency",                  "detection latency",        MMC_S_BEARER_STATS,               },
     [MMC_F_CALL_GENERAL_DBUS_PATH]                   = { "call.dbus-path",                                  "path",                     MMC_S_CALL_GENERAL,               },
     [MMC_F_CALL_PROPERTIES_NUMBER]                   = { "call.properties.number",                          "number",                   MMC_S_CALL_PROPERTIES,            },
     [MMC_F_CALL_PROPERTIES_DIRECTION]                = { "call.properties.direction",                       "direction",                MMC_S_CALL_PROPERTIES,            },
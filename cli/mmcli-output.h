@@ -287,6 +287,7 @@ typedef enum {
     MMC_F_BEARER_STATS_TOTAL_DURATION,
     MMC_F_BEARER_STATS_TOTAL_BYTES_RX,
     MMC_F_BEARER_STATS_TOTAL_BYTES_TX,
+    MMC_F_BEARER_STATS_DETECTION_LATENCY,
     MMC_F_CALL_GENERAL_DBUS_PATH,
     MMC_F_CALL_PROPERTIES_NUMBER,
     MMC_F_CALL_PROPERTIES_DIRECTION,
@@ -252,6 +252,79 @@
  */
 #define ID_MM_TTY_FLOW_CONTROL "ID_MM_TTY_FLOW_CONTROL"
 
+/**
+ * ID_MM_GPS_IGNORED_SENTENCES:
+ *
+ * This is a port-specific tag applied to GPS data ports, listing the NMEA
+ * sentences that should be discarded right away instead of being processed
+ * and exposed in the location interface.
+ *
+ * The value of the tag should be a comma separated list of sentences, given
+ * either by type (e.g. "GSV") to discard them for all talkers, or by talker
+ * and type (e.g. "GLGSV").
+ *
+ * Since: 1.22
+ */
+#define ID_MM_GPS_IGNORED_SENTENCES "ID_MM_GPS_IGNORED_SENTENCES"
+
+/**
+ * ID_MM_BEARER_STATS_UPDATE_INTERVAL:
+ *
+ * This is a device-specific tag that allows explicitly specifying how often
+ * the statistics of connected bearers are updated, in milliseconds.
+ *
+ * When the data interface is a network interface, the transferred bytes are
+ * read from the kernel interface counters, and so short intervals (e.g. 1000)
+ * do not involve any request to the modem.
+ *
+ * Since: 1.22
+ */
+#define ID_MM_BEARER_STATS_UPDATE_INTERVAL "ID_MM_BEARER_STATS_UPDATE_INTERVAL"
+
+/**
+ * ID_MM_AT_COMMAND_CONCATENATION:
+ *
+ * This is a port-specific tag applied to AT ports, specifying that the modem
+ * supports concatenating multiple extended syntax commands in the same command
+ * line (e.g. "AT+CPIN?;+CREG?").
+ *
+ * When set, the sequences of side-effect-free queries run by the daemon may be
+ * sent in a single command line instead of one by one.
+ *
+ * Since: 1.22
+ */
+#define ID_MM_AT_COMMAND_CONCATENATION "ID_MM_AT_COMMAND_CONCATENATION"
+
+/**
+ * ID_MM_SIGNAL_QUALITY_RSSI_DELTA:
+ *
+ * This is a device-specific tag that allows explicitly specifying the RSSI
+ * change, in dBm, that makes the modem send a new signal quality indication.
+ *
+ * Lower values give more frequent signal quality updates without the need of
+ * polling the modem. Only applicable to QMI modems.
+ *
+ * Since: 1.22
+ */
+#define ID_MM_SIGNAL_QUALITY_RSSI_DELTA "ID_MM_SIGNAL_QUALITY_RSSI_DELTA"
+
+/**
+ * ID_MM_MULTIPLEXED_LINK_POOL_SIZE:
+ *
+ * This is a device-specific tag that allows explicitly specifying the number
+ * of multiplexed network links to create in advance for the modem.
+ *
+ * The links are created when the modem is enabled, or on the first
+ * multiplexed connection attempt if they could not be created earlier. They
+ * are kept across reconnections, so that connection attempts don't need to
+ * wait for new network interfaces to be created and processed by udev.
+ *
+ * Applicable to QMI modems using rmnet links and to MBIM modems.
+ *
+ * Since: 1.22
+ */
+#define ID_MM_MULTIPLEXED_LINK_POOL_SIZE "ID_MM_MULTIPLEXED_LINK_POOL_SIZE"
+
 /*
  * The following symbols are deprecated. We don't add them to -compat
  * because this -tags file is not really part of the installed API.
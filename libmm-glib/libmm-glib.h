@@ -80,6 +80,7 @@
 #include <mm-firmware-update-settings.h>
 #include <mm-cdma-manual-activation-properties.h>
 #include <mm-signal.h>
+#include <mm-signal-sample.h>
 #include <mm-kernel-event-properties.h>
 #include <mm-pco.h>
 #include <mm-sim-preferred-network.h>
@@ -52,6 +52,7 @@ G_DEFINE_TYPE (MMBearerStats, mm_bearer_stats, G_TYPE_OBJECT)
 #define PROPERTY_TOTAL_TX_BYTES  "total-tx-bytes"
 #define PROPERTY_UPLINK_SPEED    "uplink-speed"
 #define PROPERTY_DOWNLINK_SPEED  "downlink-speed"
+#define PROPERTY_DETECTION_LATENCY "detection-latency"
 
 struct _MMBearerStatsPrivate {
     guint   duration;
@@ -65,6 +66,7 @@ struct _MMBearerStatsPrivate {
     guint64 total_tx_bytes;
     guint64 uplink_speed;
     guint64 downlink_speed;
+    guint   detection_latency;
 };
 
 /*****************************************************************************/
@@ -424,6 +426,40 @@ mm_bearer_stats_set_downlink_speed (MMBearerStats *self,
 
 /*****************************************************************************/
 
+/**
+ * mm_bearer_stats_get_detection_latency:
+ * @self: a #MMBearerStats.
+ *
+ * Gets the time it took to detect the last connection loss that was not
+ * explicitly requested, in milliseconds, measured since the connection was
+ * last known to be up.
+ *
+ * Returns: a #guint.
+ *
+ * Since: 1.22
+ */
+guint
+mm_bearer_stats_get_detection_latency (MMBearerStats *self)
+{
+    g_return_val_if_fail (MM_IS_BEARER_STATS (self), 0);
+
+    return self->priv->detection_latency;
+}
+
+/**
+ * mm_bearer_stats_set_detection_latency: (skip)
+ */
+void
+mm_bearer_stats_set_detection_latency (MMBearerStats *self,
+                                       guint          latency)
+{
+    g_return_if_fail (MM_IS_BEARER_STATS (self));
+
+    self->priv->detection_latency = latency;
+}
+
+/*****************************************************************************/
+
 /**
  * mm_bearer_stats_get_dictionary: (skip)
  */
@@ -481,6 +517,10 @@ mm_bearer_stats_get_dictionary (MMBearerStats *self)
                             "{sv}",
                             PROPERTY_DOWNLINK_SPEED,
                             g_variant_new_uint64 (self->priv->downlink_speed));
+    g_variant_builder_add  (&builder,
+                            "{sv}",
+                            PROPERTY_DETECTION_LATENCY,
+                            g_variant_new_uint32 (self->priv->detection_latency));
     return g_variant_builder_end (&builder);
 }
 
@@ -558,6 +598,10 @@ mm_bearer_stats_new_from_dictionary (GVariant *dictionary,
             mm_bearer_stats_set_downlink_speed (
                 self,
                 g_variant_get_uint64 (value));
+        } else if (g_str_equal (key, PROPERTY_DETECTION_LATENCY)) {
+            mm_bearer_stats_set_detection_latency (
+                self,
+                g_variant_get_uint32 (value));
         }
 
         g_free (key);
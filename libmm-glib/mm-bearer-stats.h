@@ -76,6 +76,7 @@ guint64 mm_bearer_stats_get_total_rx_bytes  (MMBearerStats *self);
 guint64 mm_bearer_stats_get_total_tx_bytes  (MMBearerStats *self);
 guint64 mm_bearer_stats_get_uplink_speed    (MMBearerStats *self);
 guint64 mm_bearer_stats_get_downlink_speed  (MMBearerStats *self);
+guint   mm_bearer_stats_get_detection_latency (MMBearerStats *self);
 
 /*****************************************************************************/
 /* ModemManager/libmm-glib/mmcli specific methods */
@@ -99,6 +100,7 @@ void mm_bearer_stats_set_total_rx_bytes       (MMBearerStats *self, guint64 rx_b
 void mm_bearer_stats_set_total_tx_bytes       (MMBearerStats *self, guint64 tx_bytes);
 void mm_bearer_stats_set_uplink_speed         (MMBearerStats *self, guint64 speed);
 void mm_bearer_stats_set_downlink_speed       (MMBearerStats *self, guint64 speed);
+void mm_bearer_stats_set_detection_latency    (MMBearerStats *self, guint   latency);
 
 GVariant *mm_bearer_stats_get_dictionary (MMBearerStats *self);
 
@@ -49,6 +49,8 @@ struct _MMBearerPrivate {
     PROPERTY_OBJECT_DECLARE (stats,       MMBearerStats)
 
     PROPERTY_ERROR_DECLARE (connection_error)
+
+    SNAPSHOT_DECLARE (Bearer)
 };
 
 /*****************************************************************************/
@@ -517,6 +519,99 @@ PROPERTY_ERROR_DEFINE_FAILABLE (connection_error,
 
 /*****************************************************************************/
 
+static MMBearerSnapshot *
+snapshot_new (MMBearer *self)
+{
+    MMBearerSnapshot *snapshot;
+
+    snapshot = g_slice_new0 (MMBearerSnapshot);
+
+    snapshot->interface              = mm_bearer_dup_interface (self);
+    snapshot->connected              = mm_bearer_get_connected (self);
+    snapshot->suspended              = mm_bearer_get_suspended (self);
+    snapshot->multiplexed            = mm_bearer_get_multiplexed (self);
+    snapshot->reload_stats_supported = mm_bearer_get_reload_stats_supported (self);
+    snapshot->ip_timeout             = mm_bearer_get_ip_timeout (self);
+    snapshot->bearer_type            = mm_bearer_get_bearer_type (self);
+    snapshot->profile_id             = mm_bearer_get_profile_id (self);
+
+    /* Complex types reuse the values already decoded for the getters, if any */
+    SNAPSHOT_SET_OBJECT (ipv4_config)
+    SNAPSHOT_SET_OBJECT (ipv6_config)
+    SNAPSHOT_SET_OBJECT (properties)
+    SNAPSHOT_SET_OBJECT (stats)
+
+    PROPERTY_REFRESH (connection_error)
+    if (self->priv->connection_error)
+        snapshot->connection_error = g_error_copy (self->priv->connection_error);
+
+    return snapshot;
+}
+
+static void
+snapshot_free (MMBearerSnapshot *snapshot)
+{
+    g_free (snapshot->interface);
+    g_clear_object (&snapshot->ipv4_config);
+    g_clear_object (&snapshot->ipv6_config);
+    g_clear_object (&snapshot->properties);
+    g_clear_object (&snapshot->stats);
+    g_clear_error (&snapshot->connection_error);
+    g_slice_free (MMBearerSnapshot, snapshot);
+}
+
+/**
+ * mm_bearer_get_snapshot:
+ * @self: A #MMBearer.
+ *
+ * Gets a #MMBearerSnapshot with the values of all the properties of @self.
+ *
+ * The snapshot is built once and shared by all callers until any of the
+ * properties change.
+ *
+ * Returns: (transfer full): A #MMBearerSnapshot that must be freed with
+ * mm_bearer_snapshot_unref().
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_bearer_get_snapshot_sequence:
+ * @self: A #MMBearer.
+ *
+ * Gets the change sequence of @self, which is increased every time any of the
+ * properties change.
+ *
+ * Returns: The change sequence.
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_bearer_snapshot_ref:
+ * @snapshot: A #MMBearerSnapshot.
+ *
+ * Increases the reference count of @snapshot.
+ *
+ * Returns: (transfer full): The same @snapshot.
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_bearer_snapshot_unref:
+ * @snapshot: A #MMBearerSnapshot.
+ *
+ * Decreases the reference count of @snapshot, freeing it when it reaches
+ * zero.
+ *
+ * Since: 1.22
+ */
+
+SNAPSHOT_DEFINE (Bearer, bearer, BEARER)
+
+/*****************************************************************************/
+
 /**
  * mm_bearer_connect_finish:
  * @self: A #MMBearer.
@@ -692,6 +787,8 @@ mm_bearer_init (MMBearer *self)
     PROPERTY_INITIALIZE (properties,       "properties")
     PROPERTY_INITIALIZE (stats,            "stats")
     PROPERTY_INITIALIZE (connection_error, "connection-error")
+
+    SNAPSHOT_INITIALIZE
 }
 
 static void
@@ -708,6 +805,8 @@ finalize (GObject *object)
 
     PROPERTY_ERROR_FINALIZE (connection_error)
 
+    SNAPSHOT_FINALIZE (bearer)
+
     G_OBJECT_CLASS (mm_bearer_parent_class)->finalize (object);
 }
 
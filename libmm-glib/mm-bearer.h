@@ -125,6 +125,66 @@ MMBearerStats      *mm_bearer_peek_stats       (MMBearer *self);
 GError             *mm_bearer_get_connection_error  (MMBearer *self);
 GError             *mm_bearer_peek_connection_error (MMBearer *self);
 
+/**
+ * MMBearerSnapshot:
+ * @sequence: Change sequence of the #MMBearer when the snapshot was taken.
+ * @interface: Data interface, or %NULL.
+ * @connected: Whether the bearer is connected.
+ * @suspended: Whether the bearer is suspended.
+ * @multiplexed: Whether the bearer is multiplexed.
+ * @reload_stats_supported: Whether reloading ongoing statistics is supported.
+ * @ip_timeout: Maximum time to wait for a successful IP establishment, in
+ *  seconds.
+ * @bearer_type: A #MMBearerType value.
+ * @profile_id: Profile ID, or #MM_3GPP_PROFILE_ID_UNKNOWN.
+ * @ipv4_config: A #MMBearerIpConfig, or %NULL.
+ * @ipv6_config: A #MMBearerIpConfig, or %NULL.
+ * @properties: A #MMBearerProperties, or %NULL.
+ * @stats: A #MMBearerStats, or %NULL.
+ * @connection_error: A #GError with the connection error details, or %NULL.
+ *
+ * #MMBearerSnapshot holds the values of all the properties of a #MMBearer at
+ * a given time, with the same semantics as the corresponding getters.
+ *
+ * The snapshot is immutable and may be used from any thread; the fields must
+ * not be modified.
+ *
+ * The structure is part of the public ABI: existing fields must not be
+ * reordered or removed, and new fields may only be appended at the end.
+ *
+ * Since: 1.22
+ */
+typedef struct _MMBearerSnapshot MMBearerSnapshot;
+struct _MMBearerSnapshot {
+    /*< private >*/
+    gint ref_count;
+
+    /*< public >*/
+    guint               sequence;
+    gchar              *interface;
+    gboolean            connected;
+    gboolean            suspended;
+    gboolean            multiplexed;
+    gboolean            reload_stats_supported;
+    guint               ip_timeout;
+    MMBearerType        bearer_type;
+    gint                profile_id;
+    MMBearerIpConfig   *ipv4_config;
+    MMBearerIpConfig   *ipv6_config;
+    MMBearerProperties *properties;
+    MMBearerStats      *stats;
+    GError             *connection_error;
+};
+
+#define MM_TYPE_BEARER_SNAPSHOT (mm_bearer_snapshot_get_type ())
+GType mm_bearer_snapshot_get_type (void);
+
+MMBearerSnapshot *mm_bearer_get_snapshot          (MMBearer *self);
+guint             mm_bearer_get_snapshot_sequence (MMBearer *self);
+MMBearerSnapshot *mm_bearer_snapshot_ref          (MMBearerSnapshot *snapshot);
+void              mm_bearer_snapshot_unref        (MMBearerSnapshot *snapshot);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMBearerSnapshot, mm_bearer_snapshot_unref)
+
 G_END_DECLS
 
 #endif /* _MM_BEARER_H_ */
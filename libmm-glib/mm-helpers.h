@@ -89,10 +89,14 @@
  * start of the context). It also will run a given refresh method if
  * a specific input flag is set.
  */
-#define PROPERTY_LOCK_AND_REFRESH(property_name)              \
-    g_autoptr(GMutexLocker) locker = NULL;                    \
-                                                              \
-    locker = g_mutex_locker_new (&self->priv->mutex);         \
+#define PROPERTY_LOCK_AND_REFRESH(property_name)      \
+    g_autoptr(GMutexLocker) locker = NULL;            \
+                                                      \
+    locker = g_mutex_locker_new (&self->priv->mutex); \
+    PROPERTY_REFRESH (property_name)
+
+/* Runs the refresh method if required; the context mutex must be locked */
+#define PROPERTY_REFRESH(property_name)                       \
     if (self->priv->property_name##_refresh_required) {       \
         property_name##_refresh (self);                       \
         self->priv->property_name##_refresh_required = FALSE; \
@@ -329,4 +333,96 @@
     PROPERTY_ERROR_DEFINE_GET              (property_name, Type, type, TYPE)                   \
     PROPERTY_ERROR_DEFINE_PEEK             (property_name, Type, type, TYPE)
 
+/******************************************************************************/
+/* These are helper macros to provide snapshots of all the properties of an
+ * interface. A snapshot is built on request with a type-specific
+ * snapshot_new() method (run with the context mutex locked) and shared with
+ * every caller until the proxy reports a property change, which also bumps
+ * the change sequence.
+ *
+ * The snapshot struct must have the 'ref_count' and 'sequence' fields, and a
+ * type-specific snapshot_free() method is required as well.
+ */
+
+#define SNAPSHOT_DECLARE(Type)             \
+    guint               snapshot_sequence; \
+    MM##Type##Snapshot *snapshot;
+
+/* Run after the default handler, so that the property specific refresh flags
+ * are already set when the snapshot is invalidated */
+#define SNAPSHOT_INITIALIZE                                           \
+    g_signal_connect_after (self,                                     \
+                            "g-properties-changed",                   \
+                            G_CALLBACK (snapshot_properties_changed), \
+                            NULL);
+
+#define SNAPSHOT_FINALIZE(type) \
+    g_clear_pointer (&self->priv->snapshot, mm_##type##_snapshot_unref);
+
+/* Sets an object field in the snapshot, reusing the object already decoded
+ * for the getters if any; the context mutex must be locked */
+#define SNAPSHOT_SET_OBJECT(property_name)                                    \
+    PROPERTY_REFRESH (property_name)                                          \
+    if (self->priv->property_name)                                            \
+        snapshot->property_name = g_object_ref (self->priv->property_name);
+
+#define SNAPSHOT_DEFINE(Type,type,TYPE)                                                                          \
+    MM##Type##Snapshot *                                                                                         \
+    mm_##type##_snapshot_ref (MM##Type##Snapshot *snapshot)                                                      \
+    {                                                                                                            \
+        g_return_val_if_fail (snapshot != NULL, NULL);                                                           \
+                                                                                                                 \
+        g_atomic_int_inc (&snapshot->ref_count);                                                                 \
+        return snapshot;                                                                                         \
+    }                                                                                                            \
+                                                                                                                 \
+    void                                                                                                         \
+    mm_##type##_snapshot_unref (MM##Type##Snapshot *snapshot)                                                    \
+    {                                                                                                            \
+        g_return_if_fail (snapshot != NULL);                                                                     \
+                                                                                                                 \
+        if (g_atomic_int_dec_and_test (&snapshot->ref_count))                                                    \
+            snapshot_free (snapshot);                                                                            \
+    }                                                                                                            \
+                                                                                                                 \
+    G_DEFINE_BOXED_TYPE (MM##Type##Snapshot, mm_##type##_snapshot,                                               \
+                         (GBoxedCopyFunc) mm_##type##_snapshot_ref, (GBoxedFreeFunc) mm_##type##_snapshot_unref) \
+                                                                                                                 \
+    static void                                                                                                  \
+    snapshot_properties_changed (MM##Type *self)                                                                 \
+    {                                                                                                            \
+        g_autoptr(GMutexLocker) locker = NULL;                                                                   \
+                                                                                                                 \
+        locker = g_mutex_locker_new (&self->priv->mutex);                                                        \
+        self->priv->snapshot_sequence++;                                                                         \
+        g_clear_pointer (&self->priv->snapshot, mm_##type##_snapshot_unref);                                     \
+    }                                                                                                            \
+                                                                                                                 \
+    MM##Type##Snapshot *                                                                                         \
+    mm_##type##_get_snapshot (MM##Type *self)                                                                    \
+    {                                                                                                            \
+        g_autoptr(GMutexLocker) locker = NULL;                                                                   \
+                                                                                                                 \
+        g_return_val_if_fail (MM_IS_##TYPE (self), NULL);                                                        \
+                                                                                                                 \
+        locker = g_mutex_locker_new (&self->priv->mutex);                                                        \
+        if (!self->priv->snapshot) {                                                                             \
+            self->priv->snapshot = snapshot_new (self);                                                          \
+            self->priv->snapshot->ref_count = 1;                                                                 \
+            self->priv->snapshot->sequence = self->priv->snapshot_sequence;                                      \
+        }                                                                                                        \
+        return mm_##type##_snapshot_ref (self->priv->snapshot);                                                  \
+    }                                                                                                            \
+                                                                                                                 \
+    guint                                                                                                        \
+    mm_##type##_get_snapshot_sequence (MM##Type *self)                                                           \
+    {                                                                                                            \
+        g_autoptr(GMutexLocker) locker = NULL;                                                                   \
+                                                                                                                 \
+        g_return_val_if_fail (MM_IS_##TYPE (self), 0);                                                           \
+                                                                                                                 \
+        locker = g_mutex_locker_new (&self->priv->mutex);                                                        \
+        return self->priv->snapshot_sequence;                                                                    \
+    }
+
 #endif /* _MM_HELPERS_H_ */
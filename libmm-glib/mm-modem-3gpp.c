@@ -52,6 +52,8 @@ struct _MMModem3gppPrivate {
 
     PROPERTY_OBJECT_DECLARE (initial_eps_bearer_settings, MMBearerProperties)
     PROPERTY_OBJECT_DECLARE (nr5g_registration_settings,  MMNr5gRegistrationSettings)
+
+    SNAPSHOT_DECLARE (Modem3gpp)
 };
 
 /*****************************************************************************/
@@ -1417,6 +1419,96 @@ PROPERTY_OBJECT_DEFINE_FAILABLE (nr5g_registration_settings,
 
 /*****************************************************************************/
 
+static MMModem3gppSnapshot *
+snapshot_new (MMModem3gpp *self)
+{
+    MMModem3gppSnapshot *snapshot;
+
+    snapshot = g_slice_new0 (MMModem3gppSnapshot);
+
+    snapshot->imei                    = mm_modem_3gpp_dup_imei (self);
+    snapshot->operator_code           = mm_modem_3gpp_dup_operator_code (self);
+    snapshot->operator_name           = mm_modem_3gpp_dup_operator_name (self);
+    snapshot->registration_state      = mm_modem_3gpp_get_registration_state (self);
+    snapshot->enabled_facility_locks  = mm_modem_3gpp_get_enabled_facility_locks (self);
+    snapshot->eps_ue_mode_operation   = mm_modem_3gpp_get_eps_ue_mode_operation (self);
+    snapshot->initial_eps_bearer_path = mm_modem_3gpp_dup_initial_eps_bearer_path (self);
+    snapshot->packet_service_state    = mm_modem_3gpp_get_packet_service_state (self);
+
+    if (mm_gdbus_modem3gpp_get_pco (MM_GDBUS_MODEM3GPP (self)))
+        snapshot->pco = mm_modem_3gpp_get_pco (self);
+
+    SNAPSHOT_SET_OBJECT (initial_eps_bearer_settings)
+    SNAPSHOT_SET_OBJECT (nr5g_registration_settings)
+
+    return snapshot;
+}
+
+static void
+snapshot_free (MMModem3gppSnapshot *snapshot)
+{
+    g_free (snapshot->imei);
+    g_free (snapshot->operator_code);
+    g_free (snapshot->operator_name);
+    g_list_free_full (snapshot->pco, g_object_unref);
+    g_free (snapshot->initial_eps_bearer_path);
+    g_clear_object (&snapshot->initial_eps_bearer_settings);
+    g_clear_object (&snapshot->nr5g_registration_settings);
+    g_slice_free (MMModem3gppSnapshot, snapshot);
+}
+
+/**
+ * mm_modem_3gpp_get_snapshot:
+ * @self: A #MMModem3gpp.
+ *
+ * Gets a #MMModem3gppSnapshot with the values of all the properties of @self.
+ *
+ * The snapshot is built once and shared by all callers until any of the
+ * properties change.
+ *
+ * Returns: (transfer full): A #MMModem3gppSnapshot that must be freed with
+ * mm_modem_3gpp_snapshot_unref().
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_3gpp_get_snapshot_sequence:
+ * @self: A #MMModem3gpp.
+ *
+ * Gets the change sequence of @self, which is increased every time any of the
+ * properties change.
+ *
+ * Returns: The change sequence.
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_3gpp_snapshot_ref:
+ * @snapshot: A #MMModem3gppSnapshot.
+ *
+ * Increases the reference count of @snapshot.
+ *
+ * Returns: (transfer full): The same @snapshot.
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_3gpp_snapshot_unref:
+ * @snapshot: A #MMModem3gppSnapshot.
+ *
+ * Decreases the reference count of @snapshot, freeing it when it reaches
+ * zero.
+ *
+ * Since: 1.22
+ */
+
+SNAPSHOT_DEFINE (Modem3gpp, modem_3gpp, MODEM_3GPP)
+
+/*****************************************************************************/
+
 /**
  * mm_modem_3gpp_set_nr5g_registration_settings_finish:
  * @self: A #MMModem3gpp.
@@ -1518,6 +1610,8 @@ mm_modem_3gpp_init (MMModem3gpp *self)
 
     PROPERTY_INITIALIZE (initial_eps_bearer_settings, "initial-eps-bearer-settings")
     PROPERTY_INITIALIZE (nr5g_registration_settings,  "nr5g-registration-settings")
+
+    SNAPSHOT_INITIALIZE
 }
 
 static void
@@ -1530,6 +1624,8 @@ finalize (GObject *object)
     PROPERTY_OBJECT_FINALIZE (initial_eps_bearer_settings);
     PROPERTY_OBJECT_FINALIZE (nr5g_registration_settings);
 
+    SNAPSHOT_FINALIZE (modem_3gpp)
+
     G_OBJECT_CLASS (mm_modem_3gpp_parent_class)->finalize (object);
 }
 
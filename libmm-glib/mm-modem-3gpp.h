@@ -98,6 +98,62 @@ MMModem3gppPacketServiceState mm_modem_3gpp_get_packet_service_state (MMModem3gp
 MMNr5gRegistrationSettings *mm_modem_3gpp_get_nr5g_registration_settings  (MMModem3gpp *self);
 MMNr5gRegistrationSettings *mm_modem_3gpp_peek_nr5g_registration_settings (MMModem3gpp *self);
 
+/**
+ * MMModem3gppSnapshot:
+ * @sequence: Change sequence of the #MMModem3gpp when the snapshot was taken.
+ * @imei: IMEI, or %NULL.
+ * @operator_code: Code of the current operator, or %NULL.
+ * @operator_name: Name of the current operator, or %NULL.
+ * @registration_state: A #MMModem3gppRegistrationState value.
+ * @enabled_facility_locks: Bitmask of #MMModem3gppFacility values.
+ * @eps_ue_mode_operation: A #MMModem3gppEpsUeModeOperation value.
+ * @pco: (element-type ModemManager.Pco): List of #MMPco objects.
+ * @initial_eps_bearer_path: DBus path of the initial EPS #MMBearer, or %NULL.
+ * @initial_eps_bearer_settings: A #MMBearerProperties, or %NULL.
+ * @packet_service_state: A #MMModem3gppPacketServiceState value.
+ * @nr5g_registration_settings: A #MMNr5gRegistrationSettings, or %NULL.
+ *
+ * #MMModem3gppSnapshot holds the values of all the properties of a
+ * #MMModem3gpp at a given time, with the same semantics as the corresponding
+ * getters.
+ *
+ * The snapshot is immutable and may be used from any thread; the fields must
+ * not be modified.
+ *
+ * The structure is part of the public ABI: existing fields must not be
+ * reordered or removed, and new fields may only be appended at the end.
+ *
+ * Since: 1.22
+ */
+typedef struct _MMModem3gppSnapshot MMModem3gppSnapshot;
+struct _MMModem3gppSnapshot {
+    /*< private >*/
+    gint ref_count;
+
+    /*< public >*/
+    guint                          sequence;
+    gchar                         *imei;
+    gchar                         *operator_code;
+    gchar                         *operator_name;
+    MMModem3gppRegistrationState   registration_state;
+    MMModem3gppFacility            enabled_facility_locks;
+    MMModem3gppEpsUeModeOperation  eps_ue_mode_operation;
+    GList                         *pco;
+    gchar                         *initial_eps_bearer_path;
+    MMBearerProperties            *initial_eps_bearer_settings;
+    MMModem3gppPacketServiceState  packet_service_state;
+    MMNr5gRegistrationSettings    *nr5g_registration_settings;
+};
+
+#define MM_TYPE_MODEM_3GPP_SNAPSHOT (mm_modem_3gpp_snapshot_get_type ())
+GType mm_modem_3gpp_snapshot_get_type (void);
+
+MMModem3gppSnapshot *mm_modem_3gpp_get_snapshot          (MMModem3gpp *self);
+guint                mm_modem_3gpp_get_snapshot_sequence (MMModem3gpp *self);
+MMModem3gppSnapshot *mm_modem_3gpp_snapshot_ref          (MMModem3gppSnapshot *snapshot);
+void                 mm_modem_3gpp_snapshot_unref        (MMModem3gppSnapshot *snapshot);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMModem3gppSnapshot, mm_modem_3gpp_snapshot_unref)
+
 void     mm_modem_3gpp_register        (MMModem3gpp *self,
                                         const gchar *network_id,
                                         GCancellable *cancellable,
@@ -53,6 +53,8 @@ struct _MMModemSignalPrivate {
     PROPERTY_OBJECT_DECLARE (umts, MMSignal)
     PROPERTY_OBJECT_DECLARE (lte,  MMSignal)
     PROPERTY_OBJECT_DECLARE (nr5g, MMSignal)
+
+    SNAPSHOT_DECLARE (ModemSignal)
 };
 
 /*****************************************************************************/
@@ -283,6 +285,235 @@ mm_modem_signal_setup_thresholds_sync (MMModemSignal                *self,
 
 /*****************************************************************************/
 
+/**
+ * mm_modem_signal_setup_sampling_finish:
+ * @self: A #MMModemSignal.
+ * @res: The #GAsyncResult obtained from the #GAsyncReadyCallback passed to
+ *  mm_modem_signal_setup_sampling().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with mm_modem_signal_setup_sampling().
+ *
+ * Returns: %TRUE if the setup was successful, %FALSE if @error is set.
+ *
+ * Since: 1.22
+ */
+gboolean
+mm_modem_signal_setup_sampling_finish (MMModemSignal  *self,
+                                       GAsyncResult   *res,
+                                       GError        **error)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SIGNAL (self), FALSE);
+
+    return mm_gdbus_modem_signal_call_setup_sampling_finish (MM_GDBUS_MODEM_SIGNAL (self), res, error);
+}
+
+/**
+ * mm_modem_signal_setup_sampling:
+ * @self: A #MMModemSignal.
+ * @interval: Sampling interval to set, in milliseconds. Use 0 to disable
+ *  sampling.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: A #GAsyncReadyCallback to call when the request is satisfied or
+ *  %NULL.
+ * @user_data: User data to pass to @callback.
+ *
+ * Asynchronously enables or disables the high rate sampling of the extended
+ * signal quality information. The samples are stored in the modem history and
+ * may be retrieved with mm_modem_signal_get_samples().
+ *
+ * When the operation is finished, @callback will be invoked in the
+ * <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the thread you are calling this method from. You can then call
+ * mm_modem_signal_setup_sampling_finish() to get the result of the operation.
+ *
+ * See mm_modem_signal_setup_sampling_sync() for the synchronous, blocking
+ * version of this method.
+ *
+ * Since: 1.22
+ */
+void
+mm_modem_signal_setup_sampling (MMModemSignal       *self,
+                                guint                interval,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+    g_return_if_fail (MM_IS_MODEM_SIGNAL (self));
+
+    mm_gdbus_modem_signal_call_setup_sampling (MM_GDBUS_MODEM_SIGNAL (self), interval, cancellable, callback, user_data);
+}
+
+/**
+ * mm_modem_signal_setup_sampling_sync:
+ * @self: A #MMModemSignal.
+ * @interval: Sampling interval to set, in milliseconds. Use 0 to disable
+ *  sampling.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Synchronously enables or disables the high rate sampling of the extended
+ * signal quality information.
+ *
+ * The calling thread is blocked until a reply is received. See
+ * mm_modem_signal_setup_sampling() for the asynchronous version of this method.
+ *
+ * Returns: %TRUE if the setup was successful, %FALSE if @error is set.
+ *
+ * Since: 1.22
+ */
+gboolean
+mm_modem_signal_setup_sampling_sync (MMModemSignal  *self,
+                                     guint           interval,
+                                     GCancellable   *cancellable,
+                                     GError        **error)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SIGNAL (self), FALSE);
+
+    return mm_gdbus_modem_signal_call_setup_sampling_sync (MM_GDBUS_MODEM_SIGNAL (self), interval, cancellable, error);
+}
+
+/*****************************************************************************/
+
+static GList *
+create_sample_list (GVariant  *variant,
+                    GError   **error)
+{
+    GError       *inner_error = NULL;
+    GList        *list = NULL;
+    GVariantIter  iter;
+    GVariant     *item;
+
+    /* Input is a(txa{sv}) */
+    g_variant_iter_init (&iter, variant);
+    while (!inner_error && (item = g_variant_iter_next_value (&iter))) {
+        MMSignalSample *sample;
+
+        sample = mm_signal_sample_new_from_variant (item, &inner_error);
+        if (sample)
+            list = g_list_prepend (list, sample);
+        g_variant_unref (item);
+    }
+
+    g_variant_unref (variant);
+
+    if (inner_error) {
+        g_list_free_full (list, g_object_unref);
+        g_propagate_error (error, inner_error);
+        return NULL;
+    }
+
+    /* Keep the oldest to newest order given by the daemon */
+    return g_list_reverse (list);
+}
+
+/**
+ * mm_modem_signal_get_samples_finish:
+ * @self: A #MMModemSignal.
+ * @res: The #GAsyncResult obtained from the #GAsyncReadyCallback passed to
+ *  mm_modem_signal_get_samples().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with mm_modem_signal_get_samples().
+ *
+ * Returns: (transfer full) (element-type ModemManager.SignalSample): a list
+ * of #MMSignalSample objects sorted from oldest to newest, or #NULL if
+ * @error is set or if there are no new samples. The returned value should be
+ * freed with g_list_free_full() using g_object_unref() as #GDestroyNotify
+ * function.
+ *
+ * Since: 1.22
+ */
+GList *
+mm_modem_signal_get_samples_finish (MMModemSignal  *self,
+                                    GAsyncResult   *res,
+                                    GError        **error)
+{
+    GVariant *result = NULL;
+
+    g_return_val_if_fail (MM_IS_MODEM_SIGNAL (self), NULL);
+
+    if (!mm_gdbus_modem_signal_call_get_samples_finish (MM_GDBUS_MODEM_SIGNAL (self), &result, res, error))
+        return NULL;
+
+    return create_sample_list (result, error);
+}
+
+/**
+ * mm_modem_signal_get_samples:
+ * @self: A #MMModemSignal.
+ * @since: Sequence number of the last sample already known, or 0 to get all
+ *  the samples in the history.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: A #GAsyncReadyCallback to call when the request is satisfied or
+ *  %NULL.
+ * @user_data: User data to pass to @callback.
+ *
+ * Asynchronously requests the extended signal quality information samples
+ * stored in the modem history with a sequence number greater than @since.
+ *
+ * When the operation is finished, @callback will be invoked in the
+ * <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the thread you are calling this method from. You can then call
+ * mm_modem_signal_get_samples_finish() to get the result of the operation.
+ *
+ * See mm_modem_signal_get_samples_sync() for the synchronous, blocking version
+ * of this method.
+ *
+ * Since: 1.22
+ */
+void
+mm_modem_signal_get_samples (MMModemSignal       *self,
+                             guint64              since,
+                             GCancellable        *cancellable,
+                             GAsyncReadyCallback  callback,
+                             gpointer             user_data)
+{
+    g_return_if_fail (MM_IS_MODEM_SIGNAL (self));
+
+    mm_gdbus_modem_signal_call_get_samples (MM_GDBUS_MODEM_SIGNAL (self), since, cancellable, callback, user_data);
+}
+
+/**
+ * mm_modem_signal_get_samples_sync:
+ * @self: A #MMModemSignal.
+ * @since: Sequence number of the last sample already known, or 0 to get all
+ *  the samples in the history.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Synchronously requests the extended signal quality information samples
+ * stored in the modem history with a sequence number greater than @since.
+ *
+ * The calling thread is blocked until a reply is received. See
+ * mm_modem_signal_get_samples() for the asynchronous version of this method.
+ *
+ * Returns: (transfer full) (element-type ModemManager.SignalSample): a list
+ * of #MMSignalSample objects sorted from oldest to newest, or #NULL if
+ * @error is set or if there are no new samples. The returned value should be
+ * freed with g_list_free_full() using g_object_unref() as #GDestroyNotify
+ * function.
+ *
+ * Since: 1.22
+ */
+GList *
+mm_modem_signal_get_samples_sync (MMModemSignal  *self,
+                                  guint64         since,
+                                  GCancellable   *cancellable,
+                                  GError        **error)
+{
+    GVariant *result = NULL;
+
+    g_return_val_if_fail (MM_IS_MODEM_SIGNAL (self), NULL);
+
+    if (!mm_gdbus_modem_signal_call_get_samples_sync (MM_GDBUS_MODEM_SIGNAL (self), since, &result, cancellable, error))
+        return NULL;
+
+    return create_sample_list (result, error);
+}
+
+/*****************************************************************************/
+
 /**
  * mm_modem_signal_get_rate:
  * @self: A #MMModemSignal.
@@ -345,6 +576,28 @@ mm_modem_signal_get_error_rate_threshold (MMModemSignal *self)
 
 /*****************************************************************************/
 
+/**
+ * mm_modem_signal_get_sampling_interval:
+ * @self: A #MMModemSignal.
+ *
+ * Gets the currently configured sampling interval, in milliseconds.
+ *
+ * A value of 0 indicates the sampling is disabled.
+ *
+ * Returns: the sampling interval.
+ *
+ * Since: 1.22
+ */
+guint
+mm_modem_signal_get_sampling_interval (MMModemSignal *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SIGNAL (self), 0);
+
+    return mm_gdbus_modem_signal_get_sampling_interval (MM_GDBUS_MODEM_SIGNAL (self));
+}
+
+/*****************************************************************************/
+
 /**
  * mm_modem_signal_get_cdma:
  * @self: A #MMModem.
@@ -585,6 +838,94 @@ PROPERTY_OBJECT_DEFINE_FAILABLE (nr5g,
 
 /*****************************************************************************/
 
+static MMModemSignalSnapshot *
+snapshot_new (MMModemSignal *self)
+{
+    MMModemSignalSnapshot *snapshot;
+
+    snapshot = g_slice_new0 (MMModemSignalSnapshot);
+
+    snapshot->rate                 = mm_modem_signal_get_rate (self);
+    snapshot->rssi_threshold       = mm_modem_signal_get_rssi_threshold (self);
+    snapshot->error_rate_threshold = mm_modem_signal_get_error_rate_threshold (self);
+    snapshot->sampling_interval    = mm_modem_signal_get_sampling_interval (self);
+
+    /* Reuse the values already decoded for the getters, if any */
+    SNAPSHOT_SET_OBJECT (cdma)
+    SNAPSHOT_SET_OBJECT (evdo)
+    SNAPSHOT_SET_OBJECT (gsm)
+    SNAPSHOT_SET_OBJECT (umts)
+    SNAPSHOT_SET_OBJECT (lte)
+    SNAPSHOT_SET_OBJECT (nr5g)
+
+    return snapshot;
+}
+
+static void
+snapshot_free (MMModemSignalSnapshot *snapshot)
+{
+    g_clear_object (&snapshot->cdma);
+    g_clear_object (&snapshot->evdo);
+    g_clear_object (&snapshot->gsm);
+    g_clear_object (&snapshot->umts);
+    g_clear_object (&snapshot->lte);
+    g_clear_object (&snapshot->nr5g);
+    g_slice_free (MMModemSignalSnapshot, snapshot);
+}
+
+/**
+ * mm_modem_signal_get_snapshot:
+ * @self: A #MMModemSignal.
+ *
+ * Gets a #MMModemSignalSnapshot with the values of all the properties of
+ * @self.
+ *
+ * The snapshot is built once and shared by all callers until any of the
+ * properties change.
+ *
+ * Returns: (transfer full): A #MMModemSignalSnapshot that must be freed with
+ * mm_modem_signal_snapshot_unref().
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_signal_get_snapshot_sequence:
+ * @self: A #MMModemSignal.
+ *
+ * Gets the change sequence of @self, which is increased every time any of the
+ * properties change.
+ *
+ * Returns: The change sequence.
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_signal_snapshot_ref:
+ * @snapshot: A #MMModemSignalSnapshot.
+ *
+ * Increases the reference count of @snapshot.
+ *
+ * Returns: (transfer full): The same @snapshot.
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_signal_snapshot_unref:
+ * @snapshot: A #MMModemSignalSnapshot.
+ *
+ * Decreases the reference count of @snapshot, freeing it when it reaches
+ * zero.
+ *
+ * Since: 1.22
+ */
+
+SNAPSHOT_DEFINE (ModemSignal, modem_signal, MODEM_SIGNAL)
+
+/*****************************************************************************/
+
 static void
 mm_modem_signal_init (MMModemSignal *self)
 {
@@ -597,6 +938,8 @@ mm_modem_signal_init (MMModemSignal *self)
     PROPERTY_INITIALIZE (umts, "umts")
     PROPERTY_INITIALIZE (lte,  "lte")
     PROPERTY_INITIALIZE (nr5g, "nr5g")
+
+    SNAPSHOT_INITIALIZE
 }
 
 static void
@@ -613,6 +956,8 @@ finalize (GObject *object)
     PROPERTY_OBJECT_FINALIZE (lte)
     PROPERTY_OBJECT_FINALIZE (nr5g)
 
+    SNAPSHOT_FINALIZE (modem_signal)
+
     G_OBJECT_CLASS (mm_modem_signal_parent_class)->finalize (object);
 }
 
@@ -31,6 +31,7 @@
 #include <ModemManager.h>
 
 #include "mm-signal.h"
+#include "mm-signal-sample.h"
 #include "mm-signal-threshold-properties.h"
 #include "mm-gdbus-modem.h"
 
@@ -72,6 +73,7 @@ gchar       *mm_modem_signal_dup_path                 (MMModemSignal *self);
 guint        mm_modem_signal_get_rate                 (MMModemSignal *self);
 guint        mm_modem_signal_get_rssi_threshold       (MMModemSignal *self);
 gboolean     mm_modem_signal_get_error_rate_threshold (MMModemSignal *self);
+guint        mm_modem_signal_get_sampling_interval    (MMModemSignal *self);
 
 void     mm_modem_signal_setup                   (MMModemSignal                *self,
                                                   guint                         rate,
@@ -97,6 +99,30 @@ gboolean mm_modem_signal_setup_thresholds_sync   (MMModemSignal                *
                                                   MMSignalThresholdProperties  *properties,
                                                   GCancellable                 *cancellable,
                                                   GError                      **error);
+void     mm_modem_signal_setup_sampling          (MMModemSignal                *self,
+                                                  guint                         interval,
+                                                  GCancellable                 *cancellable,
+                                                  GAsyncReadyCallback           callback,
+                                                  gpointer                      user_data);
+gboolean mm_modem_signal_setup_sampling_finish   (MMModemSignal                *self,
+                                                  GAsyncResult                 *res,
+                                                  GError                      **error);
+gboolean mm_modem_signal_setup_sampling_sync     (MMModemSignal                *self,
+                                                  guint                         interval,
+                                                  GCancellable                 *cancellable,
+                                                  GError                      **error);
+void     mm_modem_signal_get_samples             (MMModemSignal                *self,
+                                                  guint64                       since,
+                                                  GCancellable                 *cancellable,
+                                                  GAsyncReadyCallback           callback,
+                                                  gpointer                      user_data);
+GList   *mm_modem_signal_get_samples_finish      (MMModemSignal                *self,
+                                                  GAsyncResult                 *res,
+                                                  GError                      **error);
+GList   *mm_modem_signal_get_samples_sync        (MMModemSignal                *self,
+                                                  guint64                       since,
+                                                  GCancellable                 *cancellable,
+                                                  GError                      **error);
 
 MMSignal *mm_modem_signal_get_cdma  (MMModemSignal *self);
 MMSignal *mm_modem_signal_peek_cdma (MMModemSignal *self);
@@ -116,6 +142,60 @@ MMSignal *mm_modem_signal_peek_lte  (MMModemSignal *self);
 MMSignal *mm_modem_signal_get_nr5g  (MMModemSignal *self);
 MMSignal *mm_modem_signal_peek_nr5g (MMModemSignal *self);
 
+/**
+ * MMModemSignalSnapshot:
+ * @sequence: Change sequence of the #MMModemSignal when the snapshot was taken.
+ * @rate: Refresh rate, in seconds.
+ * @rssi_threshold: RSSI threshold, in dBm.
+ * @error_rate_threshold: Whether the error rate threshold is enabled.
+ * @sampling_interval: Sampling interval, in milliseconds.
+ * @cdma: A #MMSignal with the CDMA signal information, or %NULL.
+ * @evdo: A #MMSignal with the EV-DO signal information, or %NULL.
+ * @gsm: A #MMSignal with the GSM signal information, or %NULL.
+ * @umts: A #MMSignal with the UMTS signal information, or %NULL.
+ * @lte: A #MMSignal with the LTE signal information, or %NULL.
+ * @nr5g: A #MMSignal with the 5GNR signal information, or %NULL.
+ *
+ * #MMModemSignalSnapshot holds the values of all the properties of a
+ * #MMModemSignal at a given time, with the same semantics as the
+ * corresponding getters.
+ *
+ * The snapshot is immutable and may be used from any thread; the fields must
+ * not be modified.
+ *
+ * The structure is part of the public ABI: existing fields must not be
+ * reordered or removed, and new fields may only be appended at the end.
+ *
+ * Since: 1.22
+ */
+typedef struct _MMModemSignalSnapshot MMModemSignalSnapshot;
+struct _MMModemSignalSnapshot {
+    /*< private >*/
+    gint ref_count;
+
+    /*< public >*/
+    guint     sequence;
+    guint     rate;
+    guint     rssi_threshold;
+    gboolean  error_rate_threshold;
+    guint     sampling_interval;
+    MMSignal *cdma;
+    MMSignal *evdo;
+    MMSignal *gsm;
+    MMSignal *umts;
+    MMSignal *lte;
+    MMSignal *nr5g;
+};
+
+#define MM_TYPE_MODEM_SIGNAL_SNAPSHOT (mm_modem_signal_snapshot_get_type ())
+GType mm_modem_signal_snapshot_get_type (void);
+
+MMModemSignalSnapshot *mm_modem_signal_get_snapshot          (MMModemSignal *self);
+guint                  mm_modem_signal_get_snapshot_sequence (MMModemSignal *self);
+MMModemSignalSnapshot *mm_modem_signal_snapshot_ref          (MMModemSignalSnapshot *snapshot);
+void                   mm_modem_signal_snapshot_unref        (MMModemSignalSnapshot *snapshot);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMModemSignalSnapshot, mm_modem_signal_snapshot_unref)
+
 G_END_DECLS
 
 #endif /* _MM_MODEM_SIGNAL_H_ */
@@ -53,6 +53,8 @@ struct _MMModemPrivate {
     PROPERTY_ARRAY_DECLARE (current_bands)
 
     PROPERTY_OBJECT_DECLARE (unlock_retries, MMUnlockRetries)
+
+    SNAPSHOT_DECLARE (Modem)
 };
 
 /*****************************************************************************/
@@ -1430,6 +1432,160 @@ mm_modem_get_supported_ip_families (MMModem *self)
 
 /*****************************************************************************/
 
+static gpointer
+garray_dup_data (GArray *array,
+                 guint  *n_out)
+{
+    *n_out = 0;
+    if (!array || !array->len)
+        return NULL;
+
+    *n_out = array->len;
+    return g_memdup (array->data, g_array_get_element_size (array) * array->len);
+}
+
+static MMModemSnapshot *
+snapshot_new (MMModem *self)
+{
+    MMModemSnapshot *snapshot;
+
+    snapshot = g_slice_new0 (MMModemSnapshot);
+
+    snapshot->state                          = mm_modem_get_state (self);
+    snapshot->state_failed_reason            = mm_modem_get_state_failed_reason (self);
+    snapshot->power_state                    = mm_modem_get_power_state (self);
+    snapshot->access_technologies            = mm_modem_get_access_technologies (self);
+    snapshot->signal_quality                 = mm_modem_get_signal_quality (self, &snapshot->signal_quality_recent);
+    snapshot->unlock_required                = mm_modem_get_unlock_required (self);
+    snapshot->current_capabilities           = mm_modem_get_current_capabilities (self);
+    snapshot->supported_ip_families          = mm_modem_get_supported_ip_families (self);
+    snapshot->max_active_bearers             = mm_modem_get_max_active_bearers (self);
+    snapshot->max_active_multiplexed_bearers = mm_modem_get_max_active_multiplexed_bearers (self);
+    snapshot->bearer_paths                   = mm_modem_dup_bearer_paths (self);
+    snapshot->sim_path                       = mm_modem_dup_sim_path (self);
+    snapshot->sim_slot_paths                 = mm_modem_dup_sim_slot_paths (self);
+    snapshot->primary_sim_slot               = mm_modem_get_primary_sim_slot (self);
+    snapshot->manufacturer                   = mm_modem_dup_manufacturer (self);
+    snapshot->model                          = mm_modem_dup_model (self);
+    snapshot->revision                       = mm_modem_dup_revision (self);
+    snapshot->hardware_revision              = mm_modem_dup_hardware_revision (self);
+    snapshot->carrier_configuration          = mm_modem_dup_carrier_configuration (self);
+    snapshot->carrier_configuration_revision = mm_modem_dup_carrier_configuration_revision (self);
+    snapshot->device_identifier              = mm_modem_dup_device_identifier (self);
+    snapshot->device                         = mm_modem_dup_device (self);
+    snapshot->drivers                        = mm_modem_dup_drivers (self);
+    snapshot->plugin                         = mm_modem_dup_plugin (self);
+    snapshot->primary_port                   = mm_modem_dup_primary_port (self);
+    snapshot->equipment_identifier           = mm_modem_dup_equipment_identifier (self);
+    snapshot->own_numbers                    = mm_modem_dup_own_numbers (self);
+
+    if (!mm_modem_get_current_modes (self, &snapshot->current_modes.allowed, &snapshot->current_modes.preferred)) {
+        snapshot->current_modes.allowed = MM_MODEM_MODE_NONE;
+        snapshot->current_modes.preferred = MM_MODEM_MODE_NONE;
+    }
+
+    /* Complex types reuse the values already decoded for the getters, if any */
+    SNAPSHOT_SET_OBJECT (unlock_retries)
+    PROPERTY_REFRESH (supported_capabilities)
+    PROPERTY_REFRESH (supported_modes)
+    PROPERTY_REFRESH (current_bands)
+    PROPERTY_REFRESH (supported_bands)
+    PROPERTY_REFRESH (ports)
+
+    snapshot->supported_capabilities = garray_dup_data (self->priv->supported_capabilities, &snapshot->n_supported_capabilities);
+    snapshot->supported_modes        = garray_dup_data (self->priv->supported_modes, &snapshot->n_supported_modes);
+    snapshot->current_bands          = garray_dup_data (self->priv->current_bands, &snapshot->n_current_bands);
+    snapshot->supported_bands        = garray_dup_data (self->priv->supported_bands, &snapshot->n_supported_bands);
+    mm_common_ports_garray_to_array (self->priv->ports, &snapshot->ports, &snapshot->n_ports);
+
+    return snapshot;
+}
+
+static void
+snapshot_free (MMModemSnapshot *snapshot)
+{
+    g_clear_object (&snapshot->unlock_retries);
+    g_free (snapshot->supported_capabilities);
+    g_free (snapshot->supported_modes);
+    g_free (snapshot->current_bands);
+    g_free (snapshot->supported_bands);
+    g_strfreev (snapshot->bearer_paths);
+    g_free (snapshot->sim_path);
+    g_strfreev (snapshot->sim_slot_paths);
+    g_free (snapshot->manufacturer);
+    g_free (snapshot->model);
+    g_free (snapshot->revision);
+    g_free (snapshot->hardware_revision);
+    g_free (snapshot->carrier_configuration);
+    g_free (snapshot->carrier_configuration_revision);
+    g_free (snapshot->device_identifier);
+    g_free (snapshot->device);
+    g_strfreev (snapshot->drivers);
+    g_free (snapshot->plugin);
+    g_free (snapshot->primary_port);
+    mm_modem_port_info_array_free (snapshot->ports, snapshot->n_ports);
+    g_free (snapshot->equipment_identifier);
+    g_strfreev (snapshot->own_numbers);
+    g_slice_free (MMModemSnapshot, snapshot);
+}
+
+/**
+ * mm_modem_get_snapshot:
+ * @self: A #MMModem.
+ *
+ * Gets a #MMModemSnapshot with the values of all the properties of @self.
+ *
+ * The snapshot is built once and shared by all callers until any of the
+ * properties change, so this method is a cheaper alternative to using the
+ * individual getters when several properties are read at the same time, or
+ * when they are polled.
+ *
+ * Returns: (transfer full): A #MMModemSnapshot that must be freed with
+ * mm_modem_snapshot_unref().
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_get_snapshot_sequence:
+ * @self: A #MMModem.
+ *
+ * Gets the change sequence of @self, which is increased every time any of the
+ * properties change.
+ *
+ * If the value is equal to the sequence of a previously retrieved
+ * #MMModemSnapshot, the snapshot is still up to date.
+ *
+ * Returns: The change sequence.
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_snapshot_ref:
+ * @snapshot: A #MMModemSnapshot.
+ *
+ * Increases the reference count of @snapshot.
+ *
+ * Returns: (transfer full): The same @snapshot.
+ *
+ * Since: 1.22
+ */
+
+/**
+ * mm_modem_snapshot_unref:
+ * @snapshot: A #MMModemSnapshot.
+ *
+ * Decreases the reference count of @snapshot, freeing it when it reaches
+ * zero.
+ *
+ * Since: 1.22
+ */
+
+SNAPSHOT_DEFINE (Modem, modem, MODEM)
+
+/*****************************************************************************/
+
 /**
  * mm_modem_enable_finish:
  * @self: A #MMModem.
@@ -3387,6 +3543,8 @@ mm_modem_init (MMModem *self)
     PROPERTY_INITIALIZE (supported_bands,        "supported-bands")
     PROPERTY_INITIALIZE (current_bands,          "current-bands")
     PROPERTY_INITIALIZE (unlock_retries,         "unlock-retries")
+
+    SNAPSHOT_INITIALIZE
 }
 
 static void
@@ -3404,6 +3562,8 @@ finalize (GObject *object)
 
     PROPERTY_OBJECT_FINALIZE (unlock_retries)
 
+    SNAPSHOT_FINALIZE (modem)
+
     G_OBJECT_CLASS (mm_modem_parent_class)->finalize (object);
 }
 
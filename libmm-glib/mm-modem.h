@@ -184,6 +184,124 @@ gboolean           mm_modem_get_current_bands        (MMModem *self,
 
 MMBearerIpFamily   mm_modem_get_supported_ip_families (MMModem *self);
 
+/**
+ * MMModemSnapshot:
+ * @sequence: Change sequence of the #MMModem when the snapshot was taken.
+ * @state: A #MMModemState value.
+ * @state_failed_reason: A #MMModemStateFailedReason value.
+ * @power_state: A #MMModemPowerState value.
+ * @access_technologies: Bitmask of #MMModemAccessTechnology values.
+ * @signal_quality: Signal quality value in percent.
+ * @signal_quality_recent: Whether @signal_quality was recently taken.
+ * @unlock_required: A #MMModemLock value.
+ * @unlock_retries: A #MMUnlockRetries, or %NULL if unknown.
+ * @current_capabilities: Bitmask of #MMModemCapability values.
+ * @supported_capabilities: (array length=n_supported_capabilities): Array of
+ *  #MMModemCapability values.
+ * @n_supported_capabilities: Number of values in @supported_capabilities.
+ * @current_modes: A #MMModemModeCombination.
+ * @supported_modes: (array length=n_supported_modes): Array of
+ *  #MMModemModeCombination values.
+ * @n_supported_modes: Number of values in @supported_modes.
+ * @current_bands: (array length=n_current_bands): Array of #MMModemBand values.
+ * @n_current_bands: Number of values in @current_bands.
+ * @supported_bands: (array length=n_supported_bands): Array of #MMModemBand
+ *  values.
+ * @n_supported_bands: Number of values in @supported_bands.
+ * @supported_ip_families: Bitmask of #MMBearerIpFamily values.
+ * @max_active_bearers: Maximum number of active bearers.
+ * @max_active_multiplexed_bearers: Maximum number of active multiplexed
+ *  bearers.
+ * @bearer_paths: DBus paths of the #MMBearer objects, or %NULL.
+ * @sim_path: DBus path of the active #MMSim, or %NULL.
+ * @sim_slot_paths: DBus paths of the #MMSim objects in each SIM slot, or
+ *  %NULL.
+ * @primary_sim_slot: Number of the primary SIM slot.
+ * @manufacturer: Manufacturer, or %NULL.
+ * @model: Model, or %NULL.
+ * @revision: Revision, or %NULL.
+ * @hardware_revision: Hardware revision, or %NULL.
+ * @carrier_configuration: Carrier configuration, or %NULL.
+ * @carrier_configuration_revision: Carrier configuration revision, or %NULL.
+ * @device_identifier: Device identifier, or %NULL.
+ * @device: Physical modem device reference, or %NULL.
+ * @drivers: Kernel drivers, or %NULL.
+ * @plugin: Name of the plugin handling the modem, or %NULL.
+ * @primary_port: Name of the primary port, or %NULL.
+ * @ports: (array length=n_ports): Array of #MMModemPortInfo values.
+ * @n_ports: Number of values in @ports.
+ * @equipment_identifier: Equipment identifier, or %NULL.
+ * @own_numbers: Own numbers, or %NULL.
+ *
+ * #MMModemSnapshot holds the values of all the properties of a #MMModem at a
+ * given time, with the same semantics as the corresponding getters.
+ *
+ * The snapshot is immutable and may be used from any thread; the fields must
+ * not be modified.
+ *
+ * The structure is part of the public ABI: existing fields must not be
+ * reordered or removed, and new fields may only be appended at the end.
+ *
+ * Since: 1.22
+ */
+typedef struct _MMModemSnapshot MMModemSnapshot;
+struct _MMModemSnapshot {
+    /*< private >*/
+    gint ref_count;
+
+    /*< public >*/
+    guint                     sequence;
+    MMModemState              state;
+    MMModemStateFailedReason  state_failed_reason;
+    MMModemPowerState         power_state;
+    MMModemAccessTechnology   access_technologies;
+    guint                     signal_quality;
+    gboolean                  signal_quality_recent;
+    MMModemLock               unlock_required;
+    MMUnlockRetries          *unlock_retries;
+    MMModemCapability         current_capabilities;
+    MMModemCapability        *supported_capabilities;
+    guint                     n_supported_capabilities;
+    MMModemModeCombination    current_modes;
+    MMModemModeCombination   *supported_modes;
+    guint                     n_supported_modes;
+    MMModemBand              *current_bands;
+    guint                     n_current_bands;
+    MMModemBand              *supported_bands;
+    guint                     n_supported_bands;
+    MMBearerIpFamily          supported_ip_families;
+    guint                     max_active_bearers;
+    guint                     max_active_multiplexed_bearers;
+    gchar                   **bearer_paths;
+    gchar                    *sim_path;
+    gchar                   **sim_slot_paths;
+    guint                     primary_sim_slot;
+    gchar                    *manufacturer;
+    gchar                    *model;
+    gchar                    *revision;
+    gchar                    *hardware_revision;
+    gchar                    *carrier_configuration;
+    gchar                    *carrier_configuration_revision;
+    gchar                    *device_identifier;
+    gchar                    *device;
+    gchar                   **drivers;
+    gchar                    *plugin;
+    gchar                    *primary_port;
+    MMModemPortInfo          *ports;
+    guint                     n_ports;
+    gchar                    *equipment_identifier;
+    gchar                   **own_numbers;
+};
+
+#define MM_TYPE_MODEM_SNAPSHOT (mm_modem_snapshot_get_type ())
+GType mm_modem_snapshot_get_type (void);
+
+MMModemSnapshot *mm_modem_get_snapshot          (MMModem *self);
+guint            mm_modem_get_snapshot_sequence (MMModem *self);
+MMModemSnapshot *mm_modem_snapshot_ref          (MMModemSnapshot *snapshot);
+void             mm_modem_snapshot_unref        (MMModemSnapshot *snapshot);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMModemSnapshot, mm_modem_snapshot_unref)
+
 void     mm_modem_enable        (MMModem *self,
                                  GCancellable *cancellable,
                                  GAsyncReadyCallback callback,
@@ -0,0 +1,324 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * libmm-glib -- Access modem status & information from glib applications
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ */
+
+#include "mm-signal-sample.h"
+#include "mm-errors-types.h"
+
+/**
+ * SECTION: mm-signal-sample
+ * @title: MMSignalSample
+ * @short_description: Helper object to handle extended Signal information samples.
+ *
+ * The #MMSignalSample is an object handling one of the extended signal
+ * information samples stored in the modem history, as retrieved with
+ * mm_modem_signal_get_samples().
+ */
+
+G_DEFINE_TYPE (MMSignalSample, mm_signal_sample, G_TYPE_OBJECT)
+
+struct _MMSignalSamplePrivate {
+    guint64   sequence;
+    gint64    timestamp;
+    MMSignal *cdma;
+    MMSignal *evdo;
+    MMSignal *gsm;
+    MMSignal *umts;
+    MMSignal *lte;
+    MMSignal *nr5g;
+};
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_get_sequence:
+ * @self: a #MMSignalSample.
+ *
+ * Gets the sequence number of the sample.
+ *
+ * Sequence numbers increase by one with each new sample stored in the modem
+ * history, so they can be used as cursor in mm_modem_signal_get_samples().
+ *
+ * Returns: the sequence number.
+ *
+ * Since: 1.22
+ */
+guint64
+mm_signal_sample_get_sequence (MMSignalSample *self)
+{
+    g_return_val_if_fail (MM_IS_SIGNAL_SAMPLE (self), 0);
+
+    return self->priv->sequence;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_get_timestamp:
+ * @self: a #MMSignalSample.
+ *
+ * Gets the time when the sample was taken, in microseconds of the
+ * <literal>CLOCK_MONOTONIC</literal> clock, i.e. comparable with the values
+ * returned by g_get_monotonic_time().
+ *
+ * Returns: the timestamp.
+ *
+ * Since: 1.22
+ */
+gint64
+mm_signal_sample_get_timestamp (MMSignalSample *self)
+{
+    g_return_val_if_fail (MM_IS_SIGNAL_SAMPLE (self), 0);
+
+    return self->priv->timestamp;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_peek_cdma:
+ * @self: a #MMSignalSample.
+ *
+ * Gets a #MMSignal object specifying the CDMA signal information in the
+ * sample.
+ *
+ * Returns: (transfer none): A #MMSignal, or %NULL if not available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.22
+ */
+MMSignal *
+mm_signal_sample_peek_cdma (MMSignalSample *self)
+{
+    g_return_val_if_fail (MM_IS_SIGNAL_SAMPLE (self), NULL);
+
+    return self->priv->cdma;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_peek_evdo:
+ * @self: a #MMSignalSample.
+ *
+ * Gets a #MMSignal object specifying the EV-DO signal information in the
+ * sample.
+ *
+ * Returns: (transfer none): A #MMSignal, or %NULL if not available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.22
+ */
+MMSignal *
+mm_signal_sample_peek_evdo (MMSignalSample *self)
+{
+    g_return_val_if_fail (MM_IS_SIGNAL_SAMPLE (self), NULL);
+
+    return self->priv->evdo;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_peek_gsm:
+ * @self: a #MMSignalSample.
+ *
+ * Gets a #MMSignal object specifying the GSM signal information in the
+ * sample.
+ *
+ * Returns: (transfer none): A #MMSignal, or %NULL if not available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.22
+ */
+MMSignal *
+mm_signal_sample_peek_gsm (MMSignalSample *self)
+{
+    g_return_val_if_fail (MM_IS_SIGNAL_SAMPLE (self), NULL);
+
+    return self->priv->gsm;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_peek_umts:
+ * @self: a #MMSignalSample.
+ *
+ * Gets a #MMSignal object specifying the UMTS signal information in the
+ * sample.
+ *
+ * Returns: (transfer none): A #MMSignal, or %NULL if not available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.22
+ */
+MMSignal *
+mm_signal_sample_peek_umts (MMSignalSample *self)
+{
+    g_return_val_if_fail (MM_IS_SIGNAL_SAMPLE (self), NULL);
+
+    return self->priv->umts;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_peek_lte:
+ * @self: a #MMSignalSample.
+ *
+ * Gets a #MMSignal object specifying the LTE signal information in the
+ * sample.
+ *
+ * Returns: (transfer none): A #MMSignal, or %NULL if not available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.22
+ */
+MMSignal *
+mm_signal_sample_peek_lte (MMSignalSample *self)
+{
+    g_return_val_if_fail (MM_IS_SIGNAL_SAMPLE (self), NULL);
+
+    return self->priv->lte;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_peek_nr5g:
+ * @self: a #MMSignalSample.
+ *
+ * Gets a #MMSignal object specifying the 5G signal information in the
+ * sample.
+ *
+ * Returns: (transfer none): A #MMSignal, or %NULL if not available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.22
+ */
+MMSignal *
+mm_signal_sample_peek_nr5g (MMSignalSample *self)
+{
+    g_return_val_if_fail (MM_IS_SIGNAL_SAMPLE (self), NULL);
+
+    return self->priv->nr5g;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_signal_sample_new_from_variant: (skip)
+ */
+MMSignalSample *
+mm_signal_sample_new_from_variant (GVariant  *variant,
+                                   GError   **error)
+{
+    g_autoptr(MMSignalSample)  self = NULL;
+    g_autoptr(GVariant)        dictionary = NULL;
+    GVariantIter               iter;
+    gchar                     *key;
+    GVariant                  *value;
+
+    if (!g_variant_is_of_type (variant, G_VARIANT_TYPE ("(txa{sv})"))) {
+        g_set_error (error,
+                     MM_CORE_ERROR,
+                     MM_CORE_ERROR_INVALID_ARGS,
+                     "Cannot create signal sample from variant: "
+                     "invalid variant type received");
+        return NULL;
+    }
+
+    self = g_object_new (MM_TYPE_SIGNAL_SAMPLE, NULL);
+    g_variant_get (variant, "(tx@a{sv})",
+                   &self->priv->sequence,
+                   &self->priv->timestamp,
+                   &dictionary);
+
+    g_variant_iter_init (&iter, dictionary);
+    while (g_variant_iter_next (&iter, "{sv}", &key, &value)) {
+        MMSignal **signal = NULL;
+        GError    *inner_error = NULL;
+
+        if (g_str_equal (key, "cdma"))
+            signal = &self->priv->cdma;
+        else if (g_str_equal (key, "evdo"))
+            signal = &self->priv->evdo;
+        else if (g_str_equal (key, "gsm"))
+            signal = &self->priv->gsm;
+        else if (g_str_equal (key, "umts"))
+            signal = &self->priv->umts;
+        else if (g_str_equal (key, "lte"))
+            signal = &self->priv->lte;
+        else if (g_str_equal (key, "nr5g"))
+            signal = &self->priv->nr5g;
+
+        if (signal) {
+            g_clear_object (signal);
+            *signal = mm_signal_new_from_dictionary (value, &inner_error);
+        } else
+            inner_error = g_error_new (MM_CORE_ERROR,
+                                       MM_CORE_ERROR_INVALID_ARGS,
+                                       "Invalid signal sample, unexpected key '%s'",
+                                       key);
+
+        g_free (key);
+        g_variant_unref (value);
+
+        if (inner_error) {
+            g_propagate_error (error, inner_error);
+            return NULL;
+        }
+    }
+
+    return g_steal_pointer (&self);
+}
+
+/*****************************************************************************/
+
+static void
+mm_signal_sample_init (MMSignalSample *self)
+{
+    self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_SIGNAL_SAMPLE, MMSignalSamplePrivate);
+}
+
+static void
+finalize (GObject *object)
+{
+    MMSignalSample *self = MM_SIGNAL_SAMPLE (object);
+
+    g_clear_object (&self->priv->cdma);
+    g_clear_object (&self->priv->evdo);
+    g_clear_object (&self->priv->gsm);
+    g_clear_object (&self->priv->umts);
+    g_clear_object (&self->priv->lte);
+    g_clear_object (&self->priv->nr5g);
+
+    G_OBJECT_CLASS (mm_signal_sample_parent_class)->finalize (object);
+}
+
+static void
+mm_signal_sample_class_init (MMSignalSampleClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (object_class, sizeof (MMSignalSamplePrivate));
+
+    object_class->finalize = finalize;
+}
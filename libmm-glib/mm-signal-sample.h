@@ -0,0 +1,89 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * libmm-glib -- Access modem status & information from glib applications
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ */
+
+#ifndef MM_SIGNAL_SAMPLE_H
+#define MM_SIGNAL_SAMPLE_H
+
+#if !defined (__LIBMM_GLIB_H_INSIDE__) && !defined (LIBMM_GLIB_COMPILATION)
+#error "Only <libmm-glib.h> can be included directly."
+#endif
+
+#include <ModemManager.h>
+#include <glib-object.h>
+
+#include "mm-signal.h"
+
+G_BEGIN_DECLS
+
+#define MM_TYPE_SIGNAL_SAMPLE            (mm_signal_sample_get_type ())
+#define MM_SIGNAL_SAMPLE(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_SIGNAL_SAMPLE, MMSignalSample))
+#define MM_SIGNAL_SAMPLE_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_SIGNAL_SAMPLE, MMSignalSampleClass))
+#define MM_IS_SIGNAL_SAMPLE(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_SIGNAL_SAMPLE))
+#define MM_IS_SIGNAL_SAMPLE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_SIGNAL_SAMPLE))
+#define MM_SIGNAL_SAMPLE_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_SIGNAL_SAMPLE, MMSignalSampleClass))
+
+typedef struct _MMSignalSample MMSignalSample;
+typedef struct _MMSignalSampleClass MMSignalSampleClass;
+typedef struct _MMSignalSamplePrivate MMSignalSamplePrivate;
+
+/**
+ * MMSignalSample:
+ *
+ * The #MMSignalSample structure contains private data and should
+ * only be accessed using the provided API.
+ */
+struct _MMSignalSample {
+    /*< private >*/
+    GObject parent;
+    MMSignalSamplePrivate *priv;
+};
+
+struct _MMSignalSampleClass {
+    /*< private >*/
+    GObjectClass parent;
+};
+
+GType mm_signal_sample_get_type (void);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMSignalSample, g_object_unref)
+
+guint64   mm_signal_sample_get_sequence  (MMSignalSample *self);
+gint64    mm_signal_sample_get_timestamp (MMSignalSample *self);
+MMSignal *mm_signal_sample_peek_cdma     (MMSignalSample *self);
+MMSignal *mm_signal_sample_peek_evdo     (MMSignalSample *self);
+MMSignal *mm_signal_sample_peek_gsm      (MMSignalSample *self);
+MMSignal *mm_signal_sample_peek_umts     (MMSignalSample *self);
+MMSignal *mm_signal_sample_peek_lte      (MMSignalSample *self);
+MMSignal *mm_signal_sample_peek_nr5g     (MMSignalSample *self);
+
+/*****************************************************************************/
+/* ModemManager/libmm-glib/mmcli specific methods */
+
+#if defined (_LIBMM_INSIDE_MM) ||    \
+    defined (_LIBMM_INSIDE_MMCLI) || \
+    defined (LIBMM_GLIB_COMPILATION)
+
+MMSignalSample *mm_signal_sample_new_from_variant (GVariant  *variant,
+                                                   GError   **error);
+
+#endif
+
+G_END_DECLS
+
+#endif /* MM_SIGNAL_SAMPLE_H */
@@ -0,0 +1,139 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <string.h>
+#include <glib-object.h>
+
+#include <libmm-glib.h>
+
+/*****************************************************************************/
+
+static GVariant *
+build_sample_variant (guint64      sequence,
+                      gint64       timestamp,
+                      const gchar *key,
+                      MMSignal    *signal)
+{
+    GVariantBuilder builder;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    if (key) {
+        g_autoptr(GVariant) dictionary = NULL;
+
+        dictionary = mm_signal_get_dictionary (signal);
+        g_variant_builder_add (&builder, "{sv}", key, dictionary);
+    }
+    return g_variant_ref_sink (g_variant_new ("(tx@a{sv})", sequence, timestamp, g_variant_builder_end (&builder)));
+}
+
+static void
+signal_sample_empty (void)
+{
+    g_autoptr(GVariant)       variant = NULL;
+    g_autoptr(MMSignalSample) sample = NULL;
+    GError                   *error = NULL;
+
+    variant = build_sample_variant (1, 0, NULL, NULL);
+    sample = mm_signal_sample_new_from_variant (variant, &error);
+    g_assert_no_error (error);
+    g_assert (sample);
+
+    g_assert_cmpuint (mm_signal_sample_get_sequence (sample), ==, 1);
+    g_assert_cmpint (mm_signal_sample_get_timestamp (sample), ==, 0);
+    g_assert_null (mm_signal_sample_peek_cdma (sample));
+    g_assert_null (mm_signal_sample_peek_evdo (sample));
+    g_assert_null (mm_signal_sample_peek_gsm (sample));
+    g_assert_null (mm_signal_sample_peek_umts (sample));
+    g_assert_null (mm_signal_sample_peek_lte (sample));
+    g_assert_null (mm_signal_sample_peek_nr5g (sample));
+}
+
+static void
+signal_sample_lte (void)
+{
+    g_autoptr(GVariant)       variant = NULL;
+    g_autoptr(MMSignalSample) sample = NULL;
+    g_autoptr(MMSignal)       lte = NULL;
+    MMSignal                 *peeked;
+    GError                   *error = NULL;
+
+    lte = mm_signal_new ();
+    mm_signal_set_rssi (lte, -65.0);
+    mm_signal_set_rsrq (lte, -11.0);
+    mm_signal_set_rsrp (lte, -95.0);
+    mm_signal_set_snr  (lte, 13.5);
+
+    variant = build_sample_variant (G_MAXUINT64, G_MAXINT64, "lte", lte);
+    sample = mm_signal_sample_new_from_variant (variant, &error);
+    g_assert_no_error (error);
+    g_assert (sample);
+
+    g_assert_cmpuint (mm_signal_sample_get_sequence (sample), ==, G_MAXUINT64);
+    g_assert_cmpint (mm_signal_sample_get_timestamp (sample), ==, G_MAXINT64);
+    g_assert_null (mm_signal_sample_peek_umts (sample));
+    g_assert_null (mm_signal_sample_peek_nr5g (sample));
+
+    peeked = mm_signal_sample_peek_lte (sample);
+    g_assert (peeked);
+    g_assert_cmpfloat (mm_signal_get_rssi (peeked), ==, -65.0);
+    g_assert_cmpfloat (mm_signal_get_rsrq (peeked), ==, -11.0);
+    g_assert_cmpfloat (mm_signal_get_rsrp (peeked), ==, -95.0);
+    g_assert_cmpfloat (mm_signal_get_snr (peeked), ==, 13.5);
+    g_assert_cmpfloat (mm_signal_get_rscp (peeked), ==, MM_SIGNAL_UNKNOWN);
+}
+
+static void
+signal_sample_invalid_type (void)
+{
+    g_autoptr(GVariant)       variant = NULL;
+    g_autoptr(MMSignalSample) sample = NULL;
+    GError                   *error = NULL;
+
+    variant = g_variant_ref_sink (g_variant_new ("(tt)", (guint64) 1, (guint64) 2));
+    sample = mm_signal_sample_new_from_variant (variant, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_assert_null (sample);
+    g_error_free (error);
+}
+
+static void
+signal_sample_invalid_key (void)
+{
+    g_autoptr(GVariant)       variant = NULL;
+    g_autoptr(MMSignalSample) sample = NULL;
+    g_autoptr(MMSignal)       signal = NULL;
+    GError                   *error = NULL;
+
+    signal = mm_signal_new ();
+    mm_signal_set_rssi (signal, -80.0);
+
+    variant = build_sample_variant (3, 100, "wimax", signal);
+    sample = mm_signal_sample_new_from_variant (variant, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_assert_null (sample);
+    g_error_free (error);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/SignalSample/empty",        signal_sample_empty);
+    g_test_add_func ("/MM/SignalSample/lte",          signal_sample_lte);
+    g_test_add_func ("/MM/SignalSample/invalid-type", signal_sample_invalid_type);
+    g_test_add_func ("/MM/SignalSample/invalid-key",  signal_sample_invalid_key);
+
+    return g_test_run ();
+}
@@ -0,0 +1,142 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib-object.h>
+
+#include <libmm-glib.h>
+
+/*****************************************************************************/
+
+/* The proxies are created without a bus connection, so all properties are
+ * unknown and the snapshots only carry default values */
+
+static MMModemSignal *
+modem_signal_new (void)
+{
+    return g_object_new (MM_TYPE_MODEM_SIGNAL, NULL);
+}
+
+static void
+emit_properties_changed (gpointer proxy)
+{
+    GVariantBuilder      builder;
+    g_autoptr(GVariant)  changed = NULL;
+    const gchar         *invalidated[] = { NULL };
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    changed = g_variant_ref_sink (g_variant_builder_end (&builder));
+    g_signal_emit_by_name (proxy, "g-properties-changed", changed, invalidated);
+}
+
+static void
+snapshot_ref_unref (void)
+{
+    g_autoptr(MMModemSignal) self = NULL;
+    MMModemSignalSnapshot   *snapshot;
+    MMModemSignalSnapshot   *other;
+
+    self = modem_signal_new ();
+
+    /* One reference owned by the object, one by the caller */
+    snapshot = mm_modem_signal_get_snapshot (self);
+    g_assert (snapshot);
+    g_assert_cmpint (snapshot->ref_count, ==, 2);
+    g_assert_cmpuint (snapshot->sequence, ==, 0);
+    g_assert_cmpuint (snapshot->rate, ==, 0);
+    g_assert_null (snapshot->lte);
+
+    /* Shared while there are no changes */
+    other = mm_modem_signal_get_snapshot (self);
+    g_assert (other == snapshot);
+    g_assert_cmpint (snapshot->ref_count, ==, 3);
+    mm_modem_signal_snapshot_unref (other);
+    g_assert_cmpint (snapshot->ref_count, ==, 2);
+
+    g_assert (mm_modem_signal_snapshot_ref (snapshot) == snapshot);
+    g_assert_cmpint (snapshot->ref_count, ==, 3);
+    mm_modem_signal_snapshot_unref (snapshot);
+    mm_modem_signal_snapshot_unref (snapshot);
+    g_assert_cmpint (snapshot->ref_count, ==, 1);
+
+    /* Boxed copy and free map to ref and unref */
+    other = g_boxed_copy (MM_TYPE_MODEM_SIGNAL_SNAPSHOT, snapshot);
+    g_assert (other == snapshot);
+    g_assert_cmpint (snapshot->ref_count, ==, 2);
+    g_boxed_free (MM_TYPE_MODEM_SIGNAL_SNAPSHOT, other);
+    g_assert_cmpint (snapshot->ref_count, ==, 1);
+}
+
+static void
+snapshot_properties_changed (void)
+{
+    g_autoptr(MMModemSignal)         self = NULL;
+    g_autoptr(MMModemSignalSnapshot) first = NULL;
+    g_autoptr(MMModemSignalSnapshot) second = NULL;
+    g_autoptr(MMModemSignalSnapshot) third = NULL;
+
+    self = modem_signal_new ();
+    g_assert_cmpuint (mm_modem_signal_get_snapshot_sequence (self), ==, 0);
+
+    first = mm_modem_signal_get_snapshot (self);
+    g_assert_cmpuint (first->sequence, ==, 0);
+    g_assert_cmpint (first->ref_count, ==, 2);
+
+    /* A change bumps the sequence and drops the cached snapshot, while the
+     * one already given to the caller stays valid */
+    emit_properties_changed (self);
+    g_assert_cmpuint (mm_modem_signal_get_snapshot_sequence (self), ==, 1);
+    g_assert_cmpint (first->ref_count, ==, 1);
+    g_assert_cmpuint (first->sequence, ==, 0);
+
+    second = mm_modem_signal_get_snapshot (self);
+    g_assert (second != first);
+    g_assert_cmpuint (second->sequence, ==, 1);
+    g_assert_cmpint (second->ref_count, ==, 2);
+
+    /* Every change is counted, even without a snapshot in between */
+    emit_properties_changed (self);
+    emit_properties_changed (self);
+    g_assert_cmpuint (mm_modem_signal_get_snapshot_sequence (self), ==, 3);
+    g_assert_cmpint (second->ref_count, ==, 1);
+
+    third = mm_modem_signal_get_snapshot (self);
+    g_assert (third != second);
+    g_assert_cmpuint (third->sequence, ==, 3);
+}
+
+static void
+snapshot_finalize (void)
+{
+    MMModemSignal                   *self;
+    g_autoptr(MMModemSignalSnapshot) snapshot = NULL;
+
+    /* The snapshot outlives the object */
+    self = modem_signal_new ();
+    snapshot = mm_modem_signal_get_snapshot (self);
+    g_object_unref (self);
+    g_assert_cmpint (snapshot->ref_count, ==, 1);
+    g_assert_cmpuint (snapshot->sequence, ==, 0);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/Snapshot/ref-unref",          snapshot_ref_unref);
+    g_test_add_func ("/MM/Snapshot/properties-changed", snapshot_properties_changed);
+    g_test_add_func ("/MM/Snapshot/finalize",           snapshot_finalize);
+
+    return g_test_run ();
+}
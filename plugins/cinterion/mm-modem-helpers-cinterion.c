@@ -272,8 +272,8 @@ mm_cinterion_parse_scfg_test (const gchar                 *response,
         return FALSE;
     }
 
-    r1 = g_regex_new ("\\^SCFG:\\s*\"Radio/Band\",\\((?:\")?([0-9]*)(?:\")?-(?:\")?([0-9]*)(?:\")?.*\\)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
+    r1 = mm_regex_cache_get ("\\^SCFG:\\s*\"Radio/Band\",\\((?:\")?([0-9]*)(?:\")?-(?:\")?([0-9]*)(?:\")?.*\\)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
     g_assert (r1 != NULL);
 
     g_regex_match_full (r1, response, strlen (response), 0, 0, &match_info1, &inner_error);
@@ -307,10 +307,10 @@ mm_cinterion_parse_scfg_test (const gchar                 *response,
         goto finish;
     }
 
-    r2 = g_regex_new ("\\^SCFG:\\s*\"Radio/Band/([234]G)\","
-                      "\\(\"?([0-9A-Fa-fx]*)\"?-\"?([0-9A-Fa-fx]*)\"?\\)"
-                      "(,*\\(\"?([0-9A-Fa-fx]*)\"?-\"?([0-9A-Fa-fx]*)\"?\\))?",
-                     0, 0, NULL);
+    r2 = mm_regex_cache_get ("\\^SCFG:\\s*\"Radio/Band/([234]G)\","
+                             "\\(\"?([0-9A-Fa-fx]*)\"?-\"?([0-9A-Fa-fx]*)\"?\\)"
+                             "(,*\\(\"?([0-9A-Fa-fx]*)\"?-\"?([0-9A-Fa-fx]*)\"?\\))?",
+                            0, 0, NULL);
     g_assert (r2 != NULL);
 
     g_regex_match_full (r2, response, strlen (response), 0, 0, &match_info2, &inner_error);
@@ -436,7 +436,7 @@ mm_cinterion_parse_scfg_response (const gchar                  *response,
     }
 
     if (format == MM_CINTERION_RADIO_BAND_FORMAT_SINGLE) {
-        r = g_regex_new ("\\^SCFG:\\s*\"Radio/Band\",\\s*\"?([0-9a-fA-F]*)\"?", 0, 0, NULL);
+        r = mm_regex_cache_get ("\\^SCFG:\\s*\"Radio/Band\",\\s*\"?([0-9a-fA-F]*)\"?", 0, 0, NULL);
         g_assert (r != NULL);
 
         g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -468,8 +468,8 @@ mm_cinterion_parse_scfg_response (const gchar                  *response,
             }
         }
     } else if (format == MM_CINTERION_RADIO_BAND_FORMAT_MULTIPLE) {
-        r = g_regex_new ("\\^SCFG:\\s*\"Radio/Band/([234]G)\",\"?([0-9A-Fa-fx]*)\"?,?\"?([0-9A-Fa-fx]*)?\"?",
-                         0, 0, NULL);
+        r = mm_regex_cache_get ("\\^SCFG:\\s*\"Radio/Band/([234]G)\",\"?([0-9A-Fa-fx]*)\"?,?\"?([0-9A-Fa-fx]*)?\"?",
+                                0, 0, NULL);
         g_assert (r != NULL);
 
         g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -568,9 +568,9 @@ mm_cinterion_parse_cnmi_test (const gchar *response,
         return FALSE;
     }
 
-    r = g_regex_new ("\\+CNMI:\\s*\\((.*)\\),\\((.*)\\),\\((.*)\\),\\((.*)\\),\\((.*)\\)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, NULL);
+    r = mm_regex_cache_get ("\\+CNMI:\\s*\\((.*)\\),\\((.*)\\),\\((.*)\\),\\((.*)\\),\\((.*)\\)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -664,9 +664,9 @@ mm_cinterion_parse_sxrat_test (const gchar *response,
         return FALSE;
     }
 
-    r = g_regex_new ("\\^SXRAT:\\s*\\(([^\\)]*)\\),\\(([^\\)]*)\\)(,\\(([^\\)]*)\\))?(?:\\r\\n)?",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, NULL);
+    r = mm_regex_cache_get ("\\^SXRAT:\\s*\\(([^\\)]*)\\),\\(([^\\)]*)\\)(,\\(([^\\)]*)\\))?(?:\\r\\n)?",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, NULL);
 
     g_assert (r != NULL);
 
@@ -846,7 +846,7 @@ mm_cinterion_parse_sind_response (const gchar *response,
         return FALSE;
     }
 
-    r = g_regex_new ("\\^SIND:\\s*(.*),(\\d+),(\\d+)(\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^SIND:\\s*(.*),(\\d+),(\\d+)(\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
     if (g_regex_match (r, response, 0, &match_info)) {
@@ -925,8 +925,8 @@ mm_cinterion_parse_swwan_response (const gchar  *response,
         return MM_BEARER_CONNECTION_STATUS_UNKNOWN;
     }
 
-    r = g_regex_new ("\\^SWWAN:\\s*(\\d+),\\s*(\\d+)(?:,\\s*(\\d+))?(?:\\r\\n)?",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\^SWWAN:\\s*(\\d+),\\s*(\\d+)(?:,\\s*(\\d+))?(?:\\r\\n)?",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
     status = MM_BEARER_CONNECTION_STATUS_UNKNOWN;
@@ -982,7 +982,7 @@ mm_cinterion_parse_sgauth_response (const gchar          *response,
     g_autoptr(GRegex)     r = NULL;
     g_autoptr(GMatchInfo) match_info = NULL;
 
-    r = g_regex_new ("\\^SGAUTH:\\s*(\\d+),(\\d+),?\"?([a-zA-Z0-9_-]+)?\"?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^SGAUTH:\\s*(\\d+),(\\d+),?\"?([a-zA-Z0-9_-]+)?\"?", 0, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, NULL);
@@ -1059,11 +1059,11 @@ mm_cinterion_parse_smong_response (const gchar              *response,
      * 0776  1  -      -   214   03  2    00      01
      * OK
      */
-    regex = g_regex_new (".*GPRS Monitor(?:\r\n)*"
-                         "BCCH\\s*G.*\\r\\n"
-                         "\\s*(\\d+)\\s*(\\d+)\\s*",
-                         G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                         0, NULL);
+    regex = mm_regex_cache_get (".*GPRS Monitor(?:\r\n)*"
+                                "BCCH\\s*G.*\\r\\n"
+                                "\\s*(\\d+)\\s*(\\d+)\\s*",
+                                G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                                0, NULL);
     g_assert (regex);
 
     g_regex_match_full (regex, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -1127,8 +1127,8 @@ mm_cinterion_get_slcc_regex (void)
      * with an empty line preceded by prefix "^SLCC: ", in order to indicate the end
      * of the list.
      */
-    return g_regex_new ("\\r\\n(\\^SLCC: .*\\r\\n)*\\^SLCC: \\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    return mm_regex_cache_get ("\\r\\n(\\^SLCC: .*\\r\\n)*\\^SLCC: \\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 }
 
 static void
@@ -1175,13 +1175,13 @@ mm_cinterion_parse_slcc_list (const gchar *str,
      *  ^SLCC :
      */
 
-    r = g_regex_new ("\\^SLCC:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)" /* mandatory fields */
-                     "(?:,\\s*([^,]*),\\s*(\\d+)"                                                /* number and type */
-                     "(?:,\\s*([^,]*)"                                                           /* alpha */
-                     ")?)?$",
-                     G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
-                     G_REGEX_MATCH_NEWLINE_CRLF,
-                     NULL);
+    r = mm_regex_cache_get ("\\^SLCC:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)" /* mandatory fields */
+                            "(?:,\\s*([^,]*),\\s*(\\d+)"                                                /* number and type */
+                            "(?:,\\s*([^,]*)"                                                           /* alpha */
+                            ")?)?$",
+                            G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
+                            G_REGEX_MATCH_NEWLINE_CRLF,
+                            NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
@@ -1256,8 +1256,8 @@ mm_cinterion_get_ctzu_regex (void)
      *  +CTZU: "19/07/09,10:19:15",+08,1
      */
 
-    return g_regex_new ("\\r\\n\\+CTZU:\\s*\"(\\d+)\\/(\\d+)\\/(\\d+),(\\d+):(\\d+):(\\d+)\",([\\-\\+\\d]+)(?:,(\\d+))?(?:\\r\\n)?",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CTZU:\\s*\"(\\d+)\\/(\\d+)\\/(\\d+),(\\d+):(\\d+):(\\d+)\",([\\-\\+\\d]+)(?:,(\\d+))?(?:\\r\\n)?",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 }
 
 gboolean
@@ -1406,7 +1406,7 @@ mm_cinterion_parse_smoni_query_response (const gchar           *response,
         success = TRUE;
         goto out;
     }
-    pre = g_regex_new ("\\^SMONI:\\s*([234])", 0, 0, NULL);
+    pre = mm_regex_cache_get ("\\^SMONI:\\s*([234])", 0, 0, NULL);
     g_assert (pre != NULL);
     g_regex_match_full (pre, response, strlen (response), 0, 0, &match_info_pre, &inner_error);
     if (!inner_error && g_match_info_matches (match_info_pre)) {
@@ -1417,7 +1417,7 @@ mm_cinterion_parse_smoni_query_response (const gchar           *response,
         #define FLOAT "([-+]?[0-9]+\\.?[0-9]*)"
         switch (tech) {
         case MM_CINTERION_RADIO_GEN_2G:
-            r = g_regex_new ("\\^SMONI:\\s*2G,(\\d+),"FLOAT, 0, 0, NULL);
+            r = mm_regex_cache_get ("\\^SMONI:\\s*2G,(\\d+),"FLOAT, 0, 0, NULL);
             g_assert (r != NULL);
             g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
             if (!inner_error && g_match_info_matches (match_info)) {
@@ -1429,7 +1429,7 @@ mm_cinterion_parse_smoni_query_response (const gchar           *response,
             }
             break;
         case MM_CINTERION_RADIO_GEN_3G:
-            r = g_regex_new ("\\^SMONI:\\s*3G,(\\d+),(\\d+),"FLOAT","FLOAT, 0, 0, NULL);
+            r = mm_regex_cache_get ("\\^SMONI:\\s*3G,(\\d+),(\\d+),"FLOAT","FLOAT, 0, 0, NULL);
             g_assert (r != NULL);
             g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
             if (!inner_error && g_match_info_matches (match_info)) {
@@ -1446,7 +1446,7 @@ mm_cinterion_parse_smoni_query_response (const gchar           *response,
             }
             break;
         case MM_CINTERION_RADIO_GEN_4G:
-            r = g_regex_new ("\\^SMONI:\\s*4G,(\\d+),(\\d+),(\\d+),(\\d+),(\\w+),(\\d+),(\\d+),(\\w+),(\\w+),(\\d+),([^,]*),"FLOAT","FLOAT, 0, 0, NULL);
+            r = mm_regex_cache_get ("\\^SMONI:\\s*4G,(\\d+),(\\d+),(\\d+),(\\d+),(\\w+),(\\d+),(\\d+),(\\w+),(\\w+),(\\d+),([^,]*),"FLOAT","FLOAT, 0, 0, NULL);
             g_assert (r != NULL);
             g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
             if (!inner_error && g_match_info_matches (match_info)) {
@@ -1585,7 +1585,7 @@ mm_cinterion_provcfg_response_to_cid (const gchar             *response,
     g_autofree gchar      *mno = NULL;
     GError                *inner_error = NULL;
 
-    r = g_regex_new ("\\^SCFG:\\s*\"MEopMode/Prov/Cfg\",\\s*\"([0-9a-zA-Z*]*)\"", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\^SCFG:\\s*\"MEopMode/Prov/Cfg\",\\s*\"([0-9a-zA-Z*]*)\"", 0, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
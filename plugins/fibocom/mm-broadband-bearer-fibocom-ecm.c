@@ -35,8 +35,8 @@ parse_gtrndis_read_response (const gchar *response,
     g_autoptr(GRegex)     r = NULL;
     g_autoptr(GMatchInfo) match_info = NULL;
 
-    r = g_regex_new ("\\+GTRNDIS:\\s*(\\d+)(?:,(\\d+))?",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+GTRNDIS:\\s*(\\d+)(?:,(\\d+))?",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
     if (!g_regex_match (r, response, 0, &match_info)) {
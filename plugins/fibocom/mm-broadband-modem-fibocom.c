@@ -700,8 +700,8 @@ mm_broadband_modem_fibocom_init (MMBroadbandModemFibocom *self)
                                               MMBroadbandModemFibocomPrivate);
 
     self->priv->gtrndis_support = FEATURE_SUPPORT_UNKNOWN;
-    self->priv->sim_ready_regex = g_regex_new ("\\r\\n\\+SIM READY\\r\\n",
-                                               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->sim_ready_regex = mm_regex_cache_get ("\\r\\n\\+SIM READY\\r\\n",
+                                                      G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
     self->priv->initial_eps_bearer_support = FEATURE_SUPPORT_UNKNOWN;
 }
 
@@ -139,8 +139,8 @@ load_supported_modes_finish (MMIfaceModem *self,
      * %IPSYS: (0-3,5),(0-3)
      */
 
-    r = g_regex_new ("\\%IPSYS:\\s*\\((.*)\\)\\s*,\\((.*)\\)",
-                     G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\%IPSYS:\\s*\\((.*)\\)\\s*,\\((.*)\\)",
+                            G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match (r, response, 0, &match_info);
@@ -1133,9 +1133,9 @@ parse_bands (const gchar *response,
      *   ...
      * with 1 and 0 indicating whether the particular band is enabled or not.
      */
-    r = g_regex_new ("^\"(\\w+)\": (\\d)",
-                     G_REGEX_MULTILINE, G_REGEX_MATCH_NEWLINE_ANY,
-                     NULL);
+    r = mm_regex_cache_get ("^\"(\\w+)\": (\\d)",
+                            G_REGEX_MULTILINE, G_REGEX_MATCH_NEWLINE_ANY,
+                            NULL);
     g_assert (r != NULL);
 
     g_regex_match (r, response, 0, &info);
@@ -2251,12 +2251,12 @@ mm_broadband_modem_icera_init (MMBroadbandModemIcera *self)
                                               MM_TYPE_BROADBAND_MODEM_ICERA,
                                               MMBroadbandModemIceraPrivate);
 
-    self->priv->nwstate_regex = g_regex_new ("%NWSTATE:\\s*(-?\\d+),(\\d+),([^,]*),([^,]*),(\\d+)",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->pacsp_regex = g_regex_new ("\\r\\n\\+PACSP(\\d)\\r\\n",
-                                           G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ipdpact_regex = g_regex_new ("\\r\\n%IPDPACT:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)\\r\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->nwstate_regex = mm_regex_cache_get ("%NWSTATE:\\s*(-?\\d+),(\\d+),([^,]*),([^,]*),(\\d+)",
+                                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->pacsp_regex = mm_regex_cache_get ("\\r\\n\\+PACSP(\\d)\\r\\n",
+                                                  G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->ipdpact_regex = mm_regex_cache_get ("\\r\\n%IPDPACT:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)\\r\\n",
+                                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 
     self->priv->default_ip_method = MM_BEARER_IP_METHOD_STATIC;
     self->priv->last_act = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
@@ -312,9 +312,9 @@ mm_icera_parse_ipdpcfg_query_response (const gchar  *str,
 
     n_profiles = g_list_length (profiles);
 
-    r = g_regex_new ("%IPDPCFG:\\s*(\\d+),(\\d+),(\\d+),([^,]*),([^,]*),(\\d+)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, NULL);
+    r = mm_regex_cache_get ("%IPDPCFG:\\s*(\\d+),(\\d+),(\\d+),([^,]*),([^,]*),(\\d+)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
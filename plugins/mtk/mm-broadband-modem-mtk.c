@@ -85,11 +85,11 @@ load_unlock_retries_ready (MMBaseModem *self,
         return;
     }
 
-    r = g_regex_new (
-            "\\+EPINC:\\s*([0-9]+),\\s*([0-9]+),\\s*([0-9]+),\\s*([0-9]+)",
-            0,
-            0,
-            NULL);
+    r = mm_regex_cache_get (
+                   "\\+EPINC:\\s*([0-9]+),\\s*([0-9]+),\\s*([0-9]+),\\s*([0-9]+)",
+                   0,
+                   0,
+                   NULL);
 
     g_assert (r != NULL);
 
@@ -191,8 +191,8 @@ get_supported_modes_ready (MMBaseModem *self,
         return;
     }
 
-    r = g_regex_new ("\\+EGMR:\\s*\"MT([0-9]+)",
-            G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    r = mm_regex_cache_get ("\\+EGMR:\\s*\"MT([0-9]+)",
+                   G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
     g_assert (r != NULL);
 
     if (!g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &match_error)) {
@@ -306,11 +306,11 @@ load_current_modes_finish (MMIfaceModem *self,
     if (!response)
         return FALSE;
 
-    r = g_regex_new (
-                "\\+ERAT:\\s*[0-9]+,\\s*[0-9]+,\\s*([0-9]+),\\s*([0-9]+)",
-                0,
-                0,
-                error);
+    r = mm_regex_cache_get (
+                       "\\+ERAT:\\s*[0-9]+,\\s*[0-9]+,\\s*([0-9]+),\\s*([0-9]+)",
+                       0,
+                       0,
+                       error);
     g_assert (r != NULL);
 
     if (!g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &match_error)) {
@@ -858,21 +858,21 @@ mm_broadband_modem_mtk_init (MMBroadbandModemMtk *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE ((self),
                                               MM_TYPE_BROADBAND_MODEM_MTK,
                                               MMBroadbandModemMtkPrivate);
-    self->priv->ecsqg_regex = g_regex_new (
-        "\\r\\n\\+ECSQ:\\s*([0-9]*),\\s*[0-9]*,\\s*-[0-9]*\\r\\n",
-        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ecsqu_regex = g_regex_new (
-        "\\r\\n\\+ECSQ:\\s*([0-9]*),\\s*[0-9]*,\\s*-[0-9]*,\\s*-[0-9]*,\\s*-[0-9]*\\r\\n",
-        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ecsqeg_regex = g_regex_new (
-        "\\r\\n\\+ECSQ:\\s*([0-9]*),\\s*[0-9]*,\\s*-[0-9]*,\\s*1,\\s*1,\\s*1,\\s*1,\\s*[0-9]*\\r\\n",
-        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ecsqeu_regex = g_regex_new (
-        "\\r\\n\\+ECSQ:\\s*([0-9]*),\\s*[0-9]*,\\s*1,\\s*-[0-9]*,\\s*-[0-9]*,\\s*1,\\s*1,\\s*[0-9]*\\r\\n",
-        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->ecsqel_regex = g_regex_new (
-        "\\r\\n\\+ECSQ:\\s*[0-9]*,\\s*([0-9]*),\\s*1,\\s*1,\\s*1,\\s*-[0-9]*,\\s*-[0-9]*,\\s*[0-9]*\\r\\n",
-        G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->ecsqg_regex = mm_regex_cache_get (
+               "\\r\\n\\+ECSQ:\\s*([0-9]*),\\s*[0-9]*,\\s*-[0-9]*\\r\\n",
+               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->ecsqu_regex = mm_regex_cache_get (
+               "\\r\\n\\+ECSQ:\\s*([0-9]*),\\s*[0-9]*,\\s*-[0-9]*,\\s*-[0-9]*,\\s*-[0-9]*\\r\\n",
+               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->ecsqeg_regex = mm_regex_cache_get (
+               "\\r\\n\\+ECSQ:\\s*([0-9]*),\\s*[0-9]*,\\s*-[0-9]*,\\s*1,\\s*1,\\s*1,\\s*1,\\s*[0-9]*\\r\\n",
+               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->ecsqeu_regex = mm_regex_cache_get (
+               "\\r\\n\\+ECSQ:\\s*([0-9]*),\\s*[0-9]*,\\s*1,\\s*-[0-9]*,\\s*-[0-9]*,\\s*1,\\s*1,\\s*[0-9]*\\r\\n",
+               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->ecsqel_regex = mm_regex_cache_get (
+               "\\r\\n\\+ECSQ:\\s*[0-9]*,\\s*([0-9]*),\\s*1,\\s*1,\\s*1,\\s*-[0-9]*,\\s*-[0-9]*,\\s*[0-9]*\\r\\n",
+               G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 }
 
 static void
@@ -83,9 +83,9 @@ get_private (MMSharedQuectel *self)
         priv->provided_sources  = MM_MODEM_LOCATION_SOURCE_NONE;
         priv->enabled_sources   = MM_MODEM_LOCATION_SOURCE_NONE;
         priv->qgps_supported    = FEATURE_SUPPORT_UNKNOWN;
-        priv->qgpsurc_regex     = g_regex_new ("\\r\\n\\+QGPSURC:.*", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-        priv->qlwurc_regex      = g_regex_new ("\\r\\n\\+QLWURC:.*", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-        priv->rdy_regex         = g_regex_new ("\\r\\nRDY", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+        priv->qgpsurc_regex     = mm_regex_cache_get ("\\r\\n\\+QGPSURC:.*", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+        priv->qlwurc_regex      = mm_regex_cache_get ("\\r\\n\\+QLWURC:.*", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+        priv->rdy_regex         = mm_regex_cache_get ("\\r\\nRDY", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 
         g_assert (priv->qgpsurc_regex);
         g_assert (priv->qlwurc_regex);
@@ -483,7 +483,7 @@ mm_shared_quectel_setup_sim_hot_swap (MMIfaceModem        *self,
     ports[0] = mm_base_modem_peek_port_primary   (MM_BASE_MODEM (self));
     ports[1] = mm_base_modem_peek_port_secondary (MM_BASE_MODEM (self));
 
-    pattern = g_regex_new ("\\+QUSIM:\\s*1\\r\\n", G_REGEX_RAW, 0, NULL);
+    pattern = mm_regex_cache_get ("\\+QUSIM:\\s*1\\r\\n", G_REGEX_RAW, 0, NULL);
     g_assert (pattern);
 
     for (i = 0; i < G_N_ELEMENTS (ports); i++) {
@@ -521,7 +521,7 @@ telit_qss_enable_ready (MMBaseModem *self,
         goto next_step;
     }
 
-    pattern = g_regex_new ("#QSS:\\s*([0-3])\\r\\n", G_REGEX_RAW, 0, NULL);
+    pattern = mm_regex_cache_get ("#QSS:\\s*([0-3])\\r\\n", G_REGEX_RAW, 0, NULL);
     g_assert (pattern);
     mm_port_serial_at_add_unsolicited_msg_handler (
         port,
@@ -1126,10 +1126,10 @@ response_processor_cops_ignore_at_errors (MMBaseModem   *self,
         return MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
     }
 
-    r = g_regex_new ("\\+COPS:\\s*(\\d+),(\\d+),([^,]*)(?:,(\\d+))?(?:\\r\\n)?",
-                     0,
-                     0,
-                     NULL);
+    r = mm_regex_cache_get ("\\+COPS:\\s*(\\d+),(\\d+),([^,]*)(?:,(\\d+))?(?:\\r\\n)?",
+                            0,
+                            0,
+                            NULL);
     g_assert (r != NULL);
 
     if (!g_regex_match (r, response, 0, &match_info)) {
@@ -120,7 +120,7 @@ cache_port_mode (MMPortProbe *probe,
     guint                  portcfg_current;
 
     /* #PORTCFG: <requested>,<active> */
-    r = g_regex_new ("#PORTCFG:\\s*(\\d+),(\\d+)", flags, 0, NULL);
+    r = mm_regex_cache_get ("#PORTCFG:\\s*(\\d+),(\\d+)", flags, 0, NULL);
     g_assert (r != NULL);
 
     if (!g_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &error))
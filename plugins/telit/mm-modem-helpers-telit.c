@@ -713,7 +713,7 @@ common_parse_bnd_response (const gchar            *response,
     else
         load_bands_regex = load_bands_regex_4g_dec[load_type];
 
-    r = g_regex_new (load_bands_regex, G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get (load_bands_regex, G_REGEX_RAW, 0, NULL);
     g_assert (r);
 
     if (!g_regex_match (r, response, 0, &match_info)) {
@@ -868,10 +868,10 @@ mm_telit_parse_swpkgv_response (const gchar *response)
     guint matches;
 
     /* We are interested only in the first line of the response */
-    r = g_regex_new ("(?P<Base>\\d{2}.\\d{2}.*)",
-                     G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
-                     G_REGEX_MATCH_NEWLINE_CR,
-                     NULL);
+    r = mm_regex_cache_get ("(?P<Base>\\d{2}.\\d{2}.*)",
+                            G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
+                            G_REGEX_MATCH_NEWLINE_CR,
+                            NULL);
     g_assert (r != NULL);
 
     if (!g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, NULL)) {
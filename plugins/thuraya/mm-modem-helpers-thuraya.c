@@ -92,7 +92,7 @@ mm_thuraya_3gpp_parse_cpms_test_response (const gchar  *reply,
         return FALSE;
     }
 
-    r = g_regex_new ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
     g_assert (r);
 
     for (i = 0; i < N_EXPECTED_GROUPS; i++) {
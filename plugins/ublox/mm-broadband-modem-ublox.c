@@ -1130,9 +1130,9 @@ ublox_setup_ciev_handler (MMIfaceModem *self,
     primary_port = mm_base_modem_peek_port_primary (MM_BASE_MODEM (self));
     mm_obj_dbg (self, "setting up simind 'CIEV: %d' events handler", simind_idx);
     ciev_regex = g_strdup_printf ("\\r\\n\\+CIEV: %d,([0-1]{1})\\r\\n", simind_idx);
-    pattern = g_regex_new (ciev_regex,
-                           G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                           0, NULL);
+    pattern = mm_regex_cache_get (ciev_regex,
+                                  G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                                  0, NULL);
     g_assert (pattern);
     mm_port_serial_at_add_unsolicited_msg_handler (
         primary_port,
@@ -1451,12 +1451,12 @@ common_voice_setup_cleanup_unsolicited_events (MMBroadbandModemUblox *self,
     guint           i;
 
     if (G_UNLIKELY (!self->priv->ucallstat_regex))
-        self->priv->ucallstat_regex = g_regex_new ("\\r\\n\\+UCALLSTAT:\\s*(\\d+),(\\d+)\\r\\n",
-                                                   G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+        self->priv->ucallstat_regex = mm_regex_cache_get ("\\r\\n\\+UCALLSTAT:\\s*(\\d+),(\\d+)\\r\\n",
+                                                          G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 
     if (G_UNLIKELY (!self->priv->udtmfd_regex))
-        self->priv->udtmfd_regex = g_regex_new ("\\r\\n\\+UUDTMFD:\\s*([0-9A-D\\*\\#])\\r\\n",
-                                                G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+        self->priv->udtmfd_regex = mm_regex_cache_get ("\\r\\n\\+UUDTMFD:\\s*([0-9A-D\\*\\#])\\r\\n",
+                                                       G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 
     ports[0] = mm_base_modem_peek_port_primary   (MM_BASE_MODEM (self));
     ports[1] = mm_base_modem_peek_port_secondary (MM_BASE_MODEM (self));
@@ -2005,8 +2005,8 @@ mm_broadband_modem_ublox_init (MMBroadbandModemUblox *self)
     self->priv->support_config.uact     = FEATURE_SUPPORT_UNKNOWN;
     self->priv->support_config.ubandsel = FEATURE_SUPPORT_UNKNOWN;
     self->priv->udtmfd_support = FEATURE_SUPPORT_UNKNOWN;
-    self->priv->pbready_regex = g_regex_new ("\\r\\n\\+PBREADY\\r\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->pbready_regex = mm_regex_cache_get ("\\r\\n\\+PBREADY\\r\\n",
+                                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 }
 
 static void
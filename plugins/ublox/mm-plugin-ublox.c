@@ -202,8 +202,8 @@ ublox_custom_init (MMPortProbe         *probe,
     ctx = g_slice_new0 (CustomInitContext);
     ctx->wait_timeout_secs = wait_timeout_secs;
     ctx->port = g_object_ref (port);
-    ctx->ready_regex = g_regex_new ("\\r\\n\\+AT:\\s*READY\\r\\n",
-                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    ctx->ready_regex = mm_regex_cache_get ("\\r\\n\\+AT:\\s*READY\\r\\n",
+                                           G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
     g_task_set_task_data (task, ctx, (GDestroyNotify) custom_init_context_free);
 
     /* If the device hasn't been plugged in right away, we assume it was already
@@ -257,7 +257,7 @@ wwsm_read_ready (MMBaseModem  *self,
      *   +WWSM: 2,1  (2G preferred)
      *   +WWSM: 2,2  (3G preferred)
      */
-    r = g_regex_new ("\\r\\n\\+WWSM: ([0-2])(,([0-2]))?.*$", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\r\\n\\+WWSM: ([0-2])(,([0-2]))?.*$", 0, 0, NULL);
     g_assert (r != NULL);
 
     if (g_regex_match (r, response, 0, &match_info)) {
@@ -1030,7 +1030,7 @@ parse_network_registration_mode (const gchar *reply,
     if (!reply)
         return FALSE;
 
-    r = g_regex_new ("\\+COPS:\\s*(\\d)", G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("\\+COPS:\\s*(\\d)", G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match (r, reply, 0, &match_info);
@@ -1238,9 +1238,9 @@ setup_ports (MMBroadbandModem *self)
 
     /* AT+CPIN? replies will never have an OK appended */
     parser = mm_serial_parser_v1_new ();
-    regex = g_regex_new ("\\r\\n\\+CPIN: .*\\r\\n",
-                         G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                         0, NULL);
+    regex = mm_regex_cache_get ("\\r\\n\\+CPIN: .*\\r\\n",
+                                G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                                0, NULL);
     mm_serial_parser_v1_set_custom_regex (parser, regex, NULL);
 
     mm_port_serial_at_set_response_parser (MM_PORT_SERIAL_AT (primary),
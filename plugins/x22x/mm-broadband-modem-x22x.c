@@ -131,7 +131,7 @@ load_current_modes_finish (MMIfaceModem *self,
     if (!response)
         return FALSE;
 
-    r = g_regex_new ("\\+SYSSEL:\\s*(\\d+),(\\d+),(\\d+),(\\d+)", G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("\\+SYSSEL:\\s*(\\d+),(\\d+),(\\d+),(\\d+)", G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r != NULL);
 
     if (!g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &match_error)) {
@@ -377,14 +377,14 @@ mm_broadband_modem_x22x_init (MMBroadbandModemX22x *self)
                                               MM_TYPE_BROADBAND_MODEM_X22X,
                                               MMBroadbandModemX22xPrivate);
 
-    self->priv->mode_regex    = g_regex_new ("\\r\\n\\^MODE:.+\\r\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->sysinfo_regex = g_regex_new ("\\r\\n\\^SYSINFO:.+\\r\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->specc_regex   = g_regex_new ("\\r\\n\\+SPECC\\r\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
-    self->priv->sperror_regex = g_regex_new ("\\r\\n\\+SPERROR:.+\\r\\n",
-                                             G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->mode_regex    = mm_regex_cache_get ("\\r\\n\\^MODE:.+\\r\\n",
+                                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->sysinfo_regex = mm_regex_cache_get ("\\r\\n\\^SYSINFO:.+\\r\\n",
+                                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->specc_regex   = mm_regex_cache_get ("\\r\\n\\+SPECC\\r\\n",
+                                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    self->priv->sperror_regex = mm_regex_cache_get ("\\r\\n\\+SPERROR:.+\\r\\n",
+                                                    G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 }
 
 static void
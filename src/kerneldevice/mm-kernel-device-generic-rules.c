@@ -32,6 +32,8 @@ udev_rule_match_clear (MMUdevRuleMatch *rule_match)
 {
     g_free (rule_match->parameter);
     g_free (rule_match->value);
+    g_free (rule_match->name);
+    g_free (rule_match->prefix_match);
 }
 
 static void
@@ -174,6 +176,83 @@ out:
     return TRUE;
 }
 
+static gchar *
+build_match_name (const gchar *parameter,
+                  guint        prefix_len)
+{
+    gchar *name;
+
+    name = g_strdup (&parameter[prefix_len]);
+    g_strdelimit (name, "{}", ' ');
+    g_strstrip (name);
+    return name;
+}
+
+static void
+compile_rule_match (MMUdevRuleMatch *rule_match)
+{
+    const gchar *parameter;
+    const gchar *value;
+
+    parameter = rule_match->parameter;
+    value = rule_match->value;
+
+    rule_match->value_any = g_str_equal (value, "?*");
+    rule_match->value_uint_valid = mm_get_uint_from_hex_str (value, &rule_match->value_uint);
+
+    if (g_str_equal (parameter, "ACTION"))
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ACTION;
+    else if (g_str_equal (parameter, "SUBSYSTEM"))
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_SUBSYSTEM;
+    else if (g_str_equal (parameter, "SUBSYSTEMS"))
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_SUBSYSTEMS;
+    else if (g_str_equal (parameter, "DRIVER"))
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_DRIVER;
+    else if (g_str_equal (parameter, "DRIVERS"))
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_DRIVERS;
+    else if (g_str_equal (parameter, "KERNEL"))
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_KERNEL;
+    else if (g_str_equal (parameter, "DEVPATH")) {
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_DEVPATH;
+        /* If not already doing a prefix match, do an implicit one. This is so that
+         * we can add properties to the usb_device owning all ports, and then apply
+         * the property to all ports individually processed. */
+        if (value[0] && value[strlen (value) - 1] != '*')
+            rule_match->prefix_match = g_strdup_printf ("%s/*", value);
+    } else if (g_str_has_prefix (parameter, "ATTR")) {
+        const gchar *attribute;
+
+        rule_match->name = build_match_name (parameter, 5);
+        rule_match->recursive = g_str_has_prefix (parameter, "ATTRS");
+
+        attribute = rule_match->name;
+        if (g_str_equal (attribute, "idVendor") || g_str_equal (attribute, "vendor"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_VENDOR;
+        else if (g_str_equal (attribute, "idProduct") || g_str_equal (attribute, "device"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT;
+        else if (g_str_equal (attribute, "subsystem_vendor"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_SUBSYSTEM_VENDOR;
+        else if (g_str_equal (attribute, "manufacturer"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_MANUFACTURER;
+        else if (g_str_equal (attribute, "product"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT_NAME;
+        else if (g_str_equal (attribute, "bInterfaceClass"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_CLASS;
+        else if (g_str_equal (attribute, "bInterfaceSubClass"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_SUBCLASS;
+        else if (g_str_equal (attribute, "bInterfaceProtocol"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_PROTOCOL;
+        else if (g_str_equal (attribute, "bInterfaceNumber"))
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_NUMBER;
+        else
+            rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ATTR_OTHER;
+    } else if (g_str_has_prefix (parameter, "ENV")) {
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_ENV;
+        rule_match->name = build_match_name (parameter, 3);
+    } else
+        rule_match->parameter_id = MM_UDEV_RULE_PARAMETER_UNKNOWN;
+}
+
 static gboolean
 load_rule_match (MMUdevRuleMatch  *rule_match,
                  const gchar      *item,
@@ -203,6 +282,7 @@ load_rule_match (MMUdevRuleMatch  *rule_match,
     g_free (operator);
     rule_match->parameter = left;
     rule_match->value     = right;
+    compile_rule_match (rule_match);
     return TRUE;
 }
 
@@ -361,6 +441,90 @@ out:
     return TRUE;
 }
 
+static void
+compile_rule_guard (MMUdevRule *rule)
+{
+    MMUdevRuleGuard *guard;
+    guint            i;
+
+    guard = &rule->guard;
+    for (i = 0; rule->conditions && i < rule->conditions->len; i++) {
+        MMUdevRuleMatch *match;
+
+        match = &g_array_index (rule->conditions, MMUdevRuleMatch, i);
+        if (match->type != MM_UDEV_RULE_MATCH_TYPE_EQUAL)
+            continue;
+
+        switch (match->parameter_id) {
+        case MM_UDEV_RULE_PARAMETER_ATTR_VENDOR:
+            if (!match->value_uint_valid || match->value_uint > G_MAXUINT16 ||
+                (guard->has_vendor && guard->vendor != match->value_uint))
+                guard->never = TRUE;
+            guard->has_vendor = TRUE;
+            guard->vendor = (guint16) match->value_uint;
+            break;
+        case MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT:
+            if (!match->value_uint_valid || match->value_uint > G_MAXUINT16 ||
+                (guard->has_product && guard->product != match->value_uint))
+                guard->never = TRUE;
+            guard->has_product = TRUE;
+            guard->product = (guint16) match->value_uint;
+            break;
+        case MM_UDEV_RULE_PARAMETER_SUBSYSTEM:
+            if (guard->subsystem && !g_str_equal (guard->subsystem, match->value))
+                guard->never = TRUE;
+            guard->subsystem = g_intern_string (match->value);
+            break;
+        case MM_UDEV_RULE_PARAMETER_UNKNOWN:
+        case MM_UDEV_RULE_PARAMETER_ACTION:
+        case MM_UDEV_RULE_PARAMETER_SUBSYSTEMS:
+        case MM_UDEV_RULE_PARAMETER_DRIVER:
+        case MM_UDEV_RULE_PARAMETER_DRIVERS:
+        case MM_UDEV_RULE_PARAMETER_KERNEL:
+        case MM_UDEV_RULE_PARAMETER_DEVPATH:
+        case MM_UDEV_RULE_PARAMETER_ATTR_SUBSYSTEM_VENDOR:
+        case MM_UDEV_RULE_PARAMETER_ATTR_MANUFACTURER:
+        case MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT_NAME:
+        case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_CLASS:
+        case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_SUBCLASS:
+        case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_PROTOCOL:
+        case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_NUMBER:
+        case MM_UDEV_RULE_PARAMETER_ATTR_OTHER:
+        case MM_UDEV_RULE_PARAMETER_ENV:
+        default:
+            break;
+        }
+    }
+}
+
+/* Rule files are mostly sequences of rules for the same vendor (and often
+ * for the same product), so link each rule to the first following one with
+ * a different guard. Rules failing a guard can then be skipped as a whole. */
+static void
+compile_rule_guards (GArray *rules)
+{
+    guint i;
+
+    for (i = 0; i < rules->len; i++)
+        compile_rule_guard (&g_array_index (rules, MMUdevRule, i));
+
+    for (i = rules->len; i > 0; i--) {
+        MMUdevRuleGuard *guard;
+        MMUdevRuleGuard *next = NULL;
+
+        guard = &g_array_index (rules, MMUdevRule, i - 1).guard;
+        if (i < rules->len)
+            next = &g_array_index (rules, MMUdevRule, i).guard;
+
+        guard->vendor_skip = ((next && guard->has_vendor && next->has_vendor && next->vendor == guard->vendor) ?
+                              next->vendor_skip : i);
+        guard->product_skip = ((next && guard->has_product && next->has_product && next->product == guard->product) ?
+                               next->product_skip : i);
+        guard->subsystem_skip = ((next && guard->subsystem && next->subsystem == guard->subsystem) ?
+                                 next->subsystem_skip : i);
+    }
+}
+
 static GList *
 list_rule_files (const gchar *rules_dir_path)
 {
@@ -428,6 +592,8 @@ mm_kernel_device_generic_rules_load (const gchar  *rules_dir,
         goto out;
     }
 
+    compile_rule_guards (rules);
+
 out:
     if (rule_files)
         g_list_free_full (rule_files, g_free);
@@ -440,3 +606,77 @@ out:
 
     return rules;
 }
+
+/*****************************************************************************/
+
+static guint
+apply_rule (GArray                  *rules,
+            guint                    rule_i,
+            MMUdevRuleConditionFunc  condition_func,
+            MMUdevRulePropertyFunc   property_func,
+            gpointer                 user_data)
+{
+    MMUdevRule *rule;
+    guint       i;
+
+    rule = &g_array_index (rules, MMUdevRule, rule_i);
+    for (i = 0; rule->conditions && i < rule->conditions->len; i++) {
+        if (!condition_func (&g_array_index (rule->conditions, MMUdevRuleMatch, i), user_data))
+            return rule_i + 1;
+    }
+
+    switch (rule->result.type) {
+    case MM_UDEV_RULE_RESULT_TYPE_PROPERTY:
+        property_func (&rule->result.content.property, user_data);
+        break;
+    case MM_UDEV_RULE_RESULT_TYPE_LABEL:
+        /* noop */
+        break;
+    case MM_UDEV_RULE_RESULT_TYPE_GOTO_INDEX:
+        /* Jump to a new index */
+        return rule->result.content.index;
+    case MM_UDEV_RULE_RESULT_TYPE_GOTO_TAG:
+    case MM_UDEV_RULE_RESULT_TYPE_UNKNOWN:
+    default:
+        g_assert_not_reached ();
+    }
+
+    /* Go to the next rule */
+    return rule_i + 1;
+}
+
+void
+mm_kernel_device_generic_rules_apply (GArray                  *rules,
+                                      const gchar             *subsystem,
+                                      guint16                  vendor,
+                                      guint16                  product,
+                                      gboolean                 use_guards,
+                                      MMUdevRuleConditionFunc  condition_func,
+                                      MMUdevRulePropertyFunc   property_func,
+                                      gpointer                 user_data)
+{
+    guint i;
+
+    /* Guard subsystems are interned */
+    if (subsystem)
+        subsystem = g_intern_string (subsystem);
+
+    i = 0;
+    while (i < rules->len) {
+        MMUdevRuleGuard *guard;
+
+        guard = &g_array_index (rules, MMUdevRule, i).guard;
+        if (!use_guards)
+            i = apply_rule (rules, i, condition_func, property_func, user_data);
+        else if (guard->never)
+            i++;
+        else if (guard->has_vendor && guard->vendor != vendor)
+            i = guard->vendor_skip;
+        else if (guard->has_product && guard->product != product)
+            i = guard->product_skip;
+        else if (guard->subsystem && guard->subsystem != subsystem)
+            i = guard->subsystem_skip;
+        else
+            i = apply_rule (rules, i, condition_func, property_func, user_data);
+    }
+}
@@ -23,10 +23,42 @@ typedef enum {
     MM_UDEV_RULE_MATCH_TYPE_NOT_EQUAL,
 } MMUdevRuleMatchType;
 
+/* Match parameters, interned when the rules are loaded */
+typedef enum {
+    MM_UDEV_RULE_PARAMETER_UNKNOWN,
+    MM_UDEV_RULE_PARAMETER_ACTION,
+    MM_UDEV_RULE_PARAMETER_SUBSYSTEM,
+    MM_UDEV_RULE_PARAMETER_SUBSYSTEMS,
+    MM_UDEV_RULE_PARAMETER_DRIVER,
+    MM_UDEV_RULE_PARAMETER_DRIVERS,
+    MM_UDEV_RULE_PARAMETER_KERNEL,
+    MM_UDEV_RULE_PARAMETER_DEVPATH,
+    MM_UDEV_RULE_PARAMETER_ATTR_VENDOR,
+    MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT,
+    MM_UDEV_RULE_PARAMETER_ATTR_SUBSYSTEM_VENDOR,
+    MM_UDEV_RULE_PARAMETER_ATTR_MANUFACTURER,
+    MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT_NAME,
+    MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_CLASS,
+    MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_SUBCLASS,
+    MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_PROTOCOL,
+    MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_NUMBER,
+    MM_UDEV_RULE_PARAMETER_ATTR_OTHER,
+    MM_UDEV_RULE_PARAMETER_ENV,
+} MMUdevRuleParameter;
+
 typedef struct {
     MMUdevRuleMatchType  type;
     gchar               *parameter;
     gchar               *value;
+
+    /* Compiled from the parameter and value */
+    MMUdevRuleParameter  parameter_id;
+    gchar               *name;             /* attribute or property name */
+    gboolean             recursive;        /* ATTRS instead of ATTR */
+    gboolean             value_any;        /* value is '?*' */
+    gboolean             value_uint_valid;
+    guint                value_uint;       /* value as hex number */
+    gchar               *prefix_match;     /* implicit DEVPATH prefix match */
 } MMUdevRuleMatch;
 
 typedef enum {
@@ -51,12 +83,46 @@ typedef struct {
     } content;
 } MMUdevRuleResult;
 
+/* Conditions that are cheap to check before any other, and which are shared
+ * by consecutive rules (e.g. all the rules of one vendor in a file). When a
+ * guard fails, the whole run of rules with the same guard is skipped. */
+typedef struct {
+    gboolean     never;           /* conditions can never be fulfilled */
+    gboolean     has_vendor;
+    guint16      vendor;
+    guint        vendor_skip;     /* next rule not requiring the same vendor */
+    gboolean     has_product;
+    guint16      product;
+    guint        product_skip;    /* next rule not requiring the same product */
+    const gchar *subsystem;       /* interned */
+    guint        subsystem_skip;  /* next rule not requiring the same subsystem */
+} MMUdevRuleGuard;
+
 typedef struct {
     GArray           *conditions;
     MMUdevRuleResult  result;
+    MMUdevRuleGuard   guard;
 } MMUdevRule;
 
 GArray *mm_kernel_device_generic_rules_load (const gchar  *rules_dir,
                                              GError      **error);
 
+typedef gboolean (* MMUdevRuleConditionFunc) (MMUdevRuleMatch          *match,
+                                              gpointer                  user_data);
+typedef void     (* MMUdevRulePropertyFunc)  (MMUdevRuleResultProperty *property,
+                                              gpointer                  user_data);
+
+/* Process the rules for a device with the given bus subsystem, vendor and
+ * product. Each condition is checked with condition_func, and property_func
+ * is called for each property set by a matching rule. If use_guards is TRUE,
+ * rules failing their guard are skipped without checking any condition. */
+void    mm_kernel_device_generic_rules_apply (GArray                  *rules,
+                                              const gchar             *subsystem,
+                                              guint16                  vendor,
+                                              guint16                  product,
+                                              gboolean                 use_guards,
+                                              MMUdevRuleConditionFunc  condition_func,
+                                              MMUdevRulePropertyFunc   property_func,
+                                              gpointer                 user_data);
+
 G_END_DECLS
@@ -18,6 +18,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
 
 #define _LIBMM_INSIDE_MM
 #include <libmm-glib.h>
@@ -72,6 +75,9 @@ struct _MMKernelDeviceGenericPrivate {
     guint16  physdev_revision;
     gchar   *physdev_manufacturer;
     gchar   *physdev_product;
+
+    /* Attributes read while applying the rules */
+    GHashTable *rules_sysfs_attributes;
 };
 
 static gboolean
@@ -99,19 +105,6 @@ read_sysfs_attribute_as_string (const gchar *path,
     return contents;
 }
 
-static guint
-read_sysfs_attribute_as_hex (const gchar *path,
-                             const gchar *attribute)
-{
-    g_autofree gchar *contents = NULL;
-    guint             val = 0;
-
-    contents = read_sysfs_attribute_as_string (path, attribute);
-    if (contents)
-        mm_get_uint_from_hex_str (contents, &val);
-    return val;
-}
-
 static gchar *
 read_sysfs_attribute_link_basename (const gchar *path,
                                     const gchar *attribute)
@@ -160,6 +153,214 @@ lookup_sysfs_attribute_as_string (MMKernelDeviceGeneric *self,
     return NULL;
 }
 
+/*****************************************************************************/
+/* Batched sysfs attribute reads
+ *
+ * All attributes of the same sysfs object are read relative to a single
+ * directory file descriptor, instead of resolving the full path for each one.
+ */
+
+/* sysfs attributes are never longer than one page */
+#define SYSFS_ATTRIBUTE_MAX_SIZE 4096
+
+static gchar *
+read_sysfs_attribute_at (gint         dirfd,
+                         const gchar *attribute)
+{
+    g_autofree gchar *buffer = NULL;
+    gssize            n_read;
+    gint              fd;
+
+    fd = openat (dirfd, attribute, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return NULL;
+
+    buffer = g_malloc (SYSFS_ATTRIBUTE_MAX_SIZE + 1);
+    do {
+        n_read = read (fd, buffer, SYSFS_ATTRIBUTE_MAX_SIZE);
+    } while (n_read < 0 && errno == EINTR);
+    close (fd);
+
+    if (n_read < 0)
+        return NULL;
+
+    buffer[n_read] = '\0';
+    g_strdelimit (buffer, "\r\n", ' ');
+    g_strstrip (buffer);
+    return g_strdup (buffer);
+}
+
+/* Reads all the given attributes, values are NULL for the ones not found and
+ * for empty attribute names. Returns FALSE if the sysfs object itself cannot
+ * be opened. */
+static gboolean
+read_sysfs_attributes (const gchar  *path,
+                       const gchar **attributes,
+                       gchar       **values,
+                       struct stat  *out_stat)
+{
+    gint  dirfd;
+    guint i;
+
+    dirfd = open (path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd < 0)
+        return FALSE;
+
+    if (out_stat && fstat (dirfd, out_stat) < 0) {
+        close (dirfd);
+        return FALSE;
+    }
+
+    for (i = 0; attributes[i]; i++)
+        values[i] = attributes[i][0] ? read_sysfs_attribute_at (dirfd, attributes[i]) : NULL;
+
+    close (dirfd);
+    return TRUE;
+}
+
+static guint
+parse_sysfs_attribute_as_hex (const gchar *value)
+{
+    guint val = 0;
+
+    if (value)
+        mm_get_uint_from_hex_str (value, &val);
+    return val;
+}
+
+/*****************************************************************************/
+/* Physical device attributes cache
+ *
+ * Composite devices expose lots of ports, and each of them used to read the
+ * same attributes from the physical device sysfs object. These are now read
+ * once, and shared by all ports of the same physical device until one of them
+ * is removed.
+ */
+
+typedef enum {
+    PHYSDEV_ATTRIBUTE_VID,
+    PHYSDEV_ATTRIBUTE_PID,
+    PHYSDEV_ATTRIBUTE_SUBSYSTEM_VID,
+    PHYSDEV_ATTRIBUTE_REVISION,
+    PHYSDEV_ATTRIBUTE_MANUFACTURER,
+    PHYSDEV_ATTRIBUTE_PRODUCT,
+    PHYSDEV_ATTRIBUTE_LAST
+} PhysdevAttribute;
+
+/* Attribute names per bus, in PhysdevAttribute order; missing ones are
+ * given as empty strings */
+static const gchar *physdev_attributes_usb[]    = { "idVendor", "idProduct", "", "bcdDevice", "manufacturer", "product", NULL };
+static const gchar *physdev_attributes_pci[]    = { "vendor", "device", "subsystem_vendor", "revision", "", "", NULL };
+static const gchar *physdev_attributes_pcmcia[] = { "manf_id", "card_id", "", "", "", "", NULL };
+
+typedef struct {
+    /* To detect a different device at the same path */
+    ino_t  ino;
+    gchar *values[PHYSDEV_ATTRIBUTE_LAST];
+} PhysdevAttributes;
+
+/* physdev sysfs path -> PhysdevAttributes */
+static GHashTable *physdev_cache;
+/* port 'subsystem/name' -> physdev sysfs path, to invalidate on removals */
+static GHashTable *physdev_cache_ports;
+
+static void
+physdev_attributes_free (PhysdevAttributes *attrs)
+{
+    guint i;
+
+    for (i = 0; i < PHYSDEV_ATTRIBUTE_LAST; i++)
+        g_free (attrs->values[i]);
+    g_slice_free (PhysdevAttributes, attrs);
+}
+
+static gchar *
+build_physdev_cache_port_key (const gchar *subsystem,
+                              const gchar *name)
+{
+    return g_strdup_printf ("%s/%s", subsystem, name);
+}
+
+gchar **
+mm_kernel_device_generic_lookup_physdev_attributes (const gchar  *subsystem,
+                                                    const gchar  *name,
+                                                    const gchar  *physdev_sysfs_path,
+                                                    const gchar **attributes)
+{
+    PhysdevAttributes *attrs;
+    struct stat        st;
+
+    g_assert (g_strv_length ((gchar **) attributes) <= PHYSDEV_ATTRIBUTE_LAST);
+
+    if (G_UNLIKELY (!physdev_cache)) {
+        physdev_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) physdev_attributes_free);
+        physdev_cache_ports = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    }
+
+    g_hash_table_insert (physdev_cache_ports,
+                         build_physdev_cache_port_key (subsystem, name),
+                         g_strdup (physdev_sysfs_path));
+
+    attrs = g_hash_table_lookup (physdev_cache, physdev_sysfs_path);
+    if (attrs && stat (physdev_sysfs_path, &st) == 0 && st.st_ino == attrs->ino)
+        return attrs->values;
+
+    attrs = g_slice_new0 (PhysdevAttributes);
+    if (!read_sysfs_attributes (physdev_sysfs_path, attributes, attrs->values, &st)) {
+        physdev_attributes_free (attrs);
+        g_hash_table_remove (physdev_cache, physdev_sysfs_path);
+        return NULL;
+    }
+    attrs->ino = st.st_ino;
+
+    mm_dbg ("physical device attributes loaded: %s", physdev_sysfs_path);
+    g_hash_table_insert (physdev_cache, g_strdup (physdev_sysfs_path), attrs);
+    return attrs->values;
+}
+
+void
+mm_kernel_device_generic_forget_port (const gchar *subsystem,
+                                      const gchar *name)
+{
+    g_autofree gchar *key = NULL;
+    const gchar      *physdev_sysfs_path;
+
+    if (!physdev_cache)
+        return;
+
+    key = build_physdev_cache_port_key (subsystem, name);
+    physdev_sysfs_path = g_hash_table_lookup (physdev_cache_ports, key);
+    if (!physdev_sysfs_path)
+        return;
+
+    if (g_hash_table_remove (physdev_cache, physdev_sysfs_path))
+        mm_dbg ("physical device attributes invalidated: %s", physdev_sysfs_path);
+    g_hash_table_remove (physdev_cache_ports, key);
+}
+
+static void
+preload_physdev_attributes (MMKernelDeviceGeneric  *self,
+                            const gchar           **attributes)
+{
+    gchar **values;
+
+    g_assert (self->priv->physdev_sysfs_path);
+
+    values = mm_kernel_device_generic_lookup_physdev_attributes (mm_kernel_event_properties_get_subsystem (self->priv->properties),
+                                                                 mm_kernel_event_properties_get_name      (self->priv->properties),
+                                                                 self->priv->physdev_sysfs_path,
+                                                                 attributes);
+    if (!values)
+        return;
+
+    self->priv->physdev_vid = parse_sysfs_attribute_as_hex (values[PHYSDEV_ATTRIBUTE_VID]);
+    self->priv->physdev_pid = parse_sysfs_attribute_as_hex (values[PHYSDEV_ATTRIBUTE_PID]);
+    self->priv->physdev_subsystem_vid = parse_sysfs_attribute_as_hex (values[PHYSDEV_ATTRIBUTE_SUBSYSTEM_VID]);
+    self->priv->physdev_revision = parse_sysfs_attribute_as_hex (values[PHYSDEV_ATTRIBUTE_REVISION]);
+    self->priv->physdev_manufacturer = g_strdup (values[PHYSDEV_ATTRIBUTE_MANUFACTURER]);
+    self->priv->physdev_product = g_strdup (values[PHYSDEV_ATTRIBUTE_PRODUCT]);
+}
+
 /*****************************************************************************/
 /* Load contents */
 
@@ -361,8 +562,7 @@ preload_contents_pcmcia (MMKernelDeviceGeneric *self)
 
         if (pcmcia_subsystem_found  && parent_subsystem && (g_strcmp0 (parent_subsystem, "pcmcia") != 0)) {
             self->priv->physdev_sysfs_path = g_strdup (iter);
-            self->priv->physdev_vid = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "manf_id");
-            self->priv->physdev_pid = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "card_id");
+            preload_physdev_attributes (self, physdev_attributes_pcmcia);
             /* stop traversing as soon as the physical device is found */
             break;
         }
@@ -400,10 +600,7 @@ preload_contents_pci (MMKernelDeviceGeneric *self)
          * one that reports the 'pci' subsystem */
         if (!self->priv->physdev_sysfs_path && (g_strcmp0 (current_subsystem, "pci") == 0)) {
             self->priv->physdev_sysfs_path = g_strdup (iter);
-            self->priv->physdev_vid = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "vendor");
-            self->priv->physdev_pid = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "device");
-            self->priv->physdev_subsystem_vid = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "subsystem_vendor");
-            self->priv->physdev_revision = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "revision");
+            preload_physdev_attributes (self, physdev_attributes_pci);
             /* stop traversing as soon as the physical device is found */
             break;
         }
@@ -438,21 +635,25 @@ preload_contents_usb (MMKernelDeviceGeneric *self)
 
         /* is this the USB interface? */
         if (!self->priv->interface_sysfs_path && has_sysfs_attribute (iter, "bInterfaceClass")) {
+            static const gchar *interface_attributes[] = { "bInterfaceClass", "bInterfaceSubClass", "bInterfaceProtocol", "bInterfaceNumber", "interface", NULL };
+            gchar              *values[G_N_ELEMENTS (interface_attributes)] = { NULL };
+            guint               i;
+
             self->priv->interface_sysfs_path = g_strdup (iter);
-            self->priv->interface_class = read_sysfs_attribute_as_hex (self->priv->interface_sysfs_path, "bInterfaceClass");
-            self->priv->interface_subclass = read_sysfs_attribute_as_hex (self->priv->interface_sysfs_path, "bInterfaceSubClass");
-            self->priv->interface_protocol = read_sysfs_attribute_as_hex (self->priv->interface_sysfs_path, "bInterfaceProtocol");
-            self->priv->interface_number = read_sysfs_attribute_as_hex (self->priv->interface_sysfs_path, "bInterfaceNumber");
-            self->priv->interface_description = read_sysfs_attribute_as_string (self->priv->interface_sysfs_path, "interface");
+            if (read_sysfs_attributes (self->priv->interface_sysfs_path, interface_attributes, values, NULL)) {
+                self->priv->interface_class = parse_sysfs_attribute_as_hex (values[0]);
+                self->priv->interface_subclass = parse_sysfs_attribute_as_hex (values[1]);
+                self->priv->interface_protocol = parse_sysfs_attribute_as_hex (values[2]);
+                self->priv->interface_number = parse_sysfs_attribute_as_hex (values[3]);
+                self->priv->interface_description = g_steal_pointer (&values[4]);
+            }
+            for (i = 0; i < G_N_ELEMENTS (values); i++)
+                g_free (values[i]);
         }
         /* is this the USB physdev? */
         else if (!self->priv->physdev_sysfs_path && has_sysfs_attribute (iter, "idVendor")) {
             self->priv->physdev_sysfs_path = g_strdup (iter);
-            self->priv->physdev_vid = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "idVendor");
-            self->priv->physdev_pid = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "idProduct");
-            self->priv->physdev_revision = read_sysfs_attribute_as_hex (self->priv->physdev_sysfs_path, "bcdDevice");
-            self->priv->physdev_manufacturer = read_sysfs_attribute_as_string (self->priv->physdev_sysfs_path, "manufacturer");
-            self->priv->physdev_product = read_sysfs_attribute_as_string (self->priv->physdev_sysfs_path, "product");
+            preload_physdev_attributes (self, physdev_attributes_usb);
             /* stop traversing as soon as the physical device is found */
             break;
         }
@@ -749,6 +950,58 @@ kernel_device_cmp (MMKernelDevice *a,
 
 /*****************************************************************************/
 
+/* Attributes read while applying the rules, so that they're read only once
+ * even if checked by multiple rules */
+static const gchar *
+lookup_sysfs_attribute_memoized (MMKernelDeviceGeneric *self,
+                                 const gchar           *attribute,
+                                 gboolean               iterate)
+{
+    g_autofree gchar *key = NULL;
+    gpointer          value;
+
+    if (!self->priv->rules_sysfs_attributes)
+        self->priv->rules_sysfs_attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    key = g_strdup_printf ("%s%s", iterate ? "ATTRS:" : "ATTR:", attribute);
+    if (g_hash_table_lookup_extended (self->priv->rules_sysfs_attributes, key, NULL, &value))
+        return (const gchar *) value;
+
+    value = lookup_sysfs_attribute_as_string (self, attribute, iterate);
+    g_hash_table_insert (self->priv->rules_sysfs_attributes, g_steal_pointer (&key), value);
+    return (const gchar *) value;
+}
+
+static gboolean
+check_condition_uint (MMUdevRuleMatch *match,
+                      guint            value,
+                      gboolean         condition_equal)
+{
+    return (match->value_uint_valid && ((value == match->value_uint) == condition_equal));
+}
+
+static gboolean
+check_condition_devpath (MMKernelDeviceGeneric *self,
+                         MMUdevRuleMatch       *match,
+                         gboolean               condition_equal)
+{
+    /* If sysfs path invalid (e.g. path doesn't exist), no match */
+    if (!self->priv->sysfs_path)
+        return FALSE;
+
+    /* We allow both a direct match and a prefix match */
+    if ((mm_kernel_device_generic_string_match (self->priv->sysfs_path, match->value, self) == condition_equal) ||
+        (match->prefix_match && mm_kernel_device_generic_string_match (self->priv->sysfs_path, match->prefix_match, self) == condition_equal))
+        return TRUE;
+
+    if (g_str_has_prefix (self->priv->sysfs_path, "/sys")) {
+        if ((mm_kernel_device_generic_string_match (&self->priv->sysfs_path[4], match->value, self) == condition_equal) ||
+            (match->prefix_match && mm_kernel_device_generic_string_match (&self->priv->sysfs_path[4], match->prefix_match, self) == condition_equal))
+            return TRUE;
+    }
+    return FALSE;
+}
+
 static gboolean
 check_condition (MMKernelDeviceGeneric *self,
                  MMUdevRuleMatch       *match)
@@ -757,220 +1010,130 @@ check_condition (MMKernelDeviceGeneric *self,
 
     condition_equal = (match->type == MM_UDEV_RULE_MATCH_TYPE_EQUAL);
 
-    /* We only apply 'add' rules */
-    if (g_str_equal (match->parameter, "ACTION"))
+    switch (match->parameter_id) {
+    case MM_UDEV_RULE_PARAMETER_ACTION:
+        /* We only apply 'add' rules */
         return ((!!strstr (match->value, "add")) == condition_equal);
 
-    /* Exact SUBSYSTEM match */
-    if (g_str_equal (match->parameter, "SUBSYSTEM"))
+    case MM_UDEV_RULE_PARAMETER_SUBSYSTEM:
+        /* Exact SUBSYSTEM match */
         return ((self->priv->subsystems && !g_strcmp0 (self->priv->subsystems[0], match->value)) == condition_equal);
 
-    /* Loose SUBSYSTEMS match */
-    if (g_str_equal (match->parameter, "SUBSYSTEMS"))
+    case MM_UDEV_RULE_PARAMETER_SUBSYSTEMS:
+        /* Loose SUBSYSTEMS match */
         return ((self->priv->subsystems && g_strv_contains ((const gchar * const *) self->priv->subsystems, match->value)) == condition_equal);
 
-    /* Exact DRIVER match */
-    if (g_str_equal (match->parameter, "DRIVER"))
+    case MM_UDEV_RULE_PARAMETER_DRIVER:
+        /* Exact DRIVER match */
         return ((self->priv->drivers && !g_strcmp0 (self->priv->drivers[0], match->value)) == condition_equal);
 
-    /* Loose DRIVERS match */
-    if (g_str_equal (match->parameter, "DRIVERS"))
+    case MM_UDEV_RULE_PARAMETER_DRIVERS:
+        /* Loose DRIVERS match */
         return ((self->priv->drivers && g_strv_contains ((const gchar * const *) self->priv->drivers, match->value)) == condition_equal);
 
-    /* Device name checks */
-    if (g_str_equal (match->parameter, "KERNEL"))
+    case MM_UDEV_RULE_PARAMETER_KERNEL:
+        /* Device name checks */
         return (mm_kernel_device_generic_string_match (mm_kernel_device_get_name (MM_KERNEL_DEVICE (self)), match->value, self) == condition_equal);
 
-    /* Device sysfs path checks; we allow both a direct match and a prefix patch */
-    if (g_str_equal (match->parameter, "DEVPATH")) {
-        g_autofree gchar *prefix_match = NULL;
-
-        /* If sysfs path invalid (e.g. path doesn't exist), no match */
-        if (!self->priv->sysfs_path)
-            return FALSE;
-
-        /* If not already doing a prefix match, do an implicit one. This is so that
-         * we can add properties to the usb_device owning all ports, and then apply
-         * the property to all ports individually processed here. */
-        if (match->value[0] && match->value[strlen (match->value) - 1] != '*')
-            prefix_match = g_strdup_printf ("%s/*", match->value);
-
-        if ((mm_kernel_device_generic_string_match (self->priv->sysfs_path, match->value, self) == condition_equal) ||
-            (prefix_match && mm_kernel_device_generic_string_match (self->priv->sysfs_path, prefix_match, self) == condition_equal))
-            return TRUE;
-
-        if (g_str_has_prefix (self->priv->sysfs_path, "/sys")) {
-            if ((mm_kernel_device_generic_string_match (&self->priv->sysfs_path[4], match->value, self) == condition_equal) ||
-                (prefix_match && mm_kernel_device_generic_string_match (&self->priv->sysfs_path[4], prefix_match, self) == condition_equal))
-                return TRUE;
-        }
-        return FALSE;
-    }
-
-    /* Attributes checks */
-    if (g_str_has_prefix (match->parameter, "ATTR")) {
-        gchar    *attribute;
-        gchar    *contents = NULL;
-        gboolean  result = FALSE;
-        guint     val;
-
-        attribute = g_strdup (&match->parameter[5]);
-        g_strdelimit (attribute, "{}", ' ');
-        g_strstrip (attribute);
-
-        /* VID/PID/SUBSYSTEM VID directly from our API */
-        if (g_str_equal (attribute, "idVendor") || g_str_equal (attribute, "vendor"))
-            result = ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                      ((mm_kernel_device_get_physdev_vid (MM_KERNEL_DEVICE (self)) == val) == condition_equal));
-        else if (g_str_equal (attribute, "idProduct") || g_str_equal (attribute, "device"))
-            result = ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                      ((mm_kernel_device_get_physdev_pid (MM_KERNEL_DEVICE (self)) == val) == condition_equal));
-        else if (g_str_equal (attribute, "subsystem_vendor"))
-            result = ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                      ((mm_kernel_device_get_physdev_subsystem_vid (MM_KERNEL_DEVICE (self)) == val) == condition_equal));
-        /* manufacturer in the physdev */
-        else if (g_str_equal (attribute, "manufacturer"))
-            result = ((self->priv->physdev_manufacturer && g_str_equal (self->priv->physdev_manufacturer, match->value)) == condition_equal);
-        /* product in the physdev */
-        else if (g_str_equal (attribute, "product"))
-            result = ((self->priv->physdev_product && g_str_equal (self->priv->physdev_product, match->value)) == condition_equal);
-        /* interface class/subclass/protocol/number in the interface */
-        else if (g_str_equal (attribute, "bInterfaceClass"))
-            result = (g_str_equal (match->value, "?*") || ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                                                           ((self->priv->interface_class == val) == condition_equal)));
-        else if (g_str_equal (attribute, "bInterfaceSubClass"))
-            result = (g_str_equal (match->value, "?*") || ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                                                           ((self->priv->interface_subclass == val) == condition_equal)));
-        else if (g_str_equal (attribute, "bInterfaceProtocol"))
-            result = (g_str_equal (match->value, "?*") || ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                                                           ((self->priv->interface_protocol == val) == condition_equal)));
-        else if (g_str_equal (attribute, "bInterfaceNumber"))
-            result = (g_str_equal (match->value, "?*") || ((mm_get_uint_from_hex_str (match->value, &val)) &&
-                                                           ((self->priv->interface_number == val) == condition_equal)));
-        else {
-            g_autofree gchar *found_value = NULL;
-
-            found_value = lookup_sysfs_attribute_as_string (self, attribute, g_str_has_prefix (match->parameter, "ATTRS"));
-            result = ((found_value && g_str_equal (found_value, match->value)) == condition_equal);
-        }
-
-        g_free (contents);
-        g_free (attribute);
-        return result;
+    case MM_UDEV_RULE_PARAMETER_DEVPATH:
+        /* Device sysfs path checks */
+        return check_condition_devpath (self, match, condition_equal);
+
+    /* VID/PID/SUBSYSTEM VID directly from our API */
+    case MM_UDEV_RULE_PARAMETER_ATTR_VENDOR:
+        return check_condition_uint (match, mm_kernel_device_get_physdev_vid (MM_KERNEL_DEVICE (self)), condition_equal);
+    case MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT:
+        return check_condition_uint (match, mm_kernel_device_get_physdev_pid (MM_KERNEL_DEVICE (self)), condition_equal);
+    case MM_UDEV_RULE_PARAMETER_ATTR_SUBSYSTEM_VENDOR:
+        return check_condition_uint (match, mm_kernel_device_get_physdev_subsystem_vid (MM_KERNEL_DEVICE (self)), condition_equal);
+
+    /* manufacturer and product in the physdev */
+    case MM_UDEV_RULE_PARAMETER_ATTR_MANUFACTURER:
+        return ((self->priv->physdev_manufacturer && g_str_equal (self->priv->physdev_manufacturer, match->value)) == condition_equal);
+    case MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT_NAME:
+        return ((self->priv->physdev_product && g_str_equal (self->priv->physdev_product, match->value)) == condition_equal);
+
+    /* interface class/subclass/protocol/number in the interface */
+    case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_CLASS:
+        return (match->value_any || check_condition_uint (match, self->priv->interface_class, condition_equal));
+    case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_SUBCLASS:
+        return (match->value_any || check_condition_uint (match, self->priv->interface_subclass, condition_equal));
+    case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_PROTOCOL:
+        return (match->value_any || check_condition_uint (match, self->priv->interface_protocol, condition_equal));
+    case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_NUMBER:
+        return (match->value_any || check_condition_uint (match, self->priv->interface_number, condition_equal));
+
+    case MM_UDEV_RULE_PARAMETER_ATTR_OTHER: {
+        const gchar *found_value;
+
+        found_value = lookup_sysfs_attribute_memoized (self, match->name, match->recursive);
+        return ((found_value && g_str_equal (found_value, match->value)) == condition_equal);
     }
 
-    /* Previously set property checks */
-    if (g_str_has_prefix (match->parameter, "ENV")) {
-        gchar    *property;
-        gboolean  result = FALSE;
-
-        property = g_strdup (&match->parameter[3]);
-        g_strdelimit (property, "{}", ' ');
-        g_strstrip (property);
-
-        result = ((!g_strcmp0 ((const gchar *) g_object_get_data (G_OBJECT (self), property), match->value)) == condition_equal);
+    case MM_UDEV_RULE_PARAMETER_ENV:
+        /* Previously set property checks */
+        return ((!g_strcmp0 ((const gchar *) g_object_get_data (G_OBJECT (self), match->name), match->value)) == condition_equal);
 
-        g_free (property);
-        return result;
+    case MM_UDEV_RULE_PARAMETER_UNKNOWN:
+    default:
+        mm_obj_warn (self, "unknown match condition parameter: %s", match->parameter);
+        return FALSE;
     }
-
-    mm_obj_warn (self, "unknown match condition parameter: %s", match->parameter);
-    return FALSE;
 }
 
-static guint
-check_rule (MMKernelDeviceGeneric *self,
-            guint                  rule_i)
+static gboolean
+rule_condition_cb (MMUdevRuleMatch       *match,
+                   MMKernelDeviceGeneric *self)
 {
-    MMUdevRule *rule;
-    gboolean    apply = TRUE;
-
-    g_assert (rule_i < self->priv->rules->len);
-
-    rule = &g_array_index (self->priv->rules, MMUdevRule, rule_i);
-    if (rule->conditions) {
-        guint condition_i;
-
-        for (condition_i = 0; condition_i < rule->conditions->len; condition_i++) {
-            MMUdevRuleMatch *match;
-
-            match = &g_array_index (rule->conditions, MMUdevRuleMatch, condition_i);
-            if (!check_condition (self, match)) {
-                apply = FALSE;
-                break;
-            }
-        }
-    }
-
-    if (apply) {
-        switch (rule->result.type) {
-        case MM_UDEV_RULE_RESULT_TYPE_PROPERTY: {
-            gchar *property_value_read = NULL;
-
-            if (g_str_equal (rule->result.content.property.value, "$attr{bInterfaceClass}"))
-                property_value_read = g_strdup_printf ("%02x", self->priv->interface_class);
-            else if (g_str_equal (rule->result.content.property.value, "$attr{bInterfaceSubClass}"))
-                property_value_read = g_strdup_printf ("%02x", self->priv->interface_subclass);
-            else if (g_str_equal (rule->result.content.property.value, "$attr{bInterfaceProtocol}"))
-                property_value_read = g_strdup_printf ("%02x", self->priv->interface_protocol);
-            else if (g_str_equal (rule->result.content.property.value, "$attr{bInterfaceNumber}"))
-                property_value_read = g_strdup_printf ("%02x", self->priv->interface_number);
-
-            /* add new property */
-            mm_obj_dbg (self, "property added: %s=%s",
-                        rule->result.content.property.name,
-                        property_value_read ? property_value_read : rule->result.content.property.value);
-
-            if (!property_value_read)
-                /* NOTE: we keep a reference to the list of rules ourselves, so it isn't
-                 * an issue if we re-use the same string (i.e. without g_strdup-ing it)
-                 * as a property value. */
-                g_object_set_data (G_OBJECT (self),
-                                   rule->result.content.property.name,
-                                   rule->result.content.property.value);
-            else
-                g_object_set_data_full (G_OBJECT (self),
-                                        rule->result.content.property.name,
-                                        property_value_read,
-                                        g_free);
-            break;
-        }
-
-        case MM_UDEV_RULE_RESULT_TYPE_LABEL:
-            /* noop */
-            break;
-
-        case MM_UDEV_RULE_RESULT_TYPE_GOTO_INDEX:
-            /* Jump to a new index */
-            return rule->result.content.index;
-
-        case MM_UDEV_RULE_RESULT_TYPE_GOTO_TAG:
-        case MM_UDEV_RULE_RESULT_TYPE_UNKNOWN:
-        default:
-            g_assert_not_reached ();
-        }
-    }
+    return check_condition (self, match);
+}
 
-    /* Go to the next rule */
-    return rule_i + 1;
+static void
+rule_property_cb (MMUdevRuleResultProperty *property,
+                  MMKernelDeviceGeneric    *self)
+{
+    gchar *property_value_read = NULL;
+
+    if (g_str_equal (property->value, "$attr{bInterfaceClass}"))
+        property_value_read = g_strdup_printf ("%02x", self->priv->interface_class);
+    else if (g_str_equal (property->value, "$attr{bInterfaceSubClass}"))
+        property_value_read = g_strdup_printf ("%02x", self->priv->interface_subclass);
+    else if (g_str_equal (property->value, "$attr{bInterfaceProtocol}"))
+        property_value_read = g_strdup_printf ("%02x", self->priv->interface_protocol);
+    else if (g_str_equal (property->value, "$attr{bInterfaceNumber}"))
+        property_value_read = g_strdup_printf ("%02x", self->priv->interface_number);
+
+    /* add new property */
+    mm_obj_dbg (self, "property added: %s=%s",
+                property->name,
+                property_value_read ? property_value_read : property->value);
+
+    if (!property_value_read)
+        /* NOTE: we keep a reference to the list of rules ourselves, so it isn't
+         * an issue if we re-use the same string (i.e. without g_strdup-ing it)
+         * as a property value. */
+        g_object_set_data (G_OBJECT (self), property->name, property->value);
+    else
+        g_object_set_data_full (G_OBJECT (self), property->name, property_value_read, g_free);
 }
 
 static void
 preload_rule_properties (MMKernelDeviceGeneric *self)
 {
-    guint i;
-
     g_assert (self->priv->rules);
     g_assert (self->priv->rules->len > 0);
 
-    /* Start to process rules */
-    i = 0;
-    while (i < self->priv->rules->len) {
-        guint next_rule;
-
-        next_rule = check_rule (self, i);
-        i = next_rule;
-    }
+    mm_kernel_device_generic_rules_apply (self->priv->rules,
+                                          self->priv->subsystems ? self->priv->subsystems[0] : NULL,
+                                          mm_kernel_device_get_physdev_vid (MM_KERNEL_DEVICE (self)),
+                                          mm_kernel_device_get_physdev_pid (MM_KERNEL_DEVICE (self)),
+                                          TRUE,
+                                          (MMUdevRuleConditionFunc) rule_condition_cb,
+                                          (MMUdevRulePropertyFunc) rule_property_cb,
+                                          self);
+
+    /* Attributes may change after the rules have been applied */
+    g_clear_pointer (&self->priv->rules_sysfs_attributes, g_hash_table_unref);
 }
 
 static void
@@ -1183,6 +1346,7 @@ dispose (GObject *object)
     g_clear_pointer (&self->priv->drivers,               g_strfreev);
     g_clear_pointer (&self->priv->subsystems,            g_strfreev);
     g_clear_pointer (&self->priv->rules,                 g_array_unref);
+    g_clear_pointer (&self->priv->rules_sysfs_attributes, g_hash_table_unref);
     g_clear_object  (&self->priv->properties);
 
     G_OBJECT_CLASS (mm_kernel_device_generic_parent_class)->dispose (object);
@@ -53,4 +53,15 @@ MMKernelDevice *mm_kernel_device_generic_new_with_rules (MMKernelEventProperties
                                                          GArray                   *rules,
                                                          GError                  **error);
 
+/* Attributes of the physical device are read once and shared by all its
+ * ports. Values are given in the same order as the (up to 6) attribute names,
+ * owned by the cache, and valid until the entry is dropped when any of the
+ * ports is forgotten. */
+gchar **mm_kernel_device_generic_lookup_physdev_attributes (const gchar  *subsystem,
+                                                            const gchar  *name,
+                                                            const gchar  *physdev_sysfs_path,
+                                                            const gchar **attributes);
+void    mm_kernel_device_generic_forget_port               (const gchar  *subsystem,
+                                                            const gchar  *name);
+
 #endif /* MM_KERNEL_DEVICE_GENERIC_H */
@@ -20,6 +20,7 @@
 #include <gio/gio.h>
 
 #include "mm-log-object.h"
+#include "mm-modem-helpers.h"
 #include "mm-kernel-device-helpers.h"
 
 /******************************************************************************/
@@ -126,7 +127,7 @@ mm_kernel_device_generic_string_match (const gchar *str,
 
     regex_pattern = build_string_match_pattern (pattern);
 
-    regex = g_regex_new (regex_pattern, G_REGEX_UNGREEDY, 0, &inner_error);
+    regex = mm_regex_cache_get (regex_pattern, G_REGEX_UNGREEDY, 0, &inner_error);
     if (!regex) {
         mm_obj_warn (log_object, "invalid pattern in rule '%s': %s", regex_pattern, inner_error->message);
         return FALSE;
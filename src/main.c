@@ -28,8 +28,11 @@
 
 #define MM_LOG_NO_OBJECT
 #include "mm-log.h"
+#include "mm-trace.h"
 #include "mm-base-manager.h"
+#include "mm-plugin-manager.h"
 #include "mm-context.h"
+#include "mm-modem-helpers.h"
 
 #if defined WITH_SUSPEND_RESUME
 # include "mm-sleep-monitor.h"
@@ -172,6 +175,25 @@ main (int argc, char *argv[])
         exit (1);
     }
 
+    if (mm_context_get_log_trace_file () &&
+        !mm_trace_setup (mm_context_get_log_trace_file (), &error)) {
+        g_printerr ("error: failed to set up tracing: %s\n", error->message);
+        g_error_free (error);
+        exit (1);
+    }
+
+    /* Build-time helper, nothing else to do once the manifest is written */
+    if (mm_context_get_test_write_plugin_manifest ()) {
+        if (!mm_plugin_manager_write_manifest (mm_context_get_test_plugin_dir (),
+                                               mm_context_get_test_write_plugin_manifest (),
+                                               &error)) {
+            g_printerr ("error: failed to write plugin manifest: %s\n", error->message);
+            g_error_free (error);
+            exit (1);
+        }
+        exit (0);
+    }
+
     g_unix_signal_add (SIGTERM, quit_cb, NULL);
     g_unix_signal_add (SIGINT, quit_cb, NULL);
 
@@ -250,8 +272,12 @@ main (int argc, char *argv[])
 
     g_bus_unown_name (name_id);
 
+    mm_regex_cache_log_stats ();
+    mm_regex_cache_clear ();
+
     mm_info ("ModemManager is shut down");
 
+    mm_trace_shutdown ();
     mm_log_shutdown ();
 
     return 0;
@@ -23,8 +23,11 @@
 #include <unistd.h>
 #include <string.h>
 #include <ctype.h>
+#include <net/if.h>
+#include <sys/socket.h>
 
 #include <ModemManager.h>
+#include <ModemManager-tags.h>
 #define _LIBMM_INSIDE_MM
 #include <libmm-glib.h>
 
@@ -35,6 +38,7 @@
 #include "mm-base-bearer.h"
 #include "mm-base-modem-at.h"
 #include "mm-base-modem.h"
+#include "mm-netlink.h"
 #include "mm-log-object.h"
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
@@ -46,8 +50,6 @@
 
 #define BEARER_DEFERRED_UNREGISTRATION_TIMEOUT 15
 
-#define BEARER_STATS_UPDATE_TIMEOUT 30
-
 /* Initial connectivity check after 30s, then each 5s */
 #define BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT 30
 #define BEARER_CONNECTION_MONITOR_TIMEOUT          5
@@ -72,6 +74,7 @@ enum {
     PROP_MODEM,
     PROP_STATUS,
     PROP_CONFIG,
+    PROP_STATS_UPDATE_INTERVAL,
     PROP_LAST
 };
 
@@ -103,6 +106,15 @@ struct _MMBaseBearerPrivate {
     guint connection_monitor_id;
     /* Flag to specify whether connection monitoring is supported or not */
     gboolean load_connection_status_unsupported;
+    /* Whether there is a connection status check in progress */
+    gboolean connection_check_ongoing;
+    /* Data interface link monitoring */
+    guint  connection_monitor_ifindex;
+    guint  connection_monitor_link_flags;
+    gulong link_changed_id;
+    gulong address_changed_id;
+    /* Last time the connection was known to be up, in monotonic time */
+    gint64 connection_last_seen_up;
 
     /*-- 3GPP specific --*/
     guint deferred_3gpp_unregistration_id;
@@ -123,10 +135,22 @@ struct _MMBaseBearerPrivate {
     MMBearerStats *stats;
     /* Handler id for the stats update timeout */
     guint stats_update_id;
+    /* Configured and currently applied stats update intervals, in ms */
+    guint stats_update_interval;
+    guint stats_update_interval_applied;
+    /* Data interface of the ongoing connection, used to look up udev tags */
+    gchar *stats_interface;
+    /* Whether there is a stats update operation in progress */
+    gboolean stats_update_ongoing;
     /* Timer to measure the duration of the connection */
     GTimer *duration_timer;
     /* Flag to specify whether reloading stats is supported or not */
     gboolean reload_stats_supported;
+    /* Index of the data interface when its counters are read via netlink,
+     * and the counter values found when the connection was established */
+    guint    stats_ifindex;
+    guint64  stats_netlink_rx_base;
+    guint64  stats_netlink_tx_base;
 };
 
 /*****************************************************************************/
@@ -154,8 +178,30 @@ mm_base_bearer_export (MMBaseBearer *self)
 
 /*****************************************************************************/
 
+static void bearer_update_interface_stats (MMBaseBearer *self);
+
 static void
-connection_monitor_stop (MMBaseBearer *self)
+connection_monitor_seen_up (MMBaseBearer *self)
+{
+    self->priv->connection_last_seen_up = g_get_monotonic_time ();
+}
+
+static void
+connection_monitor_update_detection_latency (MMBaseBearer *self)
+{
+    guint latency;
+
+    if (!self->priv->connection_last_seen_up)
+        return;
+
+    latency = (guint) ((g_get_monotonic_time () - self->priv->connection_last_seen_up) / 1000);
+    mm_obj_dbg (self, "connection loss detected %ums after the connection was last known to be up", latency);
+    mm_bearer_stats_set_detection_latency (self->priv->stats, latency);
+    bearer_update_interface_stats (self);
+}
+
+static void
+connection_monitor_polling_stop (MMBaseBearer *self)
 {
     if (self->priv->connection_monitor_id) {
         g_source_remove (self->priv->connection_monitor_id);
@@ -163,6 +209,35 @@ connection_monitor_stop (MMBaseBearer *self)
     }
 }
 
+static void
+connection_monitor_events_stop (MMBaseBearer *self)
+{
+    MMNetlink *netlink;
+
+    if (!self->priv->connection_monitor_ifindex)
+        return;
+
+    netlink = mm_netlink_get ();
+    if (self->priv->link_changed_id) {
+        g_signal_handler_disconnect (netlink, self->priv->link_changed_id);
+        self->priv->link_changed_id = 0;
+    }
+    if (self->priv->address_changed_id) {
+        g_signal_handler_disconnect (netlink, self->priv->address_changed_id);
+        self->priv->address_changed_id = 0;
+    }
+    mm_netlink_events_disable (netlink);
+    self->priv->connection_monitor_ifindex = 0;
+}
+
+static void
+connection_monitor_stop (MMBaseBearer *self)
+{
+    connection_monitor_polling_stop (self);
+    connection_monitor_events_stop (self);
+    self->priv->connection_last_seen_up = 0;
+}
+
 static void
 load_connection_status_ready (MMBaseBearer *self,
                               GAsyncResult *res)
@@ -170,6 +245,8 @@ load_connection_status_ready (MMBaseBearer *self,
     GError                   *error = NULL;
     MMBearerConnectionStatus  status;
 
+    self->priv->connection_check_ongoing = FALSE;
+
     status = MM_BASE_BEARER_GET_CLASS (self)->load_connection_status_finish (self, res, &error);
     if (status == MM_BEARER_CONNECTION_STATUS_UNKNOWN) {
         /* Only warn if not reporting an "unsupported" error */
@@ -183,7 +260,7 @@ load_connection_status_ready (MMBaseBearer *self,
          * ignore the error and remove the timeout. */
         mm_obj_dbg (self, "connection monitoring is unsupported by the device");
         self->priv->load_connection_status_unsupported = TRUE;
-        connection_monitor_stop (self);
+        connection_monitor_polling_stop (self);
         g_error_free (error);
         return;
     }
@@ -191,29 +268,40 @@ load_connection_status_ready (MMBaseBearer *self,
     /* Report connection or disconnection */
     g_assert (status == MM_BEARER_CONNECTION_STATUS_CONNECTED || status == MM_BEARER_CONNECTION_STATUS_DISCONNECTED);
     mm_obj_dbg (self, "connection status loaded: %s", mm_bearer_connection_status_get_string (status));
+    if (status == MM_BEARER_CONNECTION_STATUS_CONNECTED && self->priv->status == MM_BEARER_STATUS_CONNECTED)
+        connection_monitor_seen_up (self);
     mm_base_bearer_report_connection_status (self, status);
 }
 
+static void
+connection_monitor_check (MMBaseBearer *self)
+{
+    /* If the implementation knows how to load connection status, run it */
+    if (self->priv->status != MM_BEARER_STATUS_CONNECTED ||
+        self->priv->connection_check_ongoing ||
+        self->priv->load_connection_status_unsupported ||
+        !MM_BASE_BEARER_GET_CLASS (self)->load_connection_status ||
+        !MM_BASE_BEARER_GET_CLASS (self)->load_connection_status_finish)
+        return;
+
+    self->priv->connection_check_ongoing = TRUE;
+    MM_BASE_BEARER_GET_CLASS (self)->load_connection_status (
+        self,
+        (GAsyncReadyCallback)load_connection_status_ready,
+        NULL);
+}
+
 static gboolean
 connection_monitor_cb (MMBaseBearer *self)
 {
-    /* If the implementation knows how to load connection status, run it */
-    if (self->priv->status == MM_BEARER_STATUS_CONNECTED)
-        MM_BASE_BEARER_GET_CLASS (self)->load_connection_status (
-            self,
-            (GAsyncReadyCallback)load_connection_status_ready,
-            NULL);
+    connection_monitor_check (self);
     return G_SOURCE_CONTINUE;
 }
 
 static gboolean
 initial_connection_monitor_cb (MMBaseBearer *self)
 {
-    if (self->priv->status == MM_BEARER_STATUS_CONNECTED)
-        MM_BASE_BEARER_GET_CLASS (self)->load_connection_status (
-            self,
-            (GAsyncReadyCallback)load_connection_status_ready,
-            NULL);
+    connection_monitor_check (self);
 
     /* Add new monitor timeout at a higher rate */
     self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_TIMEOUT,
@@ -224,9 +312,97 @@ initial_connection_monitor_cb (MMBaseBearer *self)
     return G_SOURCE_REMOVE;
 }
 
+#define LINK_FLAGS_RUNNING (IFF_UP | IFF_RUNNING)
+
+static void
+link_changed_cb (MMNetlink    *netlink,
+                 guint         ifindex,
+                 const gchar  *name,
+                 guint         flags,
+                 guint         mtu,
+                 gboolean      removed,
+                 MMBaseBearer *self)
+{
+    guint previous_flags;
+
+    if (ifindex != self->priv->connection_monitor_ifindex ||
+        self->priv->status != MM_BEARER_STATUS_CONNECTED)
+        return;
+
+    /* Without the data interface there is no connection to monitor */
+    if (removed) {
+        mm_obj_info (self, "data interface removed");
+        mm_base_bearer_report_connection_status (self, MM_BEARER_CONNECTION_STATUS_DISCONNECTED);
+        return;
+    }
+
+    /* Link updates are reported for any change in the interface, only
+     * check connection status when the link stops running */
+    previous_flags = self->priv->connection_monitor_link_flags;
+    self->priv->connection_monitor_link_flags = flags;
+    if ((previous_flags & LINK_FLAGS_RUNNING) == LINK_FLAGS_RUNNING &&
+        (flags & LINK_FLAGS_RUNNING) != LINK_FLAGS_RUNNING) {
+        mm_obj_dbg (self, "data interface link stopped running: checking connection status");
+        connection_monitor_check (self);
+    }
+}
+
+static void
+address_changed_cb (MMNetlink    *netlink,
+                    guint         ifindex,
+                    guint         family,
+                    gboolean      removed,
+                    MMBaseBearer *self)
+{
+    if (ifindex != self->priv->connection_monitor_ifindex ||
+        self->priv->status != MM_BEARER_STATUS_CONNECTED ||
+        !removed)
+        return;
+
+    mm_obj_dbg (self, "%s address removed from data interface: checking connection status",
+                family == AF_INET6 ? "IPv6" : "IPv4");
+    connection_monitor_check (self);
+}
+
 static void
-connection_monitor_start (MMBaseBearer *self)
+connection_monitor_events_start (MMBaseBearer *self,
+                                 const gchar  *interface)
 {
+    MMNetlink *netlink;
+    guint      ifindex;
+
+    /* Only applicable when the data port is a network interface */
+    ifindex = interface ? if_nametoindex (interface) : 0;
+    if (!ifindex)
+        return;
+
+    g_assert (!self->priv->connection_monitor_ifindex);
+    self->priv->connection_monitor_ifindex = ifindex;
+    /* Assume running until told otherwise */
+    self->priv->connection_monitor_link_flags = LINK_FLAGS_RUNNING;
+
+    netlink = mm_netlink_get ();
+    mm_netlink_events_enable (netlink);
+    self->priv->link_changed_id = g_signal_connect (netlink,
+                                                    MM_NETLINK_SIGNAL_LINK_CHANGED,
+                                                    G_CALLBACK (link_changed_cb),
+                                                    self);
+    self->priv->address_changed_id = g_signal_connect (netlink,
+                                                       MM_NETLINK_SIGNAL_ADDRESS_CHANGED,
+                                                       G_CALLBACK (address_changed_cb),
+                                                       self);
+}
+
+static void
+connection_monitor_start (MMBaseBearer *self,
+                          const gchar  *interface)
+{
+    connection_monitor_seen_up (self);
+
+    /* Link and address events in the data interface trigger an explicit
+     * connection status check, or a disconnection if the interface is gone */
+    connection_monitor_events_start (self, interface);
+
     /* If not implemented, don't schedule anything */
     if (!MM_BASE_BEARER_GET_CLASS (self)->load_connection_status ||
         !MM_BASE_BEARER_GET_CLASS (self)->load_connection_status_finish)
@@ -235,6 +411,14 @@ connection_monitor_start (MMBaseBearer *self)
     if (self->priv->load_connection_status_unsupported)
         return;
 
+    /* Polling is only a fallback for modems not reporting disconnections
+     * via indications */
+    if (MM_BASE_BEARER_GET_CLASS (self)->connection_status_indications_supported &&
+        MM_BASE_BEARER_GET_CLASS (self)->connection_status_indications_supported (self)) {
+        mm_obj_dbg (self, "disconnections reported via indications: connection status polling not required");
+        return;
+    }
+
     /* Schedule initial check */
     g_assert (!self->priv->connection_monitor_id);
     self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
@@ -349,6 +533,8 @@ bearer_set_ongoing_interface_stats (MMBaseBearer *self,
 
         delta_rx_bytes = rx_bytes - mm_bearer_stats_get_rx_bytes (self->priv->stats);
         if (delta_rx_bytes > 0) {
+            /* Receiving data means the connection is up */
+            connection_monitor_seen_up (self);
             mm_bearer_stats_set_rx_bytes (self->priv->stats, rx_bytes);
             mm_bearer_stats_set_total_rx_bytes (self->priv->stats,
                                                 mm_bearer_stats_get_total_rx_bytes (self->priv->stats) + delta_rx_bytes);
@@ -372,6 +558,15 @@ bearer_set_ongoing_interface_stats (MMBaseBearer *self,
         bearer_update_interface_stats (self);
 }
 
+static void
+bearer_stats_schedule_stop (MMBaseBearer *self)
+{
+    if (self->priv->stats_update_id) {
+        g_source_remove (self->priv->stats_update_id);
+        self->priv->stats_update_id = 0;
+    }
+}
+
 static void
 bearer_stats_stop (MMBaseBearer *self)
 {
@@ -384,10 +579,7 @@ bearer_stats_stop (MMBaseBearer *self)
         self->priv->duration_timer = NULL;
     }
 
-    if (self->priv->stats_update_id) {
-        g_source_remove (self->priv->stats_update_id);
-        self->priv->stats_update_id = 0;
-    }
+    bearer_stats_schedule_stop (self);
 }
 
 static void
@@ -398,12 +590,18 @@ reload_stats_ready (MMBaseBearer *self,
     guint64  rx_bytes = 0;
     guint64  tx_bytes = 0;
 
+    self->priv->stats_update_ongoing = FALSE;
+
     if (!MM_BASE_BEARER_GET_CLASS (self)->reload_stats_finish (self, &rx_bytes, &tx_bytes, res, &error)) {
         mm_obj_warn (self, "reloading stats failed: %s", error->message);
         g_error_free (error);
         return;
     }
 
+    /* Ignore the result if we got disconnected in the meantime */
+    if (!self->priv->duration_timer)
+        return;
+
     /* We only update stats if they were retrieved properly */
     bearer_set_ongoing_interface_stats (self,
                                         (guint32) g_timer_elapsed (self->priv->duration_timer, NULL),
@@ -411,20 +609,17 @@ reload_stats_ready (MMBaseBearer *self,
                                         tx_bytes);
 }
 
-static gboolean
-stats_update_cb (MMBaseBearer *self)
+static void
+stats_reload_from_modem (MMBaseBearer *self)
 {
-    /* Ignore stats update if we're not connected */
-    if (self->priv->status != MM_BEARER_STATUS_CONNECTED)
-        return G_SOURCE_CONTINUE;
-
     /* If the implementation knows how to update stat values, run it */
     if (self->priv->reload_stats_supported) {
+        self->priv->stats_update_ongoing = TRUE;
         MM_BASE_BEARER_GET_CLASS (self)->reload_stats (
             self,
             (GAsyncReadyCallback)reload_stats_ready,
             NULL);
-        return G_SOURCE_CONTINUE;
+        return;
     }
 
     /* Otherwise, just update duration and we're done */
@@ -432,11 +627,152 @@ stats_update_cb (MMBaseBearer *self)
                                         (guint32) g_timer_elapsed (self->priv->duration_timer, NULL),
                                         0,
                                         0);
+}
+
+static void
+netlink_get_link_stats_ready (MMNetlink    *netlink,
+                              GAsyncResult *res,
+                              MMBaseBearer *self)
+{
+    g_autoptr(GError) error = NULL;
+    guint64           rx_bytes = 0;
+    guint64           tx_bytes = 0;
+
+    self->priv->stats_update_ongoing = FALSE;
+
+    if (!mm_netlink_get_link_stats_finish (netlink, res, &rx_bytes, &tx_bytes, &error)) {
+        /* Ignore the failure if we got disconnected in the meantime */
+        if (self->priv->duration_timer && self->priv->stats_ifindex) {
+            mm_obj_dbg (self, "couldn't load interface stats via netlink: %s", error->message);
+            mm_obj_dbg (self, "falling back to loading stats from the modem");
+            self->priv->stats_ifindex = 0;
+            stats_reload_from_modem (self);
+        }
+        g_object_unref (self);
+        return;
+    }
+
+    /* Counters are reported relative to the baseline read when the
+     * connection was established */
+    if (self->priv->duration_timer)
+        bearer_set_ongoing_interface_stats (self,
+                                            (guint32) g_timer_elapsed (self->priv->duration_timer, NULL),
+                                            rx_bytes > self->priv->stats_netlink_rx_base ? rx_bytes - self->priv->stats_netlink_rx_base : 0,
+                                            tx_bytes > self->priv->stats_netlink_tx_base ? tx_bytes - self->priv->stats_netlink_tx_base : 0);
+    g_object_unref (self);
+}
+
+static void
+netlink_get_link_stats_baseline_ready (MMNetlink    *netlink,
+                                       GAsyncResult *res,
+                                       MMBaseBearer *self)
+{
+    g_autoptr(GError) error = NULL;
+
+    self->priv->stats_update_ongoing = FALSE;
+
+    /* The interface counters are not reset on every connection, so the values
+     * found right after connecting are the baseline for all later reads */
+    if (!mm_netlink_get_link_stats_finish (netlink,
+                                           res,
+                                           &self->priv->stats_netlink_rx_base,
+                                           &self->priv->stats_netlink_tx_base,
+                                           &error)) {
+        if (self->priv->duration_timer && self->priv->stats_ifindex) {
+            mm_obj_dbg (self, "couldn't load interface stats baseline via netlink: %s", error->message);
+            mm_obj_dbg (self, "falling back to loading stats from the modem");
+            self->priv->stats_ifindex = 0;
+            stats_reload_from_modem (self);
+        }
+        g_object_unref (self);
+        return;
+    }
+
+    if (self->priv->duration_timer)
+        bearer_set_ongoing_interface_stats (self,
+                                            (guint32) g_timer_elapsed (self->priv->duration_timer, NULL),
+                                            0,
+                                            0);
+    g_object_unref (self);
+}
+
+static gboolean
+stats_update_cb (MMBaseBearer *self)
+{
+    /* Ignore stats update if we're not connected */
+    if (self->priv->status != MM_BEARER_STATUS_CONNECTED)
+        return G_SOURCE_CONTINUE;
+
+    /* With short update intervals the previous update may still be running */
+    if (self->priv->stats_update_ongoing)
+        return G_SOURCE_CONTINUE;
+
+    /* The data interface counters are read straight from the kernel, so that
+     * frequent updates don't need any request in the modem control channel */
+    if (self->priv->stats_ifindex) {
+        self->priv->stats_update_ongoing = TRUE;
+        mm_netlink_get_link_stats (mm_netlink_get (),
+                                   self->priv->stats_ifindex,
+                                   NULL,
+                                   (GAsyncReadyCallback)netlink_get_link_stats_ready,
+                                   g_object_ref (self));
+        return G_SOURCE_CONTINUE;
+    }
+
+    stats_reload_from_modem (self);
     return G_SOURCE_CONTINUE;
 }
 
+static void
+bearer_stats_schedule (MMBaseBearer *self)
+{
+    g_assert (!self->priv->stats_update_id);
+
+    /* Whole seconds allow grouping the wakeups with other timeouts */
+    if (self->priv->stats_update_interval_applied % 1000 == 0)
+        self->priv->stats_update_id = g_timeout_add_seconds (self->priv->stats_update_interval_applied / 1000,
+                                                             (GSourceFunc) stats_update_cb,
+                                                             self);
+    else
+        self->priv->stats_update_id = g_timeout_add (self->priv->stats_update_interval_applied,
+                                                     (GSourceFunc) stats_update_cb,
+                                                     self);
+}
+
+static guint
+bearer_load_stats_update_interval (MMBaseBearer *self,
+                                   const gchar  *interface)
+{
+    MMPort         *port;
+    MMKernelDevice *kernel_device;
+    guint           interval = 0;
+
+    /* An explicit interval configured in the device with udev tags takes
+     * precedence over the one configured in the bearer object */
+    port = (self->priv->modem && interface) ? mm_base_modem_peek_port (self->priv->modem, interface) : NULL;
+    kernel_device = port ? mm_port_peek_kernel_device (port) : NULL;
+    if (kernel_device) {
+        if (mm_kernel_device_has_global_property (kernel_device, ID_MM_BEARER_STATS_UPDATE_INTERVAL))
+            interval = mm_kernel_device_get_global_property_as_int (kernel_device, ID_MM_BEARER_STATS_UPDATE_INTERVAL);
+        else if (mm_kernel_device_peek_lower_device (kernel_device) &&
+                 mm_kernel_device_has_global_property (mm_kernel_device_peek_lower_device (kernel_device), ID_MM_BEARER_STATS_UPDATE_INTERVAL))
+            interval = mm_kernel_device_get_global_property_as_int (mm_kernel_device_peek_lower_device (kernel_device), ID_MM_BEARER_STATS_UPDATE_INTERVAL);
+    }
+
+    if (!interval)
+        return self->priv->stats_update_interval;
+
+    if (interval < MM_BASE_BEARER_STATS_UPDATE_INTERVAL_MIN) {
+        mm_obj_warn (self, "stats update interval %ums too short, using %ums",
+                     interval, MM_BASE_BEARER_STATS_UPDATE_INTERVAL_MIN);
+        interval = MM_BASE_BEARER_STATS_UPDATE_INTERVAL_MIN;
+    }
+    return interval;
+}
+
 static void
 bearer_stats_start (MMBaseBearer *self,
+                    const gchar  *interface,
                     guint64       uplink_speed,
                     guint64       downlink_speed)
 {
@@ -444,19 +780,38 @@ bearer_stats_start (MMBaseBearer *self,
     g_assert (!self->priv->duration_timer);
     self->priv->duration_timer = g_timer_new ();
 
+    /* Interface counters are available only when the data port is a
+     * network interface (e.g. not in PPP setups, where it's the TTY) */
+    self->priv->stats_ifindex = interface ? if_nametoindex (interface) : 0;
+    self->priv->stats_netlink_rx_base = 0;
+    self->priv->stats_netlink_tx_base = 0;
+
     /* Schedule */
-    g_assert (!self->priv->stats_update_id);
-    self->priv->stats_update_id = g_timeout_add_seconds (BEARER_STATS_UPDATE_TIMEOUT,
-                                                         (GSourceFunc) stats_update_cb,
-                                                         self);
+    g_free (self->priv->stats_interface);
+    self->priv->stats_interface = g_strdup (interface);
+    self->priv->stats_update_interval_applied = bearer_load_stats_update_interval (self, interface);
+    mm_obj_dbg (self, "stats updated every %ums from %s",
+                self->priv->stats_update_interval_applied,
+                self->priv->stats_ifindex ? "interface counters" : "modem");
+    bearer_stats_schedule (self);
 
     mm_bearer_stats_set_start_date (self->priv->stats, (guint64)(g_get_real_time() / G_USEC_PER_SEC));
     mm_bearer_stats_set_uplink_speed (self->priv->stats, uplink_speed);
     mm_bearer_stats_set_downlink_speed (self->priv->stats, downlink_speed);
     bearer_update_interface_stats (self);
 
-    /* Load initial values */
-    stats_update_cb (self);
+    /* Load initial values; when reading the interface counters, the first
+     * read is the baseline, and periodic updates are skipped until it's done */
+    if (self->priv->stats_ifindex) {
+        self->priv->stats_update_ongoing = TRUE;
+        mm_netlink_get_link_stats (mm_netlink_get (),
+                                   self->priv->stats_ifindex,
+                                   NULL,
+                                   (GAsyncReadyCallback)netlink_get_link_stats_baseline_ready,
+                                   g_object_ref (self));
+        return;
+    }
+    stats_reload_from_modem (self);
 }
 
 /*****************************************************************************/
@@ -566,7 +921,7 @@ bearer_update_status (MMBaseBearer *self,
                                 "connection #%u finished: duration %us",
                                 mm_bearer_stats_get_attempts (self->priv->stats),
                                 mm_bearer_stats_get_duration (self->priv->stats));
-        if (self->priv->reload_stats_supported)
+        if (self->priv->reload_stats_supported || self->priv->stats_ifindex)
             g_string_append_printf (report,
                                     ", tx: %" G_GUINT64_FORMAT " bytes, rx: %" G_GUINT64_FORMAT " bytes",
                                     mm_bearer_stats_get_tx_bytes (self->priv->stats),
@@ -612,10 +967,10 @@ bearer_update_status_connected (MMBaseBearer     *self,
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_STATUS]);
 
     /* Start statistics */
-    bearer_stats_start (self, uplink_speed, downlink_speed);
+    bearer_stats_start (self, interface, uplink_speed, downlink_speed);
 
     /* Start connection monitor, if supported */
-    connection_monitor_start (self);
+    connection_monitor_start (self, interface);
 
     /* Run dispatcher scripts */
     bearer_run_dispatcher_scripts (self, TRUE);
@@ -1546,6 +1901,8 @@ report_connection_status (MMBaseBearer             *self,
     /* In the generic bearer implementation we just need to reset the
      * interface status */
     if (status == MM_BEARER_CONNECTION_STATUS_DISCONNECTED) {
+        if (self->priv->status == MM_BEARER_STATUS_CONNECTED)
+            connection_monitor_update_detection_latency (self);
         bearer_update_connection_error (self, connection_error);
         bearer_update_status (self, MM_BEARER_STATUS_DISCONNECTED);
     }
@@ -1792,6 +2149,21 @@ set_property (GObject *object,
         /* We don't allow g_object_set()-ing the status property */
         g_assert_not_reached ();
         break;
+    case PROP_STATS_UPDATE_INTERVAL:
+        self->priv->stats_update_interval = g_value_get_uint (value);
+        /* Reschedule right away if already connected and the applied interval
+         * changes; an interval given in udev tags still takes precedence */
+        if (self->priv->stats_update_id) {
+            guint interval;
+
+            interval = bearer_load_stats_update_interval (self, self->priv->stats_interface);
+            if (interval != self->priv->stats_update_interval_applied) {
+                self->priv->stats_update_interval_applied = interval;
+                bearer_stats_schedule_stop (self);
+                bearer_stats_schedule (self);
+            }
+        }
+        break;
     case PROP_CONFIG: {
         GVariant *dictionary;
 
@@ -1839,6 +2211,9 @@ get_property (GObject *object,
     case PROP_CONFIG:
         g_value_set_object (value, self->priv->config);
         break;
+    case PROP_STATS_UPDATE_INTERVAL:
+        g_value_set_uint (value, self->priv->stats_update_interval);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -1863,6 +2238,7 @@ mm_base_bearer_init (MMBaseBearer *self)
     self->priv->reason_cdma = CONNECTION_FORBIDDEN_REASON_NONE;
     self->priv->reload_stats_supported = FALSE;
     self->priv->stats = mm_bearer_stats_new ();
+    self->priv->stats_update_interval = MM_BASE_BEARER_STATS_UPDATE_INTERVAL_DEFAULT;
 
     /* Set defaults */
     mm_gdbus_bearer_set_interface   (MM_GDBUS_BEARER (self), NULL);
@@ -1886,6 +2262,7 @@ finalize (GObject *object)
     MMBaseBearer *self = MM_BASE_BEARER (object);
 
     g_free (self->priv->path);
+    g_free (self->priv->stats_interface);
 
     G_OBJECT_CLASS (mm_base_bearer_parent_class)->finalize (object);
 }
@@ -1974,6 +2351,16 @@ mm_base_bearer_class_init (MMBaseBearerClass *klass)
                              MM_TYPE_BEARER_PROPERTIES,
                              G_PARAM_READWRITE);
     g_object_class_install_property (object_class, PROP_CONFIG, properties[PROP_CONFIG]);
+
+    properties[PROP_STATS_UPDATE_INTERVAL] =
+        g_param_spec_uint (MM_BASE_BEARER_STATS_UPDATE_INTERVAL,
+                           "Stats update interval",
+                           "Interval between statistics updates while connected, in milliseconds",
+                           MM_BASE_BEARER_STATS_UPDATE_INTERVAL_MIN,
+                           G_MAXUINT,
+                           MM_BASE_BEARER_STATS_UPDATE_INTERVAL_DEFAULT,
+                           G_PARAM_READWRITE);
+    g_object_class_install_property (object_class, PROP_STATS_UPDATE_INTERVAL, properties[PROP_STATS_UPDATE_INTERVAL]);
 }
 
 /*****************************************************************************/
@@ -91,6 +91,13 @@ typedef struct _MMBaseBearerPrivate MMBaseBearerPrivate;
 #define MM_BASE_BEARER_MODEM      "bearer-modem"
 #define MM_BASE_BEARER_STATUS     "bearer-status"
 #define MM_BASE_BEARER_CONFIG     "bearer-config"
+#define MM_BASE_BEARER_STATS_UPDATE_INTERVAL "bearer-stats-update-interval"
+
+/* Default and minimum stats update intervals, in milliseconds. The interval
+ * given in the ID_MM_BEARER_STATS_UPDATE_INTERVAL udev tag, if any, always
+ * takes precedence over the one set in the bearer object property. */
+#define MM_BASE_BEARER_STATS_UPDATE_INTERVAL_DEFAULT 30000
+#define MM_BASE_BEARER_STATS_UPDATE_INTERVAL_MIN       100
 
 typedef enum { /*< underscore_name=mm_bearer_status >*/
     MM_BEARER_STATUS_DISCONNECTED,
@@ -149,6 +156,14 @@ struct _MMBaseBearerClass {
                                                                 GAsyncResult *res,
                                                                 GError **error);
 
+    /* Check whether disconnections are reported via indications:
+     *
+     * If the modem is known to report disconnections asynchronously (e.g.
+     * with +CGEV URCs), this method should return TRUE, so that the
+     * connection status polling with load_connection_status() is skipped.
+     */
+    gboolean (* connection_status_indications_supported) (MMBaseBearer *bearer);
+
 #if defined WITH_SUSPEND_RESUME
 
     /* Reload connection status:
@@ -460,6 +460,7 @@ handle_kernel_event (MMBaseManager            *self,
     }
 
     if (g_strcmp0 (action, "remove") == 0) {
+        mm_kernel_device_generic_forget_port (subsystem, name);
         device_removed (self, subsystem, name);
         return TRUE;
     }
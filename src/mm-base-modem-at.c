@@ -13,6 +13,8 @@
  * Copyright (C) 2011 Aleksander Morgado <aleksander@gnu.org>
  */
 
+#include <string.h>
+
 #include <glib.h>
 #include <glib-object.h>
 
@@ -20,6 +22,8 @@
 
 #include "mm-base-modem-at.h"
 #include "mm-errors-types.h"
+#include "mm-modem-helpers.h"
+#include "mm-log-object.h"
 
 static gboolean
 abort_async_if_port_unusable (MMBaseModem *self,
@@ -89,6 +93,10 @@ modem_cancellable_cancelled (GCancellable *modem_cancellable,
 /*****************************************************************************/
 /* AT sequence handling */
 
+/* Limits when concatenating commands in the same command line */
+#define MAX_CONCATENATED_COMMANDS     8
+#define MAX_CONCATENATED_COMMAND_LINE 120
+
 typedef struct {
     MMBaseModem                *self;
     MMPortSerialAt             *port;
@@ -102,6 +110,12 @@ typedef struct {
     gpointer                    response_processor_context;
     GDestroyNotify              response_processor_context_free;
     GVariant                   *result;
+    /* Number of commands sent in the last concatenated command line, and
+     * the responses to them not yet processed */
+    guint                       n_concatenated;
+    GStrv                       concatenated_responses;
+    guint                       concatenated_responses_i;
+    gboolean                    concatenation_failed;
 } AtSequenceContext;
 
 static void
@@ -127,6 +141,7 @@ at_sequence_context_free (AtSequenceContext *ctx)
         g_variant_unref (ctx->result);
     if (ctx->simple)
         g_object_unref (ctx->simple);
+    g_strfreev (ctx->concatenated_responses);
     g_free (ctx);
 }
 
@@ -151,28 +166,17 @@ mm_base_modem_at_sequence_full_finish (MMBaseModem   *self,
     return ctx->result;
 }
 
+static void at_sequence_run (AtSequenceContext *ctx);
+
 static void
-at_sequence_parse_response (MMPortSerialAt    *port,
-                            GAsyncResult      *res,
-                            AtSequenceContext *ctx)
+at_sequence_process_response (AtSequenceContext *ctx,
+                              const gchar       *response,
+                              const GError      *error)
 {
     MMBaseModemAtResponseProcessorResult  processor_result;
     GVariant                             *result = NULL;
     GError                               *result_error = NULL;
     GSimpleAsyncResult                   *simple;
-    const gchar                          *response;
-    GError                               *error = NULL;
-
-    response = mm_port_serial_at_command_finish (port, res, &error);
-
-    /* Cancelled? */
-    if (g_cancellable_is_cancelled (ctx->cancellable)) {
-        g_simple_async_result_set_error (ctx->simple, G_IO_ERROR, G_IO_ERROR_CANCELLED, "AT sequence was cancelled");
-        g_clear_error (&error);
-        g_simple_async_result_complete (ctx->simple);
-        at_sequence_context_free (ctx);
-        return;
-    }
 
     if (!ctx->current->response_processor)
         processor_result = MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
@@ -201,30 +205,17 @@ at_sequence_parse_response (MMPortSerialAt    *port,
                 g_simple_async_result_take_error (ctx->simple, result_error);
                 g_simple_async_result_complete (ctx->simple);
                 at_sequence_context_free (ctx);
-                if (error)
-                    g_error_free (error);
                 return;
             default:
                 g_assert_not_reached ();
         }
     }
 
-    if (error)
-        g_error_free (error);
-
     if (processor_result == MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE) {
         ctx->current++;
         if (ctx->current->command) {
             /* Schedule the next command in the probing group */
-            mm_port_serial_at_command (
-                ctx->port,
-                ctx->current->command,
-                ctx->current->timeout,
-                FALSE,
-                ctx->current->allow_cached,
-                ctx->cancellable,
-                (GAsyncReadyCallback)at_sequence_parse_response,
-                ctx);
+            at_sequence_run (ctx);
             return;
         }
         /* On last command, end. */
@@ -251,6 +242,179 @@ at_sequence_parse_response (MMPortSerialAt    *port,
     g_object_unref (simple);
 }
 
+static gboolean
+at_sequence_complete_if_cancelled (AtSequenceContext *ctx)
+{
+    if (!g_cancellable_is_cancelled (ctx->cancellable))
+        return FALSE;
+
+    g_simple_async_result_set_error (ctx->simple, G_IO_ERROR, G_IO_ERROR_CANCELLED, "AT sequence was cancelled");
+    g_simple_async_result_complete (ctx->simple);
+    at_sequence_context_free (ctx);
+    return TRUE;
+}
+
+static void
+at_sequence_parse_response (MMPortSerialAt    *port,
+                            GAsyncResult      *res,
+                            AtSequenceContext *ctx)
+{
+    const gchar       *response;
+    g_autoptr(GError)  error = NULL;
+
+    response = mm_port_serial_at_command_finish (port, res, &error);
+
+    /* Cancelled? */
+    if (at_sequence_complete_if_cancelled (ctx))
+        return;
+
+    at_sequence_process_response (ctx, response, error);
+}
+
+static void
+at_sequence_parse_concatenated_response (MMPortSerialAt    *port,
+                                         GAsyncResult      *res,
+                                         AtSequenceContext *ctx)
+{
+    const gchar          *response;
+    g_autoptr(GError)     error = NULL;
+    g_autoptr(GPtrArray)  commands = NULL;
+    guint                 i;
+
+    response = mm_port_serial_at_command_finish (port, res, &error);
+
+    /* Cancelled? */
+    if (at_sequence_complete_if_cancelled (ctx))
+        return;
+
+    if (!error) {
+        commands = g_ptr_array_new ();
+        for (i = 0; i < ctx->n_concatenated; i++)
+            g_ptr_array_add (commands, (gpointer) ctx->current[i].command);
+        g_ptr_array_add (commands, NULL);
+        ctx->concatenated_responses = mm_split_concatenated_at_response (response,
+                                                                         (const gchar **) commands->pdata,
+                                                                         &error);
+        ctx->concatenated_responses_i = 0;
+    }
+
+    /* As the commands have no side effects, we can safely run them again one
+     * by one, e.g. to know which one failed */
+    if (error) {
+        mm_obj_dbg (ctx->self, "concatenated commands failed, will run them one by one: %s", error->message);
+        ctx->concatenation_failed = TRUE;
+    } else
+        mm_obj_dbg (ctx->self, "%u commands run in a single command line, %u round trips saved",
+                    ctx->n_concatenated, ctx->n_concatenated - 1);
+
+    at_sequence_run (ctx);
+}
+
+static guint
+at_sequence_get_n_concatenated (AtSequenceContext *ctx)
+{
+    const MMBaseModemAtCommand *command;
+    gboolean                    concatenation = FALSE;
+    gsize                       len = 2; /* AT */
+    guint                       n = 0;
+
+    if (ctx->concatenation_failed)
+        return 0;
+
+    g_object_get (ctx->port, MM_PORT_SERIAL_AT_COMMAND_CONCATENATION, &concatenation, NULL);
+    if (!concatenation)
+        return 0;
+
+    for (command = ctx->current;
+         command->command && command->allow_concatenation && n < MAX_CONCATENATED_COMMANDS;
+         command++, n++) {
+        g_autofree gchar *name = NULL;
+
+        name = mm_at_command_get_extended_name (command->command);
+        if (!name)
+            break;
+
+        len += strlen (command->command) + 1;
+        if (len > MAX_CONCATENATED_COMMAND_LINE)
+            break;
+    }
+
+    return n;
+}
+
+static void
+at_sequence_run (AtSequenceContext *ctx)
+{
+    const MMBaseModemAtCommand *command;
+    GString                    *command_line;
+    MMPortSerialCommandPriority priority = MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND;
+    guint                       timeout = 0;
+    guint                       n;
+    guint                       i;
+
+    /* Responses already available from a previous concatenated command line */
+    if (ctx->concatenated_responses) {
+        g_autofree gchar *response = NULL;
+
+        response = g_strdup (ctx->concatenated_responses[ctx->concatenated_responses_i++]);
+        if (!ctx->concatenated_responses[ctx->concatenated_responses_i])
+            g_clear_pointer (&ctx->concatenated_responses, g_strfreev);
+        at_sequence_process_response (ctx, response, NULL);
+        return;
+    }
+
+    /* Single command */
+    n = at_sequence_get_n_concatenated (ctx);
+    if (n < 2) {
+        mm_port_serial_at_command_full (
+            ctx->port,
+            ctx->current->command,
+            ctx->current->timeout,
+            FALSE,
+            ctx->current->allow_cached,
+            ctx->current->priority,
+            ctx->cancellable,
+            (GAsyncReadyCallback)at_sequence_parse_response,
+            ctx);
+        return;
+    }
+
+    /* Multiple commands in the same command line, the modem runs them one
+     * after the other so the timeout must cover all of them, and the command
+     * line is scheduled with the most urgent class of all of them */
+    ctx->n_concatenated = n;
+    command_line = g_string_new ("");
+    for (i = 0, command = ctx->current; i < n; i++, command++) {
+        const gchar *str;
+
+        if (command->priority == MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL)
+            priority = MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL;
+        else if (command->priority == MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE &&
+                 priority == MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND)
+            priority = MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE;
+
+        str = command->command;
+        if (g_ascii_strncasecmp (str, "AT", 2) == 0)
+            str += 2;
+        if (i > 0)
+            g_string_append_c (command_line, ';');
+        g_string_append (command_line, str);
+        timeout += command->timeout;
+    }
+
+    mm_port_serial_at_command_full (
+        ctx->port,
+        command_line->str,
+        timeout,
+        FALSE,
+        FALSE,
+        priority,
+        ctx->cancellable,
+        (GAsyncReadyCallback)at_sequence_parse_concatenated_response,
+        ctx);
+    g_string_free (command_line, TRUE);
+}
+
 void
 mm_base_modem_at_sequence_full (MMBaseModem                *self,
                                 MMPortSerialAt             *port,
@@ -296,15 +460,7 @@ mm_base_modem_at_sequence_full (MMBaseModem                *self,
     }
 
     /* Go on with the first one in the sequence */
-    mm_port_serial_at_command (
-        ctx->port,
-        ctx->current->command,
-        ctx->current->timeout,
-        FALSE,
-        ctx->current->allow_cached,
-        ctx->cancellable,
-        (GAsyncReadyCallback)at_sequence_parse_response,
-        ctx);
+    at_sequence_run (ctx);
 }
 
 GVariant *
@@ -320,19 +476,22 @@ mm_base_modem_at_sequence_finish (MMBaseModem *self,
                 error));
 }
 
-void
-mm_base_modem_at_sequence (MMBaseModem *self,
-                           const MMBaseModemAtCommand *sequence,
-                           gpointer response_processor_context,
-                           GDestroyNotify response_processor_context_free,
-                           GAsyncReadyCallback callback,
-                           gpointer user_data)
+static void
+_at_sequence (MMBaseModem *self,
+              const MMBaseModemAtCommand *sequence,
+              gboolean any_port,
+              gpointer response_processor_context,
+              GDestroyNotify response_processor_context_free,
+              GAsyncReadyCallback callback,
+              gpointer user_data)
 {
     MMPortSerialAt *port;
     GError *error = NULL;
 
     /* No port given, so we'll try to guess which is best */
-    port = mm_base_modem_peek_best_at_port (self, &error);
+    port = (any_port ?
+            mm_base_modem_peek_least_busy_at_port (self, &error) :
+            mm_base_modem_peek_best_at_port (self, &error));
     if (!port) {
         g_assert (error != NULL);
         g_simple_async_report_take_gerror_in_idle (G_OBJECT (self),
@@ -353,6 +512,40 @@ mm_base_modem_at_sequence (MMBaseModem *self,
         user_data);
 }
 
+void
+mm_base_modem_at_sequence (MMBaseModem *self,
+                           const MMBaseModemAtCommand *sequence,
+                           gpointer response_processor_context,
+                           GDestroyNotify response_processor_context_free,
+                           GAsyncReadyCallback callback,
+                           gpointer user_data)
+{
+    _at_sequence (self,
+                  sequence,
+                  FALSE,
+                  response_processor_context,
+                  response_processor_context_free,
+                  callback,
+                  user_data);
+}
+
+void
+mm_base_modem_at_sequence_any_port (MMBaseModem *self,
+                                    const MMBaseModemAtCommand *sequence,
+                                    gpointer response_processor_context,
+                                    GDestroyNotify response_processor_context_free,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data)
+{
+    _at_sequence (self,
+                  sequence,
+                  TRUE,
+                  response_processor_context,
+                  response_processor_context_free,
+                  callback,
+                  user_data);
+}
+
 /*****************************************************************************/
 /* Response processor helpers */
 
@@ -549,6 +742,30 @@ mm_base_modem_at_command_full (MMBaseModem *self,
                                GCancellable *cancellable,
                                GAsyncReadyCallback callback,
                                gpointer user_data)
+{
+    mm_base_modem_at_command_full_with_priority (self,
+                                                 port,
+                                                 command,
+                                                 timeout,
+                                                 allow_cached,
+                                                 is_raw,
+                                                 MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE,
+                                                 cancellable,
+                                                 callback,
+                                                 user_data);
+}
+
+void
+mm_base_modem_at_command_full_with_priority (MMBaseModem *self,
+                                             MMPortSerialAt *port,
+                                             const gchar *command,
+                                             guint timeout,
+                                             gboolean allow_cached,
+                                             gboolean is_raw,
+                                             MMPortSerialCommandPriority priority,
+                                             GCancellable *cancellable,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data)
 {
     AtCommandContext *ctx;
 
@@ -581,12 +798,13 @@ mm_base_modem_at_command_full (MMBaseModem *self,
     }
 
     /* Go on with the command */
-    mm_port_serial_at_command (
+    mm_port_serial_at_command_full (
         port,
         command,
         timeout,
         is_raw,
         allow_cached,
+        priority,
         ctx->cancellable,
         (GAsyncReadyCallback)at_command_ready,
         ctx);
@@ -606,6 +824,8 @@ _at_command (MMBaseModem *self,
              guint timeout,
              gboolean allow_cached,
              gboolean is_raw,
+             MMPortSerialCommandPriority priority,
+             gboolean any_port,
              GAsyncReadyCallback callback,
              gpointer user_data)
 {
@@ -613,7 +833,9 @@ _at_command (MMBaseModem *self,
     GError *error = NULL;
 
     /* No port given, so we'll try to guess which is best */
-    port = mm_base_modem_peek_best_at_port (self, &error);
+    port = (any_port ?
+            mm_base_modem_peek_least_busy_at_port (self, &error) :
+            mm_base_modem_peek_best_at_port (self, &error));
     if (!port) {
         g_assert (error != NULL);
         g_simple_async_report_take_gerror_in_idle (G_OBJECT (self),
@@ -623,15 +845,16 @@ _at_command (MMBaseModem *self,
         return;
     }
 
-    mm_base_modem_at_command_full (self,
-                                   port,
-                                   command,
-                                   timeout,
-                                   allow_cached,
-                                   is_raw,
-                                   NULL,
-                                   callback,
-                                   user_data);
+    mm_base_modem_at_command_full_with_priority (self,
+                                                 port,
+                                                 command,
+                                                 timeout,
+                                                 allow_cached,
+                                                 is_raw,
+                                                 priority,
+                                                 NULL,
+                                                 callback,
+                                                 user_data);
 }
 
 void
@@ -642,7 +865,31 @@ mm_base_modem_at_command (MMBaseModem *self,
                           GAsyncReadyCallback callback,
                           gpointer user_data)
 {
-    _at_command (self, command, timeout, allow_cached, FALSE, callback, user_data);
+    _at_command (self, command, timeout, allow_cached, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE, FALSE, callback, user_data);
+}
+
+void
+mm_base_modem_at_command_with_priority (MMBaseModem *self,
+                                        const gchar *command,
+                                        guint timeout,
+                                        gboolean allow_cached,
+                                        MMPortSerialCommandPriority priority,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data)
+{
+    _at_command (self, command, timeout, allow_cached, FALSE, priority, FALSE, callback, user_data);
+}
+
+void
+mm_base_modem_at_command_any_port (MMBaseModem *self,
+                                   const gchar *command,
+                                   guint timeout,
+                                   gboolean allow_cached,
+                                   MMPortSerialCommandPriority priority,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data)
+{
+    _at_command (self, command, timeout, allow_cached, FALSE, priority, TRUE, callback, user_data);
 }
 
 void
@@ -653,7 +900,7 @@ mm_base_modem_at_command_raw (MMBaseModem *self,
                               GAsyncReadyCallback callback,
                               gpointer user_data)
 {
-    _at_command (self, command, timeout, allow_cached, TRUE, callback, user_data);
+    _at_command (self, command, timeout, allow_cached, TRUE, MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE, FALSE, callback, user_data);
 }
 
 void
@@ -67,6 +67,13 @@ typedef struct {
     gboolean allow_cached;
     /* The response processor */
     MMBaseModemAtResponseProcessor response_processor;
+    /* Flag to allow sending the command in the same command line as the
+     * adjacent ones also flagged, if the port supports command concatenation.
+     * Only for side-effect-free extended syntax queries whose response lines
+     * are all prefixed by the command name (e.g. +CPIN? or +CREG?) */
+    gboolean allow_concatenation;
+    /* Scheduling class of the command in the port queue */
+    MMPortSerialCommandPriority priority;
 } MMBaseModemAtCommand;
 
 /* Generic AT sequence handling, using the best AT port available and without
@@ -82,6 +89,17 @@ GVariant *mm_base_modem_at_sequence_finish (MMBaseModem *self,
                                             gpointer *response_processor_context,
                                             GError **error);
 
+/* Same as mm_base_modem_at_sequence(), but the sequence is a set of
+ * independent queries which may run in whichever AT port of the modem is
+ * least busy. Never use it for commands that configure the port itself.
+ * Finished with mm_base_modem_at_sequence_finish(). */
+void     mm_base_modem_at_sequence_any_port (MMBaseModem *self,
+                                             const MMBaseModemAtCommand *sequence,
+                                             gpointer response_processor_context,
+                                             GDestroyNotify response_processor_context_free,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data);
+
 /* Fully detailed AT sequence handling, when specific AT port and/or explicit
  * cancellations need to be used. */
 void     mm_base_modem_at_sequence_full         (MMBaseModem *self,
@@ -210,6 +228,39 @@ const gchar *mm_base_modem_at_command_full_finish (MMBaseModem *self,
                                                    GAsyncResult *res,
                                                    GError **error);
 
+/* Same as mm_base_modem_at_command() and mm_base_modem_at_command_full(), but
+ * with an explicit scheduling class for the command in the port queue. The
+ * operations are finished with the same finish() methods. */
+void mm_base_modem_at_command_with_priority      (MMBaseModem *self,
+                                                  const gchar *command,
+                                                  guint timeout,
+                                                  gboolean allow_cached,
+                                                  MMPortSerialCommandPriority priority,
+                                                  GAsyncReadyCallback callback,
+                                                  gpointer user_data);
+void mm_base_modem_at_command_full_with_priority (MMBaseModem *self,
+                                                  MMPortSerialAt *port,
+                                                  const gchar *command,
+                                                  guint timeout,
+                                                  gboolean allow_cached,
+                                                  gboolean is_raw,
+                                                  MMPortSerialCommandPriority priority,
+                                                  GCancellable *cancellable,
+                                                  GAsyncReadyCallback callback,
+                                                  gpointer user_data);
+
+/* Same as mm_base_modem_at_command_with_priority(), but the command is an
+ * independent query which may run in whichever AT port of the modem is least
+ * busy. Never use it for commands that configure the port itself.
+ * Finished with mm_base_modem_at_command_finish(). */
+void mm_base_modem_at_command_any_port           (MMBaseModem *self,
+                                                  const gchar *command,
+                                                  guint timeout,
+                                                  gboolean allow_cached,
+                                                  MMPortSerialCommandPriority priority,
+                                                  GAsyncReadyCallback callback,
+                                                  gpointer user_data);
+
 /******************************************************************************/
 /* Support for MMBaseModemAtCommand with heap allocated contents */
 
@@ -220,6 +271,8 @@ typedef struct {
     guint     timeout;
     gboolean  allow_cached;
     MMBaseModemAtResponseProcessor response_processor;
+    gboolean  allow_concatenation;
+    MMPortSerialCommandPriority priority;
 } MMBaseModemAtCommandAlloc;
 
 G_STATIC_ASSERT (sizeof (MMBaseModemAtCommandAlloc) == sizeof (MMBaseModemAtCommand));
@@ -227,6 +280,8 @@ G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, command)
 G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, timeout)            == G_STRUCT_OFFSET (MMBaseModemAtCommand, timeout));
 G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, allow_cached)       == G_STRUCT_OFFSET (MMBaseModemAtCommand, allow_cached));
 G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, response_processor) == G_STRUCT_OFFSET (MMBaseModemAtCommand, response_processor));
+G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, allow_concatenation) == G_STRUCT_OFFSET (MMBaseModemAtCommand, allow_concatenation));
+G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, priority)           == G_STRUCT_OFFSET (MMBaseModemAtCommand, priority));
 
 void mm_base_modem_at_command_alloc_clear (MMBaseModemAtCommandAlloc *command);
 
@@ -30,11 +30,13 @@
 
 #include "mm-context.h"
 #include "mm-base-modem.h"
+#include "mm-bringup-scheduler.h"
 #if defined WITH_QRTR
 #include "mm-kernel-device-qrtr.h"
 #endif
 
 #include "mm-log-object.h"
+#include "mm-netlink.h"
 #include "mm-port-enums-types.h"
 #include "mm-serial-parsers.h"
 #include "mm-modem-helpers.h"
@@ -136,6 +138,14 @@ struct _MMBaseModemPrivate {
     /* Additional port links grabbed after having
      * organized ports */
     GHashTable *link_ports;
+
+    /* Bring-up slot held while initializing, if throttling is enabled */
+    gchar    *bringup_group;
+    gboolean  bringup_slot_acquired;
+
+    /* Bring-up step timing, 0 if not started and -1 once completed */
+    gint64 creation_time;
+    gint64 bringup_step_start_time[MM_BASE_MODEM_BRINGUP_STEP_LAST];
 };
 
 guint
@@ -194,9 +204,24 @@ base_modem_create_tty_port (MMBaseModem        *self,
 
     if (ptype == MM_PORT_TYPE_QCDM)
         port = MM_PORT (mm_port_serial_qcdm_new (name, MM_PORT_SUBSYS_TTY));
-    else if (ptype == MM_PORT_TYPE_GPS)
+    else if (ptype == MM_PORT_TYPE_GPS) {
+        const gchar *ignored_sentences_tag;
+
         port = MM_PORT (mm_port_serial_gps_new (name));
-    else if (ptype == MM_PORT_TYPE_AUDIO)
+
+        /* Optional user-provided list of NMEA sentences to discard */
+        ignored_sentences_tag = mm_kernel_device_get_property (kernel_device, ID_MM_GPS_IGNORED_SENTENCES);
+        if (ignored_sentences_tag) {
+            g_auto(GStrv) ignored_sentences = NULL;
+            guint         i;
+
+            ignored_sentences = g_strsplit (ignored_sentences_tag, ",", -1);
+            for (i = 0; ignored_sentences[i]; i++)
+                g_strstrip (ignored_sentences[i]);
+            mm_port_serial_gps_set_ignored_sentences (MM_PORT_SERIAL_GPS (port),
+                                                      (const gchar * const *) ignored_sentences);
+        }
+    } else if (ptype == MM_PORT_TYPE_AUDIO)
         port = MM_PORT (mm_port_serial_new (name, ptype));
     else if (ptype == MM_PORT_TYPE_AT)
         port = MM_PORT (mm_port_serial_at_new (name, MM_PORT_SUBSYS_TTY));
@@ -431,6 +456,12 @@ base_modem_internal_grab_port (MMBaseModem         *self,
             at_pflags = MM_PORT_SERIAL_AT_FLAG_NONE;
 
         mm_port_serial_at_set_flags (MM_PORT_SERIAL_AT (port), at_pflags);
+
+        /* Optional user-provided command concatenation support */
+        if (mm_kernel_device_get_property_as_boolean (kernel_device, ID_MM_AT_COMMAND_CONCATENATION)) {
+            mm_obj_dbg (port, "AT port supports command concatenation");
+            g_object_set (port, MM_PORT_SERIAL_AT_COMMAND_CONCATENATION, TRUE, NULL);
+        }
     }
 
     /* Add it to the tracking HT.
@@ -529,6 +560,8 @@ typedef struct {
     gchar  *name;
     gulong  link_port_grabbed_id;
     guint   timeout_id;
+    gulong  netlink_link_changed_id;
+    gint64  netlink_link_time;
 } WaitLinkPortContext;
 
 static void
@@ -536,10 +569,33 @@ wait_link_port_context_free (WaitLinkPortContext *ctx)
 {
     g_assert (!ctx->link_port_grabbed_id);
     g_assert (!ctx->timeout_id);
+    g_assert (!ctx->netlink_link_changed_id);
     g_free (ctx->name);
     g_slice_free (WaitLinkPortContext, ctx);
 }
 
+static void
+wait_link_port_context_disconnect (MMBaseModem         *self,
+                                   WaitLinkPortContext *ctx)
+{
+    if (ctx->timeout_id) {
+        g_source_remove (ctx->timeout_id);
+        ctx->timeout_id = 0;
+    }
+    if (ctx->link_port_grabbed_id) {
+        g_signal_handler_disconnect (self, ctx->link_port_grabbed_id);
+        ctx->link_port_grabbed_id = 0;
+    }
+    if (ctx->netlink_link_changed_id) {
+        MMNetlink *netlink;
+
+        netlink = mm_netlink_get ();
+        g_signal_handler_disconnect (netlink, ctx->netlink_link_changed_id);
+        ctx->netlink_link_changed_id = 0;
+        mm_netlink_events_disable (netlink);
+    }
+}
+
 MMPort *
 mm_base_modem_wait_link_port_finish (MMBaseModem   *self,
                                      GAsyncResult  *res,
@@ -558,17 +614,87 @@ wait_link_port_timeout_cb (GTask *task)
     ctx  = g_task_get_task_data     (task);
 
     ctx->timeout_id = 0;
-    g_signal_handler_disconnect (self, ctx->link_port_grabbed_id);
-    ctx->link_port_grabbed_id = 0;
+    wait_link_port_context_disconnect (self, ctx);
 
     g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_NOT_FOUND,
-                             "Timed out waiting for link port 'net/%s'",
-                             ctx->name);
+                             "Timed out waiting for link port 'net/%s'%s",
+                             ctx->name,
+                             ctx->netlink_link_time ? " (link exists in the kernel)" : "");
     g_object_unref (task);
 
     return G_SOURCE_REMOVE;
 }
 
+static void
+wait_link_port_netlink_link_changed_cb (MMNetlink   *netlink,
+                                        guint        ifindex,
+                                        const gchar *name,
+                                        guint        flags,
+                                        guint        mtu,
+                                        gboolean     removed,
+                                        GTask       *task)
+{
+    WaitLinkPortContext *ctx;
+    MMBaseModem         *self;
+
+    ctx = g_task_get_task_data (task);
+    if (g_strcmp0 (name, ctx->name) != 0)
+        return;
+
+    self = g_task_get_source_object (task);
+
+    if (!removed) {
+        /* The port is grabbed once udev has processed the new link */
+        if (!ctx->netlink_link_time) {
+            ctx->netlink_link_time = g_get_monotonic_time ();
+            mm_obj_dbg (self, "link 'net/%s' reported by the kernel, waiting for udev...", ctx->name);
+        }
+        return;
+    }
+
+    /* No point in waiting for the udev event if the link is already gone */
+    wait_link_port_context_disconnect (self, ctx);
+    g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_NOT_FOUND,
+                             "Link port 'net/%s' removed while waiting for it",
+                             ctx->name);
+    g_object_unref (task);
+}
+
+static void
+wait_link_port_state_ready (MMPortNet    *link_port,
+                            GAsyncResult *res,
+                            GTask        *task)
+{
+    MMBaseModem       *self;
+    g_autoptr(GError)  error = NULL;
+
+    self = g_task_get_source_object (task);
+
+    /* Not fatal, the link state is only used to skip redundant link setups */
+    if (!mm_port_net_wait_link_state_finish (link_port, res, &error))
+        mm_obj_dbg (self, "link state of port 'net/%s' unknown: %s",
+                    mm_port_get_device (MM_PORT (link_port)), error->message);
+
+    g_task_return_pointer (task, g_object_ref (link_port), g_object_unref);
+    g_object_unref (task);
+}
+
+static void
+wait_link_port_complete (GTask  *task,
+                         MMPort *link_port)
+{
+    /* The link port is given once its carrier and MTU are known */
+    if (MM_IS_PORT_NET (link_port)) {
+        mm_port_net_wait_link_state (MM_PORT_NET (link_port),
+                                     (GAsyncReadyCallback) wait_link_port_state_ready,
+                                     task);
+        return;
+    }
+
+    g_task_return_pointer (task, g_object_ref (link_port), g_object_unref);
+    g_object_unref (task);
+}
+
 static void
 wait_link_port_grabbed_cb (MMBaseModem *self,
                            MMPort      *link_port,
@@ -595,13 +721,11 @@ wait_link_port_grabbed_cb (MMBaseModem *self,
 
     /* we got it! */
 
-    g_source_remove (ctx->timeout_id);
-    ctx->timeout_id = 0;
-    g_signal_handler_disconnect (self, ctx->link_port_grabbed_id);
-    ctx->link_port_grabbed_id = 0;
-
-    g_task_return_pointer (task, g_object_ref (link_port), g_object_unref);
-    g_object_unref (task);
+    if (ctx->netlink_link_time)
+        mm_obj_dbg (self, "link port 'net/%s' grabbed %" G_GINT64_FORMAT "ms after the kernel reported it",
+                    ctx->name, (g_get_monotonic_time () - ctx->netlink_link_time) / 1000);
+    wait_link_port_context_disconnect (self, ctx);
+    wait_link_port_complete (task, link_port);
 }
 
 void
@@ -630,8 +754,7 @@ mm_base_modem_wait_link_port (MMBaseModem         *self,
     port = g_hash_table_lookup (self->priv->link_ports, key);
     if (port) {
         mm_obj_dbg (self, "no need to wait for port '%s/%s': already grabbed", subsystem, name);
-        g_task_return_pointer (task, g_object_ref (port), g_object_unref);
-        g_object_unref (task);
+        wait_link_port_complete (task, port);
         return;
     }
 
@@ -647,6 +770,11 @@ mm_base_modem_wait_link_port (MMBaseModem         *self,
                                                   MM_BASE_MODEM_SIGNAL_LINK_PORT_GRABBED,
                                                   G_CALLBACK (wait_link_port_grabbed_cb),
                                                   task);
+    mm_netlink_events_enable (mm_netlink_get ());
+    ctx->netlink_link_changed_id = g_signal_connect (mm_netlink_get (),
+                                                     MM_NETLINK_SIGNAL_LINK_CHANGED,
+                                                     G_CALLBACK (wait_link_port_netlink_link_changed_cb),
+                                                     task);
 
     mm_obj_dbg (self, "waiting for port '%s/%s'...", subsystem, name);
 }
@@ -1094,6 +1222,53 @@ mm_base_modem_peek_best_at_port (MMBaseModem *self,
     return NULL;
 }
 
+MMPortSerialAt *
+mm_base_modem_get_least_busy_at_port (MMBaseModem *self,
+                                      GError **error)
+{
+    MMPortSerialAt *port;
+
+    port = mm_base_modem_peek_least_busy_at_port (self, error);
+    return (port ? g_object_ref (port) : NULL);
+}
+
+MMPortSerialAt *
+mm_base_modem_peek_least_busy_at_port (MMBaseModem *self,
+                                       GError **error)
+{
+    MMPortSerialAt *pool[2];
+    MMPortSerialAt *best = NULL;
+    guint           best_queue_length = 0;
+    guint           i;
+
+    /* Only the primary and secondary ports get configured by the modem
+     * (init sequence, unsolicited messages...), so only those are able to
+     * run any independent query. On ties the primary port is preferred, so
+     * the secondary port is only used while the primary one is busy. */
+    pool[0] = self->priv->primary;
+    pool[1] = self->priv->secondary;
+
+    for (i = 0; i < G_N_ELEMENTS (pool); i++) {
+        guint queue_length;
+
+        if (!pool[i] || mm_port_get_connected (MM_PORT (pool[i])))
+            continue;
+
+        queue_length = mm_port_serial_get_queue_length (MM_PORT_SERIAL (pool[i]));
+        if (!best || queue_length < best_queue_length) {
+            best = pool[i];
+            best_queue_length = queue_length;
+        }
+    }
+
+    if (!best)
+        g_set_error (error,
+                     MM_CORE_ERROR,
+                     MM_CORE_ERROR_CONNECTED,
+                     "No AT port available to run command");
+    return best;
+}
+
 gboolean
 mm_base_modem_has_at_port (MMBaseModem *self)
 {
@@ -1255,12 +1430,61 @@ mm_base_modem_get_port (MMBaseModem *self,
     return (port ? g_object_ref (port) : NULL);
 }
 
+/*****************************************************************************/
+/* Bring-up step timing */
+
+static const gchar *bringup_step_str[MM_BASE_MODEM_BRINGUP_STEP_LAST] = {
+    [MM_BASE_MODEM_BRINGUP_STEP_INIT]     = "init",
+    [MM_BASE_MODEM_BRINGUP_STEP_ENABLE]   = "enable",
+    [MM_BASE_MODEM_BRINGUP_STEP_REGISTER] = "register",
+    [MM_BASE_MODEM_BRINGUP_STEP_CONNECT]  = "connect",
+};
+
+void
+mm_base_modem_bringup_step_started (MMBaseModem            *self,
+                                    MMBaseModemBringupStep  step)
+{
+    g_assert (step < MM_BASE_MODEM_BRINGUP_STEP_LAST);
+
+    /* Only the first run of each step is tracked, and retries while the
+     * step is ongoing don't reset the start time */
+    if (!self->priv->bringup_step_start_time[step])
+        self->priv->bringup_step_start_time[step] = g_get_monotonic_time ();
+}
+
+void
+mm_base_modem_bringup_step_completed (MMBaseModem            *self,
+                                      MMBaseModemBringupStep  step)
+{
+    gint64 now;
+
+    g_assert (step < MM_BASE_MODEM_BRINGUP_STEP_LAST);
+
+    if (self->priv->bringup_step_start_time[step] <= 0)
+        return;
+
+    now = g_get_monotonic_time ();
+    mm_obj_info (self, "bring-up step '%s' completed in '%lf' seconds ('%lf' seconds since modem created)",
+                 bringup_step_str[step],
+                 (now - self->priv->bringup_step_start_time[step]) / (gdouble) G_USEC_PER_SEC,
+                 (now - self->priv->creation_time) / (gdouble) G_USEC_PER_SEC);
+    self->priv->bringup_step_start_time[step] = -1;
+}
+
+/*****************************************************************************/
+
 static void
 initialize_ready (MMBaseModem *self,
                   GAsyncResult *res)
 {
     g_autoptr(GError) error = NULL;
 
+    /* Let other modems behind the same hub be initialized */
+    if (self->priv->bringup_slot_acquired) {
+        mm_bringup_scheduler_release (mm_bringup_scheduler_get (), self->priv->bringup_group);
+        self->priv->bringup_slot_acquired = FALSE;
+    }
+
     if (!mm_base_modem_initialize_finish (self, res, &error)) {
         if (g_error_matches (error, MM_CORE_ERROR, MM_CORE_ERROR_ABORTED)) {
             /* FATAL error, won't even be exported in DBus */
@@ -1272,10 +1496,75 @@ initialize_ready (MMBaseModem *self,
         }
     } else {
         mm_obj_dbg (self, "modem initialized");
+        mm_base_modem_bringup_step_completed (self, MM_BASE_MODEM_BRINGUP_STEP_INIT);
         mm_base_modem_set_valid (self, TRUE);
     }
 }
 
+static void
+initialize_start (MMBaseModem *self)
+{
+    mm_base_modem_bringup_step_started (self, MM_BASE_MODEM_BRINGUP_STEP_INIT);
+    mm_base_modem_initialize (self,
+                              (GAsyncReadyCallback)initialize_ready,
+                              NULL);
+}
+
+static void
+bringup_slot_acquire_ready (MMBringupScheduler *scheduler,
+                            GAsyncResult       *res,
+                            MMBaseModem        *self)
+{
+    g_autoptr(GError) error = NULL;
+
+    /* Only fails if the modem is gone while waiting */
+    if (!mm_bringup_scheduler_acquire_finish (scheduler, res, &error)) {
+        mm_obj_dbg (self, "initialization aborted: %s", error->message);
+        g_object_unref (self);
+        return;
+    }
+
+    mm_obj_dbg (self, "bring-up slot acquired after '%lf' seconds",
+                (g_get_monotonic_time () - self->priv->creation_time) / (gdouble) G_USEC_PER_SEC);
+    self->priv->bringup_slot_acquired = TRUE;
+    initialize_start (self);
+    g_object_unref (self);
+}
+
+static gboolean
+request_bringup_slot (MMBaseModem *self)
+{
+    MMBringupScheduler *scheduler;
+    GHashTableIter      iter;
+    MMPort             *port;
+
+    scheduler = mm_bringup_scheduler_get ();
+    if (!mm_bringup_scheduler_is_enabled (scheduler))
+        return FALSE;
+
+    /* All ports are in the same physical device, any of them will do */
+    g_hash_table_iter_init (&iter, self->priv->ports);
+    while (!self->priv->bringup_group && g_hash_table_iter_next (&iter, NULL, (gpointer)&port)) {
+        MMKernelDevice *kernel_device;
+
+        kernel_device = mm_port_peek_kernel_device (port);
+        if (kernel_device)
+            self->priv->bringup_group = mm_bringup_scheduler_build_group (kernel_device);
+    }
+    if (!self->priv->bringup_group)
+        return FALSE;
+
+    /* The modem was already probed, so it goes before any device that is
+     * still waiting to be probed */
+    mm_bringup_scheduler_acquire (scheduler,
+                                  self->priv->bringup_group,
+                                  TRUE,
+                                  self->priv->cancellable,
+                                  (GAsyncReadyCallback) bringup_slot_acquire_ready,
+                                  g_object_ref (self));
+    return TRUE;
+}
+
 static inline void
 log_port (MMBaseModem *self, MMPort *port, const char *desc)
 {
@@ -1595,10 +1884,10 @@ mm_base_modem_organize_ports (MMBaseModem *self,
     }
 #endif
 
-    /* As soon as we get the ports organized, we initialize the modem */
-    mm_base_modem_initialize (self,
-                              (GAsyncReadyCallback)initialize_ready,
-                              NULL);
+    /* As soon as we get the ports organized, we initialize the modem, once
+     * allowed by the bring-up scheduler */
+    if (!request_bringup_slot (self))
+        initialize_start (self);
 
     return TRUE;
 }
@@ -1822,6 +2111,7 @@ mm_base_modem_init (MMBaseModem *self)
                                NULL);
 
     self->priv->max_timeouts = DEFAULT_MAX_TIMEOUTS;
+    self->priv->creation_time = g_get_monotonic_time ();
 
     setup_ports_table (&self->priv->ports);
     setup_ports_table (&self->priv->link_ports);
@@ -1950,6 +2240,7 @@ finalize (GObject *object)
     g_free (self->priv->device);
     g_strfreev (self->priv->drivers);
     g_free (self->priv->plugin);
+    g_free (self->priv->bringup_group);
 
     G_OBJECT_CLASS (mm_base_modem_parent_class)->finalize (object);
 }
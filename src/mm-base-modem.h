@@ -168,6 +168,7 @@ MMPortSerialAt   *mm_base_modem_peek_port_gps_control  (MMBaseModem *self);
 MMPortSerialGps  *mm_base_modem_peek_port_gps          (MMBaseModem *self);
 MMPortSerial     *mm_base_modem_peek_port_audio        (MMBaseModem *self);
 MMPortSerialAt   *mm_base_modem_peek_best_at_port      (MMBaseModem *self, GError **error);
+MMPortSerialAt   *mm_base_modem_peek_least_busy_at_port (MMBaseModem *self, GError **error);
 MMPort           *mm_base_modem_peek_best_data_port    (MMBaseModem *self, MMPortType type);
 GList            *mm_base_modem_peek_data_ports        (MMBaseModem *self);
 
@@ -178,6 +179,7 @@ MMPortSerialAt   *mm_base_modem_get_port_gps_control  (MMBaseModem *self);
 MMPortSerialGps  *mm_base_modem_get_port_gps          (MMBaseModem *self);
 MMPortSerial     *mm_base_modem_get_port_audio        (MMBaseModem *self);
 MMPortSerialAt   *mm_base_modem_get_best_at_port      (MMBaseModem *self, GError **error);
+MMPortSerialAt   *mm_base_modem_get_least_busy_at_port (MMBaseModem *self, GError **error);
 MMPort           *mm_base_modem_get_best_data_port    (MMBaseModem *self, MMPortType type);
 GList            *mm_base_modem_get_data_ports        (MMBaseModem *self);
 
@@ -231,6 +233,20 @@ gboolean mm_base_modem_initialize_finish (MMBaseModem *self,
                                           GAsyncResult *res,
                                           GError **error);
 
+/* Bring-up steps, timed once per modem */
+typedef enum {
+    MM_BASE_MODEM_BRINGUP_STEP_INIT,
+    MM_BASE_MODEM_BRINGUP_STEP_ENABLE,
+    MM_BASE_MODEM_BRINGUP_STEP_REGISTER,
+    MM_BASE_MODEM_BRINGUP_STEP_CONNECT,
+    MM_BASE_MODEM_BRINGUP_STEP_LAST
+} MMBaseModemBringupStep;
+
+void     mm_base_modem_bringup_step_started   (MMBaseModem            *self,
+                                               MMBaseModemBringupStep  step);
+void     mm_base_modem_bringup_step_completed (MMBaseModem            *self,
+                                               MMBaseModemBringupStep  step);
+
 void     mm_base_modem_enable        (MMBaseModem *self,
                                       GAsyncReadyCallback callback,
                                       gpointer user_data);
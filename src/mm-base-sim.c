@@ -32,6 +32,7 @@
 #include "mm-base-modem-at.h"
 #include "mm-base-modem.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-modem-helpers.h"
 
 static void async_initable_iface_init (GAsyncInitableIface *iface);
@@ -2665,6 +2666,8 @@ interface_initialization_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "sim-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         ctx->step++;
@@ -32,6 +32,7 @@
 #include "mm-port-enums-types.h"
 #include "mm-bearer-mbim.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-context.h"
 
 G_DEFINE_TYPE (MMBearerMbim, mm_bearer_mbim, MM_TYPE_BASE_BEARER)
@@ -1123,6 +1124,8 @@ connect_context_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx  = g_task_get_task_data (task);
 
+    mm_trace_step (self, "bearer-mbim-connect", ctx->step, CONNECT_STEP_LAST);
+
     switch (ctx->step) {
     case CONNECT_STEP_FIRST:
         ctx->step++;
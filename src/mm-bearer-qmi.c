@@ -35,6 +35,7 @@
 #include "mm-modem-helpers-qmi.h"
 #include "mm-port-enums-types.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-modem-helpers.h"
 #include "mm-context.h"
 
@@ -418,6 +419,45 @@ reload_connection_status_ready (MMBaseBearer *self,
     g_object_unref (task);
 }
 
+static gboolean
+connection_status_polling_enabled (MMBearerQmi *self)
+{
+    /* Connection status polling is an optional feature that must be
+     * enabled explicitly via udev tags. Note that when connected via a
+     * muxed link, the udev tag should be checked on the main interface
+     * (lower device) */
+    if (self->priv->data &&
+        !mm_kernel_device_get_global_property_as_boolean (mm_port_peek_kernel_device (self->priv->data),
+                                                          "ID_MM_QMI_CONNECTION_STATUS_POLLING_ENABLE"))
+        return FALSE;
+    if (self->priv->link &&
+        !mm_kernel_device_get_global_property_as_boolean (mm_kernel_device_peek_lower_device (mm_port_peek_kernel_device (self->priv->link)),
+                                                          "ID_MM_QMI_CONNECTION_STATUS_POLLING_ENABLE"))
+        return FALSE;
+    return TRUE;
+}
+
+static gboolean
+connection_status_indications_supported (MMBaseBearer *_self)
+{
+    MMBearerQmi *self = MM_BEARER_QMI (_self);
+
+    /* Polling explicitly requested, e.g. if the modem doesn't reliably
+     * report disconnections */
+    if (connection_status_polling_enabled (self))
+        return FALSE;
+
+    /* Disconnections are reported via WDS packet service status indications
+     * in each of the clients used in the connection */
+    if (!self->priv->client_ipv4 && !self->priv->client_ipv6)
+        return FALSE;
+    if (self->priv->client_ipv4 && !self->priv->packet_service_status_ipv4_indication_id)
+        return FALSE;
+    if (self->priv->client_ipv6 && !self->priv->packet_service_status_ipv6_indication_id)
+        return FALSE;
+    return TRUE;
+}
+
 static void
 load_connection_status (MMBaseBearer        *_self,
                         GAsyncReadyCallback  callback,
@@ -428,16 +468,8 @@ load_connection_status (MMBaseBearer        *_self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
-    /* Connection status polling is an optional feature that must be
-     * enabled explicitly via udev tags. If not set, out as unsupported.
-     * Note that when connected via a muxed link, the udev tag should be
-     * checked on the main interface (lower device) */
-    if ((self->priv->data &&
-         !mm_kernel_device_get_global_property_as_boolean (mm_port_peek_kernel_device (self->priv->data),
-                                                           "ID_MM_QMI_CONNECTION_STATUS_POLLING_ENABLE")) ||
-        (self->priv->link &&
-         !mm_kernel_device_get_global_property_as_boolean (mm_kernel_device_peek_lower_device (mm_port_peek_kernel_device (self->priv->link)),
-                                                           "ID_MM_QMI_CONNECTION_STATUS_POLLING_ENABLE"))) {
+    /* If polling not explicitly enabled, out as unsupported */
+    if (!connection_status_polling_enabled (self)) {
         g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED,
                                  "Connection status polling not required");
         g_object_unref (task);
@@ -1934,6 +1966,8 @@ connect_context_step (GTask *task)
 
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "bearer-qmi-connect", ctx->step, CONNECT_STEP_LAST);
+
     switch (ctx->step) {
     case CONNECT_STEP_FIRST:
         ctx->step++;
@@ -2974,6 +3008,7 @@ mm_bearer_qmi_class_init (MMBearerQmiClass *klass)
     base_bearer_class->reload_stats_finish = reload_stats_finish;
     base_bearer_class->load_connection_status = load_connection_status;
     base_bearer_class->load_connection_status_finish = load_connection_status_finish;
+    base_bearer_class->connection_status_indications_supported = connection_status_indications_supported;
 #if defined WITH_SUSPEND_RESUME
     base_bearer_class->reload_connection_status = reload_connection_status;
     base_bearer_class->reload_connection_status_finish = reload_connection_status_finish;
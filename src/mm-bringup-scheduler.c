@@ -0,0 +1,333 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include <ModemManager.h>
+#include <mm-errors-types.h>
+
+#include "mm-context.h"
+#include "mm-log-object.h"
+#include "mm-utils.h"
+#include "mm-bringup-scheduler.h"
+
+struct _MMBringupScheduler {
+    GObject parent;
+    /* Max slots per group, 0 if unlimited */
+    guint       limit;
+    /* Group name -> Group */
+    GHashTable *groups;
+};
+
+struct _MMBringupSchedulerClass {
+    GObjectClass parent_class;
+};
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_EXTENDED (MMBringupScheduler, mm_bringup_scheduler, G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+/*****************************************************************************/
+
+typedef struct {
+    guint   running;
+    /* List of GTasks waiting for a slot, prioritized ones first */
+    GQueue *waiting;
+} Group;
+
+static void
+group_free (Group *group)
+{
+    g_assert (g_queue_is_empty (group->waiting));
+    g_queue_free (group->waiting);
+    g_slice_free (Group, group);
+}
+
+typedef struct {
+    gchar        *group;
+    gboolean      prioritized;
+    GCancellable *cancellable;
+    gulong        cancellable_id;
+} Waiter;
+
+static void
+waiter_free (Waiter *waiter)
+{
+    g_assert (!waiter->cancellable_id);
+    g_clear_object (&waiter->cancellable);
+    g_free (waiter->group);
+    g_slice_free (Waiter, waiter);
+}
+
+static void
+waiter_disconnect (Waiter *waiter)
+{
+    if (waiter->cancellable_id) {
+        g_cancellable_disconnect (waiter->cancellable, waiter->cancellable_id);
+        waiter->cancellable_id = 0;
+    }
+}
+
+/*****************************************************************************/
+
+gboolean
+mm_bringup_scheduler_is_enabled (MMBringupScheduler *self)
+{
+    return (self->limit > 0);
+}
+
+gchar *
+mm_bringup_scheduler_build_group (MMKernelDevice *kernel_device)
+{
+    const gchar *physdev_sysfs_path;
+
+    /* Only USB devices share the hub bandwidth and the per-hub enumeration
+     * work; the parent of the physical device sysfs path is the hub (or the
+     * root hub of the bus) the device is connected to. */
+    if (g_strcmp0 (mm_kernel_device_get_physdev_subsystem (kernel_device), "usb") != 0)
+        return NULL;
+
+    physdev_sysfs_path = mm_kernel_device_get_physdev_sysfs_path (kernel_device);
+    if (!physdev_sysfs_path)
+        return NULL;
+
+    return g_path_get_dirname (physdev_sysfs_path);
+}
+
+/*****************************************************************************/
+
+static void
+group_dispatch (MMBringupScheduler *self,
+                const gchar        *group_name,
+                Group              *group)
+{
+    while (group->running < self->limit && !g_queue_is_empty (group->waiting)) {
+        GTask  *task;
+        Waiter *waiter;
+
+        task = g_queue_pop_head (group->waiting);
+        waiter = g_task_get_task_data (task);
+        waiter_disconnect (waiter);
+
+        group->running++;
+        mm_obj_dbg (self, "[%s] bring-up slot granted (%u/%u running, %u waiting)",
+                    group_name, group->running, self->limit, g_queue_get_length (group->waiting));
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+    }
+
+    if (!group->running && g_queue_is_empty (group->waiting))
+        g_hash_table_remove (self->groups, group_name);
+}
+
+gboolean
+mm_bringup_scheduler_acquire_finish (MMBringupScheduler  *self,
+                                     GAsyncResult        *res,
+                                     GError             **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static gboolean
+waiter_cancelled_idle (GTask *task)
+{
+    MMBringupScheduler *self;
+    Waiter             *waiter;
+    Group              *group;
+
+    self = g_task_get_source_object (task);
+    waiter = g_task_get_task_data (task);
+
+    /* If no longer waiting, the slot was already granted, or the request
+     * was aborted when disposing */
+    group = self->groups ? g_hash_table_lookup (self->groups, waiter->group) : NULL;
+    if (group && g_queue_remove (group->waiting, task)) {
+        waiter_disconnect (waiter);
+        mm_obj_dbg (self, "[%s] bring-up slot request cancelled", waiter->group);
+        g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                                 "Bring-up slot request cancelled");
+        g_object_unref (task);
+        group_dispatch (self, waiter->group, group);
+    }
+
+    g_object_unref (task);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+waiter_cancelled_cb (GCancellable *cancellable,
+                     GTask        *task)
+{
+    /* Cannot disconnect from within the handler, so defer */
+    g_idle_add ((GSourceFunc) waiter_cancelled_idle, g_object_ref (task));
+}
+
+void
+mm_bringup_scheduler_acquire (MMBringupScheduler  *self,
+                              const gchar         *group_name,
+                              gboolean             prioritized,
+                              GCancellable        *cancellable,
+                              GAsyncReadyCallback  callback,
+                              gpointer             user_data)
+{
+    GTask  *task;
+    Waiter *waiter;
+    Group  *group;
+    GList  *l;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    if (!self->limit || !group_name) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    if (!self->groups) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_ABORTED,
+                                 "Bring-up scheduler disposed");
+        g_object_unref (task);
+        return;
+    }
+
+    group = g_hash_table_lookup (self->groups, group_name);
+    if (!group) {
+        group = g_slice_new0 (Group);
+        group->waiting = g_queue_new ();
+        g_hash_table_insert (self->groups, g_strdup (group_name), group);
+    }
+
+    if (group->running < self->limit) {
+        group->running++;
+        mm_obj_dbg (self, "[%s] bring-up slot granted (%u/%u running)",
+                    group_name, group->running, self->limit);
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    waiter = g_slice_new0 (Waiter);
+    waiter->group = g_strdup (group_name);
+    waiter->prioritized = prioritized;
+    g_task_set_task_data (task, waiter, (GDestroyNotify) waiter_free);
+
+    /* Prioritized requests go after other prioritized ones, but before all
+     * the regular ones */
+    for (l = prioritized ? group->waiting->head : NULL; l; l = g_list_next (l)) {
+        if (!((Waiter *) g_task_get_task_data (G_TASK (l->data)))->prioritized)
+            break;
+    }
+    if (l)
+        g_queue_insert_before (group->waiting, l, task);
+    else
+        g_queue_push_tail (group->waiting, task);
+
+    mm_obj_dbg (self, "[%s] %sbring-up slot request queued (%u/%u running, %u waiting)",
+                group_name, prioritized ? "prioritized " : "",
+                group->running, self->limit, g_queue_get_length (group->waiting));
+
+    if (cancellable) {
+        waiter->cancellable = g_object_ref (cancellable);
+        waiter->cancellable_id = g_cancellable_connect (cancellable,
+                                                        G_CALLBACK (waiter_cancelled_cb),
+                                                        task,
+                                                        NULL);
+    }
+}
+
+void
+mm_bringup_scheduler_release (MMBringupScheduler *self,
+                              const gchar        *group_name)
+{
+    Group *group;
+
+    if (!self->limit || !group_name || !self->groups)
+        return;
+
+    group = g_hash_table_lookup (self->groups, group_name);
+    g_assert (group && group->running > 0);
+    group->running--;
+    mm_obj_dbg (self, "[%s] bring-up slot released (%u/%u running)",
+                group_name, group->running, self->limit);
+    group_dispatch (self, group_name, group);
+}
+
+/*****************************************************************************/
+
+static gchar *
+log_object_build_id (MMLogObject *_self)
+{
+    return g_strdup ("bringup-scheduler");
+}
+
+/*****************************************************************************/
+
+static void
+mm_bringup_scheduler_init (MMBringupScheduler *self)
+{
+    self->limit = mm_context_get_bringup_limit ();
+    self->groups = g_hash_table_new_full (g_str_hash,
+                                          g_str_equal,
+                                          g_free,
+                                          (GDestroyNotify) group_free);
+}
+
+static void
+dispose (GObject *object)
+{
+    MMBringupScheduler *self = MM_BRINGUP_SCHEDULER (object);
+    GQueue              waiting = G_QUEUE_INIT;
+    GTask              *task;
+
+    /* Abort all the waiters right away; the cancellation of a waiter runs
+     * in an idle, so it may not have removed it from its group yet */
+    if (self->groups) {
+        GHashTableIter  iter;
+        Group          *group;
+
+        g_hash_table_iter_init (&iter, self->groups);
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &group)) {
+            while ((task = g_queue_pop_head (group->waiting)) != NULL)
+                g_queue_push_tail (&waiting, task);
+        }
+        g_clear_pointer (&self->groups, g_hash_table_unref);
+    }
+
+    /* Complete them only once the groups are gone, as the callbacks may
+     * call back into the scheduler */
+    while ((task = g_queue_pop_head (&waiting)) != NULL) {
+        waiter_disconnect (g_task_get_task_data (task));
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_ABORTED,
+                                 "Bring-up scheduler disposed");
+        g_object_unref (task);
+    }
+
+    G_OBJECT_CLASS (mm_bringup_scheduler_parent_class)->dispose (object);
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+mm_bringup_scheduler_class_init (MMBringupSchedulerClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->dispose = dispose;
+}
+
+MM_DEFINE_SINGLETON_GETTER (MMBringupScheduler, mm_bringup_scheduler_get, MM_TYPE_BRINGUP_SCHEDULER);
@@ -0,0 +1,63 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_BRINGUP_SCHEDULER_H
+#define MM_BRINGUP_SCHEDULER_H
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include "mm-kernel-device.h"
+
+G_BEGIN_DECLS
+
+#define MM_TYPE_BRINGUP_SCHEDULER         (mm_bringup_scheduler_get_type ())
+#define MM_BRINGUP_SCHEDULER(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), MM_TYPE_BRINGUP_SCHEDULER, MMBringupScheduler))
+#define MM_BRINGUP_SCHEDULER_CLASS(k)     (G_TYPE_CHECK_CLASS_CAST ((k), MM_TYPE_BRINGUP_SCHEDULER, MMBringupSchedulerClass))
+#define MM_BRINGUP_SCHEDULER_GET_CLASS(o) (G_TYPE_INSTANCE_GET_CLASS ((o), MM_TYPE_BRINGUP_SCHEDULER, MMBringupSchedulerClass))
+#define MM_IS_BRINGUP_SCHEDULER(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), MM_TYPE_BRINGUP_SCHEDULER))
+#define MM_IS_BRINGUP_SCHEDULER_CLASS(k)  (G_TYPE_CHECK_CLASS_TYPE ((k), MM_TYPE_BRINGUP_SCHEDULER))
+
+typedef struct _MMBringupScheduler      MMBringupScheduler;
+typedef struct _MMBringupSchedulerClass MMBringupSchedulerClass;
+
+GType               mm_bringup_scheduler_get_type (void) G_GNUC_CONST;
+MMBringupScheduler *mm_bringup_scheduler_get      (void);
+
+/* Whether a limit of concurrent bring-ups was configured */
+gboolean mm_bringup_scheduler_is_enabled (MMBringupScheduler *self);
+
+/* Devices behind the same USB hub share the same group; NULL if the device
+ * bring-up doesn't need to be throttled. */
+gchar *mm_bringup_scheduler_build_group (MMKernelDevice *kernel_device);
+
+/* Request a bring-up slot in the given group. Prioritized requests are served
+ * before any other pending one. The operation only fails if cancelled while
+ * waiting or if the scheduler is disposed, in which case no slot is held. */
+void     mm_bringup_scheduler_acquire        (MMBringupScheduler   *self,
+                                              const gchar          *group,
+                                              gboolean              prioritized,
+                                              GCancellable         *cancellable,
+                                              GAsyncReadyCallback   callback,
+                                              gpointer              user_data);
+gboolean mm_bringup_scheduler_acquire_finish (MMBringupScheduler   *self,
+                                              GAsyncResult         *res,
+                                              GError              **error);
+
+/* Release a slot previously acquired in the given group */
+void     mm_bringup_scheduler_release        (MMBringupScheduler   *self,
+                                              const gchar          *group);
+
+G_END_DECLS
+
+#endif /* MM_BRINGUP_SCHEDULER_H */
@@ -34,6 +34,7 @@
 #include "mm-iface-modem-cdma.h"
 #include "mm-base-modem-at.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-modem-helpers.h"
 #include "mm-port-enums-types.h"
 #include "mm-helper-enums-types.h"
@@ -1315,15 +1316,16 @@ data_flash_3gpp_ready (MMPortSerial *data,
     else
         mm_obj_dbg (self, "sending PDP context deactivation in primary port again...");
 
-    mm_base_modem_at_command_full (ctx->modem,
-                                   ctx->primary,
-                                   ctx->cgact_command,
-                                   10,
-                                   FALSE,
-                                   FALSE, /* raw */
-                                   NULL, /* cancellable */
-                                   (GAsyncReadyCallback)cgact_data_ready,
-                                   task);
+    mm_base_modem_at_command_full_with_priority (ctx->modem,
+                                                 ctx->primary,
+                                                 ctx->cgact_command,
+                                                 10,
+                                                 FALSE,
+                                                 FALSE, /* raw */
+                                                 MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL,
+                                                 NULL, /* cancellable */
+                                                 (GAsyncReadyCallback)cgact_data_ready,
+                                                 task);
 }
 
 static void
@@ -1432,15 +1434,16 @@ disconnect_3gpp (MMBroadbandBearer *self,
      * we'll send CGACT there */
     if (!mm_port_get_connected (MM_PORT (ctx->primary))) {
         mm_obj_dbg (self, "sending PDP context deactivation in primary port...");
-        mm_base_modem_at_command_full (ctx->modem,
-                                       ctx->primary,
-                                       ctx->cgact_command,
-                                       45,
-                                       FALSE,
-                                       FALSE, /* raw */
-                                       NULL, /* cancellable */
-                                       (GAsyncReadyCallback)cgact_ready,
-                                       task);
+        mm_base_modem_at_command_full_with_priority (ctx->modem,
+                                                     ctx->primary,
+                                                     ctx->cgact_command,
+                                                     45,
+                                                     FALSE,
+                                                     FALSE, /* raw */
+                                                     MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL,
+                                                     NULL, /* cancellable */
+                                                     (GAsyncReadyCallback)cgact_ready,
+                                                     task);
         return;
     }
 
@@ -1451,15 +1454,16 @@ disconnect_3gpp (MMBroadbandBearer *self,
      */
     if (ctx->secondary) {
         mm_obj_dbg (self, "sending PDP context deactivation in secondary port...");
-        mm_base_modem_at_command_full (ctx->modem,
-                                       ctx->secondary,
-                                       ctx->cgact_command,
-                                       45,
-                                       FALSE,
-                                       FALSE, /* raw */
-                                       NULL, /* cancellable */
-                                       (GAsyncReadyCallback)cgact_ready,
-                                       task);
+        mm_base_modem_at_command_full_with_priority (ctx->modem,
+                                                     ctx->secondary,
+                                                     ctx->cgact_command,
+                                                     45,
+                                                     FALSE,
+                                                     FALSE, /* raw */
+                                                     MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL,
+                                                     NULL, /* cancellable */
+                                                     (GAsyncReadyCallback)cgact_ready,
+                                                     task);
         return;
     }
 
@@ -1670,6 +1674,23 @@ cgact_periodic_query_ready (MMBaseModem  *modem,
     g_object_unref (task);
 }
 
+static gboolean
+connection_status_indications_supported (MMBaseBearer *self)
+{
+    g_autoptr(MMBaseModem) modem = NULL;
+
+    /* +CGEV indications are only applicable to 3GPP */
+    if (MM_BROADBAND_BEARER (self)->priv->connection_type != CONNECTION_TYPE_3GPP)
+        return FALSE;
+
+    g_object_get (self,
+                  MM_BASE_BEARER_MODEM, &modem,
+                  NULL);
+
+    return (MM_IS_BROADBAND_MODEM (modem) &&
+            mm_broadband_modem_get_cgev_enabled (MM_BROADBAND_MODEM (modem)));
+}
+
 static void
 load_connection_status (MMBaseBearer        *self,
                         GAsyncReadyCallback  callback,
@@ -1710,15 +1731,16 @@ load_connection_status (MMBaseBearer        *self,
         goto out;
     }
 
-    mm_base_modem_at_command_full (MM_BASE_MODEM (modem),
-                                   port,
-                                   "+CGACT?",
-                                   3,
-                                   FALSE, /* allow cached */
-                                   FALSE, /* raw */
-                                   NULL, /* cancellable */
-                                   (GAsyncReadyCallback) cgact_periodic_query_ready,
-                                   task);
+    mm_base_modem_at_command_full_with_priority (MM_BASE_MODEM (modem),
+                                                 port,
+                                                 "+CGACT?",
+                                                 3,
+                                                 FALSE, /* allow cached */
+                                                 FALSE, /* raw */
+                                                 MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL,
+                                                 NULL, /* cancellable */
+                                                 (GAsyncReadyCallback) cgact_periodic_query_ready,
+                                                 task);
 
 out:
     g_clear_object (&modem);
@@ -1856,6 +1878,8 @@ interface_initialization_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "bearer-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         ctx->step++;
@@ -2048,6 +2072,7 @@ mm_broadband_bearer_class_init (MMBroadbandBearerClass *klass)
     base_bearer_class->report_connection_status = report_connection_status;
     base_bearer_class->load_connection_status = load_connection_status;
     base_bearer_class->load_connection_status_finish = load_connection_status_finish;
+    base_bearer_class->connection_status_indications_supported = connection_status_indications_supported;
 #if defined WITH_SUSPEND_RESUME
     base_bearer_class->reload_connection_status = load_connection_status;
     base_bearer_class->reload_connection_status_finish = load_connection_status_finish;
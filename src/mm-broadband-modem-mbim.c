@@ -2828,6 +2828,46 @@ enabling_started_finish (MMBroadbandModem *self,
     return g_task_propagate_boolean (G_TASK (res), error);
 }
 
+static void
+preallocate_links_ready (MMPortMbim           *mbim,
+                         GAsyncResult         *res,
+                         MMBroadbandModemMbim *self)
+{
+    g_autoptr(GError) error = NULL;
+
+    if (!mm_port_mbim_preallocate_links_finish (mbim, res, &error))
+        mm_obj_dbg (self, "multiplexed links not preallocated: %s", error->message);
+    g_object_unref (self);
+}
+
+static void
+preallocate_links (MMBroadbandModemMbim *self)
+{
+    MMPort           *data;
+    MMPortMbim       *mbim;
+    g_autofree gchar *link_prefix_hint = NULL;
+
+    data = mm_base_modem_peek_best_data_port (MM_BASE_MODEM (self), MM_PORT_TYPE_NET);
+    if (!data)
+        return;
+
+    /* No multiplexing support in mhi_net */
+    if (!g_strcmp0 (mm_kernel_device_get_driver (mm_port_peek_kernel_device (data)), "mhi_net"))
+        return;
+
+    mbim = mm_broadband_modem_mbim_peek_port_mbim_for_data (self, data, NULL);
+    if (!mbim)
+        return;
+
+    /* Same link prefix as the one used by the bearers */
+    link_prefix_hint = g_strdup_printf ("mbimmux%u.", mm_base_modem_get_dbus_id (MM_BASE_MODEM (self)));
+    mm_port_mbim_preallocate_links (mbim,
+                                    data,
+                                    link_prefix_hint,
+                                    (GAsyncReadyCallback) preallocate_links_ready,
+                                    g_object_ref (self));
+}
+
 static void
 parent_enabling_started_ready (MMBroadbandModem *self,
                                GAsyncResult *res,
@@ -2845,6 +2885,9 @@ parent_enabling_started_ready (MMBroadbandModem *self,
         g_error_free (error);
     }
 
+    /* Multiplexed links are ready before the first connection attempt */
+    preallocate_links (MM_BROADBAND_MODEM_MBIM (self));
+
     g_task_return_boolean (task, TRUE);
     g_object_unref (task);
 }
@@ -5496,9 +5539,12 @@ subscribe_list_set_ready_cb (MbimDevice *device,
                              GAsyncResult *res,
                              GTask *task)
 {
+    MMBroadbandModemMbim *self;
     MbimMessage *response;
     GError *error = NULL;
 
+    self = g_task_get_source_object (task);
+
     response = mbim_device_command_finish (device, res, &error);
     if (response) {
         mbim_message_response_get_result (response, MBIM_MESSAGE_TYPE_COMMAND_DONE, &error);
@@ -5507,8 +5553,13 @@ subscribe_list_set_ready_cb (MbimDevice *device,
 
     if (error)
         g_task_return_error (task, error);
-    else
+    else {
+        /* Signal state notifications are both subscribed and processed */
+        mm_iface_modem_set_signal_quality_indications (MM_IFACE_MODEM (self),
+                                                       (self->priv->enable_flags & PROCESS_NOTIFICATION_FLAG_SIGNAL_QUALITY) &&
+                                                       (self->priv->setup_flags & PROCESS_NOTIFICATION_FLAG_SIGNAL_QUALITY));
         g_task_return_boolean (task, TRUE);
+    }
     g_object_unref (task);
 }
 
@@ -9083,7 +9134,7 @@ mm_broadband_modem_mbim_new (const gchar *device,
                          MM_BASE_MODEM_DATA_NET_SUPPORTED, TRUE,
                          MM_BASE_MODEM_DATA_TTY_SUPPORTED, FALSE,
                          MM_IFACE_MODEM_SIM_HOT_SWAP_SUPPORTED, TRUE,
-                         MM_IFACE_MODEM_PERIODIC_SIGNAL_CHECK_DISABLED, TRUE,
+                         MM_IFACE_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN, 100,
                          NULL);
 }
 
@@ -27,6 +27,7 @@
 #include "mm-broadband-modem-qmi.h"
 
 #include "ModemManager.h"
+#include <ModemManager-tags.h>
 #include "mm-log.h"
 #include "mm-errors-types.h"
 #include "mm-modem-helpers.h"
@@ -5728,14 +5729,15 @@ ser_signal_strength_ready (QmiClientNas *client,
 
     output = qmi_client_nas_set_event_report_finish (client, res, &error);
     if (!output || !qmi_message_nas_set_event_report_output_get_result (output, &error))
-        mm_obj_dbg (self, "couldn't enable signal strength indications: '%s'", error->message);
+        mm_obj_dbg (self, "couldn't %s signal strength indications: '%s'", ctx->enable ? "enable" : "disable", error->message);
     else {
-        /* Disable access technology and signal quality polling if we can use the indications */
-        mm_obj_dbg (self, "signal strength indications enabled: polling disabled");
+        /* Disable access technology polling if we can use the indications; signal
+         * quality polling stays enabled, but only runs if the indications go stale */
+        mm_obj_dbg (self, "signal strength indications %s", ctx->enable ? "enabled" : "disabled");
         g_object_set (self,
-                      MM_IFACE_MODEM_PERIODIC_SIGNAL_CHECK_DISABLED,      TRUE,
-                      MM_IFACE_MODEM_PERIODIC_ACCESS_TECH_CHECK_DISABLED, TRUE,
+                      MM_IFACE_MODEM_PERIODIC_ACCESS_TECH_CHECK_DISABLED, ctx->enable,
                       NULL);
+        mm_iface_modem_set_signal_quality_indications (MM_IFACE_MODEM (self), ctx->enable);
     }
 
     if (!ctx->client_wds) {
@@ -5807,12 +5809,13 @@ ri_signal_info_ready (QmiClientNas *client,
         g_clear_error (&error);
         return;
     } else {
-        /* Disable access technology and signal quality polling if we can use the indications */
-        mm_obj_dbg (self, "signal info indications enabled: polling disabled");
+        /* Disable access technology polling if we can use the indications; signal
+         * quality polling stays enabled, but only runs if the indications go stale */
+        mm_obj_dbg (self, "signal info indications %s", ctx->enable ? "enabled" : "disabled");
         g_object_set (self,
-                      MM_IFACE_MODEM_PERIODIC_SIGNAL_CHECK_DISABLED,      TRUE,
-                      MM_IFACE_MODEM_PERIODIC_ACCESS_TECH_CHECK_DISABLED, TRUE,
+                      MM_IFACE_MODEM_PERIODIC_ACCESS_TECH_CHECK_DISABLED, ctx->enable,
                       NULL);
+        mm_iface_modem_set_signal_quality_indications (MM_IFACE_MODEM (self), ctx->enable);
     }
 
     if (!ctx->client_wds) {
@@ -5912,6 +5915,7 @@ common_enable_disable_unsolicited_events_signal_info_config (GTask *task)
 {
     EnableUnsolicitedEventsContext                  *ctx;
     g_autoptr(QmiMessageNasConfigSignalInfoV2Input)  input = NULL;
+    MMPort                                          *port;
     guint                                            delta;
 
     ctx = g_task_get_task_data (task);
@@ -5922,8 +5926,18 @@ common_enable_disable_unsolicited_events_signal_info_config (GTask *task)
         return;
     }
 
-    /* delta in units of 0.1dBm */
+    /* delta in units of 0.1dBm, may be tuned per device (e.g. to get
+     * updates on smaller changes) */
     delta = default_rssi_delta_dbm * 10;
+    port = MM_PORT (mm_broadband_modem_qmi_peek_port_qmi (MM_BROADBAND_MODEM_QMI (g_task_get_source_object (task))));
+    if (port && mm_port_peek_kernel_device (port) &&
+        mm_kernel_device_has_global_property (mm_port_peek_kernel_device (port), ID_MM_SIGNAL_QUALITY_RSSI_DELTA)) {
+        gint delta_dbm;
+
+        delta_dbm = mm_kernel_device_get_global_property_as_int (mm_port_peek_kernel_device (port), ID_MM_SIGNAL_QUALITY_RSSI_DELTA);
+        if (delta_dbm > 0)
+            delta = delta_dbm * 10;
+    }
     input = qmi_message_nas_config_signal_info_v2_input_new ();
     qmi_message_nas_config_signal_info_v2_input_set_cdma_rssi_delta (input, delta, NULL);
     qmi_message_nas_config_signal_info_v2_input_set_hdr_rssi_delta (input, delta, NULL);
@@ -13115,6 +13129,44 @@ wds_get_autoconnect_settings_ready (QmiClientWds *client,
                                              task);
 }
 
+static void
+preallocate_links_ready (MMPortQmi           *qmi,
+                         GAsyncResult        *res,
+                         MMBroadbandModemQmi *self)
+{
+    g_autoptr(GError) error = NULL;
+
+    if (!mm_port_qmi_preallocate_links_finish (qmi, res, &error))
+        mm_obj_dbg (self, "multiplexed links not preallocated: %s", error->message);
+    g_object_unref (self);
+}
+
+static void
+preallocate_links (MMBroadbandModemQmi *self)
+{
+    MMPort           *data;
+    MMPortQmi        *qmi;
+    g_autofree gchar *link_prefix_hint = NULL;
+
+    data = mm_base_modem_peek_best_data_port (MM_BASE_MODEM (self), MM_PORT_TYPE_NET);
+    if (!data)
+        return;
+
+    qmi = mm_broadband_modem_qmi_peek_port_qmi_for_data (self, data, NULL, NULL);
+    if (!qmi)
+        return;
+
+    /* Same link prefix as the one used by the bearers. The pool is created in
+     * the background, if the data format isn't set up yet it will be created
+     * on the first multiplexed connection attempt instead. */
+    link_prefix_hint = g_strdup_printf ("qmapmux%u.", mm_base_modem_get_dbus_id (MM_BASE_MODEM (self)));
+    mm_port_qmi_preallocate_links (qmi,
+                                   data,
+                                   link_prefix_hint,
+                                   (GAsyncReadyCallback) preallocate_links_ready,
+                                   g_object_ref (self));
+}
+
 static void
 parent_enabling_started_ready (MMBroadbandModem *_self,
                                GAsyncResult     *res,
@@ -13130,6 +13182,9 @@ parent_enabling_started_ready (MMBroadbandModem *_self,
         mm_obj_dbg (self, "couldn't start parent enabling: %s", error->message);
     }
 
+    /* Multiplexed links are ready before the first connection attempt */
+    preallocate_links (self);
+
     /* If the autoconnect check has already been done, we're finished */
     if (self->priv->autoconnect_checked) {
         g_task_return_boolean (task, TRUE);
@@ -13520,6 +13575,7 @@ mm_broadband_modem_qmi_new (const gchar *device,
                          MM_BASE_MODEM_DATA_NET_SUPPORTED, TRUE,
                          MM_BASE_MODEM_DATA_TTY_SUPPORTED, FALSE,
                          MM_IFACE_MODEM_SIM_HOT_SWAP_SUPPORTED, TRUE,
+                         MM_IFACE_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN, 100,
                          NULL);
 }
 
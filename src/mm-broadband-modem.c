@@ -52,6 +52,7 @@
 #include "mm-call-list.h"
 #include "mm-base-sim.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-port-serial-qcdm.h"
@@ -135,6 +136,7 @@ enum {
     PROP_MODEM_PERIODIC_ACCESS_TECH_CHECK_DISABLED,
     PROP_MODEM_PERIODIC_CALL_LIST_CHECK_DISABLED,
     PROP_MODEM_INDICATION_CALL_LIST_RELOAD_ENABLED,
+    PROP_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN,
     PROP_MODEM_CARRIER_CONFIG_MAPPING,
     PROP_MODEM_FIRMWARE_IGNORE_CARRIER,
     PROP_FLOW_CONTROL,
@@ -194,6 +196,7 @@ struct _MMBroadbandModemPrivate {
     MM3gppCmerInd modem_cmer_ind;
     gboolean modem_cgerep_support_checked;
     gboolean modem_cgerep_supported;
+    gboolean modem_cgerep_enabled;
     MMFlowControl flow_control;
 
     /*<--- Modem 3GPP interface --->*/
@@ -273,6 +276,7 @@ struct _MMBroadbandModemPrivate {
     /*<--- Modem Signal interface --->*/
     /* Properties */
     GObject *modem_signal_dbus_skeleton;
+    guint    modem_signal_sampling_interval_min;
 
     /*<--- Modem OMA interface --->*/
     /* Properties */
@@ -2172,8 +2176,8 @@ signal_quality_csq_ready (MMBroadbandModem *self,
  * try the other command if the first one fails.
  */
 static const MMBaseModemAtCommand signal_quality_csq_sequence[] = {
-    { "+CSQ",  3, FALSE, mm_base_modem_response_processor_string_ignore_at_errors },
-    { "+CSQ?", 3, FALSE, mm_base_modem_response_processor_string_ignore_at_errors },
+    { "+CSQ",  3, FALSE, mm_base_modem_response_processor_string_ignore_at_errors, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND },
+    { "+CSQ?", 3, FALSE, mm_base_modem_response_processor_string_ignore_at_errors, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND },
     { NULL }
 };
 
@@ -2282,15 +2286,16 @@ signal_quality_cind (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
-    mm_base_modem_at_command_full (MM_BASE_MODEM (self),
-                                   MM_PORT_SERIAL_AT (ctx->at_port),
-                                   "+CIND?",
-                                   5,
-                                   FALSE,
-                                   FALSE, /* raw */
-                                   NULL, /* cancellable */
-                                   (GAsyncReadyCallback)signal_quality_cind_ready,
-                                   task);
+    mm_base_modem_at_command_full_with_priority (MM_BASE_MODEM (self),
+                                                 MM_PORT_SERIAL_AT (ctx->at_port),
+                                                 "+CIND?",
+                                                 5,
+                                                 FALSE,
+                                                 FALSE, /* raw */
+                                                 MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND,
+                                                 NULL, /* cancellable */
+                                                 (GAsyncReadyCallback)signal_quality_cind_ready,
+                                                 task);
 }
 
 static void
@@ -2407,8 +2412,9 @@ modem_load_signal_quality (MMIfaceModem *_self,
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)signal_quality_context_free);
 
-    /* Check whether we can get a non-connected AT port */
-    ctx->at_port = (MMPortSerial *)mm_base_modem_get_best_at_port (MM_BASE_MODEM (self), &error);
+    /* Check whether we can get a non-connected AT port; signal quality
+     * queries don't depend on the port state, so use the least busy one */
+    ctx->at_port = (MMPortSerial *)mm_base_modem_get_least_busy_at_port (MM_BASE_MODEM (self), &error);
     if (ctx->at_port) {
         if (!self->priv->modem_cind_disabled &&
             self->priv->modem_cind_supported &&
@@ -3512,6 +3518,12 @@ modem_3gpp_cleanup_unsolicited_events (MMIfaceModem3gpp    *_self,
 /*****************************************************************************/
 /* Enabling/disabling unsolicited events (3GPP interface) */
 
+gboolean
+mm_broadband_modem_get_cgev_enabled (MMBroadbandModem *self)
+{
+    return self->priv->modem_cgerep_enabled;
+}
+
 typedef struct {
     gboolean        enable;
     MMPortSerialAt *primary;
@@ -3522,6 +3534,7 @@ typedef struct {
     gchar          *cgerep_command;
     gboolean        cgerep_primary_done;
     gboolean        cgerep_secondary_done;
+    const gchar    *running_command;
 } UnsolicitedEventsContext;
 
 static void
@@ -3561,6 +3574,13 @@ unsolicited_events_setup_ready (MMBroadbandModem *self,
                     ctx->enable ? "enable" : "disable",
                     error->message);
         g_error_free (error);
+    } else if (ctx->running_command == ctx->cgerep_command) {
+        /* Keep track of whether bearer disconnections are reported via +CGEV */
+        self->priv->modem_cgerep_enabled = ctx->enable;
+    } else if (ctx->running_command == ctx->cmer_command &&
+               CIND_INDICATOR_IS_VALID (self->priv->modem_cind_indicator_signal_quality)) {
+        /* Signal quality reported via +CIEV */
+        mm_iface_modem_set_signal_quality_indications (MM_IFACE_MODEM (self), ctx->enable);
     }
 
     /* Continue on next port/command */
@@ -3609,6 +3629,7 @@ run_unsolicited_events_setup (GTask *task)
 
     /* Enable unsolicited events in given port */
     if (port && command) {
+        ctx->running_command = command;
         mm_base_modem_at_command_full (MM_BASE_MODEM (self),
                                        port,
                                        command,
@@ -4965,12 +4986,14 @@ modem_3gpp_scan_networks (MMIfaceModem3gpp *self,
                           GAsyncReadyCallback callback,
                           gpointer user_data)
 {
-    mm_base_modem_at_command (MM_BASE_MODEM (self),
-                              "+COPS=?",
-                              300,
-                              FALSE,
-                              callback,
-                              user_data);
+    /* Long running scan, may be aborted to run critical commands */
+    mm_base_modem_at_command_with_priority (MM_BASE_MODEM (self),
+                                            "+COPS=?",
+                                            300,
+                                            FALSE,
+                                            MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND,
+                                            callback,
+                                            user_data);
 }
 
 /*****************************************************************************/
@@ -5100,10 +5123,6 @@ typedef struct {
     gboolean is_ps_supported;
     gboolean is_eps_supported;
     gboolean is_5gs_supported;
-    gboolean run_cs;
-    gboolean run_ps;
-    gboolean run_eps;
-    gboolean run_5gs;
     gboolean running_cs;
     gboolean running_ps;
     gboolean running_eps;
@@ -5112,6 +5131,9 @@ typedef struct {
     GError *error_ps;
     GError *error_eps;
     GError *error_5gs;
+    /* One query per supported domain. These have no side effects, so they
+     * can go in the same command line if the port supports it. */
+    MMBaseModemAtCommand sequence[5];
 } RunRegistrationChecksContext;
 
 static void
@@ -5132,8 +5154,6 @@ modem_3gpp_run_registration_checks_finish (MMIfaceModem3gpp  *self,
     return g_task_propagate_boolean (G_TASK (res), error);
 }
 
-static void run_registration_checks_context_step (GTask *task);
-
 static void
 run_registration_checks_context_set_error (RunRegistrationChecksContext *ctx,
                                            GError                       *error)
@@ -5151,14 +5171,18 @@ run_registration_checks_context_set_error (RunRegistrationChecksContext *ctx,
         g_assert_not_reached ();
 }
 
-static void
-registration_status_check_ready (MMBroadbandModem *self,
-                                 GAsyncResult     *res,
-                                 GTask            *task)
-{
+static MMBaseModemAtResponseProcessorResult
+registration_status_check_processor (MMBaseModem                   *_self,
+                                     RunRegistrationChecksContext  *ctx,
+                                     const gchar                   *command,
+                                     const gchar                   *response,
+                                     gboolean                       last_command,
+                                     const GError                  *command_error,
+                                     GVariant                     **result,
+                                     GError                       **result_error)
+{
+    MMBroadbandModem             *self = MM_BROADBAND_MODEM (_self);
     g_autoptr(GMatchInfo)         match_info = NULL;
-    RunRegistrationChecksContext *ctx;
-    const gchar                  *response;
     GError                       *error = NULL;
     guint                         i;
     gboolean                      parsed;
@@ -5171,26 +5195,26 @@ registration_status_check_ready (MMBroadbandModem *self,
     gulong                        tac = 0;
     gulong                        cid = 0;
 
-    ctx = g_task_get_task_data (task);
+    /* Errors in each check are only reported if all of them fail, so always
+     * go on with the next one */
+    ctx->running_cs  = g_str_equal (command, "+CREG?");
+    ctx->running_ps  = g_str_equal (command, "+CGREG?");
+    ctx->running_eps = g_str_equal (command, "+CEREG?");
+    ctx->running_5gs = g_str_equal (command, "+C5GREG?");
 
     /* Only one must be running */
     g_assert ((ctx->running_cs + ctx->running_ps + ctx->running_eps + ctx->running_5gs) == 1);
 
-    response = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, &error);
-    if (!response) {
-        run_registration_checks_context_set_error (ctx, error);
-        run_registration_checks_context_step (task);
-        return;
+    if (command_error) {
+        run_registration_checks_context_set_error (ctx, g_error_copy (command_error));
+        return MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
     }
 
     /* Unsolicited registration status handlers will usually process the
      * response for us, but just in case they don't, do that here.
      */
-    if (!response[0]) {
-        /* Done */
-        run_registration_checks_context_step (task);
-        return;
-    }
+    if (!response[0])
+        return MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
 
     /* Try to match the response */
     for (i = 0;
@@ -5210,8 +5234,7 @@ registration_status_check_ready (MMBroadbandModem *self,
                              "Unknown registration status response: '%s'",
                              response);
         run_registration_checks_context_set_error (ctx, error);
-        run_registration_checks_context_step (task);
-        return;
+        return MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
     }
 
     parsed = mm_3gpp_parse_creg_response (match_info,
@@ -5232,8 +5255,7 @@ registration_status_check_ready (MMBroadbandModem *self,
                                  "Error parsing registration response: '%s'",
                                  response);
         run_registration_checks_context_set_error (ctx, error);
-        run_registration_checks_context_step (task);
-        return;
+        return MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
     }
 
     /* Report new registration state and fix LAC/TAC.
@@ -5286,76 +5308,17 @@ registration_status_check_ready (MMBroadbandModem *self,
     mm_iface_modem_3gpp_update_access_technologies (MM_IFACE_MODEM_3GPP (self), act);
     mm_iface_modem_3gpp_update_location (MM_IFACE_MODEM_3GPP (self), lac, tac, cid);
 
-    run_registration_checks_context_step (task);
+    return MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
 }
 
 static void
-run_registration_checks_context_step (GTask *task)
+run_registration_checks_complete (GTask *task)
 {
-    MMBroadbandModem *self;
     RunRegistrationChecksContext *ctx;
-    GError *error = NULL;
+    GError                       *error = NULL;
 
-    self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
-    ctx->running_cs = FALSE;
-    ctx->running_ps = FALSE;
-    ctx->running_eps = FALSE;
-    ctx->running_5gs = FALSE;
-
-    if (ctx->run_cs) {
-        ctx->running_cs = TRUE;
-        ctx->run_cs = FALSE;
-        /* Check current CS-registration state. */
-        mm_base_modem_at_command (MM_BASE_MODEM (self),
-                                  "+CREG?",
-                                  10,
-                                  FALSE,
-                                  (GAsyncReadyCallback)registration_status_check_ready,
-                                  task);
-        return;
-    }
-
-    if (ctx->run_ps) {
-        ctx->running_ps = TRUE;
-        ctx->run_ps = FALSE;
-        /* Check current PS-registration state. */
-        mm_base_modem_at_command (MM_BASE_MODEM (self),
-                                  "+CGREG?",
-                                  10,
-                                  FALSE,
-                                  (GAsyncReadyCallback)registration_status_check_ready,
-                                  task);
-        return;
-    }
-
-    if (ctx->run_eps) {
-        ctx->running_eps = TRUE;
-        ctx->run_eps = FALSE;
-        /* Check current EPS-registration state. */
-        mm_base_modem_at_command (MM_BASE_MODEM (self),
-                                  "+CEREG?",
-                                  10,
-                                  FALSE,
-                                  (GAsyncReadyCallback)registration_status_check_ready,
-                                  task);
-        return;
-    }
-
-    if (ctx->run_5gs) {
-        ctx->running_5gs = TRUE;
-        ctx->run_5gs = FALSE;
-        /* Check current 5GS-registration state. */
-        mm_base_modem_at_command (MM_BASE_MODEM (self),
-                                  "+C5GREG?",
-                                  10,
-                                  FALSE,
-                                  (GAsyncReadyCallback)registration_status_check_ready,
-                                  task);
-        return;
-    }
-
     /* If all run checks returned errors we fail */
     if ((ctx->is_cs_supported || ctx->is_ps_supported || ctx->is_eps_supported || ctx->is_5gs_supported) &&
         (!ctx->is_cs_supported || ctx->error_cs) &&
@@ -5382,6 +5345,39 @@ run_registration_checks_context_step (GTask *task)
     g_object_unref (task);
 }
 
+static void
+registration_status_checks_ready (MMBaseModem  *self,
+                                  GAsyncResult *res,
+                                  GTask        *task)
+{
+    GError *error = NULL;
+
+    /* Failures of the single checks are handled by the response processor,
+     * so an error here means the sequence couldn't run at all */
+    mm_base_modem_at_sequence_finish (self, res, NULL, &error);
+    if (error) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    run_registration_checks_complete (task);
+}
+
+static void
+registration_checks_add (RunRegistrationChecksContext *ctx,
+                         guint                        *n,
+                         const gchar                  *command)
+{
+    ctx->sequence[*n].command = command;
+    ctx->sequence[*n].timeout = 10;
+    ctx->sequence[*n].allow_cached = FALSE;
+    ctx->sequence[*n].response_processor = (MMBaseModemAtResponseProcessor) registration_status_check_processor;
+    ctx->sequence[*n].allow_concatenation = TRUE;
+    ctx->sequence[*n].priority = MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND;
+    (*n)++;
+}
+
 static void
 modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
                                     gboolean             is_cs_supported,
@@ -5393,21 +5389,38 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
 {
     RunRegistrationChecksContext *ctx;
     GTask *task;
+    guint n = 0;
 
     ctx = g_new0 (RunRegistrationChecksContext, 1);
     ctx->is_cs_supported = is_cs_supported;
     ctx->is_ps_supported = is_ps_supported;
     ctx->is_eps_supported = is_eps_supported;
     ctx->is_5gs_supported = is_5gs_supported;
-    ctx->run_cs = is_cs_supported;
-    ctx->run_ps = is_ps_supported;
-    ctx->run_eps = is_eps_supported;
-    ctx->run_5gs = is_5gs_supported;
+
+    /* Check current CS, PS, EPS and 5GS registration states */
+    if (is_cs_supported)
+        registration_checks_add (ctx, &n, "+CREG?");
+    if (is_ps_supported)
+        registration_checks_add (ctx, &n, "+CGREG?");
+    if (is_eps_supported)
+        registration_checks_add (ctx, &n, "+CEREG?");
+    if (is_5gs_supported)
+        registration_checks_add (ctx, &n, "+C5GREG?");
 
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)run_registration_checks_context_free);
 
-    run_registration_checks_context_step (task);
+    if (!n) {
+        run_registration_checks_complete (task);
+        return;
+    }
+
+    mm_base_modem_at_sequence_any_port (MM_BASE_MODEM (self),
+                                        ctx->sequence,
+                                        ctx,
+                                        NULL,
+                                        (GAsyncReadyCallback)registration_status_checks_ready,
+                                        task);
 }
 
 /*****************************************************************************/
@@ -7489,8 +7502,8 @@ sms_text_part_list_ready (MMBroadbandModem *self,
     }
 
     /* +CMGL: <index>,<stat>,<oa/da>,[alpha],<scts><CR><LF><data><CR><LF> */
-    r = g_regex_new ("\\+CMGL:\\s*(\\d+)\\s*,\\s*([^,]*),\\s*([^,]*),\\s*([^,]*),\\s*([^\\r\\n]*)\\r\\n([^\\r\\n]*)",
-                     0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CMGL:\\s*(\\d+)\\s*,\\s*([^,]*),\\s*([^,]*),\\s*([^,]*),\\s*([^\\r\\n]*)\\r\\n([^\\r\\n]*)",
+                            0, 0, NULL);
     g_assert (r);
 
     if (!g_regex_match (r, response, 0, &match_info)) {
@@ -7918,8 +7931,8 @@ set_voice_in_call_unsolicited_events_handlers (MMBroadbandModem *self,
     g_autoptr(GRegex) in_call_event_regex = NULL;
     guint             i;
 
-    in_call_event_regex = g_regex_new ("\\r\\n(NO CARRIER|BUSY|NO ANSWER|NO DIALTONE)(\\r)?\\r\\n$",
-                                       G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    in_call_event_regex = mm_regex_cache_get ("\\r\\n(NO CARRIER|BUSY|NO ANSWER|NO DIALTONE)(\\r)?\\r\\n$",
+                                              G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 
     ports[0] = MM_PORT_SERIAL_AT (ports_ctx->primary);
     ports[1] = MM_PORT_SERIAL_AT (ports_ctx->secondary);
@@ -9246,7 +9259,7 @@ css_query_ready (MMIfaceModemCdma *self,
         g_autoptr(GMatchInfo) match_info = NULL;
 
         /* Format is "<band_class>,<band>,<sid>" */
-        r = g_regex_new ("\\s*([^,]*?)\\s*,\\s*([^,]*?)\\s*,\\s*(\\d+)", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+        r = mm_regex_cache_get ("\\s*([^,]*?)\\s*,\\s*([^,]*?)\\s*,\\s*(\\d+)", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
         g_assert (r);
 
         g_regex_match (r, result, 0, &match_info);
@@ -11415,6 +11428,8 @@ disabling_step (GTask *task)
 
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (ctx->self, "broadband-modem-disable", ctx->step, DISABLING_STEP_LAST);
+
     switch (ctx->step) {
     case DISABLING_STEP_FIRST:
         ctx->step++;
@@ -11858,6 +11873,8 @@ enabling_step (GTask *task)
 
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (ctx->self, "broadband-modem-enable", ctx->step, ENABLING_STEP_LAST);
+
     switch (ctx->step) {
     case ENABLING_STEP_FIRST:
         ctx->step++;
@@ -12536,6 +12553,8 @@ initialize_step (GTask *task)
 
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (ctx->self, "broadband-modem-init", ctx->step, INITIALIZE_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZE_STEP_FIRST:
         ctx->step++;
@@ -13068,6 +13087,9 @@ set_property (GObject *object,
     case PROP_MODEM_INDICATION_CALL_LIST_RELOAD_ENABLED:
         self->priv->indication_call_list_reload_enabled = g_value_get_boolean (value);
         break;
+    case PROP_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN:
+        self->priv->modem_signal_sampling_interval_min = g_value_get_uint (value);
+        break;
     case PROP_MODEM_CARRIER_CONFIG_MAPPING:
         self->priv->carrier_config_mapping = g_value_dup_string (value);
         break;
@@ -13218,6 +13240,9 @@ get_property (GObject *object,
     case PROP_MODEM_INDICATION_CALL_LIST_RELOAD_ENABLED:
         g_value_set_boolean (value, self->priv->indication_call_list_reload_enabled);
         break;
+    case PROP_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN:
+        g_value_set_uint (value, self->priv->modem_signal_sampling_interval_min);
+        break;
     case PROP_MODEM_CARRIER_CONFIG_MAPPING:
         g_value_set_string (value, self->priv->carrier_config_mapping);
         break;
@@ -13265,6 +13290,7 @@ mm_broadband_modem_init (MMBroadbandModem *self)
     self->priv->periodic_access_tech_check_disabled = FALSE;
     self->priv->periodic_call_list_check_disabled = FALSE;
     self->priv->indication_call_list_reload_enabled = FALSE;
+    self->priv->modem_signal_sampling_interval_min = 1000;
     self->priv->modem_cmer_enable_mode = MM_3GPP_CMER_MODE_NONE;
     self->priv->modem_cmer_disable_mode = MM_3GPP_CMER_MODE_NONE;
     self->priv->modem_cmer_ind = MM_3GPP_CMER_IND_NONE;
@@ -13875,6 +13901,10 @@ mm_broadband_modem_class_init (MMBroadbandModemClass *klass)
                                       PROP_MODEM_INDICATION_CALL_LIST_RELOAD_ENABLED,
                                       MM_IFACE_MODEM_VOICE_INDICATION_CALL_LIST_RELOAD_ENABLED);
 
+    g_object_class_override_property (object_class,
+                                      PROP_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN,
+                                      MM_IFACE_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN);
+
     g_object_class_override_property (object_class,
                                       PROP_MODEM_CARRIER_CONFIG_MAPPING,
                                       MM_IFACE_MODEM_CARRIER_CONFIG_MAPPING);
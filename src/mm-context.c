@@ -41,6 +41,9 @@ static gboolean      debug;
 static MMFilterRule  filter_policy = MM_FILTER_POLICY_STRICT;
 static gboolean      no_auto_scan = NO_AUTO_SCAN_DEFAULT;
 static const gchar  *initial_kernel_events;
+static gboolean      fast_probing;
+static const gchar  *probe_cache;
+static gint          bringup_limit;
 
 static gboolean
 filter_policy_option_arg (const gchar  *option_name,
@@ -84,6 +87,21 @@ static const GOptionEntry entries[] = {
         "Path to initial kernel events file",
         "[PATH]"
     },
+    {
+        "fast-probing", 0, 0, G_OPTION_ARG_NONE, &fast_probing,
+        "Finish device probing as soon as all expected ports are found",
+        NULL
+    },
+    {
+        "probe-cache", 0, 0, G_OPTION_ARG_FILENAME, &probe_cache,
+        "Path to the file where port probing results are cached",
+        "[PATH]"
+    },
+    {
+        "bringup-limit", 0, 0, G_OPTION_ARG_INT, &bringup_limit,
+        "Maximum number of devices probed or initialized at the same time behind the same USB hub (0 for no limit)",
+        "[N]"
+    },
     {
         "debug", 0, 0, G_OPTION_ARG_NONE, &debug,
         "Run with extended debugging capabilities",
@@ -120,6 +138,24 @@ mm_context_get_no_auto_scan (void)
     return no_auto_scan;
 }
 
+gboolean
+mm_context_get_fast_probing (void)
+{
+    return fast_probing;
+}
+
+const gchar *
+mm_context_get_probe_cache (void)
+{
+    return probe_cache;
+}
+
+guint
+mm_context_get_bringup_limit (void)
+{
+    return (guint) MAX (bringup_limit, 0);
+}
+
 MMFilterRule
 mm_context_get_filter_policy (void)
 {
@@ -135,6 +171,7 @@ static gboolean     log_journal;
 static gboolean     log_show_ts;
 static gboolean     log_rel_ts;
 static gboolean     log_personal_info;
+static const gchar *log_trace_file;
 
 static const GOptionEntry log_entries[] = {
     {
@@ -169,6 +206,11 @@ static const GOptionEntry log_entries[] = {
         "Show personal info in logs",
         NULL
     },
+    {
+        "log-trace-file", 0, 0, G_OPTION_ARG_FILENAME, &log_trace_file,
+        "Path to file where step and port command timing is written in Chrome trace format",
+        "[PATH]"
+    },
     { NULL }
 };
 
@@ -222,12 +264,19 @@ mm_context_get_log_personal_info (void)
     return log_personal_info;
 }
 
+const gchar *
+mm_context_get_log_trace_file (void)
+{
+    return log_trace_file;
+}
+
 /*****************************************************************************/
 /* Test context */
 
 static gboolean  test_session;
 static gboolean  test_enable;
 static gchar    *test_plugin_dir;
+static gchar    *test_write_plugin_manifest;
 #if defined WITH_UDEV
 static gboolean  test_no_udev;
 #endif
@@ -259,6 +308,11 @@ static const GOptionEntry test_entries[] = {
         "Path to look for plugins",
         "[PATH]"
     },
+    {
+        "test-write-plugin-manifest", 0, 0, G_OPTION_ARG_FILENAME, &test_write_plugin_manifest,
+        "Write the manifest of the plugins found in the plugin directory and exit",
+        "[PATH]"
+    },
 #if defined WITH_UDEV
     {
         "test-no-udev", 0, 0, G_OPTION_ARG_NONE, &test_no_udev,
@@ -332,6 +386,12 @@ mm_context_get_test_plugin_dir (void)
     return test_plugin_dir ? test_plugin_dir : PLUGINDIR;
 }
 
+const gchar *
+mm_context_get_test_write_plugin_manifest (void)
+{
+    return test_write_plugin_manifest;
+}
+
 #if defined WITH_UDEV
 gboolean
 mm_context_get_test_no_udev (void)
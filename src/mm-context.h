@@ -31,6 +31,9 @@ void mm_context_init (gint    argc,
 gboolean     mm_context_get_debug                 (void);
 const gchar *mm_context_get_initial_kernel_events (void);
 gboolean     mm_context_get_no_auto_scan          (void);
+gboolean     mm_context_get_fast_probing          (void);
+const gchar *mm_context_get_probe_cache           (void);
+guint        mm_context_get_bringup_limit         (void);
 
 /* Filter support */
 MMFilterRule mm_context_get_filter_policy (void);
@@ -42,11 +45,13 @@ gboolean     mm_context_get_log_journal             (void);
 gboolean     mm_context_get_log_timestamps          (void);
 gboolean     mm_context_get_log_relative_timestamps (void);
 gboolean     mm_context_get_log_personal_info       (void);
+const gchar *mm_context_get_log_trace_file          (void);
 
 /* Testing support */
 gboolean     mm_context_get_test_session           (void);
 gboolean     mm_context_get_test_enable            (void);
 const gchar *mm_context_get_test_plugin_dir        (void);
+const gchar *mm_context_get_test_write_plugin_manifest (void);
 #if defined WITH_UDEV
 gboolean     mm_context_get_test_no_udev           (void);
 #endif
@@ -94,6 +94,11 @@ struct _MMDevicePrivate {
 
     /* Scheduled reprobe */
     guint reprobe_id;
+
+    /* Monotonic times when the device was detected and when the modem
+     * object was created, used to report how long it took to export it */
+    gint64 detection_time;
+    gint64 creation_time;
 };
 
 /*****************************************************************************/
@@ -349,6 +354,7 @@ export_modem (MMDevice *self)
 {
     GDBusConnection *connection = NULL;
     gchar           *path;
+    gint64           now;
 
     g_assert (MM_IS_BASE_MODEM (self->priv->modem));
     g_assert (G_IS_DBUS_OBJECT_MANAGER (self->priv->object_manager));
@@ -384,6 +390,11 @@ export_modem (MMDevice *self)
     g_dbus_object_manager_server_export (self->priv->object_manager,
                                          G_DBUS_OBJECT_SKELETON (self->priv->modem));
 
+    now = g_get_monotonic_time ();
+    mm_obj_info (self, "modem exported %.3lf seconds after device detection (probing: %.3lf seconds, initialization: %.3lf seconds)",
+                 (now - self->priv->detection_time) / (gdouble) G_USEC_PER_SEC,
+                 (self->priv->creation_time - self->priv->detection_time) / (gdouble) G_USEC_PER_SEC,
+                 (now - self->priv->creation_time) / (gdouble) G_USEC_PER_SEC);
     mm_obj_dbg (self, " exported modem at path '%s'", path);
     mm_obj_dbg (self, "    plugin:  %s", mm_base_modem_get_plugin (self->priv->modem));
     mm_obj_dbg (self, "    vid:pid: 0x%04X:0x%04X",
@@ -507,6 +518,7 @@ mm_device_create_modem (MMDevice  *self,
                      g_strv_length (self->priv->virtual_ports));
     }
 
+    self->priv->creation_time = g_get_monotonic_time ();
     self->priv->modem = mm_plugin_create_modem (self->priv->plugin, self, error);
     if (self->priv->modem)
         /* We want to get notified when the modem becomes valid/invalid */
@@ -775,6 +787,7 @@ mm_device_init (MMDevice *self)
 {
     /* Initialize private data */
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_DEVICE, MMDevicePrivate);
+    self->priv->detection_time = g_get_monotonic_time ();
 }
 
 static void
@@ -26,6 +26,7 @@
 #include "mm-iface-modem-3gpp-profile-manager.h"
 #include "mm-base-modem.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 
 #define SUPPORT_CHECKED_TAG "3gpp-profile-manager-support-checked-tag"
 #define SUPPORTED_TAG       "3gpp-profile-manager-supported-tag"
@@ -1317,6 +1318,8 @@ interface_disabling_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx  = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-profile-manager-disable", ctx->step, DISABLING_STEP_LAST);
+
     switch (ctx->step) {
     case DISABLING_STEP_FIRST:
         ctx->step++;
@@ -1467,6 +1470,8 @@ interface_enabling_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx  = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-profile-manager-enable", ctx->step, ENABLING_STEP_LAST);
+
     switch (ctx->step) {
     case ENABLING_STEP_FIRST:
         ctx->step++;
@@ -1628,6 +1633,8 @@ interface_initialization_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx  = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-profile-manager-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         /* Setup quarks if we didn't do it before */
@@ -27,6 +27,7 @@
 #include "mm-base-modem.h"
 #include "mm-modem-helpers.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 
 #define SUPPORT_CHECKED_TAG "3gpp-ussd-support-checked-tag"
 #define SUPPORTED_TAG       "3gpp-ussd-supported-tag"
@@ -529,6 +530,8 @@ interface_disabling_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-ussd-disable", ctx->step, DISABLING_STEP_LAST);
+
     switch (ctx->step) {
     case DISABLING_STEP_FIRST:
         ctx->step++;
@@ -676,6 +679,8 @@ interface_enabling_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-ussd-enable", ctx->step, ENABLING_STEP_LAST);
+
     switch (ctx->step) {
     case ENABLING_STEP_FIRST:
         ctx->step++;
@@ -801,6 +806,8 @@ interface_initialization_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-ussd-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         /* Setup quarks if we didn't do it before */
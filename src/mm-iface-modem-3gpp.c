@@ -28,6 +28,7 @@
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-log.h"
+#include "mm-trace.h"
 
 #define SUBSYSTEM_3GPP "3gpp"
 
@@ -57,6 +58,15 @@
 #define PRIVATE_TAG "iface-modem-3gpp-private-tag"
 static GQuark private_quark;
 
+/* Time elapsed since a registration state change is reported by the modem
+ * until the related info is exposed in the interface */
+typedef struct {
+    gint64 start_time;
+    guint  count;
+    guint  last_ms;
+    guint  max_ms;
+} UpdateLatency;
+
 typedef struct {
     /* Registration state */
     MMModem3gppRegistrationState  state_cs;
@@ -70,6 +80,13 @@ typedef struct {
     /* Registration checks */
     guint    check_timeout_source;
     gboolean check_running;
+    /* Registration watchdog, when relying on unsolicited events */
+    guint    watchdog_timeout_source;
+    gint64   last_registration_update_time;
+    /* Update latencies */
+    UpdateLatency registration_latency;
+    UpdateLatency serving_cell_latency;
+    UpdateLatency location_latency;
 } Private;
 
 static void
@@ -82,6 +99,8 @@ private_free (Private *priv)
     }
     if (priv->check_timeout_source)
         g_source_remove (priv->check_timeout_source);
+    if (priv->watchdog_timeout_source)
+        g_source_remove (priv->watchdog_timeout_source);
     g_slice_free (Private, priv);
 }
 
@@ -1912,6 +1931,48 @@ mm_iface_modem_3gpp_clear_current_operator (MMIfaceModem3gpp *self)
         mm_iface_modem_location_3gpp_update_operator_code (MM_IFACE_MODEM_LOCATION (self), NULL);
 }
 
+/*****************************************************************************/
+/* Update latencies */
+
+/* Latencies above this are reported in the info log */
+#define UPDATE_LATENCY_INFO_THRESHOLD_MS 2000
+
+static void
+update_latency_start (UpdateLatency *latency,
+                      gint64         now)
+{
+    /* Measured since the first change reported */
+    if (!latency->start_time)
+        latency->start_time = now;
+}
+
+static void
+update_latency_cancel (UpdateLatency *latency)
+{
+    latency->start_time = 0;
+}
+
+static void
+update_latency_complete (MMIfaceModem3gpp *self,
+                         UpdateLatency    *latency,
+                         const gchar      *what)
+{
+    if (!latency->start_time)
+        return;
+
+    latency->last_ms = (guint) ((g_get_monotonic_time () - latency->start_time) / 1000);
+    latency->max_ms = MAX (latency->max_ms, latency->last_ms);
+    latency->start_time = 0;
+    latency->count++;
+
+    if (latency->last_ms > UPDATE_LATENCY_INFO_THRESHOLD_MS)
+        mm_obj_info (self, "%s update latency: %u ms (max %u ms over %u updates)",
+                     what, latency->last_ms, latency->max_ms, latency->count);
+    else
+        mm_obj_dbg (self, "%s update latency: %u ms (max %u ms over %u updates)",
+                    what, latency->last_ms, latency->max_ms, latency->count);
+}
+
 /*****************************************************************************/
 
 void
@@ -1930,10 +1991,12 @@ mm_iface_modem_3gpp_update_access_technologies (MMIfaceModem3gpp        *self,
     /* Even if registration state didn't change, report access technology,
      * but only if something valid to report */
     if (REG_STATE_IS_REGISTERED (state) || priv->reloading_registration_info) {
-        if (access_tech != MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN)
+        if (access_tech != MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN) {
             mm_iface_modem_update_access_technologies (MM_IFACE_MODEM (self),
                                                        access_tech,
                                                        MM_IFACE_MODEM_3GPP_ALL_ACCESS_TECHNOLOGIES_MASK);
+            update_latency_complete (self, &priv->serving_cell_latency, "serving cell");
+        }
     } else
         mm_iface_modem_update_access_technologies (MM_IFACE_MODEM (self),
                                                    MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,
@@ -1963,17 +2026,46 @@ mm_iface_modem_3gpp_update_location (MMIfaceModem3gpp *self,
      * where we're registering (loading current registration info after a state
      * change to registered), we also allow LAC/CID updates. */
     if (REG_STATE_IS_REGISTERED (state) || priv->reloading_registration_info) {
-        if (location_area_code || tracking_area_code || cell_id)
+        if (location_area_code || tracking_area_code || cell_id) {
             mm_iface_modem_location_3gpp_update_lac_tac_ci (MM_IFACE_MODEM_LOCATION (self),
                                                             location_area_code,
                                                             tracking_area_code,
                                                             cell_id);
+            update_latency_complete (self, &priv->location_latency, "location");
+        }
     } else
         mm_iface_modem_location_3gpp_clear (MM_IFACE_MODEM_LOCATION (self));
 }
 
 /*****************************************************************************/
 
+static void
+registered_info_latency_check (MMIfaceModem3gpp *self)
+{
+    Private *priv;
+
+    /* Serving cell and location are only reported while registered */
+    priv = get_private (self);
+    if (!REG_STATE_IS_REGISTERED (get_consolidated_reg_state (self))) {
+        update_latency_cancel (&priv->serving_cell_latency);
+        update_latency_cancel (&priv->location_latency);
+    }
+}
+
+static void
+registration_update_latency_complete (MMIfaceModem3gpp *self)
+{
+    update_latency_complete (self, &get_private (self)->registration_latency, "registration state");
+    registered_info_latency_check (self);
+}
+
+static void
+registration_update_latency_cancel (MMIfaceModem3gpp *self)
+{
+    update_latency_cancel (&get_private (self)->registration_latency);
+    registered_info_latency_check (self);
+}
+
 static void
 update_registration_reload_current_registration_info_ready (MMIfaceModem3gpp *self,
                                                             GAsyncResult     *res,
@@ -2008,6 +2100,7 @@ update_registration_reload_current_registration_info_ready (MMIfaceModem3gpp *se
                                            MM_MODEM_STATE_CHANGE_REASON_UNKNOWN);
 
     priv->reloading_registration_info = FALSE;
+    registration_update_latency_complete (self);
 }
 
 static void
@@ -2050,8 +2143,10 @@ update_registration_state (MMIfaceModem3gpp             *self,
                   NULL);
 
     /* Only set new state if different */
-    if (new_state == old_state && old_packet_service_state == get_consolidated_packet_service_state (self))
+    if (new_state == old_state && old_packet_service_state == get_consolidated_packet_service_state (self)) {
+        registration_update_latency_cancel (self);
         return;
+    }
 
     if (REG_STATE_IS_REGISTERED (new_state)) {
         MMModemState modem_state;
@@ -2072,6 +2167,7 @@ update_registration_state (MMIfaceModem3gpp             *self,
                       NULL);
         if (modem_state < MM_MODEM_STATE_ENABLED) {
             mm_obj_dbg (self, "3GPP registration state change ignored as modem isn't enabled");
+            registration_update_latency_cancel (self);
             return;
         }
 
@@ -2099,6 +2195,7 @@ update_registration_state (MMIfaceModem3gpp             *self,
                 mm_modem_3gpp_registration_state_get_string (new_state));
 
     update_non_registered_state (self, old_state, new_state);
+    registration_update_latency_complete (self);
 }
 
 #define UPDATE_REGISTRATION_STATE(domain)                                                             \
@@ -2113,6 +2210,12 @@ update_registration_state (MMIfaceModem3gpp             *self,
             return;                                                                                   \
                                                                                                       \
         priv = get_private (self);                                                                    \
+        priv->last_registration_update_time = g_get_monotonic_time ();                                \
+        if (priv->state_##domain != state) {                                                          \
+            update_latency_start (&priv->registration_latency, priv->last_registration_update_time);  \
+            update_latency_start (&priv->serving_cell_latency, priv->last_registration_update_time);  \
+            update_latency_start (&priv->location_latency, priv->last_registration_update_time);      \
+        }                                                                                             \
         priv->state_##domain = state;                                                                 \
                                                                                                       \
         if (!deferred)                                                                                \
@@ -2206,6 +2309,67 @@ periodic_registration_check_enable (MMIfaceModem3gpp *self)
                                                         self);
 }
 
+/*****************************************************************************/
+/* Registration watchdog
+ *
+ * When the registration state is reported via unsolicited events there is no
+ * need to poll periodically; the watchdog only runs an explicit registration
+ * check if no update at all has been received in a long time, e.g. if an
+ * event was lost.
+ */
+
+#define REGISTRATION_WATCHDOG_TIMEOUT_SEC 300
+
+static gboolean
+registration_watchdog_check (MMIfaceModem3gpp *self)
+{
+    Private *priv;
+    gint64   elapsed_sec;
+
+    priv = get_private (self);
+
+    elapsed_sec = (g_get_monotonic_time () - priv->last_registration_update_time) / G_USEC_PER_SEC;
+    if (elapsed_sec < REGISTRATION_WATCHDOG_TIMEOUT_SEC)
+        return G_SOURCE_CONTINUE;
+
+    mm_obj_dbg (self, "no 3GPP registration updates in the last %" G_GINT64_FORMAT " seconds: checking", elapsed_sec);
+    return periodic_registration_check (self);
+}
+
+static void
+registration_watchdog_disable (MMIfaceModem3gpp *self)
+{
+    Private *priv;
+
+    priv = get_private (self);
+
+    if (!priv->watchdog_timeout_source)
+        return;
+
+    g_source_remove (priv->watchdog_timeout_source);
+    priv->watchdog_timeout_source = 0;
+
+    mm_obj_dbg (self, "3GPP registration watchdog disabled");
+}
+
+static void
+registration_watchdog_enable (MMIfaceModem3gpp *self)
+{
+    Private *priv;
+
+    priv = get_private (self);
+
+    /* Not needed if already polling */
+    if (priv->watchdog_timeout_source || priv->check_timeout_source)
+        return;
+
+    mm_obj_dbg (self, "3GPP registration watchdog enabled");
+    priv->last_registration_update_time = g_get_monotonic_time ();
+    priv->watchdog_timeout_source = g_timeout_add_seconds (REGISTRATION_WATCHDOG_TIMEOUT_SEC,
+                                                           (GSourceFunc)registration_watchdog_check,
+                                                           self);
+}
+
 /*****************************************************************************/
 
 void
@@ -2388,6 +2552,8 @@ interface_disabling_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-disable", ctx->step, DISABLING_STEP_LAST);
+
     switch (ctx->step) {
     case DISABLING_STEP_FIRST:
         ctx->step++;
@@ -2399,8 +2565,9 @@ interface_disabling_step (GTask *task)
         /* fall through */
 
     case DISABLING_STEP_PERIODIC_REGISTRATION_CHECKS:
-        /* Disable periodic registration checks, if they were set */
+        /* Disable periodic registration checks or watchdog, if they were set */
         periodic_registration_check_disable (self);
+        registration_watchdog_disable (self);
         ctx->step++;
         /* fall through */
 
@@ -2684,6 +2851,8 @@ interface_enabling_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-enable", ctx->step, ENABLING_STEP_LAST);
+
     switch (ctx->step) {
     case ENABLING_STEP_FIRST:
         ctx->step++;
@@ -2754,6 +2923,10 @@ interface_enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_LAST:
+        /* If periodic registration checks weren't needed, registration
+         * updates come from unsolicited events; just keep a watchdog */
+        registration_watchdog_enable (self);
+
         /* We are done without errors! */
         g_task_return_boolean (task, TRUE);
         g_object_unref (task);
@@ -3161,6 +3334,8 @@ interface_initialization_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-3gpp-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         ctx->step++;
@@ -20,6 +20,7 @@
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-firmware.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 
 #if defined WITH_QMI
 # include "mm-broadband-modem-qmi.h"
@@ -471,6 +472,8 @@ interface_initialization_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-firmware-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         ctx->step++;
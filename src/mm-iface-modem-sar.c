@@ -20,6 +20,7 @@
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-sar.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 
 #define SUPPORT_CHECKED_TAG "sar-support-checked-tag"
 #define SUPPORTED_TAG       "sar-supported-tag"
@@ -383,6 +384,8 @@ interface_initialization_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-sar-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         /* Setup quarks if we didn't do it before */
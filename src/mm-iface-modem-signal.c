@@ -21,6 +21,8 @@
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-signal.h"
 #include "mm-log-object.h"
+#include "mm-signal-history.h"
+#include "mm-trace.h"
 
 #define SUPPORT_CHECKED_TAG "signal-support-checked-tag"
 #define SUPPORTED_TAG       "signal-supported-tag"
@@ -43,6 +45,12 @@ typedef struct {
     /* threshold-based reporting */
     guint    rssi_threshold;
     gboolean error_rate_threshold;
+    /* high rate sampling */
+    guint    sampling_interval;
+    guint    sampling_timeout_source;
+    gboolean sampling_ongoing;
+    /* samples history */
+    MMSignalHistory *samples;
 } Private;
 
 static void
@@ -50,6 +58,10 @@ private_free (Private *priv)
 {
     if (priv->timeout_source)
         g_source_remove (priv->timeout_source);
+    if (priv->sampling_timeout_source)
+        g_source_remove (priv->sampling_timeout_source);
+    if (priv->samples)
+        mm_signal_history_free (priv->samples);
     g_slice_free (Private, priv);
 }
 
@@ -78,6 +90,43 @@ mm_iface_modem_signal_bind_simple_status (MMIfaceModemSignal *self,
 {
 }
 
+/*****************************************************************************/
+/* Samples history */
+
+static void
+samples_add (MMIfaceModemSignal *self,
+             MMSignal           *cdma,
+             MMSignal           *evdo,
+             MMSignal           *gsm,
+             MMSignal           *umts,
+             MMSignal           *lte,
+             MMSignal           *nr5g)
+{
+    Private *priv;
+
+    priv = get_private (self);
+
+    /* The history is only allocated once the first sample arrives */
+    if (!priv->samples)
+        priv->samples = mm_signal_history_new (MM_SIGNAL_HISTORY_SIZE);
+
+    mm_signal_history_add (priv->samples, g_get_monotonic_time (), cdma, evdo, gsm, umts, lte, nr5g);
+}
+
+static GVariant *
+samples_build_list (MMIfaceModemSignal *self,
+                    guint64             since)
+{
+    Private *priv;
+
+    priv = get_private (self);
+
+    if (!priv->samples)
+        return g_variant_new_array (G_VARIANT_TYPE ("(txa{sv})"), NULL, 0);
+
+    return mm_signal_history_build_list (priv->samples, since);
+}
+
 /*****************************************************************************/
 
 static void
@@ -158,11 +207,16 @@ mm_iface_modem_signal_update (MMIfaceModemSignal *self,
 
     priv = get_private (self);
     if (!priv->enabled || (!priv->rate && !priv->rssi_threshold && !priv->error_rate_threshold)) {
-        mm_obj_dbg (self, "skipping extended signal information update...");
+        /* Updates received while only sampling go to the history */
+        if (priv->enabled && priv->sampling_interval)
+            samples_add (self, cdma, evdo, gsm, umts, lte, nr5g);
+        else
+            mm_obj_dbg (self, "skipping extended signal information update...");
         return;
     }
 
     internal_signal_update (self, cdma, evdo, gsm, umts, lte, nr5g);
+    samples_add (self, cdma, evdo, gsm, umts, lte, nr5g);
 }
 
 /*****************************************************************************/
@@ -255,6 +309,96 @@ polling_restart (MMIfaceModemSignal *self)
     polling_context_cb (self);
 }
 
+/*****************************************************************************/
+/* High rate sampling management */
+
+static void
+load_sample_ready (MMIfaceModemSignal *self,
+                   GAsyncResult       *res)
+{
+    g_autoptr(GError)   error = NULL;
+    g_autoptr(MMSignal) cdma = NULL;
+    g_autoptr(MMSignal) evdo = NULL;
+    g_autoptr(MMSignal) gsm = NULL;
+    g_autoptr(MMSignal) umts = NULL;
+    g_autoptr(MMSignal) lte = NULL;
+    g_autoptr(MMSignal) nr5g = NULL;
+    Private            *priv;
+
+    priv = get_private (self);
+    priv->sampling_ongoing = FALSE;
+
+    if (!MM_IFACE_MODEM_SIGNAL_GET_INTERFACE (self)->load_values_finish (
+            self,
+            res,
+            &cdma,
+            &evdo,
+            &gsm,
+            &umts,
+            &lte,
+            &nr5g,
+            &error)) {
+        /* Not a warning, we don't want to flood the log at high rates */
+        mm_obj_dbg (self, "couldn't load extended signal information sample: %s", error->message);
+        return;
+    }
+
+    /* Sampling may have been disabled while the request was ongoing */
+    if (!priv->enabled || !priv->sampling_interval)
+        return;
+
+    samples_add (self, cdma, evdo, gsm, umts, lte, nr5g);
+}
+
+static gboolean
+sampling_context_cb (MMIfaceModemSignal *self)
+{
+    Private *priv;
+
+    priv = get_private (self);
+
+    /* If the device is slower than the requested interval, skip ticks
+     * instead of queueing up requests */
+    if (priv->sampling_ongoing)
+        return G_SOURCE_CONTINUE;
+
+    priv->sampling_ongoing = TRUE;
+    MM_IFACE_MODEM_SIGNAL_GET_INTERFACE (self)->load_values (
+        self,
+        NULL,
+        (GAsyncReadyCallback)load_sample_ready,
+        NULL);
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+sampling_restart (MMIfaceModemSignal *self)
+{
+    Private  *priv;
+    gboolean  sampling_setup;
+
+    priv = get_private (self);
+    sampling_setup = (priv->enabled && priv->sampling_interval);
+
+    mm_obj_dbg (self, "%s extended signal information sampling: interface %s, interval %u ms",
+                sampling_setup ? "setting up" : "cleaning up",
+                priv->enabled ? "enabled" : "disabled",
+                priv->sampling_interval);
+
+    if (priv->sampling_timeout_source) {
+        g_source_remove (priv->sampling_timeout_source);
+        priv->sampling_timeout_source = 0;
+    }
+
+    if (!sampling_setup)
+        return;
+
+    priv->sampling_timeout_source = g_timeout_add (priv->sampling_interval, (GSourceFunc) sampling_context_cb, self);
+
+    /* Also launch right away */
+    sampling_context_cb (self);
+}
+
 /*****************************************************************************/
 /* Thresholds setup management */
 
@@ -509,6 +653,142 @@ handle_setup_thresholds (MmGdbusModemSignal    *skeleton,
     return TRUE;
 }
 
+/*****************************************************************************/
+
+typedef struct {
+    GDBusMethodInvocation *invocation;
+    MmGdbusModemSignal    *skeleton;
+    guint                  interval;
+} HandleSetupSamplingContext;
+
+static void
+handle_setup_sampling_context_free (HandleSetupSamplingContext *ctx)
+{
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->skeleton);
+    g_slice_free (HandleSetupSamplingContext, ctx);
+}
+
+static void
+handle_setup_sampling_auth_ready (MMBaseModem                *_self,
+                                  GAsyncResult               *res,
+                                  HandleSetupSamplingContext *ctx)
+{
+    MMIfaceModemSignal *self = MM_IFACE_MODEM_SIGNAL (_self);
+    GError             *error = NULL;
+    Private            *priv;
+    guint               interval_min = 0;
+
+    if (!mm_base_modem_authorize_finish (_self, res, &error)) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_setup_sampling_context_free (ctx);
+        return;
+    }
+
+    if (mm_iface_modem_abort_invocation_if_state_not_reached (MM_IFACE_MODEM (self),
+                                                              ctx->invocation,
+                                                              MM_MODEM_STATE_DISABLED)) {
+        handle_setup_sampling_context_free (ctx);
+        return;
+    }
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN, &interval_min,
+                  NULL);
+    if (ctx->interval && ctx->interval < interval_min) {
+        g_dbus_method_invocation_return_error (ctx->invocation, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                                               "Cannot setup sampling: interval %u ms below the minimum supported (%u ms)",
+                                               ctx->interval, interval_min);
+        handle_setup_sampling_context_free (ctx);
+        return;
+    }
+
+    priv = get_private (self);
+    priv->sampling_interval = ctx->interval;
+    sampling_restart (self);
+    mm_gdbus_modem_signal_set_sampling_interval (ctx->skeleton, ctx->interval);
+    mm_gdbus_modem_signal_complete_setup_sampling (ctx->skeleton, ctx->invocation);
+    handle_setup_sampling_context_free (ctx);
+}
+
+static gboolean
+handle_setup_sampling (MmGdbusModemSignal    *skeleton,
+                       GDBusMethodInvocation *invocation,
+                       guint                  interval,
+                       MMIfaceModemSignal    *self)
+{
+    HandleSetupSamplingContext *ctx;
+
+    ctx = g_slice_new0 (HandleSetupSamplingContext);
+    ctx->invocation = g_object_ref (invocation);
+    ctx->skeleton = g_object_ref (skeleton);
+    ctx->interval = interval;
+
+    mm_base_modem_authorize (MM_BASE_MODEM (self),
+                             invocation,
+                             MM_AUTHORIZATION_DEVICE_CONTROL,
+                             (GAsyncReadyCallback)handle_setup_sampling_auth_ready,
+                             ctx);
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    GDBusMethodInvocation *invocation;
+    MmGdbusModemSignal    *skeleton;
+    guint64                since;
+} HandleGetSamplesContext;
+
+static void
+handle_get_samples_context_free (HandleGetSamplesContext *ctx)
+{
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->skeleton);
+    g_slice_free (HandleGetSamplesContext, ctx);
+}
+
+static void
+handle_get_samples_auth_ready (MMBaseModem             *_self,
+                               GAsyncResult            *res,
+                               HandleGetSamplesContext *ctx)
+{
+    MMIfaceModemSignal *self = MM_IFACE_MODEM_SIGNAL (_self);
+    GError             *error = NULL;
+
+    if (!mm_base_modem_authorize_finish (_self, res, &error)) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_get_samples_context_free (ctx);
+        return;
+    }
+
+    mm_gdbus_modem_signal_complete_get_samples (ctx->skeleton,
+                                                ctx->invocation,
+                                                samples_build_list (self, ctx->since));
+    handle_get_samples_context_free (ctx);
+}
+
+static gboolean
+handle_get_samples (MmGdbusModemSignal    *skeleton,
+                    GDBusMethodInvocation *invocation,
+                    guint64                since,
+                    MMIfaceModemSignal    *self)
+{
+    HandleGetSamplesContext *ctx;
+
+    ctx = g_slice_new0 (HandleGetSamplesContext);
+    ctx->invocation = g_object_ref (invocation);
+    ctx->skeleton = g_object_ref (skeleton);
+    ctx->since = since;
+
+    mm_base_modem_authorize (MM_BASE_MODEM (self),
+                             invocation,
+                             MM_AUTHORIZATION_DEVICE_CONTROL,
+                             (GAsyncReadyCallback)handle_get_samples_auth_ready,
+                             ctx);
+    return TRUE;
+}
+
 /*****************************************************************************/
 /* Common enable/disable */
 
@@ -552,6 +832,7 @@ common_enable_disable (MMIfaceModemSignal  *self,
     check_interface_reset (self);
 
     polling_restart (self);
+    sampling_restart (self);
 
     thresholds_restart (self,
                         (GAsyncReadyCallback)enable_disable_thresholds_restart_ready,
@@ -669,6 +950,8 @@ interface_initialization_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-signal-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         /* Setup quarks if we didn't do it before */
@@ -734,6 +1017,14 @@ interface_initialization_step (GTask *task)
                           "handle-setup-thresholds",
                           G_CALLBACK (handle_setup_thresholds),
                           self);
+        g_signal_connect (ctx->skeleton,
+                          "handle-setup-sampling",
+                          G_CALLBACK (handle_setup_sampling),
+                          self);
+        g_signal_connect (ctx->skeleton,
+                          "handle-get-samples",
+                          G_CALLBACK (handle_get_samples),
+                          self);
         /* Finally, export the new interface */
         mm_gdbus_object_skeleton_set_modem_signal (MM_GDBUS_OBJECT_SKELETON (self),
                                                    MM_GDBUS_MODEM_SIGNAL (ctx->skeleton));
@@ -811,6 +1102,14 @@ iface_modem_signal_init (gpointer g_iface)
                               MM_GDBUS_TYPE_MODEM_SIGNAL_SKELETON,
                               G_PARAM_READWRITE));
 
+    g_object_interface_install_property
+        (g_iface,
+         g_param_spec_uint (MM_IFACE_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN,
+                            "Sampling interval minimum",
+                            "Minimum extended signal information sampling interval, in milliseconds",
+                            100, G_MAXUINT, 1000,
+                            G_PARAM_READWRITE));
+
     initialized = TRUE;
 }
 
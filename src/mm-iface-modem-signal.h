@@ -28,7 +28,8 @@
 #define MM_IS_IFACE_MODEM_SIGNAL(obj)            (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_IFACE_MODEM_SIGNAL))
 #define MM_IFACE_MODEM_SIGNAL_GET_INTERFACE(obj) (G_TYPE_INSTANCE_GET_INTERFACE ((obj), MM_TYPE_IFACE_MODEM_SIGNAL, MMIfaceModemSignal))
 
-#define MM_IFACE_MODEM_SIGNAL_DBUS_SKELETON "iface-modem-signal-dbus-skeleton"
+#define MM_IFACE_MODEM_SIGNAL_DBUS_SKELETON         "iface-modem-signal-dbus-skeleton"
+#define MM_IFACE_MODEM_SIGNAL_SAMPLING_INTERVAL_MIN "iface-modem-signal-sampling-interval-min"
 
 typedef struct _MMIfaceModemSignal MMIfaceModemSignal;
 
@@ -28,6 +28,7 @@
 #include "mm-iface-modem-cdma.h"
 #include "mm-iface-modem-simple.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 
 /*****************************************************************************/
 /* Private data context */
@@ -551,6 +552,8 @@ connection_step (ConnectionContext *ctx)
     if (completed_if_cancelled (ctx))
         return;
 
+    mm_trace_step (ctx->self, "iface-modem-simple-connect", ctx->step, CONNECTION_STEP_LAST);
+
     switch (ctx->step) {
     case CONNECTION_STEP_FIRST:
         ctx->step++;
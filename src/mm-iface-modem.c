@@ -28,6 +28,7 @@
 #include "mm-bearer-list.h"
 #include "mm-private-boxed-types.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-context.h"
 #include "mm-dispatcher-fcc-unlock.h"
 #if defined WITH_QMI
@@ -43,6 +44,10 @@
 #define SIGNAL_CHECK_INITIAL_TIMEOUT_SEC  3
 #define SIGNAL_CHECK_TIMEOUT_SEC          30
 
+/* When signal quality indications are enabled, poll only if no value was
+ * reported in this time, before the last one stops being recent */
+#define SIGNAL_CHECK_INDICATIONS_STALE_TIMEOUT_SEC 50
+
 /*****************************************************************************/
 /* Private data context */
 
@@ -63,6 +68,10 @@ typedef struct {
     gboolean access_technology_polling_supported;
     gboolean access_technology_polling_disabled;
 
+    /* Signal quality reported by the device via indications */
+    gboolean signal_quality_indications;
+    gint64   signal_quality_update_time;
+
     /* Signal quality and access tech polling support */
     gboolean signal_check_enabled;
     guint    signal_check_timeout_source;
@@ -1610,6 +1619,10 @@ void
 mm_iface_modem_update_signal_quality (MMIfaceModem *self,
                                       guint         signal_quality)
 {
+    /* Values reported by the implementation are the ones received via
+     * indications; values polled by the interface itself don't tell whether
+     * indications are still arriving */
+    get_private (self)->signal_quality_update_time = g_get_monotonic_time ();
     update_signal_quality (self, signal_quality, TRUE);
 }
 
@@ -1637,6 +1650,22 @@ static void     periodic_signal_check_disable (MMIfaceModem *self,
 static gboolean periodic_signal_check_run     (MMIfaceModem *self);
 static void     periodic_signal_check_step    (GTask        *task);
 
+/* Seconds until the last signal quality value received via indications goes
+ * stale, 0 if already stale or if indications aren't enabled */
+static guint
+signal_quality_indications_time_to_stale (Private *priv)
+{
+    gint64 elapsed_sec;
+
+    if (!priv->signal_quality_indications || !priv->signal_quality_update_time)
+        return 0;
+
+    elapsed_sec = (g_get_monotonic_time () - priv->signal_quality_update_time) / G_USEC_PER_SEC;
+    if (elapsed_sec >= SIGNAL_CHECK_INDICATIONS_STALE_TIMEOUT_SEC)
+        return 0;
+    return SIGNAL_CHECK_INDICATIONS_STALE_TIMEOUT_SEC - elapsed_sec;
+}
+
 static void
 load_access_technologies_ready (MMIfaceModem *self,
                                 GAsyncResult *res,
@@ -1723,7 +1752,10 @@ periodic_signal_check_step (GTask *task)
 
     case SIGNAL_CHECK_STEP_SIGNAL_QUALITY:
         if (priv->signal_check_enabled && priv->signal_quality_polling_supported &&
-            (!priv->signal_check_initial_done || !priv->signal_quality_polling_disabled)) {
+            (!priv->signal_check_initial_done || !priv->signal_quality_polling_disabled) &&
+            !signal_quality_indications_time_to_stale (priv)) {
+            if (priv->signal_quality_indications)
+                mm_obj_dbg (self, "no recent signal quality indications: polling");
             MM_IFACE_MODEM_GET_INTERFACE (self)->load_signal_quality (
                 self, (GAsyncReadyCallback)load_signal_quality_ready, task);
             return;
@@ -1760,9 +1792,11 @@ periodic_signal_check_step (GTask *task)
             gboolean signal_quality_ready;
             gboolean access_technology_ready;
 
-            /* Signal quality is ready if unsupported or if we got a valid
-             * value reported */
-            signal_quality_ready = (!priv->signal_quality_polling_supported || (ctx->signal_quality != 0));
+            /* Signal quality is ready if unsupported, if we got a valid
+             * value reported or if indications are being received */
+            signal_quality_ready = (!priv->signal_quality_polling_supported ||
+                                    (ctx->signal_quality != 0) ||
+                                    signal_quality_indications_time_to_stale (priv));
 
             /* Access technology is ready if unsupported or if we got a valid
              * value reported */
@@ -1781,9 +1815,24 @@ periodic_signal_check_step (GTask *task)
             mm_obj_dbg (self, "periodic signal quality and access technology checks not rescheduled: unneeded or unsupported");
             periodic_signal_check_disable (self, FALSE);
         } else {
-            mm_obj_dbg (self, "periodic signal quality and access technology checks scheduled");
+            guint timeout_sec;
+
+            timeout_sec = (priv->signal_check_initial_done ? SIGNAL_CHECK_TIMEOUT_SEC : SIGNAL_CHECK_INITIAL_TIMEOUT_SEC);
+
+            /* If signal quality comes in indications and there is nothing else
+             * to poll, just wake up when the indications would go stale */
+            if (priv->signal_check_initial_done &&
+                priv->signal_quality_indications &&
+                (!priv->access_technology_polling_supported || priv->access_technology_polling_disabled)) {
+                timeout_sec = signal_quality_indications_time_to_stale (priv);
+                if (!timeout_sec)
+                    timeout_sec = SIGNAL_CHECK_INDICATIONS_STALE_TIMEOUT_SEC;
+                mm_obj_dbg (self, "periodic signal quality check scheduled in %us, only if no indications received", timeout_sec);
+            } else
+                mm_obj_dbg (self, "periodic signal quality and access technology checks scheduled");
+
             g_assert (!priv->signal_check_timeout_source);
-            priv->signal_check_timeout_source = g_timeout_add_seconds (priv->signal_check_initial_done ? SIGNAL_CHECK_TIMEOUT_SEC : SIGNAL_CHECK_INITIAL_TIMEOUT_SEC,
+            priv->signal_check_timeout_source = g_timeout_add_seconds (timeout_sec,
                                                                        (GSourceFunc) periodic_signal_check_run,
                                                                        self);
         }
@@ -1806,6 +1855,13 @@ periodic_signal_check_run (MMIfaceModem *self)
 
     priv = get_private (self);
 
+    /* The plugin-specific setup may change at runtime, e.g. once the
+     * unsolicited messages are enabled */
+    g_object_get (self,
+                  MM_IFACE_MODEM_PERIODIC_SIGNAL_CHECK_DISABLED,      &priv->signal_quality_polling_disabled,
+                  MM_IFACE_MODEM_PERIODIC_ACCESS_TECH_CHECK_DISABLED, &priv->access_technology_polling_disabled,
+                  NULL);
+
     task = g_task_new (self, NULL, NULL, NULL);
 
     ctx = g_new0 (SignalCheckContext, 1);
@@ -1861,6 +1917,28 @@ mm_iface_modem_refresh_signal (MMIfaceModem *self)
     periodic_signal_check_run (self);
 }
 
+void
+mm_iface_modem_set_signal_quality_indications (MMIfaceModem *self,
+                                               gboolean      enabled)
+{
+    Private *priv;
+
+    priv = get_private (self);
+    if (priv->signal_quality_indications == enabled)
+        return;
+
+    mm_obj_dbg (self, "signal quality indications %s", enabled ? "enabled" : "disabled");
+    priv->signal_quality_indications = enabled;
+
+    /* When indications are gone, go back to the regular polling interval */
+    if (!enabled && priv->signal_check_enabled && priv->signal_check_timeout_source) {
+        g_source_remove (priv->signal_check_timeout_source);
+        priv->signal_check_timeout_source = g_timeout_add_seconds (SIGNAL_CHECK_TIMEOUT_SEC,
+                                                                   (GSourceFunc) periodic_signal_check_run,
+                                                                   self);
+    }
+}
+
 static void
 periodic_signal_check_disable (MMIfaceModem *self,
                                gboolean      clear)
@@ -1924,6 +2002,29 @@ bearer_list_count_connected (MMBaseBearer *bearer,
         (*count)++;
 }
 
+static void
+bringup_step_track (MMIfaceModem *self,
+                    MMModemState  old_state,
+                    MMModemState  new_state)
+{
+    MMBaseModem *modem = MM_BASE_MODEM (self);
+
+    if (new_state == MM_MODEM_STATE_ENABLING)
+        mm_base_modem_bringup_step_started (modem, MM_BASE_MODEM_BRINGUP_STEP_ENABLE);
+    else if (old_state == MM_MODEM_STATE_ENABLING && new_state >= MM_MODEM_STATE_ENABLED) {
+        mm_base_modem_bringup_step_completed (modem, MM_BASE_MODEM_BRINGUP_STEP_ENABLE);
+        mm_base_modem_bringup_step_started (modem, MM_BASE_MODEM_BRINGUP_STEP_REGISTER);
+    }
+
+    if (new_state >= MM_MODEM_STATE_REGISTERED && old_state < MM_MODEM_STATE_REGISTERED)
+        mm_base_modem_bringup_step_completed (modem, MM_BASE_MODEM_BRINGUP_STEP_REGISTER);
+
+    if (new_state == MM_MODEM_STATE_CONNECTING)
+        mm_base_modem_bringup_step_started (modem, MM_BASE_MODEM_BRINGUP_STEP_CONNECT);
+    else if (new_state == MM_MODEM_STATE_CONNECTED)
+        mm_base_modem_bringup_step_completed (modem, MM_BASE_MODEM_BRINGUP_STEP_CONNECT);
+}
+
 static void
 update_state_internal (MMIfaceModem             *self,
                        MMModemState              new_state,
@@ -1989,6 +2090,8 @@ update_state_internal (MMIfaceModem             *self,
             mm_gdbus_modem_emit_state_changed (MM_GDBUS_MODEM (skeleton), old_state, new_state, reason);
         }
 
+        bringup_step_track (self, old_state, new_state);
+
         /* If we go to a registered/connected state (from unregistered), setup
          * signal quality and access technologies periodic retrieval */
         if (new_state >= MM_MODEM_STATE_REGISTERED && old_state < MM_MODEM_STATE_REGISTERED)
@@ -4392,6 +4495,8 @@ interface_enabling_step (GTask *task)
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
+    mm_trace_step (self, "iface-modem-enable", ctx->step, ENABLING_STEP_LAST);
+
     switch (ctx->step) {
     case ENABLING_STEP_FIRST:
         ctx->step++;
@@ -5341,6 +5446,8 @@ interface_initialization_step (GTask *task)
         return;
     }
 
+    mm_trace_step (self, "iface-modem-init", ctx->step, INITIALIZATION_STEP_LAST);
+
     switch (ctx->step) {
     case INITIALIZATION_STEP_FIRST:
         /* Load device if not done before */
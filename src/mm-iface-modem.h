@@ -550,13 +550,18 @@ void mm_iface_modem_update_access_technologies (MMIfaceModem *self,
                                                 MMModemAccessTechnology access_tech,
                                                 guint32 mask);
 
-/* Allow updating signal quality */
+/* Allow updating signal quality, as received in unsolicited messages */
 void mm_iface_modem_update_signal_quality (MMIfaceModem *self,
                                            guint signal_quality);
 
 /* Allow requesting to refresh signal via polling */
 void mm_iface_modem_refresh_signal (MMIfaceModem *self);
 
+/* Allow reporting whether the device sends signal quality indications, so
+ * that signal quality is only polled if they go stale */
+void mm_iface_modem_set_signal_quality_indications (MMIfaceModem *self,
+                                                    gboolean      enabled);
+
 /* Allow setting allowed modes */
 void     mm_iface_modem_set_current_modes        (MMIfaceModem *self,
                                                   MMModemMode allowed,
@@ -0,0 +1,241 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include <ModemManager.h>
+#include <ModemManager-tags.h>
+#include <mm-errors-types.h>
+
+#include "mm-link-pool.h"
+
+typedef struct {
+    gchar    *link_name;
+    guint     link_id;
+    gboolean  setup;
+} LinkInfo;
+
+static void
+link_info_clear (LinkInfo *info)
+{
+    g_free (info->link_name);
+}
+
+struct _MMLinkPool {
+    MMPort *main;
+    guint   size;
+    GArray *links;
+    /* links requested in parallel */
+    guint   n_pending;
+    GError *saved_error;
+};
+
+/*****************************************************************************/
+
+guint
+mm_link_pool_get_requested_size (MMPort *port,
+                                 guint   max_size)
+{
+    MMKernelDevice *kernel_device;
+    gint            size = 0;
+
+    kernel_device = mm_port_peek_kernel_device (port);
+    if (kernel_device && mm_kernel_device_has_global_property (kernel_device, ID_MM_MULTIPLEXED_LINK_POOL_SIZE))
+        size = mm_kernel_device_get_global_property_as_int (kernel_device, ID_MM_MULTIPLEXED_LINK_POOL_SIZE);
+    if (size <= 0)
+        return 0;
+
+    return MIN ((guint) size, max_size);
+}
+
+/*****************************************************************************/
+
+guint
+mm_link_pool_get_size (MMLinkPool *self)
+{
+    return self->size;
+}
+
+guint
+mm_link_pool_get_n_links (MMLinkPool *self)
+{
+    return self->links->len;
+}
+
+const gchar *
+mm_link_pool_get_link (MMLinkPool *self,
+                       guint       i,
+                       guint      *link_id)
+{
+    LinkInfo *info;
+
+    g_assert (i < self->links->len);
+
+    info = &g_array_index (self->links, LinkInfo, i);
+    if (link_id)
+        *link_id = info->link_id;
+    return info->link_name;
+}
+
+guint
+mm_link_pool_count_setup (MMLinkPool *self)
+{
+    guint i;
+    guint count = 0;
+
+    for (i = 0; i < self->links->len; i++) {
+        if (g_array_index (self->links, LinkInfo, i).setup)
+            count++;
+    }
+
+    return count;
+}
+
+/*****************************************************************************/
+
+void
+mm_link_pool_add_link (MMLinkPool *self,
+                       gchar      *link_name,
+                       guint       link_id)
+{
+    LinkInfo info = { link_name, link_id, FALSE };
+
+    g_assert (link_name);
+    g_array_append_val (self->links, info);
+}
+
+void
+mm_link_pool_set_pending (MMLinkPool *self,
+                          guint       n_pending)
+{
+    g_assert (!self->n_pending);
+    self->n_pending = n_pending;
+}
+
+gboolean
+mm_link_pool_complete_pending (MMLinkPool *self,
+                               gchar      *link_name,
+                               guint       link_id,
+                               GError     *error)
+{
+    if (link_name)
+        mm_link_pool_add_link (self, link_name, link_id);
+    else if (!self->saved_error)
+        self->saved_error = error;
+    else
+        g_error_free (error);
+
+    g_assert (self->n_pending > 0);
+    return (--self->n_pending > 0);
+}
+
+gboolean
+mm_link_pool_check_pending (MMLinkPool  *self,
+                            GError     **error)
+{
+    g_assert (!self->n_pending);
+
+    if (self->saved_error) {
+        g_prefix_error (&self->saved_error, "failed to add pooled links (%u/%u added) for device: ",
+                        self->links->len, self->size);
+        g_propagate_error (error, g_steal_pointer (&self->saved_error));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+gboolean
+mm_link_pool_acquire (MMLinkPool  *self,
+                      MMPort      *main,
+                      gchar      **link_name,
+                      guint       *link_id,
+                      GError     **error)
+{
+    guint i;
+
+    if ((main != self->main) &&
+        (g_strcmp0 (mm_port_get_device (main), mm_port_get_device (self->main)) != 0)) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Preallocated links available in 'net/%s', not in 'net/%s'",
+                     mm_port_get_device (self->main),
+                     mm_port_get_device (main));
+        return FALSE;
+    }
+
+    for (i = 0; i < self->links->len; i++) {
+        LinkInfo *info;
+
+        info = &g_array_index (self->links, LinkInfo, i);
+        if (info->setup)
+            continue;
+
+        info->setup = TRUE;
+        *link_name = g_strdup (info->link_name);
+        *link_id = info->link_id;
+        return TRUE;
+    }
+
+    g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                 "No more preallocated links available");
+    return FALSE;
+}
+
+gboolean
+mm_link_pool_release (MMLinkPool  *self,
+                      const gchar *link_name)
+{
+    guint i;
+
+    for (i = 0; i < self->links->len; i++) {
+        LinkInfo *info;
+
+        info = &g_array_index (self->links, LinkInfo, i);
+        if (!info->setup || (g_strcmp0 (info->link_name, link_name) != 0))
+            continue;
+
+        info->setup = FALSE;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*****************************************************************************/
+
+MMLinkPool *
+mm_link_pool_new (MMPort *main,
+                  guint   size)
+{
+    MMLinkPool *self;
+
+    g_assert (size > 0);
+
+    self = g_slice_new0 (MMLinkPool);
+    self->main = g_object_ref (main);
+    self->size = size;
+    self->links = g_array_sized_new (FALSE, FALSE, sizeof (LinkInfo), size);
+    g_array_set_clear_func (self->links, (GDestroyNotify)link_info_clear);
+    return self;
+}
+
+void
+mm_link_pool_free (MMLinkPool *self)
+{
+    g_clear_error (&self->saved_error);
+    g_array_unref (self->links);
+    g_object_unref (self->main);
+    g_slice_free (MMLinkPool, self);
+}
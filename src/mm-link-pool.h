@@ -0,0 +1,68 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_LINK_POOL_H
+#define MM_LINK_POOL_H
+
+#include <glib.h>
+
+#include "mm-port.h"
+
+/* Set of multiplexed links created in advance on a given main net port,
+ * shared by the QMI and MBIM control ports. Each link is identified by its
+ * name and by the mux id or session id given when it was added. */
+typedef struct _MMLinkPool MMLinkPool;
+
+/* Amount of links requested with the ID_MM_MULTIPLEXED_LINK_POOL_SIZE tag in
+ * the given control port, capped to max_size. 0 if no pool is requested. */
+guint        mm_link_pool_get_requested_size (MMPort      *port,
+                                              guint        max_size);
+
+MMLinkPool  *mm_link_pool_new                (MMPort      *main,
+                                              guint        size);
+void         mm_link_pool_free               (MMLinkPool  *self);
+
+guint        mm_link_pool_get_size           (MMLinkPool  *self);
+guint        mm_link_pool_get_n_links        (MMLinkPool  *self);
+const gchar *mm_link_pool_get_link           (MMLinkPool  *self,
+                                              guint        i,
+                                              guint       *link_id);
+guint        mm_link_pool_count_setup        (MMLinkPool  *self);
+
+/* Takes ownership of link_name */
+void         mm_link_pool_add_link           (MMLinkPool  *self,
+                                              gchar       *link_name,
+                                              guint        link_id);
+
+/* When links are requested in parallel, each result is reported with
+ * complete_pending(), which takes ownership of link_name and error and
+ * returns TRUE while more results are pending. The first error reported,
+ * if any, is then given by check_pending(). */
+void         mm_link_pool_set_pending        (MMLinkPool  *self,
+                                              guint        n_pending);
+gboolean     mm_link_pool_complete_pending   (MMLinkPool  *self,
+                                              gchar       *link_name,
+                                              guint        link_id,
+                                              GError      *error);
+gboolean     mm_link_pool_check_pending      (MMLinkPool  *self,
+                                              GError     **error);
+
+gboolean     mm_link_pool_acquire            (MMLinkPool  *self,
+                                              MMPort      *main,
+                                              gchar      **link_name,
+                                              guint       *link_id,
+                                              GError     **error);
+gboolean     mm_link_pool_release            (MMLinkPool  *self,
+                                              const gchar *link_name);
+
+#endif /* MM_LINK_POOL_H */
@@ -452,6 +452,105 @@ mm_bcd_to_string (const guint8 *bcd, gsize bcd_len, gboolean low_nybble_first)
     return g_string_free (str, FALSE);
 }
 
+/*****************************************************************************/
+/* Regex cache
+ *
+ * Compiled regexes are immutable once created, so the same GRegex can be
+ * shared by all the users of a given pattern and set of flags. The cache is
+ * never purged while the daemon runs, so it is bounded to avoid growing
+ * without limit if some user builds patterns dynamically.
+ */
+
+#define REGEX_CACHE_MAX_ENTRIES 512
+
+G_LOCK_DEFINE_STATIC (regex_cache);
+static GHashTable        *regex_cache;
+static MMRegexCacheStats  regex_cache_stats;
+
+GRegex *
+mm_regex_cache_get (const gchar         *pattern,
+                    GRegexCompileFlags   compile_options,
+                    GRegexMatchFlags     match_options,
+                    GError             **error)
+{
+    g_autofree gchar *key = NULL;
+    GRegex           *regex;
+
+    g_assert (pattern);
+
+    key = g_strdup_printf ("%x:%x:%s", compile_options, match_options, pattern);
+
+    G_LOCK (regex_cache);
+    if (!regex_cache)
+        regex_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_regex_unref);
+
+    regex = g_hash_table_lookup (regex_cache, key);
+    if (regex) {
+        regex_cache_stats.hits++;
+        g_regex_ref (regex);
+        G_UNLOCK (regex_cache);
+        return regex;
+    }
+    regex_cache_stats.misses++;
+    G_UNLOCK (regex_cache);
+
+    /* Compile without holding the lock; if some other thread compiled the same
+     * pattern in the meantime, the last one stored wins */
+    regex = g_regex_new (pattern, compile_options, match_options, error);
+    if (!regex)
+        return NULL;
+
+    G_LOCK (regex_cache);
+    if (g_hash_table_size (regex_cache) < REGEX_CACHE_MAX_ENTRIES) {
+        gsize key_len;
+
+        key_len = strlen (key) + 1;
+        if (!g_hash_table_contains (regex_cache, key)) {
+            regex_cache_stats.entries++;
+            regex_cache_stats.memory += key_len;
+        }
+        g_hash_table_replace (regex_cache, g_steal_pointer (&key), g_regex_ref (regex));
+    } else
+        regex_cache_stats.uncached++;
+    G_UNLOCK (regex_cache);
+
+    return regex;
+}
+
+void
+mm_regex_cache_get_stats (MMRegexCacheStats *stats)
+{
+    g_assert (stats);
+
+    G_LOCK (regex_cache);
+    *stats = regex_cache_stats;
+    G_UNLOCK (regex_cache);
+}
+
+void
+mm_regex_cache_log_stats (void)
+{
+    MMRegexCacheStats stats;
+    guint64           total;
+
+    mm_regex_cache_get_stats (&stats);
+    total = stats.hits + stats.misses;
+    mm_dbg ("regex cache: %u entries (%" G_GSIZE_FORMAT " bytes of keys), "
+            "%" G_GUINT64_FORMAT " lookups, %.1lf%% hit rate, %" G_GUINT64_FORMAT " uncached",
+            stats.entries, stats.memory, total,
+            total ? (100.0 * stats.hits) / total : 0.0,
+            stats.uncached);
+}
+
+void
+mm_regex_cache_clear (void)
+{
+    G_LOCK (regex_cache);
+    g_clear_pointer (&regex_cache, g_hash_table_unref);
+    memset (&regex_cache_stats, 0, sizeof (regex_cache_stats));
+    G_UNLOCK (regex_cache);
+}
+
 /*****************************************************************************/
 
 GRegex *
@@ -460,10 +559,10 @@ mm_voice_ring_regex_get (void)
     /* Example:
      * <CR><LF>RING<CR><LF>
      */
-    return g_regex_new ("\\r\\nRING(?:\\r)?\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\nRING(?:\\r)?\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 GRegex *
@@ -473,10 +572,10 @@ mm_voice_cring_regex_get (void)
      * <CR><LF>+CRING: VOICE<CR><LF>
      * <CR><LF>+CRING: DATA<CR><LF>
      */
-    return g_regex_new ("\\r\\n\\+CRING:\\s*(\\S+)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CRING:\\s*(\\S+)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 GRegex *
@@ -490,10 +589,10 @@ mm_voice_clip_regex_get (void)
      *   <CR><LF>+CLIP: "+393351391306",145,,,,0<CR><LF>
      *                   \_ Number      \_ Type
      */
-    return g_regex_new ("\\r\\n\\+CLIP:\\s*([^,\\s]*)\\s*,\\s*(\\d+)\\s*,?(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CLIP:\\s*([^,\\s]*)\\s*,\\s*(\\d+)\\s*,?(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 GRegex *
@@ -507,10 +606,10 @@ mm_voice_ccwa_regex_get (void)
      *   <CR><LF>+CCWA: "+393351391306",145,1
      *                   \_ Number      \_ Type
      */
-    return g_regex_new ("\\r\\n\\+CCWA:\\s*([^,\\s]*)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,?(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CCWA:\\s*([^,\\s]*)\\s*,\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,?(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 static void
@@ -565,15 +664,15 @@ mm_3gpp_parse_clcc_response (const gchar  *str,
      *  ...
      */
 
-    r = g_regex_new ("\\+CLCC:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)" /* mandatory fields */
-                     "(?:,\\s*([^,]*),\\s*(\\d+)"                                     /* number and type */
-                     "(?:,\\s*([^,]*)"                                                /* alpha */
-                     "(?:,\\s*(\\d*)"                                                 /* priority */
-                     "(?:,\\s*(\\d*)"                                                 /* CLI validity */
-                     ")?)?)?)?$",
-                     G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
-                     G_REGEX_MATCH_NEWLINE_CRLF,
-                     NULL);
+    r = mm_regex_cache_get ("\\+CLCC:\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+),\\s*(\\d+)" /* mandatory fields */
+                            "(?:,\\s*([^,]*),\\s*(\\d+)"                                     /* number and type */
+                            "(?:,\\s*([^,]*)"                                                /* alpha */
+                            "(?:,\\s*(\\d*)"                                                 /* priority */
+                            "(?:,\\s*(\\d*)"                                                 /* CLI validity */
+                            ")?)?)?)?$",
+                            G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
+                            G_REGEX_MATCH_NEWLINE_CRLF,
+                            NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
@@ -740,7 +839,7 @@ mm_parse_ifc_test_response (const gchar  *response,
     MMFlowControl          ta_mask     = MM_FLOW_CONTROL_UNKNOWN;
     MMFlowControl          mask        = MM_FLOW_CONTROL_UNKNOWN;
 
-    r = g_regex_new ("(?:\\+IFC:)?\\s*\\((.*)\\),\\((.*)\\)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:\\+IFC:)?\\s*\\((.*)\\),\\((.*)\\)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -800,6 +899,104 @@ mm_flow_control_from_string (const gchar  *str,
 
 /*************************************************************************/
 
+gchar *
+mm_at_command_get_extended_name (const gchar *command)
+{
+    const gchar *end;
+
+    if (g_ascii_strncasecmp (command, "AT", 2) == 0)
+        command += 2;
+
+    /* Extended syntax commands start with '+', or with a vendor-specific
+     * prefix character */
+    if (!command[0] || !strchr ("+$%^*", command[0]) || !g_ascii_isalpha (command[1]))
+        return NULL;
+
+    end = command + 1;
+    while (*end && *end != '?' && *end != '=' && *end != ';')
+        end++;
+
+    return g_ascii_strup (command, end - command);
+}
+
+GStrv
+mm_split_concatenated_at_response (const gchar  *response,
+                                   const gchar **commands,
+                                   GError      **error)
+{
+    g_autoptr(GPtrArray)  names = NULL;
+    g_autoptr(GPtrArray)  responses = NULL;
+    g_auto(GStrv)         lines = NULL;
+    guint                 current = 0;
+    guint                 i;
+
+    names = g_ptr_array_new_with_free_func (g_free);
+    for (i = 0; commands[i]; i++) {
+        gchar *name;
+        guint  j;
+
+        name = mm_at_command_get_extended_name (commands[i]);
+        if (!name) {
+            g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                         "Command '%s' doesn't use the extended syntax", commands[i]);
+            return NULL;
+        }
+        /* Responses to the same command name can't be told apart */
+        for (j = 0; j < names->len; j++) {
+            if (g_str_equal (name, g_ptr_array_index (names, j))) {
+                g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                             "Command '%s' given more than once", name);
+                g_free (name);
+                return NULL;
+            }
+        }
+        g_ptr_array_add (names, name);
+    }
+
+    responses = g_ptr_array_new_with_free_func (g_free);
+    for (i = 0; i < names->len; i++)
+        g_ptr_array_add (responses, g_strdup (""));
+
+    /* Each line is assigned to the first command with a matching name, which
+     * must not be before the one matched by the previous line, as the modem
+     * runs the commands in order */
+    lines = g_strsplit (response ? response : "", "\n", -1);
+    for (i = 0; lines[i]; i++) {
+        const gchar *line;
+        guint        j;
+        gchar       *aux;
+
+        line = g_strstrip (lines[i]);
+        if (!line[0])
+            continue;
+
+        for (j = current; j < names->len; j++) {
+            const gchar *name;
+            gsize        name_len;
+
+            name = g_ptr_array_index (names, j);
+            name_len = strlen (name);
+            if (g_ascii_strncasecmp (line, name, name_len) == 0 && line[name_len] == ':')
+                break;
+        }
+        if (j == names->len) {
+            g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                         "Couldn't match response line '%s' to any command", line);
+            return NULL;
+        }
+        current = j;
+
+        aux = g_ptr_array_index (responses, j);
+        responses->pdata[j] = (aux[0] ? g_strdup_printf ("%s\r\n%s", aux, line) : g_strdup (line));
+        g_free (aux);
+    }
+
+    g_ptr_array_add (responses, NULL);
+    return (GStrv) g_ptr_array_free (g_steal_pointer (&responses), FALSE);
+}
+
+/*************************************************************************/
+
 static const gchar *creg_regex[] = {
     /* +CREG: <stat>                      (GSM 07.07 CREG=1 unsolicited) */
     [0] = "\\+(CREG|CGREG|CEREG|C5GREG):\\s*0*([0-9])",
@@ -843,10 +1040,10 @@ mm_3gpp_creg_regex_get (gboolean solicited)
 
         if (solicited) {
             pattern = g_strdup_printf ("%s$", creg_regex[i]);
-            regex = g_regex_new (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+            regex = mm_regex_cache_get (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
         } else {
             pattern = g_strdup_printf ("\\r\\n%s\\r\\n", creg_regex[i]);
-            regex = g_regex_new (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+            regex = mm_regex_cache_get (pattern, G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
         }
         g_assert (regex);
         g_ptr_array_add (array, regex);
@@ -866,10 +1063,10 @@ mm_3gpp_creg_regex_destroy (GPtrArray *array)
 GRegex *
 mm_3gpp_ciev_regex_get (void)
 {
-    return g_regex_new ("\\r\\n\\+CIEV: (.*),(\\d)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CIEV: (.*),(\\d)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 /*************************************************************************/
@@ -877,10 +1074,10 @@ mm_3gpp_ciev_regex_get (void)
 GRegex *
 mm_3gpp_cgev_regex_get (void)
 {
-    return g_regex_new ("\\r\\n\\+CGEV:\\s*(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CGEV:\\s*(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 /*************************************************************************/
@@ -888,10 +1085,10 @@ mm_3gpp_cgev_regex_get (void)
 GRegex *
 mm_3gpp_cusd_regex_get (void)
 {
-    return g_regex_new ("\\r\\n\\+CUSD:\\s*(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CUSD:\\s*(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 /*************************************************************************/
@@ -899,10 +1096,10 @@ mm_3gpp_cusd_regex_get (void)
 GRegex *
 mm_3gpp_cmti_regex_get (void)
 {
-    return g_regex_new ("\\r\\n\\+CMTI:\\s*\"(\\S+)\",\\s*(\\d+)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CMTI:\\s*\"(\\S+)\",\\s*(\\d+)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 GRegex *
@@ -911,10 +1108,10 @@ mm_3gpp_cds_regex_get (void)
     /* Example:
      * <CR><LF>+CDS: 24<CR><LF>07914356060013F10659098136395339F6219011707193802190117071938030<CR><LF>
      */
-    return g_regex_new ("\\r\\n\\+CDS:\\s*(\\d+)\\r\\n(.*)\\r\\n",
-                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                        0,
-                        NULL);
+    return mm_regex_cache_get ("\\r\\n\\+CDS:\\s*(\\d+)\\r\\n(.*)\\r\\n",
+                               G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                               0,
+                               NULL);
 }
 
 /*************************************************************************/
@@ -991,7 +1188,7 @@ mm_3gpp_parse_ws46_test_response (const gchar  *response,
     gboolean               supported_mode_25 = FALSE;
     gboolean               supported_mode_29 = FALSE;
 
-    r = g_regex_new ("(?:\\+WS46:)?\\s*\\((.*)\\)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:\\+WS46:)?\\s*\\((.*)\\)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -1218,7 +1415,7 @@ mm_3gpp_parse_cops_test_response (const gchar     *reply,
      *       +COPS: (2,"","EE","23430","609C",7)
      */
 
-    r = g_regex_new ("\\((\\d),\"([^\"\\)]*)\",([^,\\)]*),([^,\\)]*)[\\)]?,([^,\\)]*,)?(\\d+)\\)", G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("\\((\\d),\"([^\"\\)]*)\",([^,\\)]*),([^,\\)]*)[\\)]?,([^,\\)]*,)?(\\d+)\\)", G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r);
 
     /* If we didn't get any hits, try the pre-UMTS format match */
@@ -1239,7 +1436,7 @@ mm_3gpp_parse_cops_test_response (const gchar     *reply,
          *       +COPS: (2,"T - Mobile",,"31026"),(1,"Einstein PCS",,"31064"),(1,"Cingular",,"31041"),,(0,1,3),(0,2)
          */
 
-        r = g_regex_new ("\\((\\d),([^,\\)]*),([^,\\)]*),([^\\)]*)\\)", G_REGEX_UNGREEDY, 0, NULL);
+        r = mm_regex_cache_get ("\\((\\d),([^,\\)]*),([^,\\)]*),([^\\)]*)\\)", G_REGEX_UNGREEDY, 0, NULL);
         g_assert (r);
 
         g_regex_match (r, reply, 0, &match_info);
@@ -1345,7 +1542,7 @@ mm_3gpp_parse_cops_read_response (const gchar              *response,
      * or:
      *   +COPS: <mode>,<format>,<oper>,<AcT>
      */
-    r = g_regex_new ("\\+COPS:\\s*(\\d+),(\\d+),([^,]*)(?:,(\\d+))?(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+COPS:\\s*(\\d+),(\\d+),([^,]*)(?:,(\\d+))?(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -1724,9 +1921,9 @@ mm_3gpp_parse_cgdcont_test_response (const gchar  *response,
         return NULL;
     }
 
-    r = g_regex_new ("\\+CGDCONT:\\s*\\(\\s*(\\d+)\\s*-?\\s*(\\d+)?[^\\)]*\\)\\s*,\\s*\\(?\"(\\S+)\"",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, &inner_error);
+    r = mm_regex_cache_get ("\\+CGDCONT:\\s*\\(\\s*(\\d+)\\s*-?\\s*(\\d+)?[^\\)]*\\)\\s*,\\s*\\(?\"(\\S+)\"",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, &inner_error);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -1808,9 +2005,9 @@ mm_3gpp_parse_cgdcont_read_response (const gchar *reply,
         /* No APNs configured, all done */
         return NULL;
 
-    r = g_regex_new ("\\+CGDCONT:\\s*(\\d+)\\s*,([^, \\)]*)\\s*,([^, \\)]*)\\s*,([^, \\)]*)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, NULL);
+    r = mm_regex_cache_get ("\\+CGDCONT:\\s*(\\d+)\\s*,([^, \\)]*)\\s*,([^, \\)]*)\\s*,([^, \\)]*)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, NULL);
     g_assert (r);
 
     g_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &inner_error);
@@ -1885,8 +2082,8 @@ mm_3gpp_parse_cgact_read_response (const gchar *reply,
         /* Nothing configured, all done */
         return NULL;
 
-    r = g_regex_new ("\\+CGACT:\\s*(\\d+),(\\d+)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, &inner_error);
+    r = mm_regex_cache_get ("\\+CGACT:\\s*(\\d+),(\\d+)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW, 0, &inner_error);
     g_assert (r);
 
     g_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &inner_error);
@@ -2128,7 +2325,7 @@ mm_3gpp_parse_cmgf_test_response (const gchar *reply,
     while (isspace (*reply))
         reply++;
 
-    r = g_regex_new ("\\(?\\s*(\\d+)\\s*[-,]?\\s*(\\d+)?\\s*\\)?", 0, 0, error);
+    r = mm_regex_cache_get ("\\(?\\s*(\\d+)\\s*[-,]?\\s*(\\d+)?\\s*\\)?", 0, 0, error);
     if (!r)
         return FALSE;
 
@@ -2176,7 +2373,7 @@ mm_3gpp_parse_cmgr_read_response (const gchar *reply,
 
     /* +CMGR: <stat>,<alpha>,<length>(whitespace)<pdu> */
     /* The <alpha> and <length> fields are matched, but not currently used */
-    r = g_regex_new ("\\+CMGR:\\s*(\\d+)\\s*,([^,]*),\\s*(\\d+)\\s*([^\\r\\n]*)", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CMGR:\\s*(\\d+)\\s*,([^,]*),\\s*(\\d+)\\s*([^\\r\\n]*)", 0, 0, NULL);
     g_assert (r);
 
     if (!g_regex_match (r, reply, 0, &match_info)) {
@@ -2252,8 +2449,8 @@ mm_3gpp_parse_crsm_response (const gchar *reply,
         return FALSE;
     }
 
-    r = g_regex_new ("\\+CRSM:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*\"?([0-9a-fA-F]+)\"?",
-                     G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+CRSM:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,\\s*\"?([0-9a-fA-F]+)\"?",
+                            G_REGEX_RAW, 0, NULL);
     g_assert (r != NULL);
 
     if (g_regex_match (r, reply, 0, &match_info) &&
@@ -2364,16 +2561,16 @@ mm_3gpp_parse_cgcontrdp_response (const gchar  *response,
      * The format of the response changed in TS 27.007 v9.4.0, we try to detect
      * both formats ('a' if >= v9.4.0, 'b' if < v9.4.0) with a single regex here.
      */
-    r = g_regex_new ("\\+CGCONTRDP: "
-                     "(\\d+),(\\d+),([^,]*)" /* cid, bearer id, apn */
-                     "(?:,([^,]*))?" /* (a)ip+mask        or (b)ip */
-                     "(?:,([^,]*))?" /* (a)gateway        or (b)mask */
-                     "(?:,([^,]*))?" /* (a)dns1           or (b)gateway */
-                     "(?:,([^,]*))?" /* (a)dns2           or (b)dns1 */
-                     "(?:,([^,]*))?" /* (a)p-cscf primary or (b)dns2 */
-                     "(?:,(.*))?"    /* others, ignored */
-                     "(?:\\r\\n)?",
-                     0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CGCONTRDP: "
+                            "(\\d+),(\\d+),([^,]*)" /* cid, bearer id, apn */
+                            "(?:,([^,]*))?" /* (a)ip+mask        or (b)ip */
+                            "(?:,([^,]*))?" /* (a)gateway        or (b)mask */
+                            "(?:,([^,]*))?" /* (a)dns1           or (b)gateway */
+                            "(?:,([^,]*))?" /* (a)dns2           or (b)dns1 */
+                            "(?:,([^,]*))?" /* (a)p-cscf primary or (b)dns2 */
+                            "(?:,(.*))?"    /* others, ignored */
+                            "(?:\\r\\n)?",
+                            0, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -2460,7 +2657,7 @@ mm_3gpp_parse_cfun_query_response (const gchar  *response,
      * +CFUN: 1,0
      *   ..but we don't care about the second number
      */
-    r = g_regex_new ("\\+CFUN: (\\d+)(?:,(?:\\d+))?(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CFUN: (\\d+)(?:,(?:\\d+))?(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -2524,7 +2721,7 @@ mm_3gpp_parse_cesq_response (const gchar  *response,
     /* Response may be e.g.:
      * +CESQ: 99,99,255,255,20,80
      */
-    r = g_regex_new ("\\+CESQ: (\\d+),(\\d+),(\\d+),(\\d+),(\\d+),(\\d+)(?:\\r\\n)?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CESQ: (\\d+),(\\d+),(\\d+),(\\d+),(\\d+),(\\d+)(?:\\r\\n)?", 0, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -2829,10 +3026,10 @@ mm_3gpp_parse_ccwa_service_query_response (const gchar  *response,
      *
      * We're only interested in class 1 (voice)
      */
-    r = g_regex_new ("\\+CCWA:\\s*(\\d+),\\s*(\\d+)$",
-                     G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
-                     G_REGEX_MATCH_NEWLINE_CRLF,
-                     NULL);
+    r = mm_regex_cache_get ("\\+CCWA:\\s*(\\d+),\\s*(\\d+)$",
+                            G_REGEX_RAW | G_REGEX_MULTILINE | G_REGEX_NEWLINE_CRLF,
+                            G_REGEX_MATCH_NEWLINE_CRLF,
+                            NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, response, strlen (response), 0, 0, &match_info, &inner_error);
@@ -2958,7 +3155,7 @@ mm_3gpp_parse_cpms_test_response (const gchar  *reply,
         return FALSE;
     }
 
-    r = g_regex_new ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
     g_assert (r);
 
     for (i = 0; i < N_EXPECTED_GROUPS; i++) {
@@ -3029,7 +3226,7 @@ mm_3gpp_parse_cpms_query_response (const gchar *reply,
     g_autoptr(GRegex)     r = NULL;
     g_autoptr(GMatchInfo) match_info = NULL;
 
-    r = g_regex_new (CPMS_QUERY_REGEX, G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get (CPMS_QUERY_REGEX, G_REGEX_RAW, 0, NULL);
     g_assert (r);
 
     if (!g_regex_match (r, reply, 0, &match_info)) {
@@ -3108,7 +3305,7 @@ mm_3gpp_parse_cscs_test_response (const gchar *reply,
     }
 
     /* Now parse each charset */
-    r = g_regex_new ("\\s*([^,\\)]+)\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*([^,\\)]+)\\s*", 0, 0, NULL);
     g_assert (r);
 
     if (g_regex_match (r, p, 0, &match_info)) {
@@ -3147,7 +3344,7 @@ mm_3gpp_parse_clck_test_response (const gchar *reply,
     reply = mm_strip_tag (reply, "+CLCK:");
 
     /* Now parse each facility */
-    r = g_regex_new ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*\"([^,\\)]+)\"\\s*", 0, 0, NULL);
     g_assert (r != NULL);
 
     *out_facilities = MM_MODEM_3GPP_FACILITY_NONE;
@@ -3182,7 +3379,7 @@ mm_3gpp_parse_clck_write_response (const gchar *reply,
 
     reply = mm_strip_tag (reply, "+CLCK:");
 
-    r = g_regex_new ("\\s*([01])\\s*", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\s*([01])\\s*", 0, 0, NULL);
     g_assert (r != NULL);
 
     if (g_regex_match (r, reply, 0, &match_info)) {
@@ -3218,8 +3415,8 @@ mm_3gpp_parse_cnum_exec_response (const gchar *reply)
     if (!reply || !reply[0])
         return NULL;
 
-    r = g_regex_new ("\\+CNUM:\\s*((\"([^\"]|(\\\"))*\")|([^,]*)),\"(?<num>\\S+)\",\\d",
-                     G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("\\+CNUM:\\s*((\"([^\"]|(\\\"))*\")|([^,]*)),\"(?<num>\\S+)\",\\d",
+                            G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r != NULL);
 
     array = g_ptr_array_new ();
@@ -3448,7 +3645,7 @@ mm_3gpp_parse_cind_test_response (const gchar *reply,
     while (isspace (*reply))
         reply++;
 
-    r = g_regex_new ("\\(([^,]*),\\((\\d+)[-,](\\d+).*\\)", G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("\\(([^,]*),\\((\\d+)[-,](\\d+).*\\)", G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r);
 
     hash = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) cind_response_free);
@@ -3505,7 +3702,7 @@ mm_3gpp_parse_cind_read_response (const gchar *reply,
 
     reply = mm_strip_tag (reply, CIND_TAG);
 
-    r = g_regex_new ("(\\d+)[^0-9]+", G_REGEX_UNGREEDY, 0, NULL);
+    r = mm_regex_cache_get ("(\\d+)[^0-9]+", G_REGEX_UNGREEDY, 0, NULL);
     g_assert (r != NULL);
 
     if (!g_regex_match (r, reply, 0, &match_info)) {
@@ -3657,11 +3854,11 @@ mm_3gpp_parse_cgev_indication_pdp (const gchar  *str,
               type == MM_3GPP_CGEV_NW_DEACT_PDP ||
               type == MM_3GPP_CGEV_ME_DEACT_PDP);
 
-    r = g_regex_new ("(?:"
-                     "REJECT|"
-                     "NW REACT|"
-                     "NW DEACT|ME DEACT"
-                     ")\\s*([^,]*),\\s*([^,]*)(?:,\\s*([0-9]+))?", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:"
+                            "REJECT|"
+                            "NW REACT|"
+                            "NW DEACT|ME DEACT"
+                            ")\\s*([^,]*),\\s*([^,]*)(?:,\\s*([0-9]+))?", 0, 0, NULL);
     g_assert (r);
 
     str = mm_strip_tag (str, "+CGEV:");
@@ -3732,10 +3929,10 @@ mm_3gpp_parse_cgev_indication_primary (const gchar  *str,
               (type == MM_3GPP_CGEV_NW_DEACT_PRIMARY) ||
               (type == MM_3GPP_CGEV_ME_DEACT_PRIMARY));
 
-    r = g_regex_new ("(?:"
-                     "NW PDN ACT|ME PDN ACT|"
-                     "NW PDN DEACT|ME PDN DEACT|"
-                     ")\\s*([0-9]+)", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:"
+                            "NW PDN ACT|ME PDN ACT|"
+                            "NW PDN DEACT|ME PDN DEACT|"
+                            ")\\s*([0-9]+)", 0, 0, NULL);
 
     str = mm_strip_tag (str, "+CGEV:");
     g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
@@ -3789,10 +3986,10 @@ mm_3gpp_parse_cgev_indication_secondary (const gchar  *str,
               type == MM_3GPP_CGEV_NW_DEACT_SECONDARY ||
               type == MM_3GPP_CGEV_ME_DEACT_SECONDARY);
 
-    r = g_regex_new ("(?:"
-                     "NW ACT|ME ACT|"
-                     "NW DEACT|ME DEACT"
-                     ")\\s*([0-9]+),\\s*([0-9]+),\\s*([0-9]+)", 0, 0, NULL);
+    r = mm_regex_cache_get ("(?:"
+                            "NW ACT|ME ACT|"
+                            "NW DEACT|ME DEACT"
+                            ")\\s*([0-9]+),\\s*([0-9]+),\\s*([0-9]+)", 0, 0, NULL);
 
     str = mm_strip_tag (str, "+CGEV:");
     g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
@@ -3865,8 +4062,8 @@ mm_3gpp_parse_pdu_cmgl_response (const gchar *str,
      *
      * We just read <index>, <stat> and the PDU itself.
      */
-    r = g_regex_new ("\\+CMGL:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,(.*)\\r\\n([^\\r\\n]*)(\\r\\n)?",
-                     G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    r = mm_regex_cache_get ("\\+CMGL:\\s*(\\d+)\\s*,\\s*(\\d+)\\s*,(.*)\\r\\n([^\\r\\n]*)(\\r\\n)?",
+                            G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
     g_assert (r != NULL);
 
     g_regex_match_full (r, str, strlen (str), 0, 0, &match_info, &inner_error);
@@ -4638,9 +4835,9 @@ mm_cdma_parse_crm_test_response (const gchar *reply,
      *   <--- +CRM: (0-2)
      */
 
-    r = g_regex_new ("\\+CRM:\\s*\\((\\d+)-(\\d+)\\)",
-                     G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
-                     0, error);
+    r = mm_regex_cache_get ("\\+CRM:\\s*\\((\\d+)-(\\d+)\\)",
+                            G_REGEX_DOLLAR_ENDONLY | G_REGEX_RAW,
+                            0, error);
     g_assert (r != NULL);
 
     if (g_regex_match_full (r, reply, strlen (reply), 0, 0, &match_info, &match_error)) {
@@ -4927,7 +5124,7 @@ mm_parse_cclk_response (const char *response,
      *  +CCLK: "15/03/05,14:14:26-32"
      *  +CCLK: 17/07/26,11:42:15+01
      */
-    r = g_regex_new ("\\+CCLK:\\s*\"?(\\d+)/(\\d+)/(\\d+),(\\d+):(\\d+):(\\d+)([-+]\\d+)?\"?", 0, 0, NULL);
+    r = mm_regex_cache_get ("\\+CCLK:\\s*\"?(\\d+)/(\\d+)/(\\d+),(\\d+):(\\d+):(\\d+)([-+]\\d+)?\"?", 0, 0, NULL);
     g_assert (r != NULL);
 
     if (!g_regex_match_full (r, response, -1, 0, 0, &match_info, &match_error)) {
@@ -5015,7 +5212,7 @@ mm_parse_csim_response (const gchar *response,
     guint                  hex_code;
     GError                *inner_error = NULL;
 
-    r = g_regex_new ("\\+CSIM:\\s*[0-9]+,\\s*\".*([0-9a-fA-F]{4})\"", G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+CSIM:\\s*[0-9]+,\\s*\".*([0-9a-fA-F]{4})\"", G_REGEX_RAW, 0, NULL);
     g_regex_match (r, response, 0, &match_info);
 
     if (!g_match_info_matches (match_info)) {
@@ -5159,13 +5356,13 @@ mm_sim_parse_cpol_query_response (const gchar  *response,
     guint                  act = 0;
     guint                  match_count;
 
-    r = g_regex_new ("\\+CPOL:\\s*(\\d+),\\s*(\\d+),\\s*\"?(\\d+)\"?"
-                     "(?:,\\s*(\\d+))?"     /* GSM_AcTn */
-                     "(?:,\\s*(\\d+))?"     /* GSM_Compact_AcTn */
-                     "(?:,\\s*(\\d+))?"     /* UTRAN_AcTn */
-                     "(?:,\\s*(\\d+))?"     /* E-UTRAN_AcTn */
-                     "(?:,\\s*(\\d+))?",    /* NG-RAN_AcTn */
-                     G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+CPOL:\\s*(\\d+),\\s*(\\d+),\\s*\"?(\\d+)\"?"
+                            "(?:,\\s*(\\d+))?"     /* GSM_AcTn */
+                            "(?:,\\s*(\\d+))?"     /* GSM_Compact_AcTn */
+                            "(?:,\\s*(\\d+))?"     /* UTRAN_AcTn */
+                            "(?:,\\s*(\\d+))?"     /* E-UTRAN_AcTn */
+                            "(?:,\\s*(\\d+))?",    /* NG-RAN_AcTn */
+                            G_REGEX_RAW, 0, NULL);
     g_regex_match (r, response, 0, &match_info);
 
     if (!g_match_info_matches (match_info)) {
@@ -5246,8 +5443,8 @@ mm_sim_parse_cpol_test_response (const gchar  *response,
     guint                  min_index;
     guint                  max_index;
 
-    r = g_regex_new ("\\+CPOL:\\s*\\((\\d+)\\s*-\\s*(\\d+)\\)",
-                     G_REGEX_RAW, 0, NULL);
+    r = mm_regex_cache_get ("\\+CPOL:\\s*\\((\\d+)\\s*-\\s*(\\d+)\\)",
+                            G_REGEX_RAW, 0, NULL);
     g_regex_match (r, response, 0, &match_info);
 
     if (!g_match_info_matches (match_info)) {
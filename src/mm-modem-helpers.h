@@ -79,6 +79,26 @@ gchar *mm_bcd_to_string (const guint8 *bcd,
                          gsize bcd_len,
                          gboolean low_nybble_first);
 
+/* Process-wide cache of compiled regexes, indexed by pattern and flags. The
+ * returned regex is a new reference and must be unref-ed by the caller, just
+ * as if it had been created with g_regex_new(). */
+GRegex *mm_regex_cache_get (const gchar         *pattern,
+                            GRegexCompileFlags   compile_options,
+                            GRegexMatchFlags     match_options,
+                            GError             **error);
+
+typedef struct {
+    guint64 hits;
+    guint64 misses;
+    guint64 uncached; /* compiled but not stored, cache full */
+    guint   entries;
+    gsize   memory;   /* keys only, GRegex doesn't report its compiled size */
+} MMRegexCacheStats;
+
+void mm_regex_cache_get_stats (MMRegexCacheStats *stats);
+void mm_regex_cache_log_stats (void);
+void mm_regex_cache_clear     (void);
+
 /*****************************************************************************/
 /* VOICE specific helpers and utilities */
 /*****************************************************************************/
@@ -122,6 +142,14 @@ MMFlowControl mm_parse_ifc_test_response (const gchar  *response,
 MMFlowControl mm_flow_control_from_string (const gchar  *str,
                                            GError      **error);
 
+/* Concatenated AT commands (e.g. AT+CPIN?;+CREG?) support.
+ * Only extended syntax commands are supported, and all the lines in the
+ * response to each command must be prefixed by the command name. */
+gchar *mm_at_command_get_extended_name   (const gchar   *command);
+GStrv  mm_split_concatenated_at_response (const gchar   *response,
+                                          const gchar  **commands,
+                                          GError       **error);
+
 /*****************************************************************************/
 /* 3GPP specific helpers and utilities */
 /*****************************************************************************/
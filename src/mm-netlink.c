@@ -17,6 +17,7 @@
  * Copyright (C) 2021 Aleksander Morgado <aleksander@aleksander.es>
  */
 
+#include <linux/if_link.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <net/if.h>
@@ -40,6 +41,10 @@ struct _MMNetlink {
     /* Netlink state */
     guint       current_sequence_id;
     GHashTable *transactions;
+    /* Link and address events socket */
+    GSocket *events_socket;
+    GSource *events_source;
+    guint    events_users;
 };
 
 struct _MMNetlinkClass {
@@ -51,6 +56,14 @@ static void log_object_iface_init (MMLogObjectInterface *iface);
 G_DEFINE_TYPE_EXTENDED (MMNetlink, mm_netlink, G_TYPE_OBJECT, 0,
                         G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
 
+enum {
+    SIGNAL_LINK_CHANGED,
+    SIGNAL_ADDRESS_CHANGED,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
 
 /*****************************************************************************/
 /*
@@ -160,6 +173,22 @@ netlink_message_new_setlink (guint    ifindex,
     return msg;
 }
 
+static NetlinkMessage *
+netlink_message_new_getlink (guint ifindex)
+{
+    NetlinkMessage *msg;
+    NetlinkHeader  *hdr;
+
+    msg = netlink_message_new (ifindex, RTM_GETLINK);
+    hdr = netlink_message_header (msg);
+
+    /* The RTM_NEWLINK reply already acknowledges the request, and errors
+     * are reported via NLMSG_ERROR even without NLM_F_ACK. */
+    hdr->msghdr.nlmsg_flags = NLM_F_REQUEST;
+
+    return msg;
+}
+
 static void
 netlink_message_free (NetlinkMessage *msg)
 {
@@ -235,6 +264,76 @@ transaction_complete (Transaction *tr,
     g_object_unref (task);
 }
 
+typedef struct {
+    guint    flags;
+    guint    mtu;
+    gboolean has_stats;
+    guint64  rx_bytes;
+    guint64  tx_bytes;
+} LinkInfo;
+
+static void
+transaction_complete_with_link_info (Transaction     *tr,
+                                     struct nlmsghdr *hdr)
+{
+    GTask            *task;
+    struct ifinfomsg *ifi;
+    struct rtattr    *rta;
+    gint              rta_len;
+    LinkInfo         *info;
+
+    task = g_steal_pointer (&tr->completion_task);
+
+    g_hash_table_remove (tr->self->transactions,
+                         GUINT_TO_POINTER (tr->sequence_id));
+
+    if (hdr->nlmsg_len < NLMSG_LENGTH (sizeof (struct ifinfomsg))) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                 "Netlink link info message too short");
+        g_object_unref (task);
+        return;
+    }
+
+    info = g_new0 (LinkInfo, 1);
+    ifi = NLMSG_DATA (hdr);
+    info->flags = ifi->ifi_flags;
+    rta_len = IFLA_PAYLOAD (hdr);
+    for (rta = IFLA_RTA (ifi); RTA_OK (rta, rta_len); rta = RTA_NEXT (rta, rta_len)) {
+        if (rta->rta_type == IFLA_MTU && RTA_PAYLOAD (rta) >= sizeof (guint32)) {
+            guint32 mtu;
+
+            memcpy (&mtu, RTA_DATA (rta), sizeof (mtu));
+            info->mtu = mtu;
+            continue;
+        }
+        /* Prefer the 64bit counters, but accept the legacy 32bit ones
+         * if that is all the kernel gives us */
+        if (rta->rta_type == IFLA_STATS64 &&
+            RTA_PAYLOAD (rta) >= sizeof (struct rtnl_link_stats64)) {
+            struct rtnl_link_stats64 link_stats64;
+
+            memcpy (&link_stats64, RTA_DATA (rta), sizeof (link_stats64));
+            info->has_stats = TRUE;
+            info->rx_bytes = link_stats64.rx_bytes;
+            info->tx_bytes = link_stats64.tx_bytes;
+            continue;
+        }
+        if (rta->rta_type == IFLA_STATS &&
+            RTA_PAYLOAD (rta) >= sizeof (struct rtnl_link_stats) &&
+            !info->has_stats) {
+            struct rtnl_link_stats link_stats;
+
+            memcpy (&link_stats, RTA_DATA (rta), sizeof (link_stats));
+            info->has_stats = TRUE;
+            info->rx_bytes = link_stats.rx_bytes;
+            info->tx_bytes = link_stats.tx_bytes;
+        }
+    }
+
+    g_task_return_pointer (task, info, g_free);
+    g_object_unref (task);
+}
+
 static void
 transaction_free (Transaction *tr)
 {
@@ -327,13 +426,128 @@ mm_netlink_setlink (MMNetlink           *self,
 
 /*****************************************************************************/
 
+static void
+netlink_request_link (MMNetlink    *self,
+                      guint         ifindex,
+                      GCancellable *cancellable,
+                      GTask        *task)
+{
+    NetlinkMessage *msg;
+    Transaction    *tr;
+    gssize          bytes_sent;
+    GError         *error = NULL;
+
+    if (!self->socket) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                 "netlink support not available");
+        g_object_unref (task);
+        return;
+    }
+
+    msg = netlink_message_new_getlink (ifindex);
+
+    /* The task ownership is transferred to the transaction. */
+    tr = transaction_new (self, msg, 5, task);
+
+    bytes_sent = g_socket_send (self->socket,
+                                (const gchar *) msg->data,
+                                msg->len,
+                                cancellable,
+                                &error);
+    netlink_message_free (msg);
+
+    if (bytes_sent < 0)
+        transaction_complete_with_error (tr, error);
+
+    g_object_unref (task);
+}
+
+gboolean
+mm_netlink_get_link_finish (MMNetlink     *self,
+                            GAsyncResult  *res,
+                            guint         *flags,
+                            guint         *mtu,
+                            GError       **error)
+{
+    LinkInfo *info;
+
+    info = g_task_propagate_pointer (G_TASK (res), error);
+    if (!info)
+        return FALSE;
+
+    if (flags)
+        *flags = info->flags;
+    if (mtu)
+        *mtu = info->mtu;
+    g_free (info);
+    return TRUE;
+}
+
+void
+mm_netlink_get_link (MMNetlink           *self,
+                     guint                ifindex,
+                     GCancellable        *cancellable,
+                     GAsyncReadyCallback  callback,
+                     gpointer             user_data)
+{
+    netlink_request_link (self,
+                          ifindex,
+                          cancellable,
+                          g_task_new (self, cancellable, callback, user_data));
+}
+
+/*****************************************************************************/
+
+gboolean
+mm_netlink_get_link_stats_finish (MMNetlink     *self,
+                                  GAsyncResult  *res,
+                                  guint64       *rx_bytes,
+                                  guint64       *tx_bytes,
+                                  GError       **error)
+{
+    LinkInfo *info;
+
+    info = g_task_propagate_pointer (G_TASK (res), error);
+    if (!info)
+        return FALSE;
+
+    if (!info->has_stats) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED,
+                     "Netlink link info message without stats");
+        g_free (info);
+        return FALSE;
+    }
+
+    if (rx_bytes)
+        *rx_bytes = info->rx_bytes;
+    if (tx_bytes)
+        *tx_bytes = info->tx_bytes;
+    g_free (info);
+    return TRUE;
+}
+
+void
+mm_netlink_get_link_stats (MMNetlink           *self,
+                           guint                ifindex,
+                           GCancellable        *cancellable,
+                           GAsyncReadyCallback  callback,
+                           gpointer             user_data)
+{
+    netlink_request_link (self,
+                          ifindex,
+                          cancellable,
+                          g_task_new (self, cancellable, callback, user_data));
+}
+
+/*****************************************************************************/
+
 static gboolean
 netlink_message_cb (GSocket      *socket,
                     GIOCondition  condition,
                     MMNetlink    *self)
 {
     g_autoptr(GError) error = NULL;
-    gchar             buf[512];
+    gchar             buf[8192]; /* link info replies carry all link attributes */
     gssize            bytes_received;
     guint             buffer_len;
     struct nlmsghdr  *hdr;
@@ -351,11 +565,11 @@ netlink_message_cb (GSocket      *socket,
 
     buffer_len = (guint) bytes_received;
     for (hdr = (struct nlmsghdr *) buf; NLMSG_OK (hdr, buffer_len);
-         NLMSG_NEXT (hdr, buffer_len)) {
+         hdr = NLMSG_NEXT (hdr, buffer_len)) {
         Transaction     *tr;
         struct nlmsgerr *err;
 
-        if (hdr->nlmsg_type != NLMSG_ERROR)
+        if (hdr->nlmsg_type != NLMSG_ERROR && hdr->nlmsg_type != RTM_NEWLINK)
             continue;
 
         tr = g_hash_table_lookup (self->transactions,
@@ -363,7 +577,12 @@ netlink_message_cb (GSocket      *socket,
         if (!tr)
             continue;
 
-        err = NLMSG_DATA (buf);
+        if (hdr->nlmsg_type == RTM_NEWLINK) {
+            transaction_complete_with_link_info (tr, hdr);
+            continue;
+        }
+
+        err = NLMSG_DATA (hdr);
         transaction_complete (tr, err->error);
     }
     return G_SOURCE_CONTINUE;
@@ -400,6 +619,177 @@ setup_netlink_socket (MMNetlink  *self,
     return TRUE;
 }
 
+/*****************************************************************************/
+/* Link and address events */
+
+static void
+process_link_event (MMNetlink       *self,
+                    struct nlmsghdr *hdr)
+{
+    struct ifinfomsg *ifi;
+    struct rtattr    *rta;
+    gint              rta_len;
+    const gchar      *name = NULL;
+    guint32           mtu = 0;
+
+    if (hdr->nlmsg_len < NLMSG_LENGTH (sizeof (struct ifinfomsg)))
+        return;
+
+    ifi = NLMSG_DATA (hdr);
+    rta_len = IFLA_PAYLOAD (hdr);
+    for (rta = IFLA_RTA (ifi); RTA_OK (rta, rta_len); rta = RTA_NEXT (rta, rta_len)) {
+        if (rta->rta_type == IFLA_IFNAME && RTA_PAYLOAD (rta) > 0) {
+            /* The kernel always includes the trailing NUL byte */
+            if (((const gchar *) RTA_DATA (rta))[RTA_PAYLOAD (rta) - 1] == '\0')
+                name = (const gchar *) RTA_DATA (rta);
+        } else if (rta->rta_type == IFLA_MTU && RTA_PAYLOAD (rta) >= sizeof (mtu))
+            memcpy (&mtu, RTA_DATA (rta), sizeof (mtu));
+    }
+
+    g_signal_emit (self, signals[SIGNAL_LINK_CHANGED], 0,
+                   (guint) ifi->ifi_index,
+                   name,
+                   (guint) ifi->ifi_flags,
+                   (guint) mtu,
+                   hdr->nlmsg_type == RTM_DELLINK);
+}
+
+static void
+process_address_event (MMNetlink       *self,
+                       struct nlmsghdr *hdr)
+{
+    struct ifaddrmsg *ifa;
+
+    if (hdr->nlmsg_len < NLMSG_LENGTH (sizeof (struct ifaddrmsg)))
+        return;
+
+    ifa = NLMSG_DATA (hdr);
+    g_signal_emit (self, signals[SIGNAL_ADDRESS_CHANGED], 0,
+                   (guint) ifa->ifa_index,
+                   (guint) ifa->ifa_family,
+                   hdr->nlmsg_type == RTM_DELADDR);
+}
+
+static gboolean
+netlink_event_cb (GSocket      *socket,
+                  GIOCondition  condition,
+                  MMNetlink    *self)
+{
+    g_autoptr(GError) error = NULL;
+    gchar             buf[8192];
+    gssize            bytes_received;
+    guint             buffer_len;
+    struct nlmsghdr  *hdr;
+
+    if (condition & G_IO_HUP || condition & G_IO_ERR) {
+        mm_obj_warn (self, "events socket connection closed");
+        return G_SOURCE_REMOVE;
+    }
+
+    bytes_received = g_socket_receive (socket, buf, sizeof (buf), NULL, &error);
+    if (bytes_received < 0) {
+        /* Events may have been lost if the socket buffer overflowed, but
+         * the socket is still usable */
+        mm_obj_warn (self, "events socket i/o failure: %s", error->message);
+        return G_SOURCE_CONTINUE;
+    }
+
+    buffer_len = (guint) bytes_received;
+    for (hdr = (struct nlmsghdr *) buf; NLMSG_OK (hdr, buffer_len);
+         hdr = NLMSG_NEXT (hdr, buffer_len)) {
+        switch (hdr->nlmsg_type) {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+            process_link_event (self, hdr);
+            break;
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+            process_address_event (self, hdr);
+            break;
+        default:
+            break;
+        }
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+setup_netlink_events_socket (MMNetlink  *self,
+                             GError    **error)
+{
+    gint               socket_fd;
+    struct sockaddr_nl addr;
+
+    socket_fd = socket (AF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE);
+    if (socket_fd < 0) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Failed to create netlink events socket");
+        return FALSE;
+    }
+
+    memset (&addr, 0, sizeof (addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind (socket_fd, (struct sockaddr *) &addr, sizeof (addr)) < 0) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Failed to subscribe to netlink events");
+        close (socket_fd);
+        return FALSE;
+    }
+
+    self->events_socket = g_socket_new_from_fd (socket_fd, error);
+    if (!self->events_socket) {
+        close (socket_fd);
+        return FALSE;
+    }
+
+    self->events_source = g_socket_create_source (self->events_socket,
+                                                  G_IO_IN | G_IO_ERR | G_IO_HUP,
+                                                  NULL);
+    g_source_set_callback (self->events_source,
+                           (GSourceFunc) netlink_event_cb,
+                           self,
+                           NULL);
+    g_source_attach (self->events_source, NULL);
+
+    return TRUE;
+}
+
+static void
+teardown_netlink_events_socket (MMNetlink *self)
+{
+    if (self->events_source)
+        g_source_destroy (self->events_source);
+    g_clear_pointer (&self->events_source, g_source_unref);
+    g_clear_object (&self->events_socket);
+}
+
+void
+mm_netlink_events_enable (MMNetlink *self)
+{
+    g_autoptr(GError) error = NULL;
+
+    /* The events socket is shared by all users */
+    if (self->events_users++ > 0)
+        return;
+
+    mm_obj_dbg (self, "enabling link and address events");
+    if (!setup_netlink_events_socket (self, &error))
+        mm_obj_warn (self, "couldn't setup netlink events socket: %s", error->message);
+}
+
+void
+mm_netlink_events_disable (MMNetlink *self)
+{
+    g_assert (self->events_users > 0);
+
+    if (--self->events_users > 0)
+        return;
+
+    mm_obj_dbg (self, "disabling link and address events");
+    teardown_netlink_events_socket (self);
+}
+
 /*****************************************************************************/
 
 static gchar *
@@ -439,6 +829,7 @@ dispose (GObject *object)
         g_source_destroy (self->source);
     g_clear_pointer (&self->source, g_source_unref);
     g_clear_object (&self->socket);
+    teardown_netlink_events_socket (self);
 
     G_OBJECT_CLASS (mm_netlink_parent_class)->dispose (object);
 }
@@ -455,6 +846,24 @@ mm_netlink_class_init (MMNetlinkClass *klass)
     GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
     object_class->dispose = dispose;
+
+    signals[SIGNAL_LINK_CHANGED] =
+        g_signal_new (MM_NETLINK_SIGNAL_LINK_CHANGED,
+                      G_OBJECT_CLASS_TYPE (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      0,
+                      NULL, NULL,
+                      g_cclosure_marshal_generic,
+                      G_TYPE_NONE, 5, G_TYPE_UINT, G_TYPE_STRING, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_BOOLEAN);
+
+    signals[SIGNAL_ADDRESS_CHANGED] =
+        g_signal_new (MM_NETLINK_SIGNAL_ADDRESS_CHANGED,
+                      G_OBJECT_CLASS_TYPE (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      0,
+                      NULL, NULL,
+                      g_cclosure_marshal_generic,
+                      G_TYPE_NONE, 3, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_BOOLEAN);
 }
 
 MM_DEFINE_SINGLETON_GETTER (MMNetlink, mm_netlink_get, MM_TYPE_NETLINK);
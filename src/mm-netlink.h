@@ -32,6 +32,9 @@ G_BEGIN_DECLS
 #define MM_IS_NETLINK(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), MM_TYPE_NETLINK))
 #define MM_IS_NETLINK_CLASS(k)  (G_TYPE_CHECK_CLASS_TYPE ((k), MM_TYPE_NETLINK))
 
+#define MM_NETLINK_SIGNAL_LINK_CHANGED    "link-changed"    /* ifindex, name, flags, mtu, removed */
+#define MM_NETLINK_SIGNAL_ADDRESS_CHANGED "address-changed" /* ifindex, family, removed */
+
 typedef struct _MMNetlink         MMNetlink;
 typedef struct _MMNetlinkClass    MMNetlinkClass;
 
@@ -49,6 +52,33 @@ gboolean mm_netlink_setlink_finish (MMNetlink            *self,
                                     GAsyncResult         *res,
                                     GError              **error);
 
+/* Current interface flags (IFF_*) and MTU of the link */
+void     mm_netlink_get_link        (MMNetlink            *self,
+                                     guint                 ifindex,
+                                     GCancellable         *cancellable,
+                                     GAsyncReadyCallback   callback,
+                                     gpointer              user_data);
+gboolean mm_netlink_get_link_finish (MMNetlink            *self,
+                                     GAsyncResult         *res,
+                                     guint                *flags,
+                                     guint                *mtu,
+                                     GError              **error);
+
+void     mm_netlink_get_link_stats        (MMNetlink            *self,
+                                           guint                 ifindex,
+                                           GCancellable         *cancellable,
+                                           GAsyncReadyCallback   callback,
+                                           gpointer              user_data);
+gboolean mm_netlink_get_link_stats_finish (MMNetlink            *self,
+                                           GAsyncResult         *res,
+                                           guint64              *rx_bytes,
+                                           guint64              *tx_bytes,
+                                           GError              **error);
+
+/* Link and address events are only monitored while there are users */
+void     mm_netlink_events_enable  (MMNetlink *self);
+void     mm_netlink_events_disable (MMNetlink *self);
+
 G_END_DECLS
 
 #endif  /* MM_MODEM_HELPERS_NETLINK_H */
@@ -0,0 +1,335 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include "mm-plugin-index.h"
+
+/* Filters an item may be restricted by; an item is selected only if the port
+ * matches all of them */
+typedef enum {
+    RESTRICTION_IDS     = 1 << 0,
+    RESTRICTION_DRIVERS = 1 << 1,
+    RESTRICTION_TAGS    = 1 << 2,
+} Restriction;
+
+typedef struct {
+    gpointer item;
+    guint    position;
+    guint    restrictions;
+    /* Restrictions matched in the ongoing lookup */
+    guint    lookup_id;
+    guint    matched;
+} Entry;
+
+struct _MMPluginIndex {
+    /* All entries, in the order they were added */
+    GPtrArray  *entries;
+    /* Entries without any restriction, always selected */
+    GPtrArray  *unrestricted;
+    /* Lookup tables, each one to a GPtrArray of entries */
+    GHashTable *vendors;   /* vid */
+    GHashTable *products;  /* vid << 16 | pid */
+    GHashTable *drivers;
+    GHashTable *udev_tags;
+    /* NULL-terminated list of udev tags in the index */
+    GPtrArray  *udev_tag_names;
+    guint       lookup_id;
+};
+
+#define PRODUCT_KEY(vid, pid) GUINT_TO_POINTER (((guint) (vid) << 16) | (guint) (pid))
+
+/*****************************************************************************/
+
+static void
+index_entry (GHashTable *table,
+             gpointer    key,
+             Entry      *entry)
+{
+    GPtrArray *bucket;
+
+    bucket = g_hash_table_lookup (table, key);
+    if (!bucket) {
+        bucket = g_ptr_array_new ();
+        g_hash_table_insert (table, key, bucket);
+    }
+
+    /* Avoid duplicates, entries are added in order */
+    if (!bucket->len || g_ptr_array_index (bucket, bucket->len - 1) != entry)
+        g_ptr_array_add (bucket, entry);
+}
+
+void
+mm_plugin_index_add (MMPluginIndex        *self,
+                     gpointer              item,
+                     const guint16        *vendor_ids,
+                     const mm_uint16_pair *product_ids,
+                     const mm_uint16_pair *subsystem_vendor_ids,
+                     const gchar         **drivers,
+                     const gchar         **udev_tags)
+{
+    Entry *entry;
+    guint  i;
+
+    entry = g_slice_new0 (Entry);
+    entry->item = item;
+    entry->position = self->entries->len;
+    g_ptr_array_add (self->entries, entry);
+
+    /* A vendor/subsystem vendor pair can only match if the vendor matches,
+     * so those are indexed by vendor as well */
+    if (vendor_ids || product_ids) {
+        entry->restrictions |= RESTRICTION_IDS;
+        for (i = 0; vendor_ids && vendor_ids[i]; i++)
+            index_entry (self->vendors, GUINT_TO_POINTER (vendor_ids[i]), entry);
+        for (i = 0; product_ids && product_ids[i].l; i++)
+            index_entry (self->products, PRODUCT_KEY (product_ids[i].l, product_ids[i].r), entry);
+        for (i = 0; subsystem_vendor_ids && subsystem_vendor_ids[i].l; i++)
+            index_entry (self->vendors, GUINT_TO_POINTER (subsystem_vendor_ids[i].l), entry);
+    }
+
+    if (drivers) {
+        entry->restrictions |= RESTRICTION_DRIVERS;
+        for (i = 0; drivers[i]; i++)
+            index_entry (self->drivers, (gpointer) g_intern_string (drivers[i]), entry);
+    }
+
+    if (udev_tags) {
+        entry->restrictions |= RESTRICTION_TAGS;
+        for (i = 0; udev_tags[i]; i++) {
+            const gchar *tag;
+
+            tag = g_intern_string (udev_tags[i]);
+            if (!g_hash_table_contains (self->udev_tags, tag))
+                g_ptr_array_insert (self->udev_tag_names, self->udev_tag_names->len - 1, (gpointer) tag);
+            index_entry (self->udev_tags, (gpointer) tag, entry);
+        }
+    }
+
+    if (!entry->restrictions)
+        g_ptr_array_add (self->unrestricted, entry);
+}
+
+const gchar **
+mm_plugin_index_get_udev_tags (MMPluginIndex *self)
+{
+    return (const gchar **) self->udev_tag_names->pdata;
+}
+
+/*****************************************************************************/
+
+static void
+match_bucket (MMPluginIndex *self,
+              GPtrArray     *bucket,
+              Restriction    restriction,
+              GPtrArray     *hits)
+{
+    guint i;
+
+    for (i = 0; bucket && i < bucket->len; i++) {
+        Entry *entry;
+
+        entry = g_ptr_array_index (bucket, i);
+        if (entry->lookup_id != self->lookup_id) {
+            entry->lookup_id = self->lookup_id;
+            entry->matched = 0;
+            g_ptr_array_add (hits, entry);
+        }
+        entry->matched |= restriction;
+    }
+}
+
+static gint
+entry_cmp (const Entry **a,
+           const Entry **b)
+{
+    return (gint) (*a)->position - (gint) (*b)->position;
+}
+
+GPtrArray *
+mm_plugin_index_lookup (MMPluginIndex  *self,
+                        guint16         vendor,
+                        guint16         product,
+                        const gchar   **drivers,
+                        const gchar   **udev_tags)
+{
+    g_autoptr(GPtrArray)  hits = NULL;
+    GPtrArray            *selected;
+    GPtrArray            *items;
+    guint                 i;
+
+    /* Entries hold the matches of the last lookup only */
+    self->lookup_id++;
+    hits = g_ptr_array_new ();
+
+    if (vendor) {
+        match_bucket (self, g_hash_table_lookup (self->vendors, GUINT_TO_POINTER (vendor)), RESTRICTION_IDS, hits);
+        if (product)
+            match_bucket (self, g_hash_table_lookup (self->products, PRODUCT_KEY (vendor, product)), RESTRICTION_IDS, hits);
+    }
+    for (i = 0; drivers && drivers[i]; i++)
+        match_bucket (self, g_hash_table_lookup (self->drivers, g_intern_string (drivers[i])), RESTRICTION_DRIVERS, hits);
+    for (i = 0; udev_tags && udev_tags[i]; i++)
+        match_bucket (self, g_hash_table_lookup (self->udev_tags, g_intern_string (udev_tags[i])), RESTRICTION_TAGS, hits);
+
+    selected = g_ptr_array_sized_new (self->unrestricted->len + hits->len);
+    for (i = 0; i < self->unrestricted->len; i++)
+        g_ptr_array_add (selected, g_ptr_array_index (self->unrestricted, i));
+    for (i = 0; i < hits->len; i++) {
+        Entry *entry;
+
+        entry = g_ptr_array_index (hits, i);
+        if ((entry->matched & entry->restrictions) == entry->restrictions)
+            g_ptr_array_add (selected, entry);
+    }
+    g_ptr_array_sort (selected, (GCompareFunc) entry_cmp);
+
+    /* Reuse the array for the items */
+    items = selected;
+    for (i = 0; i < items->len; i++)
+        g_ptr_array_index (items, i) = ((Entry *) g_ptr_array_index (selected, i))->item;
+    return items;
+}
+
+/*****************************************************************************/
+
+gboolean
+mm_plugin_index_match_drivers (const gchar **allowed_drivers,
+                               const gchar **drivers)
+{
+    guint i;
+    guint j;
+
+    for (i = 0; allowed_drivers[i]; i++) {
+        for (j = 0; drivers[j]; j++) {
+            if (g_str_equal (drivers[j], allowed_drivers[i]))
+                return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+void
+mm_plugin_index_filter_ids (const guint16        *vendor_ids,
+                            const mm_uint16_pair *product_ids,
+                            const mm_uint16_pair *subsystem_vendor_ids,
+                            guint16               vendor,
+                            guint16               product,
+                            guint16               subsystem_vendor,
+                            gboolean             *vendor_filtered,
+                            gboolean             *product_filtered,
+                            gboolean             *subsystem_vendor_filtered)
+{
+    guint i;
+
+    *vendor_filtered = FALSE;
+    *product_filtered = FALSE;
+    *subsystem_vendor_filtered = FALSE;
+
+    /* The plugin may specify that only some vendor IDs are supported. If that
+     * is the case, filter by vendor ID. */
+    if (vendor_ids) {
+        /* If we didn't get any vendor: filtered */
+        if (!vendor)
+            *vendor_filtered = TRUE;
+        else {
+            for (i = 0; vendor_ids[i]; i++)
+                if (vendor == vendor_ids[i])
+                    break;
+
+            /* If we didn't match any vendor: filtered */
+            if (!vendor_ids[i])
+                *vendor_filtered = TRUE;
+        }
+    }
+
+    /* The plugin may specify that only some product IDs are supported. If
+     * that is the case, filter by vendor+product ID pair */
+    if (product_ids) {
+        /* If we didn't get any product: filtered */
+        if (!product || !vendor)
+            *product_filtered = TRUE;
+        else {
+            for (i = 0; product_ids[i].l; i++)
+                if (vendor == product_ids[i].l &&
+                    product == product_ids[i].r)
+                    break;
+
+            /* If we didn't match any product: filtered */
+            if (!product_ids[i].l)
+                *product_filtered = TRUE;
+        }
+
+        /* When both vendor ids and product ids are given, it may be the case that
+         * we're allowing a full VID1 and only a subset of another VID2, so try to
+         * handle that properly. */
+        if (*vendor_filtered && !*product_filtered)
+            *vendor_filtered = FALSE;
+        if (*product_filtered && vendor_ids && !*vendor_filtered)
+            *product_filtered = FALSE;
+    }
+
+    /* The plugin may specify that a set of vendor IDs is valid only when going
+     * with a specific subsystem vendor IDs (PCI modems).
+     * If that is the case, filter by vendor+subsystem vendor ID pair */
+    if (subsystem_vendor && subsystem_vendor_ids) {
+        for (i = 0; subsystem_vendor_ids[i].l; i++)
+            if (vendor == subsystem_vendor_ids[i].l &&
+                subsystem_vendor == subsystem_vendor_ids[i].r) {
+                /* If device was filtered by vendor, we override that value, since
+                 * we want to give priority to vendor/subsystem vendor match */
+                *vendor_filtered = FALSE;
+                break;
+            }
+
+        /* If we didn't match any vendor/subsystem vendor: filtered */
+        if (!subsystem_vendor_ids[i].l)
+            *subsystem_vendor_filtered = TRUE;
+    }
+}
+
+/*****************************************************************************/
+
+static void
+entry_free (Entry *entry)
+{
+    g_slice_free (Entry, entry);
+}
+
+MMPluginIndex *
+mm_plugin_index_new (void)
+{
+    MMPluginIndex *self;
+
+    self = g_slice_new0 (MMPluginIndex);
+    self->entries = g_ptr_array_new_with_free_func ((GDestroyNotify) entry_free);
+    self->unrestricted = g_ptr_array_new ();
+    self->vendors = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+    self->products = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+    self->drivers = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+    self->udev_tags = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+    self->udev_tag_names = g_ptr_array_new ();
+    g_ptr_array_add (self->udev_tag_names, NULL);
+    return self;
+}
+
+void
+mm_plugin_index_free (MMPluginIndex *self)
+{
+    g_ptr_array_unref (self->udev_tag_names);
+    g_hash_table_unref (self->udev_tags);
+    g_hash_table_unref (self->drivers);
+    g_hash_table_unref (self->products);
+    g_hash_table_unref (self->vendors);
+    g_ptr_array_unref (self->unrestricted);
+    g_ptr_array_unref (self->entries);
+    g_slice_free (MMPluginIndex, self);
+}
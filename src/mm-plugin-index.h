@@ -0,0 +1,73 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_PLUGIN_INDEX_H
+#define MM_PLUGIN_INDEX_H
+
+#include <glib.h>
+
+#include "mm-private-boxed-types.h"
+
+/* Index of the plugin pre-probing filters, used to select the plugins that
+ * may support a given port without running the filters of every plugin.
+ *
+ * The selection is conservative: an item is only left out if its filters
+ * would certainly discard the port. Items are opaque pointers, not owned by
+ * the index, and lookups return them in the same order they were added. */
+
+typedef struct _MMPluginIndex MMPluginIndex;
+
+MMPluginIndex  *mm_plugin_index_new           (void);
+void            mm_plugin_index_free          (MMPluginIndex        *self);
+
+/* If the item also filters by vendor or product strings, the ids are not
+ * mandatory (the strings may still match once probed) and should be given
+ * as NULL. */
+void            mm_plugin_index_add           (MMPluginIndex        *self,
+                                               gpointer              item,
+                                               const guint16        *vendor_ids,
+                                               const mm_uint16_pair *product_ids,
+                                               const mm_uint16_pair *subsystem_vendor_ids,
+                                               const gchar         **drivers,
+                                               const gchar         **udev_tags);
+
+/* List of all udev tags required by some item, so that the caller can check
+ * which of them the port has */
+const gchar   **mm_plugin_index_get_udev_tags (MMPluginIndex        *self);
+
+/* Returns the items that may support a port with the given ids, drivers and
+ * udev tags; the array must be freed by the caller */
+GPtrArray      *mm_plugin_index_lookup        (MMPluginIndex        *self,
+                                               guint16               vendor,
+                                               guint16               product,
+                                               const gchar         **drivers,
+                                               const gchar         **udev_tags);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMPluginIndex, mm_plugin_index_free)
+
+/* Driver and id pre-probing filters, as applied by each plugin once
+ * selected. The items selected by a lookup are a superset of the ones
+ * that pass these filters. */
+gboolean        mm_plugin_index_match_drivers (const gchar         **allowed_drivers,
+                                               const gchar         **drivers);
+void            mm_plugin_index_filter_ids    (const guint16        *vendor_ids,
+                                               const mm_uint16_pair *product_ids,
+                                               const mm_uint16_pair *subsystem_vendor_ids,
+                                               guint16               vendor,
+                                               guint16               product,
+                                               guint16               subsystem_vendor,
+                                               gboolean             *vendor_filtered,
+                                               gboolean             *product_filtered,
+                                               gboolean             *subsystem_vendor_filtered);
+
+#endif /* MM_PLUGIN_INDEX_H */
@@ -29,13 +29,21 @@
 
 #include "mm-plugin-manager.h"
 #include "mm-plugin.h"
+#include "mm-plugin-index.h"
 #include "mm-shared.h"
 #include "mm-utils.h"
 #include "mm-log-object.h"
+#include "mm-context.h"
+#include "mm-probe-cache.h"
+#include "mm-bringup-scheduler.h"
 
 #define SHARED_PREFIX "libmm-shared"
 #define PLUGIN_PREFIX "libmm-plugin"
 
+/* Manifest generated at build time with the filters of all plugins */
+#define MANIFEST_FILE  "plugins.manifest"
+#define MANIFEST_GROUP "manifest"
+
 static void initable_iface_init   (GInitableIface *iface);
 static void log_object_iface_init (MMLogObjectInterface *iface);
 
@@ -55,13 +63,21 @@ struct _MMPluginManagerPrivate {
     gchar *plugin_dir;
     /* Device filter */
     MMFilter *filter;
+    /* Persistent probing results, if enabled */
+    MMProbeCache *probe_cache;
 
     /* This list contains all plugins except for the generic one, order is not
      * important. It is loaded once when the program starts, and the list is NOT
      * expected to change after that.*/
     GList *plugins;
+    /* Index of the pre-probing filters of the plugins in the list */
+    MMPluginIndex *index;
     /* Last, the generic plugin. */
     MMPlugin *generic;
+    /* Plugins listed in the manifest which haven't been loaded yet; they are
+     * loaded (and moved to the plugins list) as soon as a port they may
+     * support is found. */
+    GList *manifest_entries;
 
     /* List of ongoing device support checks */
     GList *device_contexts;
@@ -70,6 +86,208 @@ struct _MMPluginManagerPrivate {
     gchar **subsystems;
 };
 
+/*****************************************************************************/
+/* Plugins index */
+
+static void
+plugin_manager_add_plugin (MMPluginManager *self,
+                           MMPlugin        *plugin)
+{
+    gboolean string_filters;
+
+    self->priv->plugins = g_list_append (self->priv->plugins, plugin);
+
+    /* If the plugin may still grab AT ports after probing vendor or product
+     * strings, ids are not a requirement */
+    string_filters = mm_plugin_has_string_filters (plugin);
+    mm_plugin_index_add (self->priv->index,
+                         plugin,
+                         string_filters ? NULL : mm_plugin_get_allowed_vendor_ids (plugin),
+                         string_filters ? NULL : mm_plugin_get_allowed_product_ids (plugin),
+                         string_filters ? NULL : mm_plugin_get_allowed_subsystem_vendor_ids (plugin),
+                         mm_plugin_get_allowed_drivers (plugin),
+                         mm_plugin_get_allowed_udev_tags (plugin));
+}
+
+static GPtrArray *
+plugin_manager_lookup_plugins (MMPluginManager *self,
+                               MMDevice        *device,
+                               MMKernelDevice  *port)
+{
+    g_autoptr(GPtrArray)  drivers = NULL;
+    g_autoptr(GPtrArray)  udev_tags = NULL;
+    const gchar         **device_drivers;
+    const gchar         **index_udev_tags;
+    guint                 i;
+
+    /* Ports in the list of virtual ports are matched with a fake 'virtual'
+     * driver while filtering, so always look for it */
+    drivers = g_ptr_array_new ();
+    device_drivers = mm_device_get_drivers (device);
+    for (i = 0; device_drivers && device_drivers[i]; i++)
+        g_ptr_array_add (drivers, (gpointer) device_drivers[i]);
+    g_ptr_array_add (drivers, (gpointer) "virtual");
+    g_ptr_array_add (drivers, NULL);
+
+    udev_tags = g_ptr_array_new ();
+    index_udev_tags = mm_plugin_index_get_udev_tags (self->priv->index);
+    for (i = 0; index_udev_tags[i]; i++) {
+        if (mm_kernel_device_get_global_property_as_boolean (port, index_udev_tags[i]))
+            g_ptr_array_add (udev_tags, (gpointer) index_udev_tags[i]);
+    }
+    g_ptr_array_add (udev_tags, NULL);
+
+    return mm_plugin_index_lookup (self->priv->index,
+                                   mm_device_get_vendor (device),
+                                   mm_device_get_product (device),
+                                   (const gchar **) drivers->pdata,
+                                   (const gchar **) udev_tags->pdata);
+}
+
+/*****************************************************************************/
+/* Plugins listed in the manifest, loaded on demand */
+
+typedef struct {
+    gchar          *name;
+    gchar          *path;
+    gchar         **subsystems;
+    gchar         **udev_tags;
+    gchar         **drivers;
+    guint16        *vendor_ids;
+    mm_uint16_pair *product_ids;
+    mm_uint16_pair *subsystem_vendor_ids;
+    gboolean        string_filters;
+} ManifestEntry;
+
+static void
+manifest_entry_free (ManifestEntry *entry)
+{
+    g_free (entry->name);
+    g_free (entry->path);
+    g_strfreev (entry->subsystems);
+    g_strfreev (entry->udev_tags);
+    g_strfreev (entry->drivers);
+    g_free (entry->vendor_ids);
+    g_free (entry->product_ids);
+    g_free (entry->subsystem_vendor_ids);
+    g_slice_free (ManifestEntry, entry);
+}
+
+static gboolean
+strv_contains_any (const gchar **strv,
+                   const gchar **values)
+{
+    guint i;
+
+    for (i = 0; values && values[i]; i++) {
+        if (g_strv_contains (strv, values[i]))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* This check is conservative: it only discards the plugin when the port would
+ * also be discarded by the pre-probing filters of the plugin itself. */
+static gboolean
+manifest_entry_may_support_port (ManifestEntry  *entry,
+                                 MMDevice       *device,
+                                 MMKernelDevice *port)
+{
+    guint16 vendor;
+    guint16 product;
+    guint16 subsystem_vendor;
+    guint   i;
+
+    if (!g_strv_contains ((const gchar * const *) entry->subsystems, mm_kernel_device_get_subsystem (port)))
+        return FALSE;
+
+    /* Virtual ports report a fake driver name that is only known while
+     * filtering, so don't try to be clever with those */
+    if (entry->drivers && !g_strv_contains ((const gchar * const *) entry->drivers, "virtual")) {
+        const gchar **drivers;
+
+        drivers = mm_device_get_drivers (device);
+        if (drivers && !strv_contains_any ((const gchar **) entry->drivers, drivers))
+            return FALSE;
+    }
+
+    if (entry->udev_tags) {
+        for (i = 0; entry->udev_tags[i]; i++) {
+            if (mm_kernel_device_get_global_property_as_boolean (port, entry->udev_tags[i]))
+                break;
+        }
+        if (!entry->udev_tags[i])
+            return FALSE;
+    }
+
+    /* Plugins with vendor or product string filters may still grab AT ports
+     * of devices not matching the IDs, once the strings are probed */
+    if (entry->string_filters || (!entry->vendor_ids && !entry->product_ids))
+        return TRUE;
+
+    vendor = mm_device_get_vendor (device);
+    product = mm_device_get_product (device);
+    subsystem_vendor = mm_device_get_subsystem_vendor (device);
+
+    for (i = 0; entry->vendor_ids && entry->vendor_ids[i]; i++) {
+        if (vendor == entry->vendor_ids[i])
+            return TRUE;
+    }
+    for (i = 0; entry->product_ids && entry->product_ids[i].l; i++) {
+        if (vendor == entry->product_ids[i].l && product == entry->product_ids[i].r)
+            return TRUE;
+    }
+    for (i = 0; entry->subsystem_vendor_ids && entry->subsystem_vendor_ids[i].l; i++) {
+        if (vendor == entry->subsystem_vendor_ids[i].l && subsystem_vendor == entry->subsystem_vendor_ids[i].r)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static MMPlugin *load_plugin (MMPluginManager *self,
+                              const gchar     *path);
+
+static MMPlugin *
+plugin_manager_load_manifest_entry (MMPluginManager *self,
+                                    GList           *entry_link)
+{
+    ManifestEntry *entry;
+    MMPlugin      *plugin;
+
+    entry = (ManifestEntry *) entry_link->data;
+    self->priv->manifest_entries = g_list_delete_link (self->priv->manifest_entries, entry_link);
+
+    mm_obj_dbg (self, "loading plugin '%s' on demand", entry->name);
+    plugin = load_plugin (self, entry->path);
+    if (plugin) {
+        /* The manifest may be out of date, never accept a different plugin or
+         * a generic one here */
+        if (!g_str_equal (mm_plugin_get_name (plugin), entry->name) || mm_plugin_is_generic (plugin)) {
+            mm_obj_warn (self, "plugin '%s' doesn't match the manifest: ignored", mm_plugin_get_name (plugin));
+            g_clear_object (&plugin);
+        } else
+            plugin_manager_add_plugin (self, plugin);
+    }
+
+    manifest_entry_free (entry);
+    return plugin;
+}
+
+static void
+plugin_manager_load_manifest_entries_for_port (MMPluginManager *self,
+                                               MMDevice        *device,
+                                               MMKernelDevice  *port)
+{
+    GList *l;
+    GList *next;
+
+    for (l = self->priv->manifest_entries; l; l = next) {
+        next = g_list_next (l);
+        if (manifest_entry_may_support_port ((ManifestEntry *) l->data, device, port))
+            plugin_manager_load_manifest_entry (self, l);
+    }
+}
+
 /*****************************************************************************/
 /* Build plugin list for a single port */
 
@@ -78,25 +296,33 @@ plugin_manager_build_plugins_list (MMPluginManager *self,
                                    MMDevice        *device,
                                    MMKernelDevice  *port)
 {
+    g_autoptr(GPtrArray) candidates = NULL;
     GList *list = NULL;
-    GList *l;
+    guint i;
     gboolean supported_found = FALSE;
 
-    for (l = self->priv->plugins; l && !supported_found; l = g_list_next (l)) {
+    /* Make sure all plugins that may support the port are loaded */
+    plugin_manager_load_manifest_entries_for_port (self, device, port);
+
+    /* Only run the filters of the plugins that may support the port */
+    candidates = plugin_manager_lookup_plugins (self, device, port);
+
+    for (i = 0; i < candidates->len && !supported_found; i++) {
+        MMPlugin *plugin = MM_PLUGIN (g_ptr_array_index (candidates, i));
         MMPluginSupportsHint hint;
 
-        hint = mm_plugin_discard_port_early (MM_PLUGIN (l->data), device, port);
+        hint = mm_plugin_discard_port_early (plugin, device, port);
         switch (hint) {
         case MM_PLUGIN_SUPPORTS_HINT_UNSUPPORTED:
             /* Fully discard */
             break;
         case MM_PLUGIN_SUPPORTS_HINT_MAYBE:
             /* Maybe supported, add to tail of list */
-            list = g_list_append (list, g_object_ref (l->data));
+            list = g_list_append (list, g_object_ref (plugin));
             break;
         case MM_PLUGIN_SUPPORTS_HINT_LIKELY:
             /* Likely supported, add to head of list */
-            list = g_list_prepend (list, g_object_ref (l->data));
+            list = g_list_prepend (list, g_object_ref (plugin));
             break;
         case MM_PLUGIN_SUPPORTS_HINT_SUPPORTED:
             /* Really supported, clean existing list and add it alone */
@@ -104,7 +330,7 @@ plugin_manager_build_plugins_list (MMPluginManager *self,
                 g_list_free_full (list, g_object_unref);
                 list = NULL;
             }
-            list = g_list_prepend (list, g_object_ref (l->data));
+            list = g_list_prepend (list, g_object_ref (plugin));
             /* This will end the loop as well */
             supported_found = TRUE;
             break;
@@ -727,6 +953,10 @@ port_context_new (MMPluginManager *self,
 /* The wait time we define must always be less than the probing time */
 G_STATIC_ASSERT (MIN_WAIT_TIME_MSECS < MIN_PROBING_TIME_MSECS);
 
+/* Maximum depth to look for port class directories below the physical device
+ * sysfs path, e.g. [physdev]/mhi0/mhi0_MBIM/wwan/wwan0/wwan0mbim0 */
+#define EXPECTED_PORTS_MAX_DEPTH 6
+
 /*
  * Device context
  *
@@ -783,6 +1013,27 @@ struct _DeviceContext {
 
     /* Port support check contexts being run */
     GList *port_contexts;
+
+    /* Names of the ports found in the sysfs tree of the physical device that
+     * haven't been grabbed yet, only used in fast probing mode. Once all of
+     * them are grabbed, the wait and probing timeouts are no longer needed.
+     * The list is only complete once all the interfaces of the device are
+     * exposed in sysfs; until then it's rebuilt on every grabbed port, so the
+     * names of the ports already grabbed are also kept. */
+    GHashTable *expected_ports;
+    GHashTable *grabbed_ports;
+    gboolean    expected_ports_complete;
+
+    /* Plugin that managed the device the last time, as found in the probe
+     * cache. Interned string. */
+    const gchar *cached_plugin_name;
+
+    /* Bring-up slot requested to the scheduler, only if the number of devices
+     * being brought up at the same time behind the same hub is limited. Port
+     * contexts are kept in the waiting list until the slot is acquired. */
+    gchar    *bringup_group;
+    gboolean  bringup_slot_pending;
+    gboolean  bringup_slot_acquired;
 };
 
 static void
@@ -797,12 +1048,18 @@ device_context_unref (DeviceContext *device_context)
         g_assert (!device_context->min_probing_time_id);
         g_assert (!device_context->extra_probing_time_id);
         g_assert (!device_context->port_contexts);
+        g_assert (!device_context->bringup_slot_acquired);
 
         /* The device support check task must have been completed previously */
         g_assert (!device_context->task);
 
         g_free (device_context->name);
+        g_free (device_context->bringup_group);
         g_timer_destroy (device_context->timer);
+        if (device_context->expected_ports)
+            g_hash_table_unref (device_context->expected_ports);
+        if (device_context->grabbed_ports)
+            g_hash_table_unref (device_context->grabbed_ports);
         if (device_context->cancellable)
             g_object_unref (device_context->cancellable);
         if (device_context->best_plugin)
@@ -892,9 +1149,21 @@ device_context_complete (DeviceContext *device_context)
     task = device_context->task;
     device_context->task = NULL;
 
+    /* Store or validate the cached probing results */
+    if (self->priv->probe_cache && device_context->best_plugin && !g_cancellable_is_cancelled (device_context->cancellable))
+        mm_probe_cache_update (self->priv->probe_cache,
+                               mm_device_peek_port_probe_list (device_context->device),
+                               mm_plugin_get_name (device_context->best_plugin));
+
     /* Log about the time required to complete the checks */
-    mm_obj_dbg (self, "task %s: finished in '%lf' seconds",
-                device_context->name, g_timer_elapsed (device_context->timer, NULL));
+    mm_obj_info (self, "task %s: probing finished in '%lf' seconds",
+                 device_context->name, g_timer_elapsed (device_context->timer, NULL));
+
+    /* Let other devices behind the same hub be probed */
+    if (device_context->bringup_slot_acquired) {
+        mm_bringup_scheduler_release (mm_bringup_scheduler_get (), device_context->bringup_group);
+        device_context->bringup_slot_acquired = FALSE;
+    }
 
     /* Remove signal handlers */
     if (device_context->grabbed_id) {
@@ -1056,6 +1325,10 @@ device_context_continue (DeviceContext *device_context)
     guint            n = 0;
     guint            n_active = 0;
 
+    /* Nothing to do until port probing is launched */
+    if (device_context->bringup_slot_pending)
+        return;
+
     self = g_task_get_source_object (device_context->task);
 
     /* If there are no running port contexts around, we're free to finish */
@@ -1184,6 +1457,12 @@ device_context_run_port_context (DeviceContext *device_context,
      * unless it is the generic plugin */
     if (device_context->best_plugin && !mm_plugin_is_generic (device_context->best_plugin))
         suggested = device_context->best_plugin;
+    /* Otherwise, try first with the one that managed the device last time */
+    else if (!device_context->best_plugin && device_context->cached_plugin_name) {
+        suggested = mm_plugin_manager_peek_plugin (self, device_context->cached_plugin_name);
+        if (suggested && mm_plugin_is_generic (suggested))
+            suggested = NULL;
+    }
 
     port_context_run (self,
                       port_context,
@@ -1197,8 +1476,8 @@ device_context_run_port_context (DeviceContext *device_context,
     g_list_free_full (plugins, g_object_unref);
 }
 
-static gboolean
-device_context_min_wait_time_elapsed (DeviceContext *device_context)
+static void
+device_context_launch_waiting_port_contexts (DeviceContext *device_context)
 {
     MMPluginManager *self;
     GList           *l;
@@ -1206,9 +1485,6 @@ device_context_min_wait_time_elapsed (DeviceContext *device_context)
 
     self = device_context->self;
 
-    device_context->min_wait_time_id = 0;
-    mm_obj_dbg (self, "task %s: min wait time elapsed", device_context->name);
-
     /* Move list of port contexts out of the wait list */
     g_assert (!device_context->port_contexts);
     tmp = device_context->wait_port_contexts;
@@ -1228,10 +1504,243 @@ device_context_min_wait_time_elapsed (DeviceContext *device_context)
         }
     }
     g_list_free (tmp);
+}
+
+static void
+bringup_slot_acquire_ready (MMBringupScheduler *scheduler,
+                            GAsyncResult       *res,
+                            DeviceContext      *device_context)
+{
+    MMPluginManager   *self;
+    g_autoptr(GError)  error = NULL;
+
+    self = device_context->self;
+
+    /* Only fails if the device context was cancelled while waiting, which
+     * already completed it */
+    if (!mm_bringup_scheduler_acquire_finish (scheduler, res, &error)) {
+        mm_obj_dbg (self, "task %s: bring-up slot not acquired: %s", device_context->name, error->message);
+        device_context_unref (device_context);
+        return;
+    }
+
+    /* Cancelled right when the slot was granted */
+    if (g_cancellable_is_cancelled (device_context->cancellable)) {
+        mm_bringup_scheduler_release (scheduler, device_context->bringup_group);
+        device_context_unref (device_context);
+        return;
+    }
+
+    mm_obj_dbg (self, "task %s: bring-up slot acquired after '%lf' seconds",
+                device_context->name, g_timer_elapsed (device_context->timer, NULL));
+    device_context->bringup_slot_pending = FALSE;
+    device_context->bringup_slot_acquired = TRUE;
+    device_context_launch_waiting_port_contexts (device_context);
+
+    /* Wakeup the device context logic, in case all ports were filtered */
+    if (!device_context->port_contexts)
+        device_context_continue (device_context);
+
+    device_context_unref (device_context);
+}
+
+static gboolean
+device_context_request_bringup_slot (DeviceContext *device_context)
+{
+    MMBringupScheduler *scheduler;
+    PortContext        *port_context;
+
+    scheduler = mm_bringup_scheduler_get ();
+    if (!mm_bringup_scheduler_is_enabled (scheduler) || !device_context->wait_port_contexts)
+        return FALSE;
+
+    port_context = (PortContext *)(device_context->wait_port_contexts->data);
+    device_context->bringup_group = mm_bringup_scheduler_build_group (port_context->port);
+    if (!device_context->bringup_group)
+        return FALSE;
+
+    /* Devices found in the probe cache are expected to be probed quickly, so
+     * they go first */
+    device_context->bringup_slot_pending = TRUE;
+    mm_bringup_scheduler_acquire (scheduler,
+                                  device_context->bringup_group,
+                                  !!device_context->cached_plugin_name,
+                                  device_context->cancellable,
+                                  (GAsyncReadyCallback) bringup_slot_acquire_ready,
+                                  device_context_ref (device_context));
+    return TRUE;
+}
+
+static gboolean
+device_context_min_wait_time_elapsed (DeviceContext *device_context)
+{
+    device_context->min_wait_time_id = 0;
+    mm_obj_dbg (device_context->self, "task %s: min wait time elapsed", device_context->name);
+
+    /* Port contexts stay in the waiting list until the bring-up slot is acquired */
+    if (!device_context_request_bringup_slot (device_context))
+        device_context_launch_waiting_port_contexts (device_context);
 
     return G_SOURCE_REMOVE;
 }
 
+static void
+expected_ports_scan (GHashTable  *expected_ports,
+                     const gchar *path,
+                     const gchar *parent,
+                     const gchar *grandparent,
+                     guint        depth)
+{
+    GDir        *dir;
+    const gchar *name;
+
+    if (depth > EXPECTED_PORTS_MAX_DEPTH)
+        return;
+
+    dir = g_dir_open (path, 0, NULL);
+    if (!dir)
+        return;
+
+    while ((name = g_dir_read_name (dir))) {
+        g_autofree gchar *child = NULL;
+
+        /* Only real directories, the symlinks in sysfs point back up in the
+         * tree (e.g. 'subsystem', 'driver' or 'device') */
+        child = g_build_filename (path, name, NULL);
+        if (g_file_test (child, G_FILE_TEST_IS_SYMLINK) || !g_file_test (child, G_FILE_TEST_IS_DIR))
+            continue;
+
+        /* Ports are the devices listed in the class directories; wwan ports
+         * are children of the wwan device itself */
+        if (parent &&
+            (g_str_equal (parent, "tty") ||
+             g_str_equal (parent, "net") ||
+             g_str_equal (parent, "usbmisc") ||
+             (grandparent && g_str_equal (grandparent, "wwan") && !g_str_equal (name, "power"))))
+            g_hash_table_add (expected_ports, g_strdup (name));
+
+        expected_ports_scan (expected_ports, child, name, parent, depth + 1);
+    }
+    g_dir_close (dir);
+}
+
+static gboolean
+expected_interfaces_complete (const gchar *physdev_sysfs_path)
+{
+    g_autofree gchar *num_interfaces_path = NULL;
+    g_autofree gchar *num_interfaces_str = NULL;
+    guint64           num_interfaces;
+    guint             n_found = 0;
+    GDir             *dir;
+    const gchar      *name;
+
+    /* Only USB devices report how many interfaces they have; in any other
+     * device all ports are expected to be below the physical device already */
+    num_interfaces_path = g_build_filename (physdev_sysfs_path, "bNumInterfaces", NULL);
+    if (!g_file_get_contents (num_interfaces_path, &num_interfaces_str, NULL, NULL))
+        return TRUE;
+    num_interfaces = g_ascii_strtoull (g_strstrip (num_interfaces_str), NULL, 10);
+
+    /* USB interfaces are exposed as [busnum]-[devpath]:[config].[interface] */
+    dir = g_dir_open (physdev_sysfs_path, 0, NULL);
+    if (!dir)
+        return FALSE;
+    while ((name = g_dir_read_name (dir))) {
+        if (strchr (name, ':'))
+            n_found++;
+    }
+    g_dir_close (dir);
+
+    return (n_found >= num_interfaces);
+}
+
+static void
+device_context_load_expected_ports (DeviceContext  *device_context,
+                                    MMKernelDevice *port)
+{
+    MMPluginManager *self;
+    const gchar     *physdev_sysfs_path;
+    GHashTableIter   iter;
+    const gchar     *grabbed;
+
+    self = MM_PLUGIN_MANAGER (device_context->self);
+
+    if (device_context->expected_ports)
+        g_hash_table_remove_all (device_context->expected_ports);
+    else
+        device_context->expected_ports = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    physdev_sysfs_path = mm_kernel_device_get_physdev_sysfs_path (port);
+    if (!physdev_sysfs_path) {
+        mm_obj_dbg (self, "task %s: unknown physical device sysfs path, can't load expected ports",
+                    device_context->name);
+        return;
+    }
+
+    /* Check the interfaces before looking for the ports, so that an interface
+     * showing up in between doesn't get the list marked complete */
+    device_context->expected_ports_complete = expected_interfaces_complete (physdev_sysfs_path);
+    expected_ports_scan (device_context->expected_ports, physdev_sysfs_path, NULL, NULL, 0);
+
+    g_hash_table_iter_init (&iter, device_context->grabbed_ports);
+    while (g_hash_table_iter_next (&iter, (gpointer *)&grabbed, NULL))
+        g_hash_table_remove (device_context->expected_ports, grabbed);
+
+    mm_obj_dbg (self, "task %s: %u more ports expected in the device%s",
+                device_context->name, g_hash_table_size (device_context->expected_ports),
+                device_context->expected_ports_complete ? "" : " (interfaces still missing)");
+}
+
+static gboolean
+device_context_track_expected_port (DeviceContext  *device_context,
+                                    MMKernelDevice *port)
+{
+    if (!device_context->grabbed_ports)
+        device_context->grabbed_ports = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    g_hash_table_add (device_context->grabbed_ports, g_strdup (mm_kernel_device_get_name (port)));
+
+    /* Load the list of ports we expect on the first port grabbed, and reload
+     * it as long as not all interfaces of the device were exposed */
+    if (!device_context->expected_ports_complete)
+        device_context_load_expected_ports (device_context, port);
+    else if (!g_hash_table_remove (device_context->expected_ports, mm_kernel_device_get_name (port)))
+        return FALSE;
+
+    /* TRUE only when the last expected port is found */
+    return (device_context->expected_ports_complete &&
+            !g_hash_table_size (device_context->expected_ports));
+}
+
+static void
+device_context_expected_ports_found (DeviceContext *device_context)
+{
+    MMPluginManager *self;
+
+    self = MM_PLUGIN_MANAGER (device_context->self);
+    mm_obj_dbg (self, "task %s: all expected ports found after '%lf' seconds",
+                device_context->name, g_timer_elapsed (device_context->timer, NULL));
+
+    /* Launch the waiting port contexts right away */
+    if (device_context->min_wait_time_id) {
+        g_source_remove (device_context->min_wait_time_id);
+        device_context_min_wait_time_elapsed (device_context);
+    }
+
+    /* No need to wait for more ports to appear, the device support check
+     * will finish as soon as all port contexts are completed */
+    if (device_context->min_probing_time_id) {
+        g_source_remove (device_context->min_probing_time_id);
+        device_context->min_probing_time_id = 0;
+    }
+    if (device_context->extra_probing_time_id) {
+        g_source_remove (device_context->extra_probing_time_id);
+        device_context->extra_probing_time_id = 0;
+    }
+
+    /* Wakeup the device context logic, in case all ports were filtered */
+    device_context_continue (device_context);
+}
+
 static void
 device_context_port_released (DeviceContext  *device_context,
                               MMKernelDevice *port)
@@ -1272,6 +1781,7 @@ device_context_port_grabbed (DeviceContext  *device_context,
 {
     MMPluginManager *self;
     PortContext     *port_context;
+    gboolean         expected_ports_found = FALSE;
 
     /* Recover plugin manager */
     self = MM_PLUGIN_MANAGER (device_context->self);
@@ -1295,6 +1805,24 @@ device_context_port_grabbed (DeviceContext  *device_context,
         return;
     }
 
+    /* Load cached probing results, if any */
+    if (self->priv->probe_cache) {
+        MMPortProbe *probe;
+
+        probe = MM_PORT_PROBE (mm_device_peek_port_probe (device_context->device, port));
+        if (probe) {
+            const gchar *cached_plugin_name;
+
+            cached_plugin_name = mm_probe_cache_apply (self->priv->probe_cache, probe);
+            if (cached_plugin_name && !device_context->cached_plugin_name)
+                device_context->cached_plugin_name = cached_plugin_name;
+        }
+    }
+
+    /* In fast probing mode, check whether this is the last port we expected */
+    if (mm_context_get_fast_probing ())
+        expected_ports_found = device_context_track_expected_port (device_context, port);
+
     /* Refresh the extra probing timeout. */
     if (device_context->extra_probing_time_id)
         g_source_remove (device_context->extra_probing_time_id);
@@ -1311,21 +1839,24 @@ device_context_port_grabbed (DeviceContext  *device_context,
     mm_obj_dbg (self, "task %s: new support task for port",
                 port_context->name);
 
-    /* Îf still waiting the min wait time, store it in the waiting list */
-    if (device_context->min_wait_time_id) {
+    /* Îf still waiting the min wait time or the bring-up slot, store it in the
+     * waiting list */
+    if (device_context->min_wait_time_id || device_context->bringup_slot_pending) {
         mm_obj_dbg (self, "task %s: deferred until min wait time elapsed",
                     port_context->name);
         /* Store the port reference in the list within the device */
         device_context->wait_port_contexts = g_list_prepend (device_context->wait_port_contexts, port_context);
-        return;
-    }
+    } else {
+        /* Store the port reference in the list within the device */
+        device_context->port_contexts = g_list_prepend (device_context->port_contexts, port_context) ;
 
-    /* Store the port reference in the list within the device */
-    device_context->port_contexts = g_list_prepend (device_context->port_contexts, port_context) ;
+        /* If the port has been grabbed after the min wait timeout expired, launch
+         * probing directly */
+        device_context_run_port_context (device_context, port_context);
+    }
 
-    /* If the port has been grabbed after the min wait timeout expired, launch
-     * probing directly */
-    device_context_run_port_context (device_context, port_context);
+    if (expected_ports_found)
+        device_context_expected_ports_found (device_context);
 }
 
 static gboolean
@@ -1344,7 +1875,9 @@ device_context_cancel (DeviceContext *device_context)
     g_cancellable_cancel (device_context->cancellable);
 
     /* Remove all port contexts in the waiting list. This will allow early cancellation
-     * if it arrives before the min wait time has elapsed */
+     * if it arrives before the min wait time has elapsed or before the bring-up slot
+     * is acquired */
+    device_context->bringup_slot_pending = FALSE;
     if (device_context->wait_port_contexts) {
         g_assert (!device_context->port_contexts);
         g_list_free_full (device_context->wait_port_contexts, (GDestroyNotify) port_context_unref);
@@ -1608,6 +2141,11 @@ mm_plugin_manager_peek_plugin (MMPluginManager *self,
             return plugin;
     }
 
+    for (l = self->priv->manifest_entries; l; l = g_list_next (l)) {
+        if (g_str_equal (plugin_name, ((ManifestEntry *) l->data)->name))
+            return plugin_manager_load_manifest_entry (self, l);
+    }
+
     return NULL;
 }
 
@@ -1622,61 +2160,53 @@ mm_plugin_manager_get_subsystems (MMPluginManager *self)
 /*****************************************************************************/
 
 static void
-register_plugin_allowlist_tags (MMPluginManager *self,
-                                MMPlugin        *plugin)
+register_plugin_allowlist_tags (MMPluginManager  *self,
+                                const gchar     **tags)
 {
-    const gchar **tags;
-    guint         i;
+    guint i;
 
     if (!mm_filter_check_rule_enabled (self->priv->filter, MM_FILTER_RULE_PLUGIN_ALLOWLIST))
         return;
 
-    tags = mm_plugin_get_allowed_udev_tags (plugin);
     for (i = 0; tags && tags[i]; i++)
         mm_filter_register_plugin_allowlist_tag (self->priv->filter, tags[i]);
 }
 
 static void
 register_plugin_allowlist_vendor_ids (MMPluginManager *self,
-                                       MMPlugin        *plugin)
+                                      const guint16   *vendor_ids)
 {
-    const guint16 *vendor_ids;
-    guint          i;
+    guint i;
 
     if (!mm_filter_check_rule_enabled (self->priv->filter, MM_FILTER_RULE_PLUGIN_ALLOWLIST))
         return;
 
-    vendor_ids = mm_plugin_get_allowed_vendor_ids (plugin);
     for (i = 0; vendor_ids && vendor_ids[i]; i++)
         mm_filter_register_plugin_allowlist_vendor_id (self->priv->filter, vendor_ids[i]);
 }
 
 static void
-register_plugin_allowlist_product_ids (MMPluginManager *self,
-                                       MMPlugin        *plugin)
+register_plugin_allowlist_product_ids (MMPluginManager      *self,
+                                       const mm_uint16_pair *product_ids)
 {
-    const mm_uint16_pair *product_ids;
-    guint                 i;
+    guint i;
 
     if (!mm_filter_check_rule_enabled (self->priv->filter, MM_FILTER_RULE_PLUGIN_ALLOWLIST))
         return;
 
-    product_ids = mm_plugin_get_allowed_product_ids (plugin);
     for (i = 0; product_ids && product_ids[i].l; i++)
         mm_filter_register_plugin_allowlist_product_id (self->priv->filter, product_ids[i].l, product_ids[i].r);
 }
 
 static void
-register_plugin_allowlist_subsystem_vendor_ids (MMPluginManager *self,
-                                                MMPlugin        *plugin)
+register_plugin_allowlist_subsystem_vendor_ids (MMPluginManager      *self,
+                                                const mm_uint16_pair *subsystem_vendor_ids)
 {
-    const mm_uint16_pair *subsystem_vendor_ids;
-    guint                 i;
+    guint i;
 
     if (!mm_filter_check_rule_enabled (self->priv->filter, MM_FILTER_RULE_PLUGIN_ALLOWLIST))
         return;
 
-    subsystem_vendor_ids = mm_plugin_get_allowed_subsystem_vendor_ids (plugin);
     for (i = 0; subsystem_vendor_ids && subsystem_vendor_ids[i].l; i++)
         mm_filter_register_plugin_allowlist_subsystem_vendor_id (self->priv->filter, subsystem_vendor_ids[i].l, subsystem_vendor_ids[i].r);
 }
@@ -1799,18 +2329,312 @@ out:
     g_free (path_display);
 }
 
+static gboolean
+list_modules (const gchar  *plugin_dir,
+              GList       **shared_paths,
+              GList       **plugin_paths,
+              GError      **error)
+{
+    GDir        *dir;
+    const gchar *fname;
+
+    dir = g_dir_open (plugin_dir, 0, NULL);
+    if (!dir) {
+        g_autofree gchar *plugindir_display = NULL;
+
+        plugindir_display = g_filename_display_name (plugin_dir);
+        g_set_error (error,
+                     MM_CORE_ERROR,
+                     MM_CORE_ERROR_NO_PLUGINS,
+                     "plugin directory '%s' not found",
+                     plugindir_display);
+        return FALSE;
+    }
+
+    while ((fname = g_dir_read_name (dir)) != NULL) {
+        if (!g_str_has_suffix (fname, G_MODULE_SUFFIX))
+            continue;
+        if (g_str_has_prefix (fname, SHARED_PREFIX))
+            *shared_paths = g_list_prepend (*shared_paths, g_module_build_path (plugin_dir, fname));
+        else if (g_str_has_prefix (fname, PLUGIN_PREFIX))
+            *plugin_paths = g_list_prepend (*plugin_paths, g_module_build_path (plugin_dir, fname));
+    }
+
+    g_dir_close (dir);
+    return TRUE;
+}
+
+/*****************************************************************************/
+/* Plugin manifest
+ *
+ * The manifest is a key file with one group per plugin, storing the module
+ * file name and the filters that can be evaluated without loading the plugin.
+ * It is only valid for the exact same version of the daemon.
+ */
+
+static guint16 *
+manifest_get_ids (GKeyFile    *keyfile,
+                  const gchar *group,
+                  const gchar *key)
+{
+    g_auto(GStrv)  strv = NULL;
+    guint16       *ids;
+    guint          i;
+    guint          n = 0;
+
+    strv = g_key_file_get_string_list (keyfile, group, key, NULL, NULL);
+    if (!strv || !strv[0])
+        return NULL;
+
+    ids = g_new0 (guint16, g_strv_length (strv) + 1);
+    for (i = 0; strv[i]; i++) {
+        guint aux;
+
+        if (mm_get_uint_from_hex_str (strv[i], &aux) && aux > 0 && aux <= G_MAXUINT16)
+            ids[n++] = (guint16) aux;
+    }
+    return ids;
+}
+
+static mm_uint16_pair *
+manifest_get_id_pairs (GKeyFile    *keyfile,
+                       const gchar *group,
+                       const gchar *key)
+{
+    g_auto(GStrv)   strv = NULL;
+    mm_uint16_pair *pairs;
+    guint           i;
+    guint           n = 0;
+
+    strv = g_key_file_get_string_list (keyfile, group, key, NULL, NULL);
+    if (!strv || !strv[0])
+        return NULL;
+
+    pairs = g_new0 (mm_uint16_pair, g_strv_length (strv) + 1);
+    for (i = 0; strv[i]; i++) {
+        g_auto(GStrv) split = NULL;
+        guint         l;
+        guint         r;
+
+        split = g_strsplit (strv[i], ":", -1);
+        if (g_strv_length (split) == 2 &&
+            mm_get_uint_from_hex_str (split[0], &l) && l > 0 && l <= G_MAXUINT16 &&
+            mm_get_uint_from_hex_str (split[1], &r) && r <= G_MAXUINT16) {
+            pairs[n].l = (guint16) l;
+            pairs[n].r = (guint16) r;
+            n++;
+        }
+    }
+    return pairs;
+}
+
+static void
+manifest_set_ids (GKeyFile      *keyfile,
+                  const gchar   *group,
+                  const gchar   *key,
+                  const guint16 *ids)
+{
+    g_autoptr(GPtrArray) strv = NULL;
+    guint                i;
+
+    if (!ids)
+        return;
+
+    strv = g_ptr_array_new_with_free_func (g_free);
+    for (i = 0; ids[i]; i++)
+        g_ptr_array_add (strv, g_strdup_printf ("%04x", ids[i]));
+    g_key_file_set_string_list (keyfile, group, key, (const gchar * const *) strv->pdata, strv->len);
+}
+
+static void
+manifest_set_id_pairs (GKeyFile             *keyfile,
+                       const gchar          *group,
+                       const gchar          *key,
+                       const mm_uint16_pair *pairs)
+{
+    g_autoptr(GPtrArray) strv = NULL;
+    guint                i;
+
+    if (!pairs)
+        return;
+
+    strv = g_ptr_array_new_with_free_func (g_free);
+    for (i = 0; pairs[i].l; i++)
+        g_ptr_array_add (strv, g_strdup_printf ("%04x:%04x", pairs[i].l, pairs[i].r));
+    g_key_file_set_string_list (keyfile, group, key, (const gchar * const *) strv->pdata, strv->len);
+}
+
+static void
+manifest_set_strv (GKeyFile     *keyfile,
+                   const gchar  *group,
+                   const gchar  *key,
+                   const gchar **strv)
+{
+    if (strv)
+        g_key_file_set_string_list (keyfile, group, key, strv, g_strv_length ((gchar **) strv));
+}
+
+/* Returns a table of module file name -> plugin group */
+static GHashTable *
+manifest_load (MMPluginManager *self,
+               GKeyFile        *keyfile)
+{
+    g_autofree gchar  *path = NULL;
+    g_autofree gchar  *version = NULL;
+    g_autoptr(GError)  error = NULL;
+    g_auto(GStrv)      groups = NULL;
+    GHashTable        *modules;
+    guint              i;
+
+    path = g_build_filename (self->priv->plugin_dir, MANIFEST_FILE, NULL);
+    if (!g_key_file_load_from_file (keyfile, path, G_KEY_FILE_NONE, &error)) {
+        if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+            mm_obj_warn (self, "couldn't load plugin manifest: %s", error->message);
+        return NULL;
+    }
+
+    version = g_key_file_get_string (keyfile, MANIFEST_GROUP, "version", NULL);
+    if (g_strcmp0 (version, MM_DIST_VERSION) != 0) {
+        mm_obj_warn (self, "plugin manifest version mismatch (%s != %s): ignored",
+                     version ? version : "unknown", MM_DIST_VERSION);
+        return NULL;
+    }
+
+    modules = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    groups = g_key_file_get_groups (keyfile, NULL);
+    for (i = 0; groups[i]; i++) {
+        gchar *module;
+
+        if (g_str_equal (groups[i], MANIFEST_GROUP))
+            continue;
+        module = g_key_file_get_string (keyfile, groups[i], "module", NULL);
+        if (module)
+            g_hash_table_insert (modules, module, g_strdup (groups[i]));
+    }
+
+    mm_obj_dbg (self, "loaded plugin manifest with %u plugins", g_hash_table_size (modules));
+    return modules;
+}
+
+static ManifestEntry *
+manifest_build_entry (GKeyFile    *keyfile,
+                      const gchar *group,
+                      const gchar *path)
+{
+    ManifestEntry *entry;
+
+    /* The generic plugin is always needed */
+    if (g_key_file_get_boolean (keyfile, group, "generic", NULL))
+        return NULL;
+
+    entry = g_slice_new0 (ManifestEntry);
+    entry->name = g_strdup (group);
+    entry->path = g_strdup (path);
+    entry->subsystems = g_key_file_get_string_list (keyfile, group, "subsystems", NULL, NULL);
+    entry->udev_tags = g_key_file_get_string_list (keyfile, group, "udev-tags", NULL, NULL);
+    entry->drivers = g_key_file_get_string_list (keyfile, group, "drivers", NULL, NULL);
+    entry->vendor_ids = manifest_get_ids (keyfile, group, "vendor-ids");
+    entry->product_ids = manifest_get_id_pairs (keyfile, group, "product-ids");
+    entry->subsystem_vendor_ids = manifest_get_id_pairs (keyfile, group, "subsystem-vendor-ids");
+    entry->string_filters = g_key_file_get_boolean (keyfile, group, "string-filters", NULL);
+
+    if (!entry->subsystems || !entry->subsystems[0]) {
+        manifest_entry_free (entry);
+        return NULL;
+    }
+
+    return entry;
+}
+
+gboolean
+mm_plugin_manager_write_manifest (const gchar  *plugin_dir,
+                                  const gchar  *path,
+                                  GError      **error)
+{
+    g_autoptr(GKeyFile)  keyfile = NULL;
+    GList               *shared_paths = NULL;
+    GList               *plugin_paths = NULL;
+    GList               *plugins = NULL;
+    GList               *l;
+    gboolean             success = FALSE;
+
+    if (!list_modules (plugin_dir, &shared_paths, &plugin_paths, error))
+        return FALSE;
+
+    for (l = shared_paths; l; l = g_list_next (l))
+        load_shared (NULL, (const gchar *)(l->data));
+
+    keyfile = g_key_file_new ();
+    g_key_file_set_string (keyfile, MANIFEST_GROUP, "version", MM_DIST_VERSION);
+
+    for (l = plugin_paths; l; l = g_list_next (l)) {
+        g_autofree gchar *module = NULL;
+        MMPlugin         *plugin;
+        const gchar      *name;
+
+        plugin = load_plugin (NULL, (const gchar *)(l->data));
+        if (!plugin)
+            continue;
+        plugins = g_list_prepend (plugins, plugin);
+
+        /* Plugins without subsystems are ignored when loading anyway */
+        if (!mm_plugin_get_allowed_subsystems (plugin))
+            continue;
+
+        name = mm_plugin_get_name (plugin);
+        module = g_path_get_basename ((const gchar *)(l->data));
+        g_key_file_set_string (keyfile, name, "module", module);
+        g_key_file_set_boolean (keyfile, name, "generic", mm_plugin_is_generic (plugin));
+        manifest_set_strv (keyfile, name, "subsystems", mm_plugin_get_allowed_subsystems (plugin));
+        manifest_set_strv (keyfile, name, "udev-tags", mm_plugin_get_allowed_udev_tags (plugin));
+        manifest_set_strv (keyfile, name, "drivers", mm_plugin_get_allowed_drivers (plugin));
+        manifest_set_ids (keyfile, name, "vendor-ids", mm_plugin_get_allowed_vendor_ids (plugin));
+        manifest_set_id_pairs (keyfile, name, "product-ids", mm_plugin_get_allowed_product_ids (plugin));
+        manifest_set_id_pairs (keyfile, name, "subsystem-vendor-ids", mm_plugin_get_allowed_subsystem_vendor_ids (plugin));
+        g_key_file_set_boolean (keyfile, name, "string-filters", mm_plugin_has_string_filters (plugin));
+    }
+
+    if (!plugins)
+        g_set_error (error,
+                     MM_CORE_ERROR,
+                     MM_CORE_ERROR_NO_PLUGINS,
+                     "no plugins found in plugin directory");
+    else
+        success = g_key_file_save_to_file (keyfile, path, error);
+
+    g_list_free_full (plugins, g_object_unref);
+    g_list_free_full (shared_paths, g_free);
+    g_list_free_full (plugin_paths, g_free);
+    return success;
+}
+
+/*****************************************************************************/
+
+static void
+track_subsystems (GPtrArray    *subsystems,
+                  const gchar **plugin_subsystems)
+{
+    guint i;
+
+    /* Track required subsystems, avoiding duplicates in the list */
+    for (i = 0; plugin_subsystems[i]; i++) {
+        if (!g_ptr_array_find_with_equal_func (subsystems, plugin_subsystems[i], g_str_equal, NULL))
+            g_ptr_array_add (subsystems, g_strdup (plugin_subsystems[i]));
+    }
+}
+
 static gboolean
 load_plugins (MMPluginManager  *self,
               GError          **error)
 {
-    GDir             *dir = NULL;
-    const gchar      *fname;
-    GList            *shared_paths = NULL;
-    GList            *plugin_paths = NULL;
-    GList            *l;
-    GPtrArray        *subsystems = NULL;
-    g_autofree gchar *subsystems_str = NULL;
-    g_autofree gchar *plugindir_display = NULL;
+    GList                 *shared_paths = NULL;
+    GList                 *plugin_paths = NULL;
+    GList                 *l;
+    GPtrArray             *subsystems = NULL;
+    g_autoptr(GKeyFile)    manifest = NULL;
+    g_autoptr(GHashTable)  manifest_modules = NULL;
+    g_autofree gchar      *subsystems_str = NULL;
+    g_autofree gchar      *plugindir_display = NULL;
 
     if (!g_module_supported ()) {
         g_set_error (error,
@@ -1824,35 +2648,42 @@ load_plugins (MMPluginManager  *self,
     plugindir_display = g_filename_display_name (self->priv->plugin_dir);
 
     mm_obj_dbg (self, "looking for plugins in '%s'", plugindir_display);
-    dir = g_dir_open (self->priv->plugin_dir, 0, NULL);
-    if (!dir) {
-        g_set_error (error,
-                     MM_CORE_ERROR,
-                     MM_CORE_ERROR_NO_PLUGINS,
-                     "plugin directory '%s' not found",
-                     plugindir_display);
+    if (!list_modules (self->priv->plugin_dir, &shared_paths, &plugin_paths, error))
         goto out;
-    }
-
-    while ((fname = g_dir_read_name (dir)) != NULL) {
-        if (!g_str_has_suffix (fname, G_MODULE_SUFFIX))
-            continue;
-        if (g_str_has_prefix (fname, SHARED_PREFIX))
-            shared_paths = g_list_prepend (shared_paths, g_module_build_path (self->priv->plugin_dir, fname));
-        else if (g_str_has_prefix (fname, PLUGIN_PREFIX))
-            plugin_paths = g_list_prepend (plugin_paths, g_module_build_path (self->priv->plugin_dir, fname));
-    }
 
-    /* Load all shared utils */
+    /* Load all shared utils. These are always loaded, as plugins need their
+     * symbols resolved when they're opened. */
     for (l = shared_paths; l; l = g_list_next (l))
         load_shared (self, (const gchar *)(l->data));
 
+    /* Plugins found in the manifest are loaded on demand */
+    manifest = g_key_file_new ();
+    manifest_modules = manifest_load (self, manifest);
+
     /* Load all plugins */
     subsystems = g_ptr_array_new ();
     for (l = plugin_paths; l; l = g_list_next (l)) {
         MMPlugin     *plugin;
         const gchar **plugin_subsystems;
-        guint         i;
+
+        if (manifest_modules) {
+            g_autofree gchar *module = NULL;
+            const gchar      *group;
+            ManifestEntry    *entry;
+
+            module = g_path_get_basename ((const gchar *)(l->data));
+            group = g_hash_table_lookup (manifest_modules, module);
+            entry = group ? manifest_build_entry (manifest, group, (const gchar *)(l->data)) : NULL;
+            if (entry) {
+                self->priv->manifest_entries = g_list_append (self->priv->manifest_entries, entry);
+                track_subsystems (subsystems, (const gchar **) entry->subsystems);
+                register_plugin_allowlist_tags                 (self, (const gchar **) entry->udev_tags);
+                register_plugin_allowlist_vendor_ids           (self, entry->vendor_ids);
+                register_plugin_allowlist_product_ids          (self, entry->product_ids);
+                register_plugin_allowlist_subsystem_vendor_ids (self, entry->subsystem_vendor_ids);
+                continue;
+            }
+        }
 
         plugin = load_plugin (self, (const gchar *)(l->data));
         if (!plugin)
@@ -1875,19 +2706,15 @@ load_plugins (MMPluginManager  *self,
             }
             self->priv->generic = plugin;
         } else
-            self->priv->plugins = g_list_append (self->priv->plugins, plugin);
+            plugin_manager_add_plugin (self, plugin);
 
-        /* Track required subsystems, avoiding duplicates in the list */
-        for (i = 0; plugin_subsystems[i]; i++) {
-            if (!g_ptr_array_find_with_equal_func (subsystems, plugin_subsystems[i], g_str_equal, NULL))
-                g_ptr_array_add (subsystems, g_strdup (plugin_subsystems[i]));
-        }
+        track_subsystems (subsystems, plugin_subsystems);
 
         /* Register plugin allowlist rules in filter, if any */
-        register_plugin_allowlist_tags                 (self, plugin);
-        register_plugin_allowlist_vendor_ids           (self, plugin);
-        register_plugin_allowlist_product_ids          (self, plugin);
-        register_plugin_allowlist_subsystem_vendor_ids (self, plugin);
+        register_plugin_allowlist_tags                 (self, mm_plugin_get_allowed_udev_tags (plugin));
+        register_plugin_allowlist_vendor_ids           (self, mm_plugin_get_allowed_vendor_ids (plugin));
+        register_plugin_allowlist_product_ids          (self, mm_plugin_get_allowed_product_ids (plugin));
+        register_plugin_allowlist_subsystem_vendor_ids (self, mm_plugin_get_allowed_subsystem_vendor_ids (plugin));
     }
 
     /* Check the generic plugin once all looped */
@@ -1895,7 +2722,7 @@ load_plugins (MMPluginManager  *self,
         mm_obj_dbg (self, "generic plugin not loaded");
 
     /* Treat as error if we don't find any plugin */
-    if (!self->priv->plugins && !self->priv->generic) {
+    if (!self->priv->plugins && !self->priv->generic && !self->priv->manifest_entries) {
         g_set_error (error,
                      MM_CORE_ERROR,
                      MM_CORE_ERROR_NO_PLUGINS,
@@ -1914,21 +2741,22 @@ load_plugins (MMPluginManager  *self,
     }
     /* Add trailing NULL and store as GStrv */
     g_ptr_array_add (subsystems, NULL);
-    self->priv->subsystems = (gchar **) g_ptr_array_free (subsystems, FALSE);
+    self->priv->subsystems = (gchar **) g_ptr_array_free (g_steal_pointer (&subsystems), FALSE);
     subsystems_str = g_strjoinv (", ", self->priv->subsystems);
 
-    mm_obj_dbg (self, "successfully loaded %u plugins registering %u subsystems: %s",
+    mm_obj_dbg (self, "successfully loaded %u plugins (%u more to be loaded on demand) registering %u subsystems: %s",
                 g_list_length (self->priv->plugins) + !!self->priv->generic,
+                g_list_length (self->priv->manifest_entries),
                 g_strv_length (self->priv->subsystems), subsystems_str);
 
 out:
+    if (subsystems)
+        g_ptr_array_free (subsystems, TRUE);
     g_list_free_full (shared_paths, g_free);
     g_list_free_full (plugin_paths, g_free);
-    if (dir)
-        g_dir_close (dir);
 
     /* Return TRUE if at least one plugin found */
-    return (self->priv->plugins || self->priv->generic);
+    return (self->priv->plugins || self->priv->generic || self->priv->manifest_entries);
 }
 
 /*****************************************************************************/
@@ -1961,6 +2789,8 @@ mm_plugin_manager_init (MMPluginManager *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_PLUGIN_MANAGER,
                                               MMPluginManagerPrivate);
+
+    self->priv->index = mm_plugin_index_new ();
 }
 
 static void
@@ -2011,8 +2841,16 @@ initable_init (GInitable *initable,
                GCancellable *cancellable,
                GError **error)
 {
+    MMPluginManager *self = MM_PLUGIN_MANAGER (initable);
+
     /* Load the list of plugins */
-    return load_plugins (MM_PLUGIN_MANAGER (initable), error);
+    if (!load_plugins (self, error))
+        return FALSE;
+
+    if (mm_context_get_probe_cache ())
+        self->priv->probe_cache = mm_probe_cache_new (mm_context_get_probe_cache ());
+
+    return TRUE;
 }
 
 static void
@@ -2020,10 +2858,13 @@ dispose (GObject *object)
 {
     MMPluginManager *self = MM_PLUGIN_MANAGER (object);
 
+    g_clear_pointer (&self->priv->index, mm_plugin_index_free);
     g_list_free_full (g_steal_pointer (&self->priv->plugins), g_object_unref);
     g_clear_object (&self->priv->generic);
+    g_list_free_full (g_steal_pointer (&self->priv->manifest_entries), (GDestroyNotify) manifest_entry_free);
     g_clear_pointer (&self->priv->plugin_dir, g_free);
     g_clear_object (&self->priv->filter);
+    g_clear_object (&self->priv->probe_cache);
     g_clear_pointer (&self->priv->subsystems, g_strfreev);
 
     G_OBJECT_CLASS (mm_plugin_manager_parent_class)->dispose (object);
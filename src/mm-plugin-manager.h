@@ -67,4 +67,10 @@ MMPlugin        *mm_plugin_manager_peek_plugin                 (MMPluginManager
                                                                 const gchar          *plugin_name);
 const gchar    **mm_plugin_manager_get_subsystems              (MMPluginManager      *self);
 
+/* Write the manifest of all plugins found in the given directory, to be
+ * installed along with them so that they can be loaded on demand */
+gboolean         mm_plugin_manager_write_manifest              (const gchar          *plugin_dir,
+                                                                const gchar          *path,
+                                                                GError              **error);
+
 #endif /* MM_PLUGIN_MANAGER_H */
@@ -35,6 +35,7 @@
 #include "mm-serial-parsers.h"
 #include "mm-private-boxed-types.h"
 #include "mm-log-object.h"
+#include "mm-plugin-index.h"
 #include "mm-daemon-enums-types.h"
 
 #if defined WITH_QMI
@@ -180,6 +181,20 @@ mm_plugin_get_allowed_subsystem_vendor_ids (MMPlugin *self)
     return self->priv->subsystem_vendor_ids;
 }
 
+const gchar **
+mm_plugin_get_allowed_drivers (MMPlugin *self)
+{
+    return (const gchar **) self->priv->drivers;
+}
+
+gboolean
+mm_plugin_has_string_filters (MMPlugin *self)
+{
+    return (self->priv->vendor_strings ||
+            self->priv->product_strings ||
+            self->priv->forbidden_product_strings);
+}
+
 gboolean
 mm_plugin_is_generic (MMPlugin *self)
 {
@@ -254,9 +269,9 @@ apply_pre_probing_filters (MMPlugin       *self,
     guint16 vendor;
     guint16 product;
     guint16 subsystem_vendor;
-    gboolean product_filtered = FALSE;
-    gboolean vendor_filtered = FALSE;
-    gboolean subsystem_vendor_filtered = FALSE;
+    gboolean product_filtered;
+    gboolean vendor_filtered;
+    gboolean subsystem_vendor_filtered;
     guint i;
 
     *need_vendor_probing = FALSE;
@@ -298,24 +313,10 @@ apply_pre_probing_filters (MMPlugin       *self,
             return TRUE;
         }
 
-        /* Filtering by allowed drivers */
-        if (self->priv->drivers) {
-            gboolean found = FALSE;
-
-            for (i = 0; self->priv->drivers[i] && !found; i++) {
-                guint j;
-
-                for (j = 0; drivers[j] && !found; j++) {
-                    if (g_str_equal (drivers[j], self->priv->drivers[i]))
-                        found = TRUE;
-                }
-            }
-
-            /* If we didn't match any driver: unsupported */
-            if (!found) {
-                mm_obj_dbg (self, "port %s filtered by drivers", mm_kernel_device_get_name (port));
-                return TRUE;
-            }
+        /* Filtering by allowed drivers; if we didn't match any driver: unsupported */
+        if (self->priv->drivers && !mm_plugin_index_match_drivers ((const gchar **) self->priv->drivers, drivers)) {
+            mm_obj_dbg (self, "port %s filtered by drivers", mm_kernel_device_get_name (port));
+            return TRUE;
         }
 
         /* Filtering by forbidden drivers */
@@ -364,66 +365,17 @@ apply_pre_probing_filters (MMPlugin       *self,
     product = mm_device_get_product (device);
     subsystem_vendor = mm_device_get_subsystem_vendor (device);
 
-    /* The plugin may specify that only some vendor IDs are supported. If that
-     * is the case, filter by vendor ID. */
-    if (self->priv->vendor_ids) {
-        /* If we didn't get any vendor: filtered */
-        if (!vendor)
-            vendor_filtered = TRUE;
-        else {
-            for (i = 0; self->priv->vendor_ids[i]; i++)
-                if (vendor == self->priv->vendor_ids[i])
-                    break;
-
-            /* If we didn't match any vendor: filtered */
-            if (!self->priv->vendor_ids[i])
-                vendor_filtered = TRUE;
-        }
-    }
-
-    /* The plugin may specify that only some product IDs are supported. If
-     * that is the case, filter by vendor+product ID pair */
-    if (self->priv->product_ids) {
-        /* If we didn't get any product: filtered */
-        if (!product || !vendor)
-            product_filtered = TRUE;
-        else {
-            for (i = 0; self->priv->product_ids[i].l; i++)
-                if (vendor == self->priv->product_ids[i].l &&
-                    product == self->priv->product_ids[i].r)
-                    break;
-
-            /* If we didn't match any product: filtered */
-            if (!self->priv->product_ids[i].l)
-                product_filtered = TRUE;
-        }
-
-        /* When both vendor ids and product ids are given, it may be the case that
-         * we're allowing a full VID1 and only a subset of another VID2, so try to
-         * handle that properly. */
-        if (vendor_filtered && !product_filtered)
-            vendor_filtered = FALSE;
-        if (product_filtered && self->priv->vendor_ids && !vendor_filtered)
-            product_filtered = FALSE;
-    }
-
-    /* The plugin may specify that a set of vendor IDs is valid only when going
-     * with a specific subsystem vendor IDs (PCI modems).
-     * If that is the case, filter by vendor+subsystem vendor ID pair */
-    if (subsystem_vendor && self->priv->subsystem_vendor_ids) {
-        for (i = 0; self->priv->subsystem_vendor_ids[i].l; i++)
-            if (vendor == self->priv->subsystem_vendor_ids[i].l &&
-                subsystem_vendor == self->priv->subsystem_vendor_ids[i].r) {
-                /* If device was filtered by vendor, we override that value, since
-                 * we want to give priority to vendor/subsystem vendor match */
-                vendor_filtered = FALSE;
-                break;
-            }
-
-        /* If we didn't match any vendor/subsystem vendor: filtered */
-        if (!self->priv->subsystem_vendor_ids[i].l)
-            subsystem_vendor_filtered = TRUE;
-    }
+    /* The plugin may specify that only some vendor IDs, vendor+product ID
+     * pairs or vendor+subsystem vendor ID pairs are supported */
+    mm_plugin_index_filter_ids (self->priv->vendor_ids,
+                                self->priv->product_ids,
+                                self->priv->subsystem_vendor_ids,
+                                vendor,
+                                product,
+                                subsystem_vendor,
+                                &vendor_filtered,
+                                &product_filtered,
+                                &subsystem_vendor_filtered);
 
     /* If we got filtered by vendor/product/subsystem IDs; mark it as unsupported only if:
      *   a) we do not have vendor or product strings to compare with (i.e. plugin
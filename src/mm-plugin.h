@@ -134,6 +134,8 @@ const gchar          **mm_plugin_get_allowed_udev_tags            (MMPlugin *sel
 const guint16         *mm_plugin_get_allowed_vendor_ids           (MMPlugin *self);
 const mm_uint16_pair  *mm_plugin_get_allowed_product_ids          (MMPlugin *self);
 const mm_uint16_pair  *mm_plugin_get_allowed_subsystem_vendor_ids (MMPlugin *self);
+const gchar          **mm_plugin_get_allowed_drivers              (MMPlugin *self);
+gboolean               mm_plugin_has_string_filters               (MMPlugin *self);
 gboolean               mm_plugin_is_generic                       (MMPlugin *self);
 
 /* This method will run all pre-probing filters, to see if we can discard this
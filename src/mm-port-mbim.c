@@ -27,6 +27,7 @@
 
 #include "mm-port-mbim.h"
 #include "mm-port-net.h"
+#include "mm-link-pool.h"
 #include "mm-log-object.h"
 
 G_DEFINE_TYPE (MMPortMbim, mm_port_mbim, MM_TYPE_PORT)
@@ -38,6 +39,11 @@ struct _MMPortMbimPrivate {
     /* timeout monitoring */
     gulong timeout_monitoring_id;
 
+    /* preallocated links */
+    MMPort     *preallocated_links_main;
+    MMLinkPool *preallocated_links;
+    GList      *preallocated_links_setup_pending;
+
 #if defined WITH_QMI && QMI_MBIM_QMUX_SUPPORTED
     gboolean    qmi_supported;
     QmiDevice  *qmi_device;
@@ -160,6 +166,147 @@ mm_port_mbim_allocate_qmi_client (MMPortMbim           *self,
 
 /*****************************************************************************/
 
+static guint
+get_link_pool_size (MMPortMbim *self)
+{
+    /* links are created on demand unless a pool is explicitly requested;
+     * session 0 is kept for the non-multiplexed connection */
+    return mm_link_pool_get_requested_size (MM_PORT (self), MBIM_DEVICE_SESSION_ID_MAX - MBIM_DEVICE_SESSION_ID_MIN);
+}
+
+static void
+delete_preallocated_links (MbimDevice *mbim_device,
+                           MMLinkPool *preallocated_links)
+{
+    guint i;
+
+    /* Not fatal if this fails, all links are anyway removed when the port
+     * is reset */
+    for (i = 0; i < mm_link_pool_get_n_links (preallocated_links); i++)
+        mbim_device_delete_link (mbim_device,
+                                 mm_link_pool_get_link (preallocated_links, i, NULL),
+                                 NULL, NULL, NULL);
+}
+
+static gboolean
+acquire_preallocated_link (MMPortMbim  *self,
+                           MMPort      *main,
+                           gchar      **link_name,
+                           guint       *session_id,
+                           GError     **error)
+{
+    if (!self->priv->mbim_device) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_ABORTED,
+                     "port is closed");
+        return FALSE;
+    }
+
+    if (!self->priv->preallocated_links) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "No preallocated links available");
+        return FALSE;
+    }
+
+    return mm_link_pool_acquire (self->priv->preallocated_links, main, link_name, session_id, error);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    MbimDevice *mbim_device;
+    MMPort     *data;
+    MMLinkPool *preallocated_links;
+} InitializePreallocatedLinksContext;
+
+static void
+initialize_preallocated_links_context_free (InitializePreallocatedLinksContext *ctx)
+{
+    if (ctx->preallocated_links) {
+        delete_preallocated_links (ctx->mbim_device, ctx->preallocated_links);
+        mm_link_pool_free (ctx->preallocated_links);
+    }
+    g_object_unref (ctx->mbim_device);
+    g_object_unref (ctx->data);
+    g_slice_free (InitializePreallocatedLinksContext, ctx);
+}
+
+static MMLinkPool *
+initialize_preallocated_links_finish (MMPortMbim    *self,
+                                      GAsyncResult  *res,
+                                      GError       **error)
+{
+    return g_task_propagate_pointer (G_TASK (res), error);
+}
+
+static void
+device_add_link_preallocated_ready (MbimDevice   *device,
+                                    GAsyncResult *res,
+                                    GTask        *task)
+{
+    MMPortMbim                         *self;
+    InitializePreallocatedLinksContext *ctx;
+    GError                             *error = NULL;
+    gchar                              *link_name;
+    guint                               session_id = 0;
+
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
+
+    link_name = mbim_device_add_link_finish (device, res, &session_id, &error);
+    if (mm_link_pool_complete_pending (ctx->preallocated_links, link_name, session_id, g_steal_pointer (&error))) {
+        g_object_unref (task);
+        return;
+    }
+
+    if (!mm_link_pool_check_pending (ctx->preallocated_links, &error))
+        g_task_return_error (task, error);
+    else if (!self->priv->mbim_device)
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_ABORTED, "port is closed");
+    else
+        g_task_return_pointer (task, g_steal_pointer (&ctx->preallocated_links), (GDestroyNotify)mm_link_pool_free);
+    g_object_unref (task);
+}
+
+static void
+initialize_preallocated_links (MMPortMbim          *self,
+                               const gchar         *link_prefix_hint,
+                               GAsyncReadyCallback  callback,
+                               gpointer             user_data)
+{
+    InitializePreallocatedLinksContext *ctx;
+    GTask                              *task;
+    guint                               amount;
+    guint                               i;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    amount = get_link_pool_size (self);
+    g_assert (amount > 0);
+
+    ctx = g_slice_new0 (InitializePreallocatedLinksContext);
+    ctx->mbim_device = g_object_ref (self->priv->mbim_device);
+    ctx->data = g_object_ref (self->priv->preallocated_links_main);
+    ctx->preallocated_links = mm_link_pool_new (ctx->data, amount);
+    g_task_set_task_data (task, ctx, (GDestroyNotify)initialize_preallocated_links_context_free);
+
+    /* All links are requested at once, so that the netlink exchanges with
+     * the kernel run in parallel. Explicit session ids are given so that
+     * the automatic selection doesn't race between the requests. */
+    mm_obj_dbg (self, "creating a pool of %u multiplexed links...", amount);
+    mm_link_pool_set_pending (ctx->preallocated_links, amount);
+    for (i = 0; i < amount; i++)
+        mbim_device_add_link (ctx->mbim_device,
+                              MBIM_DEVICE_SESSION_ID_MIN + 1 + i,
+                              mm_kernel_device_get_name (mm_port_peek_kernel_device (ctx->data)),
+                              link_prefix_hint,
+                              NULL,
+                              (GAsyncReadyCallback) device_add_link_preallocated_ready,
+                              g_object_ref (task));
+    g_object_unref (task);
+}
+
+/*****************************************************************************/
+
 typedef struct {
     gchar *link_name;
     guint  session_id;
@@ -213,6 +360,130 @@ device_add_link_ready (MbimDevice   *device,
     g_object_unref (task);
 }
 
+static void
+setup_preallocated_link (GTask *task)
+{
+    MMPortMbim      *self;
+    MMPort          *data;
+    SetupLinkResult *result;
+    GError          *error = NULL;
+
+    self = g_task_get_source_object (task);
+    data = g_task_get_task_data (task);
+
+    result = g_slice_new0 (SetupLinkResult);
+    if (!acquire_preallocated_link (self, data, &result->link_name, &result->session_id, &error)) {
+        g_task_return_error (task, error);
+        setup_link_result_free (result);
+    } else
+        g_task_return_pointer (task, result, (GDestroyNotify)setup_link_result_free);
+    g_object_unref (task);
+}
+
+static void
+complete_preallocated_links_task (GTask        *task,
+                                  const GError *error)
+{
+    if (error) {
+        g_task_return_error (task, g_error_copy (error));
+        g_object_unref (task);
+        return;
+    }
+
+    /* Tasks just warming up the pool don't take any link */
+    if (g_task_get_source_tag (task) == mm_port_mbim_preallocate_links) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    setup_preallocated_link (task);
+}
+
+static void
+initialize_preallocated_links_ready (MMPortMbim   *self,
+                                     GAsyncResult *res,
+                                     GTask        *task)
+{
+    g_autoptr(GError) error = NULL;
+
+    g_assert (!self->priv->preallocated_links);
+    self->priv->preallocated_links = initialize_preallocated_links_finish (self, res, &error);
+    if (!self->priv->preallocated_links) {
+        /* reset back the main, because we're not really initialized */
+        g_clear_object (&self->priv->preallocated_links_main);
+    }
+
+    /* Complete our task and all the pending ones, either with links or
+     * with the error */
+    complete_preallocated_links_task (task, error);
+    while (self->priv->preallocated_links_setup_pending) {
+        complete_preallocated_links_task (self->priv->preallocated_links_setup_pending->data, error);
+        self->priv->preallocated_links_setup_pending = g_list_delete_link (self->priv->preallocated_links_setup_pending,
+                                                                           self->priv->preallocated_links_setup_pending);
+    }
+}
+
+static void
+request_preallocated_links (MMPortMbim  *self,
+                            MMPort      *data,
+                            const gchar *link_prefix_hint,
+                            GTask       *task)
+{
+    if (self->priv->preallocated_links) {
+        complete_preallocated_links_task (task, NULL);
+        return;
+    }
+
+    /* Queue our task if the links are already being initialized */
+    if (self->priv->preallocated_links_main) {
+        self->priv->preallocated_links_setup_pending = g_list_append (self->priv->preallocated_links_setup_pending, task);
+        return;
+    }
+
+    /* Store main to flag that we're initializing preallocated links */
+    self->priv->preallocated_links_main = g_object_ref (data);
+    initialize_preallocated_links (self,
+                                   link_prefix_hint,
+                                   (GAsyncReadyCallback) initialize_preallocated_links_ready,
+                                   task);
+}
+
+gboolean
+mm_port_mbim_preallocate_links_finish (MMPortMbim    *self,
+                                       GAsyncResult  *res,
+                                       GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+void
+mm_port_mbim_preallocate_links (MMPortMbim          *self,
+                                MMPort              *data,
+                                const gchar         *link_prefix_hint,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+    GTask *task;
+
+    task = g_task_new (self, NULL, callback, user_data);
+    g_task_set_source_tag (task, mm_port_mbim_preallocate_links);
+
+    if (!self->priv->mbim_device) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Port is not open");
+        g_object_unref (task);
+        return;
+    }
+
+    if (!get_link_pool_size (self)) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    request_preallocated_links (self, data, link_prefix_hint, task);
+}
+
 void
 mm_port_mbim_setup_link (MMPortMbim          *self,
                          MMPort              *data,
@@ -230,6 +501,13 @@ mm_port_mbim_setup_link (MMPortMbim          *self,
         return;
     }
 
+    /* When a link pool is requested, use preallocated links */
+    if (get_link_pool_size (self) > 0) {
+        g_task_set_task_data (task, g_object_ref (data), g_object_unref);
+        request_preallocated_links (self, data, link_prefix_hint, task);
+        return;
+    }
+
     mbim_device_add_link (self->priv->mbim_device,
                           MBIM_DEVICE_SESSION_ID_AUTOMATIC,
                           mm_kernel_device_get_name (mm_port_peek_kernel_device (data)),
@@ -279,6 +557,13 @@ mm_port_mbim_cleanup_link (MMPortMbim          *self,
         return;
     }
 
+    /* Preallocated links are kept for the next connection */
+    if (self->priv->preallocated_links && mm_link_pool_release (self->priv->preallocated_links, link_name)) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
     mbim_device_delete_link (self->priv->mbim_device,
                              link_name,
                              NULL,
@@ -816,6 +1101,12 @@ mm_port_mbim_close (MMPortMbim          *self,
     /* Store device(s) to close in the context */
     ctx = g_slice_new0 (PortMbimCloseContext);
     ctx->mbim_device = g_steal_pointer (&self->priv->mbim_device);
+
+    if (self->priv->preallocated_links) {
+        delete_preallocated_links (ctx->mbim_device, self->priv->preallocated_links);
+        g_clear_pointer (&self->priv->preallocated_links, mm_link_pool_free);
+    }
+    g_clear_object (&self->priv->preallocated_links_main);
     g_task_set_task_data (task, ctx, (GDestroyNotify)port_mbim_close_context_free);
 
 #if defined WITH_QMI && QMI_MBIM_QMUX_SUPPORTED
@@ -895,6 +1186,11 @@ dispose (GObject *object)
     g_clear_object (&self->priv->qmi_device);
 #endif
 
+    if (self->priv->preallocated_links && self->priv->mbim_device)
+        delete_preallocated_links (self->priv->mbim_device, self->priv->preallocated_links);
+    g_clear_pointer (&self->priv->preallocated_links, mm_link_pool_free);
+    g_clear_object (&self->priv->preallocated_links_main);
+
     /* Clear device object */
     reset_timeout_monitoring (self, self->priv->mbim_device);
     g_clear_object (&self->priv->mbim_device);
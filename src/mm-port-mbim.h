@@ -92,6 +92,15 @@ gboolean   mm_port_mbim_allocate_qmi_client_finish (MMPortMbim           *self,
 
 MbimDevice *mm_port_mbim_peek_device (MMPortMbim *self);
 
+void     mm_port_mbim_preallocate_links        (MMPortMbim           *self,
+                                                MMPort               *data,
+                                                const gchar          *link_prefix_hint,
+                                                GAsyncReadyCallback   callback,
+                                                gpointer              user_data);
+gboolean mm_port_mbim_preallocate_links_finish (MMPortMbim           *self,
+                                                GAsyncResult         *res,
+                                                GError              **error);
+
 void   mm_port_mbim_setup_link        (MMPortMbim            *self,
                                        MMPort                *data,
                                        const gchar           *link_prefix_hint,
@@ -22,10 +22,34 @@
 #include "mm-log-object.h"
 #include "mm-netlink.h"
 
+/* Only defined in linux/if.h, which clashes with net/if.h */
+#ifndef IFF_LOWER_UP
+# define IFF_LOWER_UP 0x10000
+#endif
+
 G_DEFINE_TYPE (MMPortNet, mm_port_net, MM_TYPE_PORT)
 
+enum {
+    PROP_0,
+    PROP_CARRIER,
+    PROP_MTU,
+    PROP_LAST
+};
+
+static GParamSpec *properties[PROP_LAST];
+
 struct _MMPortNetPrivate {
     guint ifindex;
+    /* Link state, loaded with an initial query and then updated from
+     * netlink events */
+    gulong    link_changed_id;
+    gboolean  link_state_loaded;
+    gboolean  link_state_valid;
+    guint     link_events;
+    GList    *link_state_waiters;
+    gboolean  up;
+    gboolean  carrier;
+    guint     mtu;
 };
 
 static void
@@ -42,6 +66,142 @@ ensure_ifindex (MMPortNet *self)
 
 /*****************************************************************************/
 
+gboolean
+mm_port_net_get_carrier (MMPortNet *self)
+{
+    return self->priv->carrier;
+}
+
+guint
+mm_port_net_get_mtu (MMPortNet *self)
+{
+    return self->priv->mtu;
+}
+
+static void
+link_state_update (MMPortNet *self,
+                   guint      flags,
+                   guint      mtu,
+                   gboolean   removed)
+{
+    gboolean carrier;
+
+    self->priv->link_state_valid = !removed;
+    self->priv->up = (!removed && (flags & IFF_UP));
+
+    carrier = (!removed && (flags & IFF_LOWER_UP));
+    if (carrier != self->priv->carrier) {
+        mm_obj_dbg (self, "carrier %s", carrier ? "detected" : "lost");
+        self->priv->carrier = carrier;
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_CARRIER]);
+    }
+
+    if (mtu && mtu != self->priv->mtu) {
+        mm_obj_dbg (self, "MTU updated: %u", mtu);
+        self->priv->mtu = mtu;
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MTU]);
+    }
+}
+
+static void
+link_state_loaded (MMPortNet    *self,
+                   const GError *error)
+{
+    GList *waiters;
+    GList *l;
+
+    self->priv->link_state_loaded = TRUE;
+
+    waiters = g_steal_pointer (&self->priv->link_state_waiters);
+    for (l = waiters; l; l = g_list_next (l)) {
+        GTask *task = l->data;
+
+        if (error)
+            g_task_return_error (task, g_error_copy (error));
+        else
+            g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+    }
+    g_list_free (waiters);
+}
+
+static void
+link_changed_cb (MMNetlink   *netlink,
+                 guint        ifindex,
+                 const gchar *name,
+                 guint        flags,
+                 guint        mtu,
+                 gboolean     removed,
+                 MMPortNet   *self)
+{
+    /* The interface may not have existed yet when the port was created,
+     * so also match by name until the index is known */
+    if (!self->priv->ifindex) {
+        if (removed || g_strcmp0 (name, mm_port_get_device (MM_PORT (self))) != 0)
+            return;
+        self->priv->ifindex = ifindex;
+        mm_obj_dbg (self, "interface index: %u", self->priv->ifindex);
+    } else if (ifindex != self->priv->ifindex)
+        return;
+
+    self->priv->link_events++;
+    link_state_update (self, flags, mtu, removed);
+    if (!self->priv->link_state_loaded)
+        link_state_loaded (self, NULL);
+
+    /* A new interface with the same name would get a different index */
+    if (removed)
+        self->priv->ifindex = 0;
+}
+
+static void
+netlink_get_link_ready (MMNetlink    *netlink,
+                        GAsyncResult *res,
+                        MMPortNet    *self)
+{
+    g_autoptr(GError) error = NULL;
+    guint             flags = 0;
+    guint             mtu = 0;
+
+    if (!mm_netlink_get_link_finish (netlink, res, &flags, &mtu, &error))
+        mm_obj_dbg (self, "couldn't load initial link state: %s", error->message);
+    /* An event received meanwhile is newer than this reply */
+    else if (!self->priv->link_events)
+        link_state_update (self, flags, mtu, FALSE);
+
+    if (!self->priv->link_state_loaded)
+        link_state_loaded (self, error);
+    g_object_unref (self);
+}
+
+gboolean
+mm_port_net_wait_link_state_finish (MMPortNet     *self,
+                                    GAsyncResult  *res,
+                                    GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+void
+mm_port_net_wait_link_state (MMPortNet           *self,
+                             GAsyncReadyCallback  callback,
+                             gpointer             user_data)
+{
+    GTask *task;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    if (self->priv->link_state_loaded) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    self->priv->link_state_waiters = g_list_append (self->priv->link_state_waiters, task);
+}
+
+/*****************************************************************************/
+
 gboolean
 mm_port_net_link_setup_finish (MMPortNet     *self,
                                GAsyncResult  *res,
@@ -50,18 +210,45 @@ mm_port_net_link_setup_finish (MMPortNet     *self,
     return g_task_propagate_boolean (G_TASK (res), error);
 }
 
+typedef struct {
+    gboolean up;
+    guint    mtu;
+} LinkSetupContext;
+
+static void
+link_setup_context_free (LinkSetupContext *ctx)
+{
+    g_slice_free (LinkSetupContext, ctx);
+}
+
 static void
 netlink_setlink_ready (MMNetlink    *netlink,
                        GAsyncResult *res,
                        GTask        *task)
 {
-    GError *error = NULL;
+    MMPortNet        *self;
+    LinkSetupContext *ctx;
+    GError           *error = NULL;
+
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
 
     if (!mm_netlink_setlink_finish (netlink, res, &error)) {
         g_prefix_error (&error, "netlink operation failed: ");
         g_task_return_error (task, error);
-    } else
-        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Don't wait for the event to know the new state, another setup
+     * may be requested before it arrives */
+    if (self->priv->link_state_valid) {
+        self->priv->up = ctx->up;
+        if (ctx->mtu)
+            self->priv->mtu = ctx->mtu;
+    }
+
+    g_task_return_boolean (task, TRUE);
     g_object_unref (task);
 }
 
@@ -73,7 +260,8 @@ mm_port_net_link_setup (MMPortNet            *self,
                         GAsyncReadyCallback   callback,
                         gpointer              user_data)
 {
-    GTask *task;
+    GTask            *task;
+    LinkSetupContext *ctx;
 
     task = g_task_new (self, cancellable, callback, user_data);
 
@@ -86,6 +274,21 @@ mm_port_net_link_setup (MMPortNet            *self,
         return;
     }
 
+    /* e.g. links reused from a pool are already up with the right MTU */
+    if (self->priv->link_state_valid &&
+        (self->priv->up == up) &&
+        (!mtu || (mtu == self->priv->mtu))) {
+        mm_obj_dbg (self, "link already %s with MTU %u", up ? "up" : "down", self->priv->mtu);
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    ctx = g_slice_new0 (LinkSetupContext);
+    ctx->up = up;
+    ctx->mtu = mtu;
+    g_task_set_task_data (task, ctx, (GDestroyNotify) link_setup_context_free);
+
     mm_netlink_setlink (mm_netlink_get (), /* singleton */
                         self->priv->ifindex,
                         up,
@@ -113,10 +316,95 @@ mm_port_net_init (MMPortNet *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_PORT_NET, MMPortNetPrivate);
 }
 
+static void
+get_property (GObject    *object,
+              guint       prop_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+    MMPortNet *self = MM_PORT_NET (object);
+
+    switch (prop_id) {
+    case PROP_CARRIER:
+        g_value_set_boolean (value, self->priv->carrier);
+        break;
+    case PROP_MTU:
+        g_value_set_uint (value, self->priv->mtu);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+constructed (GObject *object)
+{
+    MMPortNet *self = MM_PORT_NET (object);
+    MMNetlink *netlink;
+
+    G_OBJECT_CLASS (mm_port_net_parent_class)->constructed (object);
+
+    /* Carrier and MTU changes are pushed by the kernel, no need to poll */
+    netlink = mm_netlink_get ();
+    mm_netlink_events_enable (netlink);
+    self->priv->link_changed_id = g_signal_connect (netlink,
+                                                    MM_NETLINK_SIGNAL_LINK_CHANGED,
+                                                    G_CALLBACK (link_changed_cb),
+                                                    self);
+
+    /* If the interface doesn't exist yet, the state is loaded from the
+     * event reporting it */
+    self->priv->ifindex = if_nametoindex (mm_port_get_device (MM_PORT (self)));
+    if (self->priv->ifindex)
+        mm_netlink_get_link (netlink,
+                             self->priv->ifindex,
+                             NULL,
+                             (GAsyncReadyCallback) netlink_get_link_ready,
+                             g_object_ref (self));
+}
+
+static void
+dispose (GObject *object)
+{
+    MMPortNet *self = MM_PORT_NET (object);
+
+    if (self->priv->link_changed_id) {
+        MMNetlink *netlink;
+
+        netlink = mm_netlink_get ();
+        g_signal_handler_disconnect (netlink, self->priv->link_changed_id);
+        self->priv->link_changed_id = 0;
+        mm_netlink_events_disable (netlink);
+    }
+
+    G_OBJECT_CLASS (mm_port_net_parent_class)->dispose (object);
+}
+
 static void
 mm_port_net_class_init (MMPortNetClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
     g_type_class_add_private (object_class, sizeof (MMPortNetPrivate));
+
+    object_class->get_property = get_property;
+    object_class->constructed  = constructed;
+    object_class->dispose      = dispose;
+
+    properties[PROP_CARRIER] =
+        g_param_spec_boolean (MM_PORT_NET_CARRIER,
+                              "Carrier",
+                              "Whether the link reports carrier",
+                              FALSE,
+                              G_PARAM_READABLE);
+    g_object_class_install_property (object_class, PROP_CARRIER, properties[PROP_CARRIER]);
+
+    properties[PROP_MTU] =
+        g_param_spec_uint (MM_PORT_NET_MTU,
+                           "MTU",
+                           "MTU of the link, 0 if unknown",
+                           0, G_MAXUINT, 0,
+                           G_PARAM_READABLE);
+    g_object_class_install_property (object_class, PROP_MTU, properties[PROP_MTU]);
 }
@@ -32,6 +32,9 @@
 #define MM_IS_PORT_NET_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_PORT_NET))
 #define MM_PORT_NET_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_PORT_NET, MMPortNetClass))
 
+#define MM_PORT_NET_CARRIER "carrier"
+#define MM_PORT_NET_MTU     "mtu"
+
 typedef struct _MMPortNet MMPortNet;
 typedef struct _MMPortNetClass MMPortNetClass;
 typedef struct _MMPortNetPrivate MMPortNetPrivate;
@@ -50,6 +53,18 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMPortNet, g_object_unref)
 
 MMPortNet *mm_port_net_new (const gchar *name);
 
+/* Link state as reported by netlink, loaded when the port is created */
+gboolean mm_port_net_get_carrier (MMPortNet *self);
+guint    mm_port_net_get_mtu     (MMPortNet *self);
+
+/* Wait for the initial link state to be loaded */
+void     mm_port_net_wait_link_state        (MMPortNet            *self,
+                                             GAsyncReadyCallback   callback,
+                                             gpointer              user_data);
+gboolean mm_port_net_wait_link_state_finish (MMPortNet            *self,
+                                             GAsyncResult         *res,
+                                             GError              **error);
+
 void     mm_port_net_link_setup        (MMPortNet            *self,
                                         gboolean              up,
                                         guint                 mtu,
@@ -1260,9 +1260,9 @@ serial_flash_ready (MMPortSerial *port,
 }
 
 static void
-serial_buffer_full (MMPortSerial *serial,
-                    GByteArray   *buffer,
-                    MMPortProbe  *self)
+serial_buffer_full (MMPortSerial       *serial,
+                    MMPortSerialBuffer *buffer,
+                    MMPortProbe        *self)
 {
     PortProbeRunContext *ctx;
 
@@ -1314,6 +1314,7 @@ serial_open_at (MMPortProbe *self)
     if (!ctx->serial) {
         gpointer parser;
         MMPortSubsys subsys = MM_PORT_SUBSYS_TTY;
+        guint chunk_size;
 
         if (g_str_equal (mm_kernel_device_get_subsystem (self->priv->port), "usbmisc"))
             subsys = MM_PORT_SUBSYS_USBMISC;
@@ -1340,6 +1341,12 @@ serial_open_at (MMPortProbe *self)
                       MM_PORT_SERIAL_AT_SEND_LF,     ctx->at_send_lf,
                       NULL);
 
+        /* Reuse the send chunk size calibrated for the same device model */
+        chunk_size = mm_port_serial_at_lookup_send_chunk_size (mm_kernel_device_get_physdev_vid (self->priv->port),
+                                                               mm_kernel_device_get_physdev_pid (self->priv->port));
+        if (chunk_size)
+            g_object_set (ctx->serial, MM_PORT_SERIAL_SEND_CHUNK_SIZE, chunk_size, NULL);
+
         common_serial_port_setup (self, ctx->serial);
 
         parser = mm_serial_parser_v1_new ();
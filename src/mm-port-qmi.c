@@ -25,6 +25,7 @@
 
 #include "mm-port-qmi.h"
 #include "mm-port-net.h"
+#include "mm-link-pool.h"
 #include "mm-port-enums-types.h"
 #include "mm-modem-helpers-qmi.h"
 #include "mm-log-object.h"
@@ -77,9 +78,9 @@ struct _MMPortQmiPrivate {
     QmiWdaDataAggregationProtocol dap;
     guint                         max_multiplexed_links;
     /* preallocated links */
-    MMPort   *preallocated_links_main;
-    GArray   *preallocated_links;
-    GList    *preallocated_links_setup_pending;
+    MMPort     *preallocated_links_main;
+    MMLinkPool *preallocated_links;
+    GList      *preallocated_links_setup_pending;
 };
 
 /*****************************************************************************/
@@ -348,77 +349,62 @@ mm_port_qmi_allocate_client (MMPortQmi           *self,
 
 /*****************************************************************************/
 
-typedef struct {
-    gchar    *link_name;
-    guint     mux_id;
-    gboolean  setup;
-} PreallocatedLinkInfo;
-
-static void
-preallocated_link_info_clear (PreallocatedLinkInfo *info)
-{
-    g_free (info->link_name);
-}
-
-static void
-delete_preallocated_links (QmiDevice *qmi_device,
-                           GArray    *preallocated_links)
+static guint
+get_link_pool_size (MMPortQmi *self)
 {
-    guint i;
-
-    /* This link deletion cleanup may fail if the main interface is up
-     * (a limitation of qmi_wwan in some kernel versions). It's just a minor
-     * inconvenience really, if MM restarts they'll be all removed during
-     * initialization anyway */
-
-    for (i = 0; i < preallocated_links->len; i++) {
-        PreallocatedLinkInfo *info;
+    /* rmnet links are created on demand unless a pool is explicitly requested */
+    if (self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_RMNET)
+        return mm_link_pool_get_requested_size (MM_PORT (self), 1 + (QMI_DEVICE_MUX_ID_MAX - QMI_DEVICE_MUX_ID_MIN));
 
-        info = &g_array_index (preallocated_links, PreallocatedLinkInfo, i);
-        qmi_device_delete_link (qmi_device, info->link_name, info->mux_id,
-                                NULL, NULL, NULL);
-    }
+    return 0;
 }
 
 static guint
-count_preallocated_links_setup (MMPortQmi *self)
+get_preallocated_links_amount (MMPortQmi *self)
 {
-    guint i;
-    guint count = 0;
-
-    for (i = 0; self->priv->preallocated_links && (i < self->priv->preallocated_links->len); i++) {
-        PreallocatedLinkInfo *info;
+    /* qmi_wwan only supports preallocated links */
+    if (self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_QMIWWAN)
+        return DEFAULT_LINK_PREALLOCATED_AMOUNT;
 
-        info = &g_array_index (self->priv->preallocated_links, PreallocatedLinkInfo, i);
-        if (info->setup)
-            count++;
-    }
+    return get_link_pool_size (self);
+}
 
-    return count;
+static QmiDeviceAddLinkFlags
+get_rmnet_link_flags (MMPortQmi *self)
+{
+    /* This may not be fully right, but it's the only way forward we know
+     * right now for the Qualcomm SoCs based on QRTR+IPA, where QMAPV4 is
+     * used and the device has checksum offload enabled by default, so we
+     * should create the link with special flags. Ideally, we would have a
+     * way to know in advance whether the checksum offload flags are needed
+     * or not.
+     */
+    if (self->priv->dap == QMI_WDA_DATA_AGGREGATION_PROTOCOL_QMAPV4)
+        return (QMI_DEVICE_ADD_LINK_FLAGS_INGRESS_MAP_CKSUMV4 | QMI_DEVICE_ADD_LINK_FLAGS_EGRESS_MAP_CKSUMV4);
+    return QMI_DEVICE_ADD_LINK_FLAGS_NONE;
 }
 
-static gboolean
-release_preallocated_link (MMPortQmi    *self,
-                           const gchar  *link_name,
-                           guint         mux_id,
-                           GError     **error)
+/*****************************************************************************/
+
+static void
+delete_preallocated_links (QmiDevice  *qmi_device,
+                           MMLinkPool *preallocated_links)
 {
     guint i;
 
-    for (i = 0; self->priv->preallocated_links && (i < self->priv->preallocated_links->len); i++) {
-        PreallocatedLinkInfo *info;
+    /* This link deletion cleanup may fail if the main interface is up
+     * (a limitation of qmi_wwan in some kernel versions). It's just a minor
+     * inconvenience really, if MM restarts they'll be all removed during
+     * initialization anyway */
 
-        info = &g_array_index (self->priv->preallocated_links, PreallocatedLinkInfo, i);
-        if (!info->setup || (g_strcmp0 (info->link_name, link_name) != 0) || (info->mux_id != mux_id))
-            continue;
+    for (i = 0; i < mm_link_pool_get_n_links (preallocated_links); i++) {
+        const gchar *link_name;
+        guint        mux_id;
 
-        info->setup = FALSE;
-        return TRUE;
+        link_name = mm_link_pool_get_link (preallocated_links, i, &mux_id);
+        qmi_device_delete_link (qmi_device, link_name, mux_id,
+                                NULL, NULL, NULL);
     }
-
-    g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                 "No preallocated link found to release");
-    return FALSE;
 }
 
 static gboolean
@@ -428,53 +414,28 @@ acquire_preallocated_link (MMPortQmi  *self,
                            guint      *mux_id,
                            GError    **error)
 {
-    guint i;
-
     if (!self->priv->qmi_device) {
         g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_ABORTED,
                      "port is closed");
         return FALSE;
     }
 
-    if (!self->priv->preallocated_links || !self->priv->preallocated_links_main) {
+    if (!self->priv->preallocated_links) {
         g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
                      "No preallocated links available");
         return FALSE;
     }
 
-    if ((main != self->priv->preallocated_links_main) &&
-        (g_strcmp0 (mm_port_get_device (main), mm_port_get_device (self->priv->preallocated_links_main)) != 0)) {
-        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                     "Preallocated links available in 'net/%s', not in 'net/%s'",
-                     mm_port_get_device (self->priv->preallocated_links_main),
-                     mm_port_get_device (main));
-        return FALSE;
-    }
-
-    for (i = 0; i < self->priv->preallocated_links->len; i++) {
-        PreallocatedLinkInfo *info;
-
-        info = &g_array_index (self->priv->preallocated_links, PreallocatedLinkInfo, i);
-        if (info->setup)
-            continue;
-
-        info->setup = TRUE;
-        *link_name = g_strdup (info->link_name);
-        *mux_id = info->mux_id;
-        return TRUE;
-    }
-
-    g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                 "No more preallocated links available");
-    return FALSE;
+    return mm_link_pool_acquire (self->priv->preallocated_links, main, link_name, mux_id, error);
 }
 
 /*****************************************************************************/
 
 typedef struct {
-    QmiDevice *qmi_device;
-    MMPort    *data;
-    GArray    *preallocated_links;
+    QmiDevice  *qmi_device;
+    MMPort     *data;
+    gchar      *link_prefix_hint;
+    MMLinkPool *preallocated_links;
 } InitializePreallocatedLinksContext;
 
 static void
@@ -482,14 +443,15 @@ initialize_preallocated_links_context_free (InitializePreallocatedLinksContext *
 {
     if (ctx->preallocated_links) {
         delete_preallocated_links (ctx->qmi_device, ctx->preallocated_links);
-        g_array_unref (ctx->preallocated_links);
+        mm_link_pool_free (ctx->preallocated_links);
     }
+    g_free (ctx->link_prefix_hint);
     g_object_unref (ctx->qmi_device);
     g_object_unref (ctx->data);
     g_slice_free (InitializePreallocatedLinksContext, ctx);
 }
 
-static GArray *
+static MMLinkPool *
 initialize_preallocated_links_finish (MMPortQmi     *self,
                                       GAsyncResult  *res,
                                       GError       **error)
@@ -506,19 +468,21 @@ device_add_link_preallocated_ready (QmiDevice     *device,
 {
     InitializePreallocatedLinksContext *ctx;
     GError                             *error = NULL;
-    PreallocatedLinkInfo                info = { NULL, 0, FALSE };
+    gchar                              *link_name;
+    guint                               mux_id = 0;
 
     ctx = g_task_get_task_data (task);
 
-    info.link_name = qmi_device_add_link_finish (device, res, &info.mux_id, &error);
-    if (!info.link_name) {
+    link_name = qmi_device_add_link_finish (device, res, &mux_id, &error);
+    if (!link_name) {
         g_prefix_error (&error, "failed to add preallocated link (%u/%u) for device: ",
-                        ctx->preallocated_links->len + 1, DEFAULT_LINK_PREALLOCATED_AMOUNT);
+                        mm_link_pool_get_n_links (ctx->preallocated_links) + 1,
+                        mm_link_pool_get_size (ctx->preallocated_links));
         g_task_return_error (task, error);
         return;
     }
 
-    g_array_append_val (ctx->preallocated_links, info);
+    mm_link_pool_add_link (ctx->preallocated_links, link_name, mux_id);
     initialize_preallocated_links_next (task);
 }
 
@@ -527,6 +491,7 @@ initialize_preallocated_links_next (GTask *task)
 {
     MMPortQmi                          *self;
     InitializePreallocatedLinksContext *ctx;
+    guint                               n_links;
 
     self = g_task_get_source_object (task);
     ctx  = g_task_get_task_data (task);
@@ -538,14 +503,15 @@ initialize_preallocated_links_next (GTask *task)
         return;
     }
 
-    if (ctx->preallocated_links->len == DEFAULT_LINK_PREALLOCATED_AMOUNT) {
-        g_task_return_pointer (task, g_steal_pointer (&ctx->preallocated_links), (GDestroyNotify)g_array_unref);
+    n_links = mm_link_pool_get_n_links (ctx->preallocated_links);
+    if (n_links == mm_link_pool_get_size (ctx->preallocated_links)) {
+        g_task_return_pointer (task, g_steal_pointer (&ctx->preallocated_links), (GDestroyNotify)mm_link_pool_free);
         g_object_unref (task);
         return;
     }
 
     qmi_device_add_link (self->priv->qmi_device,
-                         ctx->preallocated_links->len + 1,
+                         n_links + 1,
                          mm_kernel_device_get_name (mm_port_peek_kernel_device (ctx->data)),
                          "ignored", /* n/a in qmi_wwan add_mux */
                          NULL,
@@ -553,24 +519,81 @@ initialize_preallocated_links_next (GTask *task)
                          task);
 }
 
+static void
+device_add_link_pooled_ready (QmiDevice    *device,
+                              GAsyncResult *res,
+                              GTask        *task)
+{
+    MMPortQmi                          *self;
+    InitializePreallocatedLinksContext *ctx;
+    GError                             *error = NULL;
+    gchar                              *link_name;
+    guint                               mux_id = 0;
+
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
+
+    link_name = qmi_device_add_link_with_flags_finish (device, res, &mux_id, &error);
+    if (mm_link_pool_complete_pending (ctx->preallocated_links, link_name, mux_id, g_steal_pointer (&error))) {
+        g_object_unref (task);
+        return;
+    }
+
+    if (!mm_link_pool_check_pending (ctx->preallocated_links, &error))
+        g_task_return_error (task, error);
+    else if (!self->priv->qmi_device)
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_ABORTED, "port is closed");
+    else
+        g_task_return_pointer (task, g_steal_pointer (&ctx->preallocated_links), (GDestroyNotify)mm_link_pool_free);
+    g_object_unref (task);
+}
+
 static void
 initialize_preallocated_links (MMPortQmi           *self,
+                               const gchar         *link_prefix_hint,
                                GAsyncReadyCallback  callback,
                                gpointer             user_data)
 {
     InitializePreallocatedLinksContext *ctx;
     GTask                              *task;
+    QmiDeviceAddLinkFlags               flags;
+    guint                               amount;
+    guint                               i;
 
     task = g_task_new (self, NULL, callback, user_data);
 
+    amount = get_preallocated_links_amount (self);
+    g_assert (amount > 0);
+
     ctx = g_slice_new0 (InitializePreallocatedLinksContext);
     ctx->qmi_device = g_object_ref (self->priv->qmi_device);
     ctx->data = g_object_ref (self->priv->preallocated_links_main);
-    ctx->preallocated_links = g_array_sized_new (FALSE, FALSE, sizeof (PreallocatedLinkInfo), DEFAULT_LINK_PREALLOCATED_AMOUNT);
-    g_array_set_clear_func (ctx->preallocated_links, (GDestroyNotify)preallocated_link_info_clear);
+    ctx->link_prefix_hint = g_strdup (link_prefix_hint);
+    ctx->preallocated_links = mm_link_pool_new (ctx->data, amount);
     g_task_set_task_data (task, ctx, (GDestroyNotify)initialize_preallocated_links_context_free);
 
-    initialize_preallocated_links_next (task);
+    /* qmi_wwan links are added one by one via sysfs */
+    if (!(self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_RMNET)) {
+        initialize_preallocated_links_next (task);
+        return;
+    }
+
+    /* rmnet links are requested all at once, so that the netlink exchanges
+     * with the kernel run in parallel. Explicit mux ids are given so that
+     * the automatic selection doesn't race between the requests. */
+    mm_obj_dbg (self, "creating a pool of %u multiplexed links...", amount);
+    flags = get_rmnet_link_flags (self);
+    mm_link_pool_set_pending (ctx->preallocated_links, amount);
+    for (i = 0; i < amount; i++)
+        qmi_device_add_link_with_flags (ctx->qmi_device,
+                                        QMI_DEVICE_MUX_ID_MIN + i,
+                                        mm_kernel_device_get_name (mm_port_peek_kernel_device (ctx->data)),
+                                        ctx->link_prefix_hint,
+                                        flags,
+                                        NULL,
+                                        (GAsyncReadyCallback) device_add_link_pooled_ready,
+                                        g_object_ref (task));
+    g_object_unref (task);
 }
 
 /*****************************************************************************/
@@ -642,6 +665,26 @@ setup_preallocated_link (GTask *task)
     g_object_unref (task);
 }
 
+static void
+complete_preallocated_links_task (GTask        *task,
+                                  const GError *error)
+{
+    if (error) {
+        g_task_return_error (task, g_error_copy (error));
+        g_object_unref (task);
+        return;
+    }
+
+    /* Tasks just warming up the pool don't take any link */
+    if (g_task_get_source_tag (task) == mm_port_qmi_preallocate_links) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    setup_preallocated_link (task);
+}
+
 static void
 initialize_preallocated_links_ready (MMPortQmi    *self,
                                      GAsyncResult *res,
@@ -652,55 +695,121 @@ initialize_preallocated_links_ready (MMPortQmi    *self,
     g_assert (!self->priv->preallocated_links);
     self->priv->preallocated_links = initialize_preallocated_links_finish (self, res, &error);
     if (!self->priv->preallocated_links) {
-        /* We need to fail this task and all the additional tasks also pending */
-        g_task_return_error (task, g_error_copy (error));
-        g_object_unref (task);
-        while (self->priv->preallocated_links_setup_pending) {
-            g_task_return_error (self->priv->preallocated_links_setup_pending->data, g_error_copy (error));
-            g_object_unref (self->priv->preallocated_links_setup_pending->data);
-            self->priv->preallocated_links_setup_pending = g_list_delete_link (self->priv->preallocated_links_setup_pending,
-                                                                               self->priv->preallocated_links_setup_pending);
-        }
-        /* and reset back the main, because we're not really initialized */
+        /* reset back the main, because we're not really initialized */
         g_clear_object (&self->priv->preallocated_links_main);
-        return;
     }
 
-    /* Now we know preallocated links are available, complete our task and all the pending ones */
-    setup_preallocated_link (task);
+    /* Complete our task and all the pending ones, either with links or
+     * with the error */
+    complete_preallocated_links_task (task, error);
     while (self->priv->preallocated_links_setup_pending) {
-        setup_preallocated_link (self->priv->preallocated_links_setup_pending->data);
+        complete_preallocated_links_task (self->priv->preallocated_links_setup_pending->data, error);
         self->priv->preallocated_links_setup_pending = g_list_delete_link (self->priv->preallocated_links_setup_pending,
                                                                            self->priv->preallocated_links_setup_pending);
     }
 }
 
+static void
+request_preallocated_links (MMPortQmi   *self,
+                            MMPort      *data,
+                            const gchar *link_prefix_hint,
+                            GTask       *task)
+{
+    if (self->priv->preallocated_links) {
+        complete_preallocated_links_task (task, NULL);
+        return;
+    }
+
+    /* We must make sure we don't run this procedure in parallel (e.g. if multiple
+     * connection attempts reach at the same time), so if we're told the preallocated
+     * links are already being initialized (main is set) but the array didn't exist,
+     * queue our task for completion once we're fully initialized */
+    if (self->priv->preallocated_links_main) {
+        self->priv->preallocated_links_setup_pending = g_list_append (self->priv->preallocated_links_setup_pending, task);
+        return;
+    }
+
+    /* Store main to flag that we're initializing preallocated links */
+    self->priv->preallocated_links_main = g_object_ref (data);
+    initialize_preallocated_links (self,
+                                   link_prefix_hint,
+                                   (GAsyncReadyCallback) initialize_preallocated_links_ready,
+                                   task);
+}
+
+static gboolean
+check_multiplex_supported (MMPortQmi  *self,
+                           GError    **error)
+{
+    if (!self->priv->qmi_device) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Port is not open");
+        return FALSE;
+    }
+
+    if (!(self->priv->kernel_data_modes & (MM_PORT_QMI_KERNEL_DATA_MODE_MUX_RMNET | MM_PORT_QMI_KERNEL_DATA_MODE_MUX_QMIWWAN))) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Multiplex support not available in kernel");
+        return FALSE;
+    }
+
+    if (!MM_PORT_QMI_DAP_IS_SUPPORTED_QMAP (self->priv->dap)) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Aggregation not enabled");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+gboolean
+mm_port_qmi_preallocate_links_finish (MMPortQmi     *self,
+                                      GAsyncResult  *res,
+                                      GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
 void
-mm_port_qmi_setup_link (MMPortQmi           *self,
-                        MMPort              *data,
-                        const gchar         *link_prefix_hint,
-                        GAsyncReadyCallback  callback,
-                        gpointer             user_data)
+mm_port_qmi_preallocate_links (MMPortQmi           *self,
+                               MMPort              *data,
+                               const gchar         *link_prefix_hint,
+                               GAsyncReadyCallback  callback,
+                               gpointer             user_data)
 {
-    SetupLinkContext *ctx;
-    GTask            *task;
+    GTask  *task;
+    GError *error = NULL;
 
     task = g_task_new (self, NULL, callback, user_data);
+    g_task_set_source_tag (task, mm_port_qmi_preallocate_links);
 
-    if (!self->priv->qmi_device) {
-        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Port is not open");
+    if (!check_multiplex_supported (self, &error)) {
+        g_task_return_error (task, error);
         g_object_unref (task);
         return;
     }
 
-    if (!(self->priv->kernel_data_modes & (MM_PORT_QMI_KERNEL_DATA_MODE_MUX_RMNET | MM_PORT_QMI_KERNEL_DATA_MODE_MUX_QMIWWAN))) {
-        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Multiplex support not available in kernel");
+    if (!get_link_pool_size (self)) {
+        g_task_return_boolean (task, TRUE);
         g_object_unref (task);
         return;
     }
 
-    if (!MM_PORT_QMI_DAP_IS_SUPPORTED_QMAP (self->priv->dap)) {
-        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Aggregation not enabled");
+    request_preallocated_links (self, data, link_prefix_hint, task);
+}
+
+void
+mm_port_qmi_setup_link (MMPortQmi           *self,
+                        MMPort              *data,
+                        const gchar         *link_prefix_hint,
+                        GAsyncReadyCallback  callback,
+                        gpointer             user_data)
+{
+    SetupLinkContext *ctx;
+    GTask            *task;
+    GError           *error = NULL;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    if (!check_multiplex_supported (self, &error)) {
+        g_task_return_error (task, error);
         g_object_unref (task);
         return;
     }
@@ -710,55 +819,25 @@ mm_port_qmi_setup_link (MMPortQmi           *self,
     ctx->mux_id = QMI_DEVICE_MUX_ID_UNBOUND;
     g_task_set_task_data (task, ctx, (GDestroyNotify) setup_link_context_free);
 
+    /* For qmi_wwan, or when a link pool is requested, use preallocated links */
+    if (get_preallocated_links_amount (self) > 0) {
+        request_preallocated_links (self, data, link_prefix_hint, task);
+        return;
+    }
+
     /* When using rmnet, just try to add link in the QmiDevice */
     if (self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_RMNET) {
-        QmiDeviceAddLinkFlags flags = QMI_DEVICE_ADD_LINK_FLAGS_NONE;
-
-        /* This may not be fully right, but it's the only way forward we know
-         * right now for the Qualcomm SoCs based on QRTR+IPA, where QMAPV4 is
-         * used and the device has checksum offload enabled by default, so we
-         * should create the link with special flags. Ideally, we would have a
-         * way to know in advance whether the checksum offload flags are needed
-         * or not.
-         */
-        if (self->priv->dap == QMI_WDA_DATA_AGGREGATION_PROTOCOL_QMAPV4)
-            flags = (QMI_DEVICE_ADD_LINK_FLAGS_INGRESS_MAP_CKSUMV4 | QMI_DEVICE_ADD_LINK_FLAGS_EGRESS_MAP_CKSUMV4);
-
         qmi_device_add_link_with_flags (self->priv->qmi_device,
                                         QMI_DEVICE_MUX_ID_AUTOMATIC,
                                         mm_kernel_device_get_name (mm_port_peek_kernel_device (data)),
                                         link_prefix_hint,
-                                        flags,
+                                        get_rmnet_link_flags (self),
                                         NULL,
                                         (GAsyncReadyCallback) device_add_link_ready,
                                         task);
         return;
     }
 
-    /* For qmi_wwan, use preallocated links */
-    if (self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_QMIWWAN) {
-        if (self->priv->preallocated_links) {
-            setup_preallocated_link (task);
-            return;
-        }
-
-        /* We must make sure we don't run this procedure in parallel (e.g. if multiple
-         * connection attempts reach at the same time), so if we're told the preallocated
-         * links are already being initialized (main is set) but the array didn't exist,
-         * queue our task for completion once we're fully initialized */
-        if (self->priv->preallocated_links_main) {
-            self->priv->preallocated_links_setup_pending = g_list_append (self->priv->preallocated_links_setup_pending, task);
-            return;
-        }
-
-        /* Store main to flag that we're initializing preallocated links */
-        self->priv->preallocated_links_main = g_object_ref (data);
-        initialize_preallocated_links (self,
-                                       (GAsyncReadyCallback) initialize_preallocated_links_ready,
-                                       task);
-        return;
-    }
-
     g_assert_not_reached ();
 }
 
@@ -798,25 +877,20 @@ mm_port_qmi_cleanup_link (MMPortQmi           *self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
-    if (!self->priv->qmi_device) {
-        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Port is not open");
-        g_object_unref (task);
-        return;
-    }
-
-    if (!(self->priv->kernel_data_modes & (MM_PORT_QMI_KERNEL_DATA_MODE_MUX_RMNET | MM_PORT_QMI_KERNEL_DATA_MODE_MUX_QMIWWAN))) {
-        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Multiplex support not available in kernel");
+    if (!check_multiplex_supported (self, &error)) {
+        g_task_return_error (task, error);
         g_object_unref (task);
         return;
     }
 
-    if (!MM_PORT_QMI_DAP_IS_SUPPORTED_QMAP (self->priv->dap)) {
-        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE, "Aggregation not enabled");
+    /* Preallocated links are kept for the next connection */
+    if (self->priv->preallocated_links && mm_link_pool_release (self->priv->preallocated_links, link_name)) {
+        g_task_return_boolean (task, TRUE);
         g_object_unref (task);
         return;
     }
 
-    /* When using rmnet, just try to add link in the QmiDevice */
+    /* When using rmnet, links not in the pool are deleted from the QmiDevice */
     if (self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_RMNET) {
         qmi_device_delete_link (self->priv->qmi_device,
                                 link_name,
@@ -827,17 +901,9 @@ mm_port_qmi_cleanup_link (MMPortQmi           *self,
         return;
     }
 
-    /* For qmi_wwan, use preallocated links */
-    if (self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_QMIWWAN) {
-        if (!release_preallocated_link (self, link_name, mux_id, &error))
-            g_task_return_error (task, error);
-        else
-            g_task_return_boolean (task, TRUE);
-        g_object_unref (task);
-        return;
-    }
-
-    g_assert_not_reached ();
+    g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                             "No preallocated link found to release");
+    g_object_unref (task);
 }
 
 /*****************************************************************************/
@@ -2062,8 +2128,8 @@ count_links_setup (MMPortQmi *self,
         return links->len;
     }
 
-    if (self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_QMIWWAN)
-        return count_preallocated_links_setup (self);
+    if ((self->priv->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_MUX_QMIWWAN) && self->priv->preallocated_links)
+        return mm_link_pool_count_setup (self->priv->preallocated_links);
 
     return 0;
 }
@@ -2692,7 +2758,7 @@ mm_port_qmi_close (MMPortQmi           *self,
     /* Cleanup preallocated links, if any */
     if (self->priv->preallocated_links) {
         delete_preallocated_links (ctx->qmi_device, self->priv->preallocated_links);
-        g_clear_pointer (&self->priv->preallocated_links, g_array_unref);
+        g_clear_pointer (&self->priv->preallocated_links, mm_link_pool_free);
     }
     g_clear_object (&self->priv->preallocated_links_main);
 
@@ -2796,7 +2862,7 @@ dispose (GObject *object)
     /* Cleanup preallocated links, if any */
     if (self->priv->preallocated_links && self->priv->qmi_device)
         delete_preallocated_links (self->priv->qmi_device, self->priv->preallocated_links);
-    g_clear_pointer (&self->priv->preallocated_links, g_array_unref);
+    g_clear_pointer (&self->priv->preallocated_links, mm_link_pool_free);
     g_clear_object (&self->priv->preallocated_links_main);
 
     /* Clear node object */
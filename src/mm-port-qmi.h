@@ -154,6 +154,15 @@ gboolean mm_port_qmi_setup_data_format_finish (MMPortQmi                      *s
                                                GAsyncResult                   *res,
                                                GError                        **error);
 
+void     mm_port_qmi_preallocate_links        (MMPortQmi            *self,
+                                               MMPort               *data,
+                                               const gchar          *link_prefix_hint,
+                                               GAsyncReadyCallback   callback,
+                                               gpointer              user_data);
+gboolean mm_port_qmi_preallocate_links_finish (MMPortQmi            *self,
+                                               GAsyncResult         *res,
+                                               GError              **error);
+
 void   mm_port_qmi_setup_link        (MMPortQmi             *self,
                                       MMPort                *data,
                                       const gchar           *link_prefix_hint,
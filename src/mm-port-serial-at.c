@@ -14,13 +14,16 @@
  * Copyright (C) 2009 Red Hat, Inc.
  */
 
-#define _GNU_SOURCE  /* for strcasestr() */
+#define _GNU_SOURCE  /* for strcasestr() and memmem() */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 
+#include <ModemManager.h>
+#include <mm-errors-types.h>
+
 #include "mm-port-serial-at.h"
 #include "mm-log-object.h"
 
@@ -32,6 +35,7 @@ enum {
     PROP_INIT_SEQUENCE_ENABLED,
     PROP_INIT_SEQUENCE,
     PROP_SEND_LF,
+    PROP_COMMAND_CONCATENATION,
     LAST_PROP
 };
 
@@ -42,6 +46,9 @@ struct _MMPortSerialAtPrivate {
     GDestroyNotify response_parser_notify;
 
     GSList *unsolicited_msg_handlers;
+    /* Literal prefixes of the registered handlers, shared among handlers */
+    GHashTable *unsolicited_msg_prefixes;
+    guint       unsolicited_msg_generation;
 
     MMPortSerialAtFlag flags;
 
@@ -50,6 +57,7 @@ struct _MMPortSerialAtPrivate {
     guint init_sequence_enabled;
     gchar **init_sequence;
     gboolean send_lf;
+    gboolean command_concatenation;
 };
 
 /*****************************************************************************/
@@ -96,29 +104,38 @@ mm_port_serial_at_set_response_parser (MMPortSerialAt *self,
     self->priv->response_parser_notify = notify;
 }
 
-void
-mm_port_serial_at_remove_echo (GByteArray *response)
+/* Length of the echo or garbage found before the first <CR><LF> */
+static gsize
+echo_len (const guint8 *data,
+          gsize         len)
 {
-    guint i;
+    gsize i;
 
-    if (response->len <= 2)
-        return;
+    if (len <= 2)
+        return 0;
 
-    for (i = 0; i < (response->len - 1); i++) {
+    for (i = 0; i < (len - 1); i++) {
         /* If there is any content before the first
          * <CR><LF>, assume it's echo or garbage, and skip it */
-        if (response->data[i] == '\r' && response->data[i + 1] == '\n') {
-            if (i > 0)
-                g_byte_array_remove_range (response, 0, i);
-            /* else, good, we're already started with <CR><LF> */
-            break;
-        }
+        if (data[i] == '\r' && data[i + 1] == '\n')
+            return i;
     }
+    return 0;
+}
+
+void
+mm_port_serial_at_remove_echo (GByteArray *response)
+{
+    gsize len;
+
+    len = echo_len (response->data, response->len);
+    if (len > 0)
+        g_byte_array_remove_range (response, 0, len);
 }
 
 static MMPortSerialResponseType
 parse_response (MMPortSerial *port,
-                GByteArray *response,
+                MMPortSerialBuffer *response,
                 GByteArray **parsed_response,
                 GError **error)
 {
@@ -131,7 +148,7 @@ parse_response (MMPortSerial *port,
 
     /* Remove echo */
     if (self->priv->remove_echo)
-        mm_port_serial_at_remove_echo (response);
+        mm_port_serial_buffer_consume (response, echo_len (response->data, response->len));
 
     /* If there's no response to receive, we're done; e.g. if we only got
      * unsolicited messages */
@@ -142,19 +159,21 @@ parse_response (MMPortSerial *port,
     string = g_string_sized_new (response->len + 1);
     g_string_append_len (string, (const char *) response->data, response->len);
 
-    /* Fully cleanup the response array, we'll consider the contents we got
-     * as the full reply that the command may expect. */
-    g_byte_array_remove_range (response, 0, response->len);
-
     /* Parse it; returns FALSE if there is nothing we can do with this
      * response yet. */
     if (!self->priv->response_parser_fn (self->priv->response_parser_user_data, string, self, &inner_error)) {
-        /* Copy what we got back in the response buffer. */
-        g_byte_array_append (response, (const guint8 *) string->str, string->len);
+        /* The response buffer is left untouched, unless the parser modified
+         * the contents (e.g. removing leading garbage) */
+        if (string->len != response->len || memcmp (string->str, response->data, string->len) != 0)
+            mm_port_serial_buffer_replace (response, (const guint8 *) string->str, string->len);
         g_string_free (string, TRUE);
         return MM_PORT_SERIAL_RESPONSE_NONE;
     }
 
+    /* Fully cleanup the response buffer, we'll consider the contents we got
+     * as the full reply that the command may expect. */
+    mm_port_serial_buffer_consume (response, response->len);
+
     /* If we got an error, propagate it without any further response string */
     if (inner_error) {
         g_string_free (string, TRUE);
@@ -170,14 +189,184 @@ parse_response (MMPortSerial *port,
 
 /*****************************************************************************/
 
+/* Literal text that any match of a given unsolicited message handler regex
+ * must include, e.g. "+CREG: ". If the text isn't found in the received data,
+ * the regex is not even tried. */
+typedef struct {
+    gchar    *str;
+    gsize     len;
+    guint     refcount;
+    /* Lookup result, only valid for the given parse generation */
+    guint     generation;
+    gboolean  present;
+} UnsolicitedMsgPrefix;
+
 typedef struct {
     GRegex *regex;
     MMPortSerialAtUnsolicitedMsgFn callback;
     gboolean enable;
     gpointer user_data;
     GDestroyNotify notify;
+    UnsolicitedMsgPrefix *prefix;
+    /* Statistics */
+    guint64 attempts;
+    guint64 matches;
+    guint64 skipped;
 } MMAtUnsolicitedMsgHandler;
 
+#define UNSOLICITED_MSG_PREFIX_MIN_LEN 2
+
+static gboolean
+regex_has_toplevel_alternation (const gchar *pattern)
+{
+    const gchar *p;
+    gint         depth = 0;
+    gboolean     in_class = FALSE;
+
+    for (p = pattern; *p; p++) {
+        if (*p == '\\') {
+            if (!*(++p))
+                break;
+            continue;
+        }
+        if (in_class) {
+            if (*p == ']')
+                in_class = FALSE;
+            continue;
+        }
+        if (*p == '[')
+            in_class = TRUE;
+        else if (*p == '(')
+            depth++;
+        else if (*p == ')')
+            depth--;
+        else if (*p == '|' && depth <= 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* Skips leading "\r", "\n" and groups including only those, e.g. "(?:\r\n)?" */
+static const gchar *
+regex_skip_leading_line_breaks (const gchar *p)
+{
+    while (*p) {
+        if (p[0] == '\\' && (p[1] == 'r' || p[1] == 'n')) {
+            p += 2;
+        } else if (g_str_has_prefix (p, "(?:")) {
+            const gchar *q = p + 3;
+
+            while (q[0] == '\\' && (q[1] == 'r' || q[1] == 'n'))
+                q += 2;
+            if (*q != ')' || q == p + 3)
+                break;
+            p = q + 1;
+        } else if (*p == '?' || *p == '*' || *p == '+') {
+            p++;
+        } else
+            break;
+    }
+    return p;
+}
+
+gchar *
+mm_port_serial_at_get_regex_literal_prefix (GRegex *regex)
+{
+    const gchar *p;
+    GString     *prefix;
+
+    /* Only for plain case-sensitive patterns */
+    if (g_regex_get_compile_flags (regex) & (G_REGEX_CASELESS | G_REGEX_EXTENDED))
+        return NULL;
+
+    p = g_regex_get_pattern (regex);
+    if (regex_has_toplevel_alternation (p))
+        return NULL;
+
+    prefix = g_string_new (NULL);
+    p = regex_skip_leading_line_breaks (p);
+    while (*p) {
+        gchar c;
+
+        if (*p == '\\') {
+            /* Escaped alphanumerics are character classes or special chars */
+            if (!p[1] || g_ascii_isalnum (p[1]))
+                break;
+            c = p[1];
+            p += 2;
+        } else if (strchr (".[]()|?*+{}^$", *p))
+            break;
+        else
+            c = *p++;
+
+        /* Characters with a quantifier may not be required */
+        if (*p == '?' || *p == '*' || *p == '{')
+            break;
+        g_string_append_c (prefix, c);
+        if (*p == '+')
+            break;
+    }
+
+    if (prefix->len < UNSOLICITED_MSG_PREFIX_MIN_LEN) {
+        g_string_free (prefix, TRUE);
+        return NULL;
+    }
+    return g_string_free (prefix, FALSE);
+}
+
+static UnsolicitedMsgPrefix *
+unsolicited_msg_prefix_acquire (MMPortSerialAt *self,
+                                GRegex         *regex)
+{
+    UnsolicitedMsgPrefix *prefix;
+    gchar                *str;
+
+    str = mm_port_serial_at_get_regex_literal_prefix (regex);
+    if (!str)
+        return NULL;
+
+    prefix = g_hash_table_lookup (self->priv->unsolicited_msg_prefixes, str);
+    if (prefix) {
+        g_free (str);
+        prefix->refcount++;
+        return prefix;
+    }
+
+    prefix = g_slice_new0 (UnsolicitedMsgPrefix);
+    prefix->str = str;
+    prefix->len = strlen (str);
+    prefix->refcount = 1;
+    g_hash_table_insert (self->priv->unsolicited_msg_prefixes, prefix->str, prefix);
+    return prefix;
+}
+
+static void
+unsolicited_msg_prefix_release (MMPortSerialAt       *self,
+                                UnsolicitedMsgPrefix *prefix)
+{
+    if (!prefix || --prefix->refcount > 0)
+        return;
+
+    g_hash_table_remove (self->priv->unsolicited_msg_prefixes, prefix->str);
+    g_free (prefix->str);
+    g_slice_free (UnsolicitedMsgPrefix, prefix);
+}
+
+static gboolean
+unsolicited_msg_prefix_present (MMPortSerialAt       *self,
+                                UnsolicitedMsgPrefix *prefix,
+                                GByteArray           *response)
+{
+    /* Each prefix is looked for only once per chunk of data, even if shared
+     * by several handlers. Removing matches from the response will never make
+     * an absent prefix appear, so this result is safe to reuse. */
+    if (prefix->generation != self->priv->unsolicited_msg_generation) {
+        prefix->generation = self->priv->unsolicited_msg_generation;
+        prefix->present = !!memmem (response->data, response->len, prefix->str, prefix->len);
+    }
+    return prefix->present;
+}
+
 static gint
 unsolicited_msg_handler_cmp (MMAtUnsolicitedMsgHandler *handler,
                              GRegex *regex)
@@ -211,8 +400,9 @@ mm_port_serial_at_add_unsolicited_msg_handler (MMPortSerialAt *self,
         /* The new handler is always PREPENDED, so that e.g. plugins can provide
          * more specific matches for URCs that are also handled by the generic
          * plugin. */
-        handler = g_slice_new (MMAtUnsolicitedMsgHandler);
+        handler = g_slice_new0 (MMAtUnsolicitedMsgHandler);
         handler->regex = g_regex_ref (regex);
+        handler->prefix = unsolicited_msg_prefix_acquire (self, regex);
         self->priv->unsolicited_msg_handlers = g_slist_prepend (self->priv->unsolicited_msg_handlers, handler);
     }
 
@@ -242,6 +432,46 @@ mm_port_serial_at_enable_unsolicited_msg_handler (MMPortSerialAt *self,
     }
 }
 
+GArray *
+mm_port_serial_at_get_unsolicited_msg_stats (MMPortSerialAt *self)
+{
+    GArray *stats;
+    GSList *iter;
+
+    g_return_val_if_fail (MM_IS_PORT_SERIAL_AT (self), NULL);
+
+    stats = g_array_new (FALSE, FALSE, sizeof (MMPortSerialAtUnsolicitedMsgStats));
+    for (iter = self->priv->unsolicited_msg_handlers; iter; iter = g_slist_next (iter)) {
+        MMAtUnsolicitedMsgHandler         *handler = (MMAtUnsolicitedMsgHandler *) iter->data;
+        MMPortSerialAtUnsolicitedMsgStats  item;
+
+        item.pattern = g_regex_get_pattern (handler->regex);
+        item.prefix = handler->prefix ? handler->prefix->str : NULL;
+        item.attempts = handler->attempts;
+        item.matches = handler->matches;
+        item.skipped = handler->skipped;
+        g_array_append_val (stats, item);
+    }
+    return stats;
+}
+
+static void
+log_unsolicited_msg_stats (MMPortSerialAt *self)
+{
+    GSList *iter;
+
+    for (iter = self->priv->unsolicited_msg_handlers; iter; iter = g_slist_next (iter)) {
+        MMAtUnsolicitedMsgHandler *handler = (MMAtUnsolicitedMsgHandler *) iter->data;
+
+        if (!handler->attempts && !handler->skipped)
+            continue;
+        mm_obj_dbg (self, "unsolicited message handler '%s': %" G_GUINT64_FORMAT " matches, %"
+                    G_GUINT64_FORMAT " attempts, %" G_GUINT64_FORMAT " skipped",
+                    g_regex_get_pattern (handler->regex),
+                    handler->matches, handler->attempts, handler->skipped);
+    }
+}
+
 static gboolean
 remove_eval_cb (const GMatchInfo *match_info,
                 GString *result,
@@ -258,14 +488,17 @@ remove_eval_cb (const GMatchInfo *match_info,
 }
 
 static void
-parse_unsolicited (MMPortSerial *port, GByteArray *response)
+parse_unsolicited (MMPortSerial *port, MMPortSerialBuffer *response)
 {
     MMPortSerialAt *self = MM_PORT_SERIAL_AT (port);
     GSList *iter;
 
     /* Remove echo */
     if (self->priv->remove_echo)
-        mm_port_serial_at_remove_echo (response);
+        mm_port_serial_buffer_consume (response, echo_len (response->data, response->len));
+
+    /* New lookup of handler prefixes */
+    self->priv->unsolicited_msg_generation++;
 
     for (iter = self->priv->unsolicited_msg_handlers; iter; iter = iter->next) {
         MMAtUnsolicitedMsgHandler *handler = (MMAtUnsolicitedMsgHandler *) iter->data;
@@ -275,6 +508,12 @@ parse_unsolicited (MMPortSerial *port, GByteArray *response)
         if (!handler->enable)
             continue;
 
+        if (handler->prefix && !unsolicited_msg_prefix_present (self, handler->prefix, response)) {
+            handler->skipped++;
+            continue;
+        }
+
+        handler->attempts++;
         matches = g_regex_match_full (handler->regex,
                                       (const char *) response->data,
                                       response->len,
@@ -291,14 +530,14 @@ parse_unsolicited (MMPortSerial *port, GByteArray *response)
             g_autofree gchar *str = NULL;
             gint              result_len = response->len;
 
+            handler->matches++;
             str = g_regex_replace_eval (handler->regex,
                                         (const char *) response->data,
                                         response->len,
                                         0, 0,
                                         remove_eval_cb, &result_len, NULL);
 
-            g_byte_array_remove_range (response, 0, response->len);
-            g_byte_array_append (response, (const guint8 *) str, result_len);
+            mm_port_serial_buffer_replace (response, (const guint8 *) str, result_len);
         }
     }
 }
@@ -400,6 +639,28 @@ mm_port_serial_at_command (MMPortSerialAt *self,
                            GCancellable *cancellable,
                            GAsyncReadyCallback callback,
                            gpointer user_data)
+{
+    mm_port_serial_at_command_full (self,
+                                    command,
+                                    timeout_seconds,
+                                    is_raw,
+                                    allow_cached,
+                                    MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE,
+                                    cancellable,
+                                    callback,
+                                    user_data);
+}
+
+void
+mm_port_serial_at_command_full (MMPortSerialAt *self,
+                                const char *command,
+                                guint32 timeout_seconds,
+                                gboolean is_raw,
+                                gboolean allow_cached,
+                                MMPortSerialCommandPriority priority,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
 {
     GSimpleAsyncResult *simple;
     GByteArray *buf;
@@ -425,6 +686,7 @@ mm_port_serial_at_command (MMPortSerialAt *self,
                             timeout_seconds,
                             allow_cached,
                             is_raw, /* raw commands always run next, never queued last */
+                            priority,
                             cancellable,
                             (GAsyncReadyCallback)serial_command_ready,
                             simple);
@@ -514,6 +776,222 @@ mm_port_serial_at_run_init_sequence (MMPortSerialAt *self)
     }
 }
 
+/*****************************************************************************/
+/* Send chunk size calibration
+ *
+ * Ports that need a send delay get commands written in chunks separated by
+ * that delay. The chunk size is one byte by default, and calibrated when the
+ * port is first opened by sending increasingly long command lines and
+ * checking the reply. The probe lines alternate "S3?" and "S4?" queries, and
+ * the reply must have one value per query, alternating between two different
+ * ones (the CR and LF characters). A lost byte either makes the line invalid,
+ * or turns a query into one returning a different value ("S?" reads the last
+ * register referenced) or into no value at all ("S3" just selects it). */
+
+#define SEND_CHUNK_SIZE_MAX                64
+#define SEND_CHUNK_SIZE_PROBE_TIMEOUT_SECS 3
+
+/* Calibrated chunk sizes, keyed by VID/PID */
+static GHashTable *send_chunk_size_cache;
+
+static guint
+send_chunk_size_cache_key (guint16 vid,
+                           guint16 pid)
+{
+    return ((guint) vid << 16) | pid;
+}
+
+guint
+mm_port_serial_at_lookup_send_chunk_size (guint16 vid,
+                                          guint16 pid)
+{
+    if (!send_chunk_size_cache || (!vid && !pid))
+        return 0;
+
+    return GPOINTER_TO_UINT (g_hash_table_lookup (send_chunk_size_cache,
+                                                  GUINT_TO_POINTER (send_chunk_size_cache_key (vid, pid))));
+}
+
+typedef struct {
+    MMPortSerialAt *self;
+    guint           key;
+    guint           chunk_size;
+    guint           probe_chunk_size;
+    guint           probe_n_queries;
+} CalibrationContext;
+
+static gboolean
+calibration_check_reply (const gchar  *response,
+                         guint         n_queries,
+                         GError      **error)
+{
+    g_auto(GStrv)  lines = NULL;
+    const gchar   *values[2] = { NULL, NULL };
+    guint          n_values = 0;
+    guint          i;
+
+    lines = g_strsplit_set (response, "\r\n", -1);
+    for (i = 0; lines[i]; i++) {
+        const gchar *value;
+
+        value = g_strstrip (lines[i]);
+        if (!value[0])
+            continue;
+
+        if (!values[n_values % 2])
+            values[n_values % 2] = value;
+        else if (!g_str_equal (values[n_values % 2], value)) {
+            g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                         "unexpected S-register value at query %u: %s", n_values + 1, value);
+            return FALSE;
+        }
+        n_values++;
+    }
+
+    if (n_values != n_queries) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "got %u S-register values for %u queries", n_values, n_queries);
+        return FALSE;
+    }
+
+    if (g_str_equal (values[0], values[1])) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "S3 and S4 registers have the same value: %s", values[0]);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void calibration_step (CalibrationContext *ctx);
+
+static void
+calibration_context_complete_and_free (CalibrationContext *ctx)
+{
+    g_object_set (ctx->self, MM_PORT_SERIAL_SEND_CHUNK_SIZE, ctx->chunk_size, NULL);
+
+    if (G_UNLIKELY (!send_chunk_size_cache))
+        send_chunk_size_cache = g_hash_table_new (g_direct_hash, g_direct_equal);
+    g_hash_table_insert (send_chunk_size_cache,
+                         GUINT_TO_POINTER (ctx->key),
+                         GUINT_TO_POINTER (ctx->chunk_size));
+
+    mm_obj_dbg (ctx->self, "send chunk size calibrated to %u bytes", ctx->chunk_size);
+
+    g_object_unref (ctx->self);
+    g_slice_free (CalibrationContext, ctx);
+}
+
+static void
+calibration_step_ready (MMPortSerialAt     *self,
+                        GAsyncResult       *res,
+                        CalibrationContext *ctx)
+{
+    g_autoptr(GError)  error = NULL;
+    const gchar       *response;
+
+    response = mm_port_serial_at_command_finish (self, res, &error);
+    if (response)
+        calibration_check_reply (response, ctx->probe_n_queries, &error);
+
+    /* Port closed while calibrating; nothing learnt about the device */
+    if (!mm_port_serial_is_open (MM_PORT_SERIAL (self))) {
+        g_object_set (self, MM_PORT_SERIAL_SEND_CHUNK_SIZE, ctx->chunk_size, NULL);
+        g_object_unref (ctx->self);
+        g_slice_free (CalibrationContext, ctx);
+        return;
+    }
+
+    if (error) {
+        /* Keep the last chunk size that worked. Note that the completion
+         * happens before the next queued command is processed, so no other
+         * command is sent with the rejected chunk size. */
+        mm_obj_dbg (self, "send chunk size %u not supported: %s", ctx->probe_chunk_size, error->message);
+        calibration_context_complete_and_free (ctx);
+        return;
+    }
+
+    ctx->chunk_size = ctx->probe_chunk_size;
+    if (ctx->chunk_size >= SEND_CHUNK_SIZE_MAX) {
+        calibration_context_complete_and_free (ctx);
+        return;
+    }
+
+    calibration_step (ctx);
+}
+
+static void
+calibration_step (CalibrationContext *ctx)
+{
+    g_autoptr(GString) command = NULL;
+
+    ctx->probe_chunk_size = ctx->chunk_size * 2;
+
+    /* Make sure the probe spans at least two chunks */
+    command = g_string_new (NULL);
+    ctx->probe_n_queries = 0;
+    while (command->len < 2 * ctx->probe_chunk_size) {
+        g_string_append (command, "S3?S4?");
+        ctx->probe_n_queries += 2;
+    }
+
+    g_object_set (ctx->self, MM_PORT_SERIAL_SEND_CHUNK_SIZE, ctx->probe_chunk_size, NULL);
+
+    /* Critical, so that it goes before any other command waiting in the queue */
+    mm_port_serial_at_command_full (ctx->self,
+                                    command->str,
+                                    SEND_CHUNK_SIZE_PROBE_TIMEOUT_SECS,
+                                    FALSE,
+                                    FALSE,
+                                    MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL,
+                                    NULL,
+                                    (GAsyncReadyCallback) calibration_step_ready,
+                                    ctx);
+}
+
+static void
+calibrate_send_chunk_size (MMPortSerialAt *self)
+{
+    MMKernelDevice     *kernel_device;
+    CalibrationContext *ctx;
+    guint64             send_delay = 0;
+    guint16             vid;
+    guint16             pid;
+    guint               chunk_size;
+
+    if (mm_port_get_subsys (MM_PORT (self)) != MM_PORT_SUBSYS_TTY)
+        return;
+
+    g_object_get (self, MM_PORT_SERIAL_SEND_DELAY, &send_delay, NULL);
+    if (!send_delay)
+        return;
+
+    /* Results are stored per device model */
+    kernel_device = mm_port_peek_kernel_device (MM_PORT (self));
+    if (!kernel_device)
+        return;
+    vid = mm_kernel_device_get_physdev_vid (kernel_device);
+    pid = mm_kernel_device_get_physdev_pid (kernel_device);
+    if (!vid && !pid)
+        return;
+
+    chunk_size = mm_port_serial_at_lookup_send_chunk_size (vid, pid);
+    if (chunk_size) {
+        mm_obj_dbg (self, "using cached send chunk size: %u bytes", chunk_size);
+        g_object_set (self, MM_PORT_SERIAL_SEND_CHUNK_SIZE, chunk_size, NULL);
+        return;
+    }
+
+    mm_obj_dbg (self, "calibrating send chunk size...");
+    ctx = g_slice_new0 (CalibrationContext);
+    ctx->self = g_object_ref (self);
+    ctx->key = send_chunk_size_cache_key (vid, pid);
+    ctx->chunk_size = 1;
+    calibration_step (ctx);
+}
+
+/*****************************************************************************/
+
 static void
 config (MMPortSerial *_self)
 {
@@ -521,6 +999,8 @@ config (MMPortSerial *_self)
 
     if (self->priv->init_sequence_enabled)
         mm_port_serial_at_run_init_sequence (self);
+
+    calibrate_send_chunk_size (self);
 }
 
 /*****************************************************************************/
@@ -548,6 +1028,8 @@ mm_port_serial_at_init (MMPortSerialAt *self)
 
     /* By default, don't send line feed */
     self->priv->send_lf = FALSE;
+
+    self->priv->unsolicited_msg_prefixes = g_hash_table_new (g_str_hash, g_str_equal);
 }
 
 static void
@@ -572,6 +1054,9 @@ set_property (GObject *object,
     case PROP_SEND_LF:
         self->priv->send_lf = g_value_get_boolean (value);
         break;
+    case PROP_COMMAND_CONCATENATION:
+        self->priv->command_concatenation = g_value_get_boolean (value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -599,6 +1084,9 @@ get_property (GObject *object,
     case PROP_SEND_LF:
         g_value_set_boolean (value, self->priv->send_lf);
         break;
+    case PROP_COMMAND_CONCATENATION:
+        g_value_set_boolean (value, self->priv->command_concatenation);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -610,12 +1098,15 @@ finalize (GObject *object)
 {
     MMPortSerialAt *self = MM_PORT_SERIAL_AT (object);
 
+    log_unsolicited_msg_stats (self);
+
     while (self->priv->unsolicited_msg_handlers) {
         MMAtUnsolicitedMsgHandler *handler = (MMAtUnsolicitedMsgHandler *) self->priv->unsolicited_msg_handlers->data;
 
         if (handler->notify)
             handler->notify (handler->user_data);
 
+        unsolicited_msg_prefix_release (self, handler->prefix);
         g_regex_unref (handler->regex);
         g_slice_free (MMAtUnsolicitedMsgHandler, handler);
         self->priv->unsolicited_msg_handlers = g_slist_delete_link (self->priv->unsolicited_msg_handlers,
@@ -626,6 +1117,7 @@ finalize (GObject *object)
         self->priv->response_parser_notify (self->priv->response_parser_user_data);
 
     g_strfreev (self->priv->init_sequence);
+    g_hash_table_unref (self->priv->unsolicited_msg_prefixes);
 
     G_OBJECT_CLASS (mm_port_serial_at_parent_class)->finalize (object);
 }
@@ -646,6 +1138,8 @@ mm_port_serial_at_class_init (MMPortSerialAtClass *klass)
     serial_class->parse_unsolicited = parse_unsolicited;
     serial_class->parse_response = parse_response;
     serial_class->debug_log = debug_log;
+    /* Any character received while a command runs aborts it (V.250) */
+    serial_class->abort_sequence = "\r";
     serial_class->config = config;
 
     g_object_class_install_property
@@ -679,4 +1173,12 @@ mm_port_serial_at_class_init (MMPortSerialAtClass *klass)
                                "Send line-feed at the end of each AT command sent",
                                FALSE,
                                G_PARAM_READWRITE));
+
+    g_object_class_install_property
+        (object_class, PROP_COMMAND_CONCATENATION,
+         g_param_spec_boolean (MM_PORT_SERIAL_AT_COMMAND_CONCATENATION,
+                               "Command concatenation",
+                               "Whether multiple extended syntax commands can be concatenated in the same command line",
+                               FALSE,
+                               G_PARAM_READWRITE));
 }
@@ -69,6 +69,7 @@ typedef void (*MMPortSerialAtUnsolicitedMsgFn) (MMPortSerialAt *port,
 #define MM_PORT_SERIAL_AT_INIT_SEQUENCE_ENABLED "init-sequence-enabled"
 #define MM_PORT_SERIAL_AT_INIT_SEQUENCE         "init-sequence"
 #define MM_PORT_SERIAL_AT_SEND_LF               "send-lf"
+#define MM_PORT_SERIAL_AT_COMMAND_CONCATENATION "command-concatenation"
 
 struct _MMPortSerialAt {
     MMPortSerial parent;
@@ -95,6 +96,19 @@ void     mm_port_serial_at_enable_unsolicited_msg_handler (MMPortSerialAt *self,
                                                            GRegex *regex,
                                                            gboolean enable);
 
+/* Per-handler statistics, to find out which unsolicited messages are more
+ * expensive to process. The strings are owned by the port and are only valid
+ * while the handlers are registered. */
+typedef struct {
+    const gchar *pattern;
+    const gchar *prefix;
+    guint64      attempts;
+    guint64      matches;
+    guint64      skipped;
+} MMPortSerialAtUnsolicitedMsgStats;
+
+GArray  *mm_port_serial_at_get_unsolicited_msg_stats (MMPortSerialAt *self);
+
 void     mm_port_serial_at_set_response_parser (MMPortSerialAt *self,
                                                 MMPortSerialAtResponseParserFn fn,
                                                 gpointer user_data,
@@ -108,6 +122,16 @@ void         mm_port_serial_at_command        (MMPortSerialAt *self,
                                                GCancellable *cancellable,
                                                GAsyncReadyCallback callback,
                                                gpointer user_data);
+/* Same as mm_port_serial_at_command(), with an explicit scheduling class */
+void         mm_port_serial_at_command_full   (MMPortSerialAt *self,
+                                               const char *command,
+                                               guint32 timeout_seconds,
+                                               gboolean is_raw,
+                                               gboolean allow_cached,
+                                               MMPortSerialCommandPriority priority,
+                                               GCancellable *cancellable,
+                                               GAsyncReadyCallback callback,
+                                               gpointer user_data);
 const gchar *mm_port_serial_at_command_finish (MMPortSerialAt *self,
                                                GAsyncResult *res,
                                                GError **error);
@@ -120,6 +144,7 @@ gchar   *mm_port_serial_at_quote_string (const char *string);
 
 /* Just for unit tests */
 void     mm_port_serial_at_remove_echo (GByteArray *response);
+gchar   *mm_port_serial_at_get_regex_literal_prefix (GRegex *regex);
 
 void     mm_port_serial_at_set_flags (MMPortSerialAt *self,
                                       MMPortSerialAtFlag flags);
@@ -129,4 +154,9 @@ MMPortSerialAtFlag mm_port_serial_at_get_flags (MMPortSerialAt *self);
 /* Tell the port to run its init sequence, if any, right away */
 void mm_port_serial_at_run_init_sequence (MMPortSerialAt *self);
 
+/* Send chunk size calibrated for a given device model in a previous port
+ * opening, or 0 if unknown */
+guint mm_port_serial_at_lookup_send_chunk_size (guint16 vid,
+                                                guint16 pid);
+
 #endif /* MM_PORT_SERIAL_AT_H */
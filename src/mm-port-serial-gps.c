@@ -13,6 +13,8 @@
  * Copyright (C) 2012 Aleksander Morgado <aleksander@gnu.org>
  */
 
+#define _GNU_SOURCE  /* for memmem() and memrchr() */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -29,8 +31,11 @@ struct _MMPortSerialGpsPrivate {
     gpointer user_data;
     GDestroyNotify notify;
 
-    /* Regex for all known traces */
-    GRegex *known_traces_regex;
+    /* Sentences not to be reported to the trace handler */
+    gchar **ignored_sentences;
+
+    /* Reused to report each trace as a NUL-terminated string */
+    GString *trace;
 };
 
 /*****************************************************************************/
@@ -53,81 +58,148 @@ mm_port_serial_gps_add_trace_handler (MMPortSerialGps *self,
 
 /*****************************************************************************/
 
-static gboolean
-remove_eval_cb (const GMatchInfo *match_info,
-                GString *result,
-                gpointer user_data)
+void
+mm_port_serial_gps_set_ignored_sentences (MMPortSerialGps     *self,
+                                          const gchar * const *sentences)
 {
-    int *result_len = (int *) user_data;
-    int start;
-    int end;
+    g_return_if_fail (MM_IS_PORT_SERIAL_GPS (self));
 
-    if (g_match_info_fetch_pos  (match_info, 0, &start, &end))
-        *result_len -= (end - start);
+    g_strfreev (self->priv->ignored_sentences);
+    self->priv->ignored_sentences = g_strdupv ((gchar **) sentences);
+}
+
+/*****************************************************************************/
 
+/* Sentences are given as "$<address>,...", where the address is built with
+ * the talker id (e.g. GP, GL, GA, GN) and the sentence type (e.g. GSV).
+ * Ignored sentences may be given either as full address or just as type, in
+ * which case they apply to all talkers. */
+static gboolean
+sentence_ignored (MMPortSerialGps *self,
+                  const guint8    *sentence,
+                  gsize            len)
+{
+    const guint8 *comma;
+    gsize         address_len;
+    guint         i;
+
+    if (!self->priv->ignored_sentences)
+        return FALSE;
+
+    comma = memchr (sentence, ',', len);
+    if (!comma)
+        return FALSE;
+    address_len = comma - sentence - 1;
+
+    for (i = 0; self->priv->ignored_sentences[i]; i++) {
+        const gchar *ignored = self->priv->ignored_sentences[i];
+        gsize        ignored_len;
+
+        ignored_len = strlen (ignored);
+        if (ignored_len == address_len && !memcmp (&sentence[1], ignored, ignored_len))
+            return TRUE;
+        if (ignored_len == 3 && address_len == 5 && !memcmp (&sentence[3], ignored, ignored_len))
+            return TRUE;
+    }
     return FALSE;
 }
 
+static gint
+hex_value (guint8 c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+/* The checksum is the XOR of all characters between '$' and '*'. Sentences
+ * without checksum are accepted. */
+static gboolean
+sentence_checksum_valid (const guint8 *sentence,
+                         gsize         len)
+{
+    guint8 checksum = 0;
+    gint   high;
+    gint   low;
+    gsize  i;
+
+    if (len < 4 || sentence[len - 3] != '*')
+        return TRUE;
+
+    high = hex_value (sentence[len - 2]);
+    low = hex_value (sentence[len - 1]);
+    if (high < 0 || low < 0)
+        return FALSE;
+
+    for (i = 1; i < len - 3; i++)
+        checksum ^= sentence[i];
+
+    return (checksum == ((high << 4) | low));
+}
+
 static MMPortSerialResponseType
 parse_response (MMPortSerial *port,
-                GByteArray *response,
+                MMPortSerialBuffer *response,
                 GByteArray **parsed_response,
                 GError **error)
 {
-    MMPortSerialGps       *self = MM_PORT_SERIAL_GPS (port);
-    g_autoptr(GMatchInfo)  match_info = NULL;
-    gboolean               matches;
-    gchar                 *str;
-    gint                   result_len;
-    guint                  i;
-
-    for (i = 0; i < response->len; i++) {
+    MMPortSerialGps *self = MM_PORT_SERIAL_GPS (port);
+    gboolean         found = FALSE;
+
+    /* All traces start with the dollar sign and end with <CR><LF>; they are
+     * framed in place and removed from the buffer one by one. */
+    while (response->len > 0) {
+        const guint8 *start;
+        const guint8 *end;
+        const guint8 *last_start;
+        gsize         len;
+
         /* If there is any content before the first $,
          * assume it's garbage, and skip it */
-        if (response->data[i] == '$') {
-            if (i > 0)
-                g_byte_array_remove_range (response, 0, i);
-            /* else, good, we're already started with $ */
+        start = memchr (response->data, '$', response->len);
+        if (!start) {
+            mm_port_serial_buffer_consume (response, response->len);
             break;
         }
-    }
+        if (start != response->data)
+            mm_port_serial_buffer_consume (response, start - response->data);
 
-    matches = g_regex_match_full (self->priv->known_traces_regex,
-                                  (const gchar *) response->data,
-                                  response->len,
-                                  0, 0, &match_info, NULL);
-
-    if (self->priv->callback) {
-        while (g_match_info_matches (match_info)) {
-            gchar *trace;
-
-            trace = g_match_info_fetch (match_info, 0);
-            if (trace) {
-                self->priv->callback (self, trace, self->priv->user_data);
-                g_free (trace);
-            }
-            g_match_info_next (match_info, NULL);
-        }
-    }
+        end = memmem (response->data, response->len, "\r\n", 2);
+        if (!end)
+            break;
 
-    if (!matches)
-        return MM_PORT_SERIAL_RESPONSE_NONE;
+        /* If the trace was truncated and a new one started before the line
+         * end, skip the truncated one */
+        last_start = memrchr (response->data, '$', end - response->data);
+        if (last_start != response->data) {
+            mm_port_serial_buffer_consume (response, last_start - response->data);
+            continue;
+        }
 
-    /* Remove matches */
-    result_len = response->len;
-    str = g_regex_replace_eval (self->priv->known_traces_regex,
-                                (const char *) response->data,
-                                response->len,
-                                0, 0,
-                                remove_eval_cb, &result_len, NULL);
+        len = end - response->data;
+        found = TRUE;
+        if (!sentence_checksum_valid (response->data, len))
+            mm_obj_dbg (self, "ignoring trace with invalid checksum");
+        else if (self->priv->callback && !sentence_ignored (self, response->data, len)) {
+            /* The trace reported includes the trailing <CR><LF> */
+            g_string_truncate (self->priv->trace, 0);
+            g_string_append_len (self->priv->trace, (const gchar *) response->data, len + 2);
+            self->priv->callback (self, self->priv->trace->str, self->priv->user_data);
+        }
 
-    /* Cleanup response buffer */
-    g_byte_array_remove_range (response, 0, response->len);
+        mm_port_serial_buffer_consume (response, len + 2);
+    }
 
-    /* Build parsed response */
-    *parsed_response = g_byte_array_new_take ((guint8 *)str, result_len);
+    if (!found)
+        return MM_PORT_SERIAL_RESPONSE_NONE;
 
-    return TRUE;
+    /* Build parsed response; all the data has already been processed */
+    *parsed_response = g_byte_array_new ();
+    return MM_PORT_SERIAL_RESPONSE_BUFFER;
 }
 
 /*****************************************************************************/
@@ -185,12 +257,7 @@ mm_port_serial_gps_init (MMPortSerialGps *self)
                                               MM_TYPE_PORT_SERIAL_GPS,
                                               MMPortSerialGpsPrivate);
 
-    /* We'll assume that all traces start with the dollar sign and end with \r\n */
-    self->priv->known_traces_regex =
-        g_regex_new ("\\$.*\\r\\n",
-                     G_REGEX_RAW | G_REGEX_OPTIMIZE,
-                     0,
-                     NULL);
+    self->priv->trace = g_string_sized_new (100);
 }
 
 static void
@@ -201,7 +268,8 @@ finalize (GObject *object)
     if (self->priv->notify)
         self->priv->notify (self->priv->user_data);
 
-    g_regex_unref (self->priv->known_traces_regex);
+    g_strfreev (self->priv->ignored_sentences);
+    g_string_free (self->priv->trace, TRUE);
 
     G_OBJECT_CLASS (mm_port_serial_gps_parent_class)->finalize (object);
 }
@@ -55,4 +55,9 @@ void mm_port_serial_gps_add_trace_handler (MMPortSerialGps *self,
                                            gpointer user_data,
                                            GDestroyNotify notify);
 
+/* Sentences given either by type (e.g. "GSV") or by talker and type
+ * (e.g. "GLGSV") that should not be reported to the trace handler */
+void mm_port_serial_gps_set_ignored_sentences (MMPortSerialGps     *self,
+                                               const gchar * const *sentences);
+
 #endif /* MM_PORT_SERIAL_GPS_H */
@@ -38,7 +38,7 @@ struct _MMPortSerialQcdmPrivate {
 /*****************************************************************************/
 
 static gboolean
-find_qcdm_start (GByteArray *response, gsize *start)
+find_qcdm_start (MMPortSerialBuffer *response, gsize *start)
 {
     guint i;
     gint  last = -1;
@@ -71,7 +71,7 @@ find_qcdm_start (GByteArray *response, gsize *start)
 }
 
 static MMPortSerialResponseType
-parse_qcdm (GByteArray *response,
+parse_qcdm (MMPortSerialBuffer *response,
             gboolean want_log,
             GByteArray **parsed_response,
             GError **error)
@@ -91,7 +91,7 @@ parse_qcdm (GByteArray *response,
     }
 
     /* If there is anything before the start marker, remove it */
-    g_byte_array_remove_range (response, 0, start);
+    mm_port_serial_buffer_consume (response, start);
     if (response->len == 0)
         return MM_PORT_SERIAL_RESPONSE_NONE;
 
@@ -139,13 +139,13 @@ parse_qcdm (GByteArray *response,
     /* Remove the data we used from the input buffer, leaving out any
      * additional data that may already been received (e.g. from the following
      * message). */
-    g_byte_array_remove_range (response, 0, used);
+    mm_port_serial_buffer_consume (response, used);
     return MM_PORT_SERIAL_RESPONSE_BUFFER;
 }
 
 static MMPortSerialResponseType
 parse_response (MMPortSerial *port,
-                GByteArray *response,
+                MMPortSerialBuffer *response,
                 GByteArray **parsed_response,
                 GError **error)
 {
@@ -200,6 +200,7 @@ mm_port_serial_qcdm_command (MMPortSerialQcdm *self,
                             timeout_seconds,
                             FALSE, /* never cached */
                             FALSE, /* always queued last */
+                            MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE,
                             cancellable,
                             (GAsyncReadyCallback)serial_command_ready,
                             task);
@@ -297,7 +298,7 @@ mm_port_serial_qcdm_enable_unsolicited_msg_handler (MMPortSerialQcdm *self,
 }
 
 static void
-parse_unsolicited (MMPortSerial *port, GByteArray *response)
+parse_unsolicited (MMPortSerial *port, MMPortSerialBuffer *response)
 {
     MMPortSerialQcdm *self = MM_PORT_SERIAL_QCDM (port);
     GByteArray *log_buffer = NULL;
@@ -36,12 +36,14 @@
 #include "mm-port-serial.h"
 #include "mm-log-object.h"
 #include "mm-helper-enums-types.h"
+#include "mm-trace.h"
 
 static gboolean port_serial_queue_process          (gpointer data);
 static void     port_serial_schedule_queue_process (MMPortSerial *self,
                                                     guint timeout_ms);
 static void     port_serial_close_force            (MMPortSerial *self);
 static void     port_serial_reopen_cancel          (MMPortSerial *self);
+static void     port_serial_abort_background       (MMPortSerial *self);
 static void     port_serial_set_cached_reply       (MMPortSerial *self,
                                                     const GByteArray *command,
                                                     const GByteArray *response);
@@ -56,6 +58,7 @@ enum {
     PROP_STOPBITS,
     PROP_FLOW_CONTROL,
     PROP_SEND_DELAY,
+    PROP_SEND_CHUNK_SIZE,
     PROP_FD,
     PROP_SPEW_CONTROL,
     PROP_FLASH_OK,
@@ -73,13 +76,20 @@ static guint signals[LAST_SIGNAL] = { 0 };
 
 #define SERIAL_BUF_SIZE 2048
 
+/* Background commands with a timeout at least this long are considered long
+ * running, and may be aborted to let critical commands through */
+#define LONG_RUNNING_COMMAND_TIMEOUT_SECS 30
+
+/* Time to wait for the reply of an aborted command */
+#define ABORTED_COMMAND_REPLY_TIMEOUT_SECS 3
+
 struct _MMPortSerialPrivate {
     guint32 open_count;
     gboolean forced_close;
     int fd;
     GHashTable *reply_cache;
     GQueue *queue;
-    GByteArray *response;
+    MMPortSerialBuffer *response;
 
     /* For real ports, iochannel, and we implement the eagain limit */
     GIOChannel *iochannel;
@@ -96,11 +106,15 @@ struct _MMPortSerialPrivate {
     guint stopbits;
     MMFlowControl flow_control;
     guint64 send_delay;
+    guint send_chunk_size;
     gboolean spew_control;
     gboolean flash_ok;
 
     guint queue_id;
     guint timeout_id;
+    gboolean abort_pending;
+    guint abort_timeout_id;
+    MMPortSerialQueueStats queue_stats;
 
     GCancellable *cancellable;
     gulong cancellable_id;
@@ -113,6 +127,78 @@ struct _MMPortSerialPrivate {
     GTask *reopen_task;
 };
 
+/*****************************************************************************/
+/* Receive buffer */
+
+MMPortSerialBuffer *
+mm_port_serial_buffer_new (void)
+{
+    MMPortSerialBuffer *buffer;
+
+    buffer = g_slice_new0 (MMPortSerialBuffer);
+    buffer->storage = g_byte_array_sized_new (500);
+    buffer->data = buffer->storage->data;
+    return buffer;
+}
+
+void
+mm_port_serial_buffer_free (MMPortSerialBuffer *buffer)
+{
+    g_byte_array_unref (buffer->storage);
+    g_slice_free (MMPortSerialBuffer, buffer);
+}
+
+static void
+buffer_update_view (MMPortSerialBuffer *buffer)
+{
+    buffer->data = buffer->storage->data + buffer->offset;
+    buffer->len = buffer->storage->len - buffer->offset;
+}
+
+void
+mm_port_serial_buffer_append (MMPortSerialBuffer *buffer,
+                              const guint8       *data,
+                              gsize               len)
+{
+    /* Compact only once the consumed data is at least as big as the pending
+     * data, so that each byte is moved a bounded number of times */
+    if (buffer->offset > 0 && buffer->offset >= buffer->len) {
+        if (buffer->len > 0)
+            memmove (buffer->storage->data, buffer->storage->data + buffer->offset, buffer->len);
+        g_byte_array_set_size (buffer->storage, buffer->len);
+        buffer->offset = 0;
+    }
+
+    g_byte_array_append (buffer->storage, data, len);
+    buffer_update_view (buffer);
+}
+
+void
+mm_port_serial_buffer_consume (MMPortSerialBuffer *buffer,
+                               gsize               len)
+{
+    g_assert (len <= buffer->len);
+
+    buffer->offset += len;
+    /* Fully consumed, nothing to compact */
+    if (buffer->offset == buffer->storage->len) {
+        g_byte_array_set_size (buffer->storage, 0);
+        buffer->offset = 0;
+    }
+    buffer_update_view (buffer);
+}
+
+void
+mm_port_serial_buffer_replace (MMPortSerialBuffer *buffer,
+                               const guint8       *data,
+                               gsize               len)
+{
+    g_byte_array_set_size (buffer->storage, 0);
+    buffer->offset = 0;
+    g_byte_array_append (buffer->storage, data, len);
+    buffer_update_view (buffer);
+}
+
 /*****************************************************************************/
 /* Command */
 
@@ -125,14 +211,69 @@ typedef struct {
     gboolean allow_cached;
     guint32 eagain_count;
 
+    gboolean run_next;
+    MMPortSerialCommandPriority priority;
+    gint64 queued_time;
+    /* Duplicate commands waiting for this same reply */
+    GList *coalesced;
+
     guint32 idx;
     gboolean started;
+    gint64 started_time;
     gboolean done;
 } CommandContext;
 
+/* Lower rank is sent first */
+static const guint priority_rank[MM_PORT_SERIAL_COMMAND_PRIORITY_LAST] = {
+    [MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL]    = 0,
+    [MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE] = 1,
+    [MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND]  = 2,
+};
+
+static void
+command_context_set_result (CommandContext   *ctx,
+                            const GByteArray *response,
+                            const GError     *error)
+{
+    GList *l;
+
+    if (error)
+        g_simple_async_result_set_from_error (ctx->result, error);
+    else
+        g_simple_async_result_set_op_res_gpointer (ctx->result,
+                                                   g_byte_array_ref ((GByteArray *)response),
+                                                   (GDestroyNotify) g_byte_array_unref);
+
+    /* Each coalesced command gets its own copy of the response, as the
+     * receivers are allowed to modify it */
+    for (l = ctx->coalesced; l; l = g_list_next (l)) {
+        CommandContext *other = l->data;
+
+        if (error)
+            g_simple_async_result_set_from_error (other->result, error);
+        else {
+            GByteArray *copy;
+
+            copy = g_byte_array_sized_new (response->len);
+            g_byte_array_append (copy, response->data, response->len);
+            g_simple_async_result_set_op_res_gpointer (other->result,
+                                                       copy,
+                                                       (GDestroyNotify) g_byte_array_unref);
+        }
+    }
+}
+
 static void
 command_context_complete_and_free (CommandContext *ctx, gboolean idle)
 {
+    GList *l;
+
+    /* Coalesced commands are always completed in idle, the caller of the
+     * original command may need to process the response first */
+    for (l = ctx->coalesced; l; l = g_list_next (l))
+        command_context_complete_and_free ((CommandContext *) l->data, TRUE);
+    g_list_free (ctx->coalesced);
+
     if (idle)
         g_simple_async_result_complete_in_idle (ctx->result);
     else
@@ -156,12 +297,146 @@ mm_port_serial_command_finish (MMPortSerial *self,
     return g_byte_array_ref (g_simple_async_result_get_op_res_gpointer (G_SIMPLE_ASYNC_RESULT (res)));
 }
 
+static guint
+queue_depth_bucket (guint depth)
+{
+    guint bucket = 0;
+
+    /* 0, 1, 2-3, 4-7, 8-15, 16+ */
+    while (depth && bucket < MM_PORT_SERIAL_QUEUE_DEPTH_BUCKETS - 1) {
+        depth >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static guint
+wait_time_bucket (gint64 wait_us)
+{
+    static const gint64 limits_ms[MM_PORT_SERIAL_WAIT_TIME_BUCKETS - 1] = { 10, 100, 1000, 10000, 60000 };
+    guint               bucket;
+
+    for (bucket = 0; bucket < G_N_ELEMENTS (limits_ms); bucket++) {
+        if (wait_us < limits_ms[bucket] * 1000)
+            break;
+    }
+    return bucket;
+}
+
+static void
+port_serial_log_queue_stats (MMPortSerial *self)
+{
+    MMPortSerialQueueStats *stats = &self->priv->queue_stats;
+    GString                *str;
+    guint                   n = 0;
+    guint                   i;
+    guint                   j;
+
+    for (i = 0; i < MM_PORT_SERIAL_QUEUE_DEPTH_BUCKETS; i++)
+        n += stats->queue_depth[i];
+    if (!n)
+        return;
+
+    str = g_string_new ("queue depth [");
+    for (i = 0; i < MM_PORT_SERIAL_QUEUE_DEPTH_BUCKETS; i++)
+        g_string_append_printf (str, "%s%u", i ? " " : "", stats->queue_depth[i]);
+    g_string_append (str, "], wait time");
+    for (i = 0; i < MM_PORT_SERIAL_COMMAND_PRIORITY_LAST; i++) {
+        static const gchar *names[] = { "interactive", "critical", "background" };
+
+        g_string_append_printf (str, " %s [", names[i]);
+        for (j = 0; j < MM_PORT_SERIAL_WAIT_TIME_BUCKETS; j++)
+            g_string_append_printf (str, "%s%u", j ? " " : "", stats->wait_time[i][j]);
+        g_string_append_c (str, ']');
+    }
+    g_string_append_printf (str, ", %u coalesced, %u aborted", stats->coalesced, stats->aborted);
+
+    mm_obj_dbg (self, "command %s", str->str);
+    g_string_free (str, TRUE);
+}
+
+void
+mm_port_serial_get_queue_stats (MMPortSerial           *self,
+                                MMPortSerialQueueStats *stats)
+{
+    g_return_if_fail (MM_IS_PORT_SERIAL (self));
+    g_return_if_fail (stats != NULL);
+
+    *stats = self->priv->queue_stats;
+}
+
+guint
+mm_port_serial_get_queue_length (MMPortSerial *self)
+{
+    g_return_val_if_fail (MM_IS_PORT_SERIAL (self), 0);
+
+    return g_queue_get_length (self->priv->queue);
+}
+
+static gboolean
+port_serial_queue_coalesce (MMPortSerial   *self,
+                            CommandContext *ctx)
+{
+    GList *l;
+
+    /* Only background commands not yet sent are coalesced, as these are
+     * expected to be side-effect free polls */
+    for (l = self->priv->queue->head; l; l = g_list_next (l)) {
+        CommandContext *other = l->data;
+
+        if (other->started ||
+            other->priority != MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND ||
+            other->allow_cached != ctx->allow_cached ||
+            (ctx->cancellable && ctx->cancellable != other->cancellable) ||
+            other->command->len != ctx->command->len ||
+            memcmp (other->command->data, ctx->command->data, ctx->command->len) != 0)
+            continue;
+
+        other->coalesced = g_list_append (other->coalesced, ctx);
+        self->priv->queue_stats.coalesced++;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static void
+port_serial_queue_insert (MMPortSerial   *self,
+                          CommandContext *ctx)
+{
+    GList *l;
+
+    /* If requested to run next, push to the head of the queue so that it really is
+     * the next one sent */
+    if (ctx->run_next) {
+        g_queue_push_head (self->priv->queue, ctx);
+        return;
+    }
+
+    /* Skip from the tail all the commands with lower priority not yet
+     * started. Commands explicitly requested to run next are never
+     * overtaken. */
+    for (l = self->priv->queue->tail; l; l = g_list_previous (l)) {
+        CommandContext *other = l->data;
+
+        if (other->started ||
+            other->run_next ||
+            priority_rank[other->priority] <= priority_rank[ctx->priority])
+            break;
+    }
+
+    if (l)
+        g_queue_insert_after (self->priv->queue, l, ctx);
+    else
+        g_queue_push_head (self->priv->queue, ctx);
+}
+
 void
 mm_port_serial_command (MMPortSerial *self,
                         GByteArray *command,
                         guint32 timeout_seconds,
                         gboolean allow_cached,
                         gboolean run_next,
+                        MMPortSerialCommandPriority priority,
                         GCancellable *cancellable,
                         GAsyncReadyCallback callback,
                         gpointer user_data)
@@ -182,6 +457,9 @@ mm_port_serial_command (MMPortSerial *self,
     ctx->allow_cached = allow_cached;
     ctx->timeout = timeout_seconds;
     ctx->cancellable = (cancellable ? g_object_ref (cancellable) : NULL);
+    ctx->run_next = run_next;
+    ctx->priority = priority < MM_PORT_SERIAL_COMMAND_PRIORITY_LAST ? priority : MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE;
+    ctx->queued_time = g_get_monotonic_time ();
 
     /* Only accept about 3 seconds of EAGAIN for this command */
     if (self->priv->send_delay && mm_port_get_subsys (MM_PORT (self)) == MM_PORT_SUBSYS_TTY)
@@ -202,12 +480,19 @@ mm_port_serial_command (MMPortSerial *self,
     if (!allow_cached)
         port_serial_set_cached_reply (self, ctx->command, NULL);
 
-    /* If requested to run next, push to the head of the queue so that it really is
-     * the next one sent */
-    if (run_next)
-        g_queue_push_head (self->priv->queue, ctx);
-    else
-        g_queue_push_tail (self->priv->queue, ctx);
+    self->priv->queue_stats.queue_depth[queue_depth_bucket (g_queue_get_length (self->priv->queue))]++;
+
+    /* A duplicate of an already queued background command just waits for
+     * the same reply */
+    if (!run_next &&
+        ctx->priority == MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND &&
+        port_serial_queue_coalesce (self, ctx))
+        return;
+
+    port_serial_queue_insert (self, ctx);
+
+    if (ctx->priority == MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL)
+        port_serial_abort_background (self);
 
     if (g_queue_get_length (self->priv->queue) == 1)
         port_serial_schedule_queue_process (self, 0);
@@ -558,6 +843,7 @@ port_serial_process_command (MMPortSerial *self,
     /* Only print command the first time */
     if (ctx->started == FALSE) {
         ctx->started = TRUE;
+        ctx->started_time = g_get_monotonic_time ();
         serial_debug (self, "-->", (const gchar *) ctx->command->data, ctx->command->len);
     }
 
@@ -566,8 +852,9 @@ port_serial_process_command (MMPortSerial *self,
         send_len = (gssize)ctx->command->len;
         p = (gchar *)ctx->command->data;
     } else {
-        /* Send just one byte of the command */
-        send_len = 1;
+        /* Send just one chunk of the command, one byte unless the port
+         * was calibrated to accept more */
+        send_len = (gssize) MIN (self->priv->send_chunk_size, ctx->command->len - ctx->idx);
         p = (gchar *)&ctx->command->data[ctx->idx];
     }
 
@@ -694,6 +981,11 @@ port_serial_schedule_queue_process (MMPortSerial *self, guint timeout_ms)
         return;
     }
 
+    if (self->priv->abort_pending) {
+        /* Waiting for the reply of an aborted command */
+        return;
+    }
+
     if (self->priv->queue_id) {
         /* Already scheduled */
         return;
@@ -706,13 +998,8 @@ port_serial_schedule_queue_process (MMPortSerial *self, guint timeout_ms)
 }
 
 static void
-port_serial_got_response (MMPortSerial *self,
-                          GByteArray   *parsed_response,
-                          const GError *error)
+port_serial_clear_response_wait (MMPortSerial *self)
 {
-    /* Either one or the other, not both */
-    g_assert ((parsed_response && !error) || (!parsed_response && error));
-
     if (self->priv->timeout_id) {
         g_source_remove (self->priv->timeout_id);
         self->priv->timeout_id = 0;
@@ -726,6 +1013,69 @@ port_serial_got_response (MMPortSerial *self,
     }
 
     g_clear_object (&self->priv->cancellable);
+}
+
+static void
+trace_command (MMPortSerial   *self,
+               CommandContext *ctx)
+{
+    g_autofree gchar *name = NULL;
+    const guint8     *data;
+    guint             len;
+    guint             i;
+
+    data = ctx->command->data;
+    len = ctx->command->len;
+
+    /* AT commands are named without their arguments, which may contain
+     * personal info (e.g. the PIN or the dialed number): only the command
+     * name letters and the set or query suffix are kept. Anything else
+     * (e.g. QCDM frames or SMS text) is just reported by its size */
+    i = 0;
+    if (len >= 2 && g_ascii_strncasecmp ((const gchar *) data, "AT", 2) == 0) {
+        i = 2;
+        if (i < len && g_ascii_toupper (data[i]) == 'D')
+            i++;
+        else {
+            if (i < len && data[i] && strchr ("+$^%*&#", data[i]))
+                i++;
+            while (i < len && g_ascii_isalpha (data[i]))
+                i++;
+            if (i < len && data[i] == '=')
+                i++;
+            if (i < len && data[i] == '?')
+                i++;
+        }
+    }
+
+    if (i > 0)
+        name = g_strndup ((const gchar *) data, i);
+    else
+        name = g_strdup_printf ("binary command (%u bytes)", len);
+
+    mm_trace_span (self, "command", name, ctx->started_time);
+}
+
+static void
+port_serial_got_response (MMPortSerial *self,
+                          GByteArray   *parsed_response,
+                          const GError *error)
+{
+    /* Either one or the other, not both */
+    g_assert ((parsed_response && !error) || (!parsed_response && error));
+
+    port_serial_clear_response_wait (self);
+
+    /* The reply of an aborted command, which was already completed */
+    if (self->priv->abort_pending) {
+        mm_obj_dbg (self, "discarding reply of aborted command");
+        g_source_remove (self->priv->abort_timeout_id);
+        self->priv->abort_timeout_id = 0;
+        self->priv->abort_pending = FALSE;
+        if (!g_queue_is_empty (self->priv->queue))
+            port_serial_schedule_queue_process (self, 0);
+        return;
+    }
 
     /* The completion of the command context may end up fully disposing the
      * serial port object. In order to cope with that, we make sure we have
@@ -737,16 +1087,13 @@ port_serial_got_response (MMPortSerial *self,
 
         ctx = (CommandContext *) g_queue_pop_head (self->priv->queue);
         if (ctx) {
+            if (ctx->started && mm_trace_enabled ())
+                trace_command (self, ctx);
+
             /* Complete the command context with the appropriate result */
-            if (error)
-                g_simple_async_result_set_from_error (ctx->result, error);
-            else {
-                if (ctx->allow_cached)
-                    port_serial_set_cached_reply (self, ctx->command, parsed_response);
-                g_simple_async_result_set_op_res_gpointer (ctx->result,
-                                                           g_byte_array_ref (parsed_response),
-                                                           (GDestroyNotify) g_byte_array_unref);
-            }
+            if (!error && ctx->allow_cached)
+                port_serial_set_cached_reply (self, ctx->command, parsed_response);
+            command_context_set_result (ctx, parsed_response, error);
 
             /* Don't complete in idle. We need the caller remove the response range which
              * was processed, and that must be done before processing any new queued command */
@@ -812,6 +1159,91 @@ port_serial_response_wait_cancelled (GCancellable *cancellable,
     g_error_free (error);
 }
 
+static gboolean
+port_serial_send_abort_sequence (MMPortSerial *self)
+{
+    const gchar *abort_sequence;
+    gsize        len;
+    gsize        written = 0;
+
+    abort_sequence = MM_PORT_SERIAL_GET_CLASS (self)->abort_sequence;
+    if (!abort_sequence)
+        return FALSE;
+
+    len = strlen (abort_sequence);
+    if (self->priv->iochannel) {
+        if (g_io_channel_write_chars (self->priv->iochannel, abort_sequence, len, &written, NULL) != G_IO_STATUS_NORMAL)
+            return FALSE;
+    } else if (self->priv->socket) {
+        gssize bytes_sent;
+
+        bytes_sent = g_socket_send (self->priv->socket, abort_sequence, len, NULL, NULL);
+        if (bytes_sent > 0)
+            written = (gsize) bytes_sent;
+    }
+
+    if (written != len)
+        return FALSE;
+
+    serial_debug (self, "-->", abort_sequence, len);
+    return TRUE;
+}
+
+static gboolean
+port_serial_abort_timed_out (MMPortSerial *self)
+{
+    self->priv->abort_timeout_id = 0;
+
+    /* No reply to the aborted command, just go on with the next one */
+    mm_obj_dbg (self, "no reply to aborted command");
+    self->priv->abort_pending = FALSE;
+    if (!g_queue_is_empty (self->priv->queue))
+        port_serial_schedule_queue_process (self, 0);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+port_serial_abort_background (MMPortSerial *self)
+{
+    CommandContext *ctx;
+    GError         *error;
+
+    /* Only a long running background command already sent and waiting for
+     * the reply is aborted */
+    ctx = (CommandContext *) g_queue_peek_head (self->priv->queue);
+    if (!ctx ||
+        !ctx->done ||
+        !self->priv->timeout_id ||
+        self->priv->abort_pending ||
+        ctx->priority != MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND ||
+        ctx->timeout < LONG_RUNNING_COMMAND_TIMEOUT_SECS)
+        return;
+
+    if (!port_serial_send_abort_sequence (self))
+        return;
+
+    mm_obj_dbg (self, "aborted long running background command to run a critical one");
+    self->priv->queue_stats.aborted++;
+
+    port_serial_clear_response_wait (self);
+
+    /* The modem still replies to the aborted command, that reply must be
+     * discarded before sending the next one; the queue is not processed
+     * until then */
+    self->priv->abort_pending = TRUE;
+    self->priv->abort_timeout_id = g_timeout_add_seconds (ABORTED_COMMAND_REPLY_TIMEOUT_SECS,
+                                                          (GSourceFunc) port_serial_abort_timed_out,
+                                                          self);
+
+    g_queue_pop_head (self->priv->queue);
+    error = g_error_new_literal (MM_CORE_ERROR,
+                                 MM_CORE_ERROR_ABORTED,
+                                 "Command aborted to run a critical command");
+    command_context_set_result (ctx, NULL, error);
+    command_context_complete_and_free (ctx, TRUE);
+    g_error_free (error);
+}
+
 static gboolean
 port_serial_queue_process (gpointer data)
 {
@@ -821,10 +1253,19 @@ port_serial_queue_process (gpointer data)
 
     self->priv->queue_id = 0;
 
+    /* Nothing is sent until the reply of an aborted command is discarded */
+    if (self->priv->abort_pending)
+        return G_SOURCE_REMOVE;
+
     ctx = (CommandContext *) g_queue_peek_head (self->priv->queue);
     if (!ctx)
         return G_SOURCE_REMOVE;
 
+    if (ctx->queued_time) {
+        self->priv->queue_stats.wait_time[ctx->priority][wait_time_bucket (g_get_monotonic_time () - ctx->queued_time)]++;
+        ctx->queued_time = 0;
+    }
+
     if (ctx->allow_cached) {
         const GByteArray *cached;
 
@@ -851,7 +1292,7 @@ port_serial_queue_process (gpointer data)
         return G_SOURCE_REMOVE;
     }
 
-    /* Schedule the next byte of the command to be sent */
+    /* Schedule the next chunk of the command to be sent */
     if (!ctx->done) {
         port_serial_schedule_queue_process (self,
                                             (mm_port_get_subsys (MM_PORT (self)) == MM_PORT_SUBSYS_TTY ?
@@ -954,15 +1395,13 @@ common_input_available (MMPortSerial *self,
 
     if (condition & G_IO_HUP) {
         mm_obj_dbg (self, "unexpected port hangup!");
-        if (self->priv->response->len)
-            g_byte_array_remove_range (self->priv->response, 0, self->priv->response->len);
+        mm_port_serial_buffer_consume (self->priv->response, self->priv->response->len);
         port_serial_close_force (self);
         return G_SOURCE_REMOVE;
     }
 
     if (condition & G_IO_ERR) {
-        if (self->priv->response->len)
-            g_byte_array_remove_range (self->priv->response, 0, self->priv->response->len);
+        mm_port_serial_buffer_consume (self->priv->response, self->priv->response->len);
         return G_SOURCE_CONTINUE;
     }
 
@@ -1013,7 +1452,7 @@ common_input_available (MMPortSerial *self,
 
         g_assert (bytes_read > 0);
         serial_debug (self, "<--", buf, bytes_read);
-        g_byte_array_append (self->priv->response, (const guint8 *) buf, bytes_read);
+        mm_port_serial_buffer_append (self->priv->response, (const guint8 *) buf, bytes_read);
 
         /* See if we can parse anything. The response parsing may actually
          * schedule the completion of a serial command, and that in turn may end
@@ -1027,7 +1466,7 @@ common_input_available (MMPortSerial *self,
             if ((self->priv->response->len > SERIAL_BUF_SIZE) && self->priv->spew_control) {
                 /* Notify listeners and then trim the buffer */
                 g_signal_emit (self, signals[BUFFER_FULL], 0, self->priv->response);
-                g_byte_array_remove_range (self->priv->response, 0, (SERIAL_BUF_SIZE / 2));
+                mm_port_serial_buffer_consume (self->priv->response, (SERIAL_BUF_SIZE / 2));
             }
 
             parse_response_buffer (self);
@@ -1437,17 +1876,29 @@ _close_internal (MMPortSerial *self, gboolean force)
     }
 
     /* Clear the command queue */
-    for (i = 0; i < g_queue_get_length (self->priv->queue); i++) {
-        CommandContext *ctx;
-
-        ctx = g_queue_peek_nth (self->priv->queue, i);
-        g_simple_async_result_set_error (ctx->result,
-                                         MM_SERIAL_ERROR,
-                                         MM_SERIAL_ERROR_SEND_FAILED,
-                                         "Serial port is now closed");
-        command_context_complete_and_free (ctx, TRUE);
+    if (!g_queue_is_empty (self->priv->queue)) {
+        GError *error;
+
+        error = g_error_new_literal (MM_SERIAL_ERROR,
+                                     MM_SERIAL_ERROR_SEND_FAILED,
+                                     "Serial port is now closed");
+        for (i = 0; i < g_queue_get_length (self->priv->queue); i++) {
+            CommandContext *ctx;
+
+            ctx = g_queue_peek_nth (self->priv->queue, i);
+            command_context_set_result (ctx, NULL, error);
+            command_context_complete_and_free (ctx, TRUE);
+        }
+        g_queue_clear (self->priv->queue);
+        g_error_free (error);
+    }
+    self->priv->abort_pending = FALSE;
+    if (self->priv->abort_timeout_id) {
+        g_source_remove (self->priv->abort_timeout_id);
+        self->priv->abort_timeout_id = 0;
     }
-    g_queue_clear (self->priv->queue);
+
+    port_serial_log_queue_stats (self);
 
     if (self->priv->timeout_id) {
         g_source_remove (self->priv->timeout_id);
@@ -1960,9 +2411,10 @@ mm_port_serial_init (MMPortSerial *self)
     self->priv->stopbits = 1;
     self->priv->flow_control = MM_FLOW_CONTROL_UNKNOWN;
     self->priv->send_delay = 1000;
+    self->priv->send_chunk_size = 1;
 
     self->priv->queue = g_queue_new ();
-    self->priv->response = g_byte_array_sized_new (500);
+    self->priv->response = mm_port_serial_buffer_new ();
 }
 
 static void
@@ -1995,6 +2447,9 @@ set_property (GObject *object,
     case PROP_SEND_DELAY:
         self->priv->send_delay = g_value_get_uint64 (value);
         break;
+    case PROP_SEND_CHUNK_SIZE:
+        self->priv->send_chunk_size = g_value_get_uint (value);
+        break;
     case PROP_SPEW_CONTROL:
         self->priv->spew_control = g_value_get_boolean (value);
         break;
@@ -2037,6 +2492,9 @@ get_property (GObject *object,
     case PROP_SEND_DELAY:
         g_value_set_uint64 (value, self->priv->send_delay);
         break;
+    case PROP_SEND_CHUNK_SIZE:
+        g_value_set_uint (value, self->priv->send_chunk_size);
+        break;
     case PROP_SPEW_CONTROL:
         g_value_set_boolean (value, self->priv->spew_control);
         break;
@@ -2066,11 +2524,14 @@ finalize (GObject *object)
     if (self->priv->timeout_id)
         g_source_remove (self->priv->timeout_id);
 
+    if (self->priv->abort_timeout_id)
+        g_source_remove (self->priv->abort_timeout_id);
+
     if (self->priv->queue_id)
         g_source_remove (self->priv->queue_id);
 
     g_hash_table_destroy (self->priv->reply_cache);
-    g_byte_array_unref (self->priv->response);
+    mm_port_serial_buffer_free (self->priv->response);
     g_queue_free (self->priv->queue);
 
     G_OBJECT_CLASS (mm_port_serial_parent_class)->finalize (object);
@@ -2148,6 +2609,14 @@ mm_port_serial_class_init (MMPortSerialClass *klass)
                               0, G_MAXUINT64, 0,
                               G_PARAM_READWRITE));
 
+    g_object_class_install_property
+        (object_class, PROP_SEND_CHUNK_SIZE,
+         g_param_spec_uint (MM_PORT_SERIAL_SEND_CHUNK_SIZE,
+                            "SendChunkSize",
+                            "Number of bytes written at once when a send delay is in use",
+                            1, G_MAXUINT, 1,
+                            G_PARAM_READWRITE));
+
     g_object_class_install_property
         (object_class, PROP_SPEW_CONTROL,
          g_param_spec_boolean (MM_PORT_SERIAL_SPEW_CONTROL,
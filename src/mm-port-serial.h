@@ -37,6 +37,7 @@
 #define MM_PORT_SERIAL_STOPBITS     "stopbits"
 #define MM_PORT_SERIAL_FLOW_CONTROL "flowcontrol"
 #define MM_PORT_SERIAL_SEND_DELAY   "send-delay"
+#define MM_PORT_SERIAL_SEND_CHUNK_SIZE "send-chunk-size"
 #define MM_PORT_SERIAL_FD           "fd" /* Construct-only */
 #define MM_PORT_SERIAL_SPEW_CONTROL "spew-control"
 #define MM_PORT_SERIAL_FLASH_OK     "flash-ok"
@@ -47,6 +48,54 @@ typedef enum {
     MM_PORT_SERIAL_RESPONSE_ERROR,
 } MMPortSerialResponseType;
 
+/* Receive buffer. Processed data is consumed by moving the start offset, and
+ * the storage is only compacted lazily, so that removing a parsed response or
+ * URC doesn't require moving all the remaining data each time. The @data and
+ * @len fields always give a contiguous view of the pending contents and must
+ * be considered read-only. */
+typedef struct {
+    const guint8 *data;
+    gsize         len;
+    /*< private >*/
+    GByteArray   *storage;
+    gsize         offset;
+} MMPortSerialBuffer;
+
+MMPortSerialBuffer *mm_port_serial_buffer_new     (void);
+void                mm_port_serial_buffer_free    (MMPortSerialBuffer *buffer);
+void                mm_port_serial_buffer_append  (MMPortSerialBuffer *buffer,
+                                                   const guint8       *data,
+                                                   gsize               len);
+void                mm_port_serial_buffer_consume (MMPortSerialBuffer *buffer,
+                                                   gsize               len);
+/* Replaces the whole contents; @data must not point into the buffer itself */
+void                mm_port_serial_buffer_replace (MMPortSerialBuffer *buffer,
+                                                   const guint8       *data,
+                                                   gsize               len);
+
+/* Scheduling class of the commands in the port queue. Pending commands are
+ * sent in class order (critical, interactive, background), and FIFO within the
+ * same class. */
+typedef enum {
+    MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE = 0,
+    MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL,
+    MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND,
+    MM_PORT_SERIAL_COMMAND_PRIORITY_LAST
+} MMPortSerialCommandPriority;
+
+/* Queue statistics. Depth buckets: 0, 1, 2-3, 4-7, 8-15, 16+ commands already
+ * queued when a new one is added. Wait time buckets: <10ms, <100ms, <1s, <10s,
+ * <60s, 60s+ since queued until sent. */
+#define MM_PORT_SERIAL_QUEUE_DEPTH_BUCKETS 6
+#define MM_PORT_SERIAL_WAIT_TIME_BUCKETS   6
+
+typedef struct {
+    guint queue_depth[MM_PORT_SERIAL_QUEUE_DEPTH_BUCKETS];
+    guint wait_time[MM_PORT_SERIAL_COMMAND_PRIORITY_LAST][MM_PORT_SERIAL_WAIT_TIME_BUCKETS];
+    guint coalesced;
+    guint aborted;
+} MMPortSerialQueueStats;
+
 typedef struct _MMPortSerial MMPortSerial;
 typedef struct _MMPortSerialClass MMPortSerialClass;
 typedef struct _MMPortSerialPrivate MMPortSerialPrivate;
@@ -61,9 +110,9 @@ struct _MMPortSerialClass {
 
     /* Called for subclasses to parse unsolicited responses.  If any recognized
      * unsolicited response is found, it should be removed from the 'response'
-     * byte array before returning.
+     * buffer before returning.
      */
-    void     (*parse_unsolicited) (MMPortSerial *self, GByteArray *response);
+    void     (*parse_unsolicited) (MMPortSerial *self, MMPortSerialBuffer *response);
 
     /*
      * Called to parse the device's response to a command or determine if the
@@ -78,11 +127,11 @@ struct _MMPortSerialClass {
      * If there is no response, @MM_PORT_SERIAL_RESPONSE_NONE will be returned,
      * and neither @error nor @parsed_response will be set.
      *
-     * The implementation is allowed to cleanup the @response byte array, e.g. to
+     * The implementation is allowed to cleanup the @response buffer, e.g. to
      * just remove 1 single response if more than one found.
      */
     MMPortSerialResponseType (*parse_response) (MMPortSerial *self,
-                                                GByteArray *response,
+                                                MMPortSerialBuffer *response,
                                                 GByteArray **parsed_response,
                                                 GError **error);
 
@@ -100,8 +149,12 @@ struct _MMPortSerialClass {
                                    const gchar  *buf,
                                    gsize         len);
 
+    /* Characters to send in order to abort the command currently being run
+     * by the device, or NULL if commands can't be aborted. */
+    const gchar *abort_sequence;
+
     /* Signals */
-    void (*buffer_full)           (MMPortSerial *port, const GByteArray *buffer);
+    void (*buffer_full)           (MMPortSerial *port, const MMPortSerialBuffer *buffer);
     void (*forced_close)          (MMPortSerial *port);
 };
 
@@ -145,6 +198,7 @@ void        mm_port_serial_command        (MMPortSerial *self,
                                            guint32 timeout_seconds,
                                            gboolean allow_cached,
                                            gboolean run_next,
+                                           MMPortSerialCommandPriority priority,
                                            GCancellable *cancellable,
                                            GAsyncReadyCallback callback,
                                            gpointer user_data);
@@ -157,4 +211,10 @@ gboolean mm_port_serial_set_flow_control (MMPortSerial   *self,
                                           GError        **error);
 
 MMFlowControl mm_port_serial_get_flow_control (MMPortSerial *self);
+
+void mm_port_serial_get_queue_stats (MMPortSerial           *self,
+                                     MMPortSerialQueueStats *stats);
+
+/* Number of commands queued, including the one in progress, if any */
+guint mm_port_serial_get_queue_length (MMPortSerial *self);
 #endif /* MM_PORT_SERIAL_H */
@@ -0,0 +1,345 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#include "mm-probe-cache.h"
+#include "mm-log-object.h"
+
+/* Keys stored in each port group */
+#define KEY_PLUGIN  "plugin"
+#define KEY_AT      "at"
+#define KEY_QCDM    "qcdm"
+#define KEY_QMI     "qmi"
+#define KEY_MBIM    "mbim"
+#define KEY_VENDOR  "vendor"
+#define KEY_PRODUCT "product"
+#define KEY_ICERA   "icera"
+#define KEY_XMM     "xmm"
+
+static void log_object_iface_init (MMLogObjectInterface *iface);
+
+G_DEFINE_TYPE_EXTENDED (MMProbeCache, mm_probe_cache, G_TYPE_OBJECT, 0,
+                        G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
+
+struct _MMProbeCachePrivate {
+    gchar    *path;
+    GKeyFile *key_file;
+};
+
+/*****************************************************************************/
+
+/* The group prefix identifies the physical device, the full group name
+ * identifies the port within the device. Port names of USB devices are not
+ * used as they may change across reboots (e.g. ttyUSB numbering). */
+static gchar *
+build_group_prefix (MMKernelDevice *port)
+{
+    const gchar *physdev_uid;
+
+    physdev_uid = mm_kernel_device_get_physdev_uid (port);
+    if (!physdev_uid)
+        return NULL;
+    return g_strdup_printf ("%s|", physdev_uid);
+}
+
+/* USB ports are identified by their interface number. PCI and MHI ports don't
+ * have one, so the port name is used instead; for wwan ports the wwan device
+ * index is skipped (e.g. 'mbim0' out of 'wwan0mbim0'), as that depends on the
+ * order in which devices are found. */
+static const gchar *
+build_group_port_id (MMKernelDevice *port)
+{
+    const gchar *name;
+    const gchar *subsystem;
+
+    if (mm_kernel_device_get_interface_number (port) >= 0)
+        return "";
+
+    name = mm_kernel_device_get_name (port);
+    subsystem = mm_kernel_device_get_subsystem (port);
+    if (name && subsystem && g_str_equal (subsystem, "wwan") && g_str_has_prefix (name, "wwan")) {
+        name += strlen ("wwan");
+        while (g_ascii_isdigit (*name))
+            name++;
+    }
+    return name ? name : "";
+}
+
+static gchar *
+build_group_name (MMKernelDevice *port)
+{
+    g_autofree gchar *prefix = NULL;
+
+    prefix = build_group_prefix (port);
+    if (!prefix)
+        return NULL;
+
+    return g_strdup_printf ("%s%04x:%04x:%04x|%d|%s|%s",
+                            prefix,
+                            mm_kernel_device_get_physdev_vid (port),
+                            mm_kernel_device_get_physdev_pid (port),
+                            mm_kernel_device_get_physdev_revision (port),
+                            mm_kernel_device_get_interface_number (port),
+                            mm_kernel_device_get_subsystem (port),
+                            build_group_port_id (port));
+}
+
+static void
+probe_cache_save (MMProbeCache *self)
+{
+    g_autoptr(GError)  error = NULL;
+    g_autofree gchar  *dir = NULL;
+
+    dir = g_path_get_dirname (self->priv->path);
+    if (g_mkdir_with_parents (dir, 0755) < 0) {
+        mm_obj_warn (self, "couldn't create directory '%s': %s", dir, g_strerror (errno));
+        return;
+    }
+
+    if (!g_key_file_save_to_file (self->priv->key_file, self->priv->path, &error))
+        mm_obj_warn (self, "couldn't save probe cache: %s", error->message);
+}
+
+/*****************************************************************************/
+
+const gchar *
+mm_probe_cache_apply (MMProbeCache *self,
+                      MMPortProbe  *probe)
+{
+    g_autofree gchar *group = NULL;
+    g_autofree gchar *vendor = NULL;
+    g_autofree gchar *product = NULL;
+    g_autofree gchar *plugin = NULL;
+    GKeyFile         *key_file;
+
+    key_file = self->priv->key_file;
+
+    group = build_group_name (mm_port_probe_peek_port (probe));
+    if (!group || !g_key_file_has_group (key_file, group))
+        return NULL;
+
+    mm_obj_dbg (self, "loading cached probing results for port %s", mm_port_probe_get_port_name (probe));
+
+    if (g_key_file_get_boolean (key_file, group, KEY_AT, NULL)) {
+        /* AT probing itself is the validation request. Negative or missing
+         * results of the additional AT probing steps are not loaded, as they
+         * may just not have been requested by the plugin in use. */
+        vendor = g_key_file_get_string (key_file, group, KEY_VENDOR, NULL);
+        if (vendor)
+            mm_port_probe_set_result_at_vendor (probe, vendor);
+        product = g_key_file_get_string (key_file, group, KEY_PRODUCT, NULL);
+        if (product)
+            mm_port_probe_set_result_at_product (probe, product);
+        if (g_key_file_get_boolean (key_file, group, KEY_ICERA, NULL))
+            mm_port_probe_set_result_at_icera (probe, TRUE);
+        if (g_key_file_get_boolean (key_file, group, KEY_XMM, NULL))
+            mm_port_probe_set_result_at_xmm (probe, TRUE);
+        mm_port_probe_set_result_qcdm (probe, FALSE);
+        mm_port_probe_set_result_qmi (probe, FALSE);
+        mm_port_probe_set_result_mbim (probe, FALSE);
+    } else {
+        mm_port_probe_set_result_at (probe, FALSE);
+        /* QCDM, QMI or MBIM probing will be the validation request */
+        if (!g_key_file_get_boolean (key_file, group, KEY_QCDM, NULL))
+            mm_port_probe_set_result_qcdm (probe, FALSE);
+        if (!g_key_file_get_boolean (key_file, group, KEY_QMI, NULL))
+            mm_port_probe_set_result_qmi (probe, FALSE);
+        if (!g_key_file_get_boolean (key_file, group, KEY_MBIM, NULL))
+            mm_port_probe_set_result_mbim (probe, FALSE);
+    }
+
+    plugin = g_key_file_get_string (key_file, group, KEY_PLUGIN, NULL);
+    return plugin ? g_intern_string (plugin) : NULL;
+}
+
+/*****************************************************************************/
+
+static gboolean
+probe_matches_group (MMProbeCache *self,
+                     MMPortProbe  *probe,
+                     const gchar  *group,
+                     const gchar  *plugin_name)
+{
+    g_autofree gchar *cached_plugin = NULL;
+
+    cached_plugin = g_key_file_get_string (self->priv->key_file, group, KEY_PLUGIN, NULL);
+    return ((g_strcmp0 (cached_plugin, plugin_name) == 0) &&
+            (g_key_file_get_boolean (self->priv->key_file, group, KEY_AT,   NULL) == mm_port_probe_is_at   (probe)) &&
+            (g_key_file_get_boolean (self->priv->key_file, group, KEY_QCDM, NULL) == mm_port_probe_is_qcdm (probe)) &&
+            (g_key_file_get_boolean (self->priv->key_file, group, KEY_QMI,  NULL) == mm_port_probe_is_qmi  (probe)) &&
+            (g_key_file_get_boolean (self->priv->key_file, group, KEY_MBIM, NULL) == mm_port_probe_is_mbim (probe)));
+}
+
+static void
+probe_cache_invalidate (MMProbeCache *self,
+                        const gchar  *prefix)
+{
+    g_auto(GStrv) groups = NULL;
+    guint         i;
+
+    groups = g_key_file_get_groups (self->priv->key_file, NULL);
+    for (i = 0; groups && groups[i]; i++) {
+        if (g_str_has_prefix (groups[i], prefix))
+            g_key_file_remove_group (self->priv->key_file, groups[i], NULL);
+    }
+}
+
+static void
+probe_to_group (MMProbeCache *self,
+                MMPortProbe  *probe,
+                const gchar  *group,
+                const gchar  *plugin_name)
+{
+    GKeyFile *key_file;
+
+    key_file = self->priv->key_file;
+
+    g_key_file_set_string  (key_file, group, KEY_PLUGIN, plugin_name);
+    g_key_file_set_boolean (key_file, group, KEY_AT,     mm_port_probe_is_at (probe));
+    g_key_file_set_boolean (key_file, group, KEY_QCDM,   mm_port_probe_is_qcdm (probe));
+    g_key_file_set_boolean (key_file, group, KEY_QMI,    mm_port_probe_is_qmi (probe));
+    g_key_file_set_boolean (key_file, group, KEY_MBIM,   mm_port_probe_is_mbim (probe));
+    g_key_file_set_boolean (key_file, group, KEY_ICERA,  mm_port_probe_is_icera (probe));
+    g_key_file_set_boolean (key_file, group, KEY_XMM,    mm_port_probe_is_xmm (probe));
+    if (mm_port_probe_get_vendor (probe))
+        g_key_file_set_string (key_file, group, KEY_VENDOR, mm_port_probe_get_vendor (probe));
+    if (mm_port_probe_get_product (probe))
+        g_key_file_set_string (key_file, group, KEY_PRODUCT, mm_port_probe_get_product (probe));
+}
+
+void
+mm_probe_cache_update (MMProbeCache *self,
+                       GList        *probes,
+                       const gchar  *plugin_name)
+{
+    g_autofree gchar *prefix = NULL;
+    gboolean          updated = FALSE;
+    GList            *l;
+
+    if (!probes)
+        return;
+
+    prefix = build_group_prefix (mm_port_probe_peek_port (MM_PORT_PROBE (probes->data)));
+    if (!prefix)
+        return;
+
+    /* If any of the cached ports doesn't match the new results, the whole
+     * device is invalidated. The results we got in this run were partially
+     * loaded from the cache, so they aren't stored either; the next time the
+     * device is found it will be fully probed. */
+    for (l = probes; l; l = g_list_next (l)) {
+        MMPortProbe      *probe = MM_PORT_PROBE (l->data);
+        g_autofree gchar *group = NULL;
+
+        group = build_group_name (mm_port_probe_peek_port (probe));
+        if (group &&
+            g_key_file_has_group (self->priv->key_file, group) &&
+            !probe_matches_group (self, probe, group, plugin_name)) {
+            mm_obj_info (self, "probing results of port %s don't match the cached ones: invalidating device",
+                         mm_port_probe_get_port_name (probe));
+            probe_cache_invalidate (self, prefix);
+            probe_cache_save (self);
+            return;
+        }
+    }
+
+    /* Add the ports not cached yet */
+    for (l = probes; l; l = g_list_next (l)) {
+        MMPortProbe      *probe = MM_PORT_PROBE (l->data);
+        g_autofree gchar *group = NULL;
+
+        group = build_group_name (mm_port_probe_peek_port (probe));
+        if (!group || g_key_file_has_group (self->priv->key_file, group))
+            continue;
+
+        mm_obj_dbg (self, "caching probing results of port %s", mm_port_probe_get_port_name (probe));
+        probe_to_group (self, probe, group, plugin_name);
+        updated = TRUE;
+    }
+
+    if (updated)
+        probe_cache_save (self);
+}
+
+/*****************************************************************************/
+
+static gchar *
+log_object_build_id (MMLogObject *_self)
+{
+    return g_strdup ("probe-cache");
+}
+
+/*****************************************************************************/
+
+MMProbeCache *
+mm_probe_cache_new (const gchar *path)
+{
+    MMProbeCache      *self;
+    g_autoptr(GError)  error = NULL;
+
+    g_assert (path);
+
+    self = g_object_new (MM_TYPE_PROBE_CACHE, NULL);
+    self->priv->path = g_strdup (path);
+    self->priv->key_file = g_key_file_new ();
+
+    if (!g_key_file_load_from_file (self->priv->key_file, path, G_KEY_FILE_NONE, &error)) {
+        if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+            mm_obj_warn (self, "couldn't load probe cache from '%s': %s", path, error->message);
+    } else {
+        g_auto(GStrv) groups = NULL;
+
+        groups = g_key_file_get_groups (self->priv->key_file, NULL);
+        mm_obj_dbg (self, "loaded %u cached port probing results from '%s'",
+                    groups ? g_strv_length (groups) : 0, path);
+    }
+
+    return self;
+}
+
+static void
+mm_probe_cache_init (MMProbeCache *self)
+{
+    self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_PROBE_CACHE, MMProbeCachePrivate);
+}
+
+static void
+finalize (GObject *object)
+{
+    MMProbeCache *self = MM_PROBE_CACHE (object);
+
+    g_free (self->priv->path);
+    g_clear_pointer (&self->priv->key_file, g_key_file_unref);
+
+    G_OBJECT_CLASS (mm_probe_cache_parent_class)->finalize (object);
+}
+
+static void
+log_object_iface_init (MMLogObjectInterface *iface)
+{
+    iface->build_id = log_object_build_id;
+}
+
+static void
+mm_probe_cache_class_init (MMProbeCacheClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (object_class, sizeof (MMProbeCachePrivate));
+
+    object_class->finalize = finalize;
+}
@@ -0,0 +1,57 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_PROBE_CACHE_H
+#define MM_PROBE_CACHE_H
+
+#include <glib-object.h>
+
+#include "mm-port-probe.h"
+
+#define MM_TYPE_PROBE_CACHE            (mm_probe_cache_get_type ())
+#define MM_PROBE_CACHE(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_PROBE_CACHE, MMProbeCache))
+#define MM_PROBE_CACHE_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), MM_TYPE_PROBE_CACHE, MMProbeCacheClass))
+#define MM_IS_PROBE_CACHE(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_PROBE_CACHE))
+#define MM_IS_PROBE_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), MM_TYPE_PROBE_CACHE))
+#define MM_PROBE_CACHE_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj), MM_TYPE_PROBE_CACHE, MMProbeCacheClass))
+
+typedef struct _MMProbeCachePrivate MMProbeCachePrivate;
+
+typedef struct {
+    GObject              parent;
+    MMProbeCachePrivate *priv;
+} MMProbeCache;
+
+typedef struct {
+    GObjectClass parent;
+} MMProbeCacheClass;
+
+GType mm_probe_cache_get_type (void);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMProbeCache, g_object_unref)
+
+MMProbeCache *mm_probe_cache_new (const gchar *path);
+
+/* Preload the cached probing results in the given port probe, if any. The
+ * probing step that would confirm the port type is left pending, so that it
+ * runs as a single validation request. Returns the name of the plugin that
+ * managed the port, if known. */
+const gchar *mm_probe_cache_apply (MMProbeCache *self,
+                                   MMPortProbe  *probe);
+
+/* Store the probing results of all the given ports, or invalidate the cached
+ * ones if they don't match. */
+void mm_probe_cache_update (MMProbeCache *self,
+                            GList        *probes,
+                            const gchar  *plugin_name);
+
+#endif /* MM_PROBE_CACHE_H */
@@ -18,6 +18,7 @@
 #include <stdlib.h>
 
 #include "mm-error-helpers.h"
+#include "mm-modem-helpers.h"
 #include "mm-serial-parsers.h"
 #include "mm-log-object.h"
 
@@ -79,6 +80,298 @@ remove_matches (GRegex *r, GString *string)
     g_free (str);
 }
 
+/*****************************************************************************/
+/* Line scanner
+ *
+ * Final result codes are always reported as full lines, so instead of running
+ * every regex over the whole accumulated response each time new data arrives,
+ * we keep track of the line boundaries found so far and classify each line only
+ * once, when it gets completed. The classification result is cached until the
+ * response is fully consumed.
+ */
+
+typedef enum {
+    RESPONSE_CLASS_NONE,
+    RESPONSE_CLASS_OK,
+    RESPONSE_CLASS_CONNECT,
+    RESPONSE_CLASS_CME_ERROR,
+    RESPONSE_CLASS_CMS_ERROR,
+    RESPONSE_CLASS_CME_ERROR_STR,
+    RESPONSE_CLASS_CMS_ERROR_STR,
+    RESPONSE_CLASS_EZX_ERROR,
+    RESPONSE_CLASS_UNKNOWN_ERROR,
+    RESPONSE_CLASS_CONNECT_FAILED,
+    RESPONSE_CLASS_NA,
+    RESPONSE_CLASS_LAST
+} ResponseClass;
+
+typedef enum {
+    /* Full line must be equal to the token */
+    MATCH_EXACT,
+    /* Full line must start with the token */
+    MATCH_PREFIX,
+    /* Line must start with the token, even if not yet completed */
+    MATCH_PREFIX_PARTIAL,
+    /* Full line must end with the token */
+    MATCH_SUFFIX,
+} MatchMode;
+
+typedef struct {
+    const gchar   *token;
+    MatchMode      mode;
+    ResponseClass  klass;
+} FinalResultCode;
+
+/* The match modes mimic the original regular expressions, e.g. a line starting
+ * with ERROR is considered a final error even if the line is not completed */
+static const FinalResultCode final_result_codes[] = {
+    { "OK",                  MATCH_EXACT,          RESPONSE_CLASS_OK             },
+    { "CONNECT",             MATCH_PREFIX,         RESPONSE_CLASS_CONNECT        },
+    { "+CME ERROR:",         MATCH_PREFIX,         RESPONSE_CLASS_CME_ERROR      },
+    { "+CMS ERROR:",         MATCH_PREFIX,         RESPONSE_CLASS_CMS_ERROR      },
+    { "MODEM ERROR:",        MATCH_PREFIX,         RESPONSE_CLASS_EZX_ERROR      },
+    { "ERROR",               MATCH_PREFIX_PARTIAL, RESPONSE_CLASS_UNKNOWN_ERROR  },
+    { "COMMAND NOT SUPPORT", MATCH_SUFFIX,         RESPONSE_CLASS_UNKNOWN_ERROR  },
+    { "NO CARRIER",          MATCH_PREFIX_PARTIAL, RESPONSE_CLASS_CONNECT_FAILED },
+    { "BUSY",                MATCH_PREFIX_PARTIAL, RESPONSE_CLASS_CONNECT_FAILED },
+    { "NO ANSWER",           MATCH_PREFIX_PARTIAL, RESPONSE_CLASS_CONNECT_FAILED },
+    { "NO DIALTONE",         MATCH_SUFFIX,         RESPONSE_CLASS_CONNECT_FAILED },
+    /* Samsung Z810 may reply "NA" to report a not-available error */
+    { "NA",                  MATCH_EXACT,          RESPONSE_CLASS_NA             },
+};
+
+typedef struct {
+    gsize start;
+    gsize len;
+} LineRange;
+
+typedef struct {
+    /* Copy of the response contents already scanned, used to detect whether
+     * the response buffer was modified (e.g. URCs or echo removed) between
+     * parse operations */
+    GByteArray *scanned;
+    /* Offset where to look for the next <CR><LF> */
+    gsize       search_from;
+    /* Start of the line not yet completed, if any */
+    gboolean    line_started;
+    gsize       line_start;
+    /* First complete line found for each response class */
+    gboolean    found[RESPONSE_CLASS_LAST];
+    LineRange   lines[RESPONSE_CLASS_LAST];
+} LineScanner;
+
+static void
+line_scanner_reset (LineScanner *scanner)
+{
+    g_byte_array_set_size (scanner->scanned, 0);
+    scanner->search_from = 0;
+    scanner->line_started = FALSE;
+    scanner->line_start = 0;
+    memset (scanner->found, 0, sizeof (scanner->found));
+}
+
+static gboolean
+find_crlf (const gchar *str,
+           gsize        len,
+           gsize        from,
+           gsize       *crlf)
+{
+    const gchar *p;
+
+    while (from + 1 < len) {
+        p = memchr (str + from, '\r', len - from - 1);
+        if (!p)
+            return FALSE;
+        if (p[1] == '\n') {
+            *crlf = p - str;
+            return TRUE;
+        }
+        from = (p - str) + 1;
+    }
+    return FALSE;
+}
+
+static gboolean
+is_regex_space (gchar c)
+{
+    /* Same characters as matched by \s in the original regexes */
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v');
+}
+
+/* Returns the argument given after the final result code prefix, following the
+ * same rules as "\s*([^\n\r]+)" would. */
+static gboolean
+line_get_argument (const gchar  *line,
+                   gsize         line_len,
+                   gsize         prefix_len,
+                   const gchar **arg,
+                   gsize        *arg_len)
+{
+    gsize i;
+
+    if (line_len <= prefix_len)
+        return FALSE;
+
+    /* Skip whitespaces, but always leave at least one character */
+    for (i = prefix_len; (i + 1 < line_len) && is_regex_space (line[i]); i++);
+
+    *arg = &line[i];
+    *arg_len = line_len - i;
+    return TRUE;
+}
+
+static gboolean
+argument_is_numeric (const gchar *arg,
+                     gsize        arg_len)
+{
+    gsize i;
+
+    for (i = 0; i < arg_len; i++) {
+        if (!g_ascii_isdigit (arg[i]))
+            return FALSE;
+    }
+    return (arg_len > 0);
+}
+
+static ResponseClass
+classify_line (const gchar *line,
+               gsize        line_len,
+               gboolean     complete)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (final_result_codes); i++) {
+        const FinalResultCode *code = &final_result_codes[i];
+        gsize                  token_len;
+        const gchar           *arg;
+        gsize                  arg_len;
+
+        if (!complete && code->mode != MATCH_PREFIX_PARTIAL)
+            continue;
+
+        token_len = strlen (code->token);
+        if (line_len < token_len)
+            continue;
+
+        switch (code->mode) {
+        case MATCH_EXACT:
+            if (line_len != token_len || memcmp (line, code->token, token_len) != 0)
+                continue;
+            break;
+        case MATCH_PREFIX:
+        case MATCH_PREFIX_PARTIAL:
+            if (memcmp (line, code->token, token_len) != 0)
+                continue;
+            break;
+        case MATCH_SUFFIX:
+            if (memcmp (line + line_len - token_len, code->token, token_len) != 0)
+                continue;
+            break;
+        default:
+            g_assert_not_reached ();
+        }
+
+        /* Errors with arguments need some further validation */
+        switch (code->klass) {
+        case RESPONSE_CLASS_CME_ERROR:
+        case RESPONSE_CLASS_CMS_ERROR:
+            if (!line_get_argument (line, line_len, token_len, &arg, &arg_len))
+                return RESPONSE_CLASS_NONE;
+            if (argument_is_numeric (arg, arg_len))
+                return code->klass;
+            return (code->klass == RESPONSE_CLASS_CME_ERROR ?
+                    RESPONSE_CLASS_CME_ERROR_STR :
+                    RESPONSE_CLASS_CMS_ERROR_STR);
+        case RESPONSE_CLASS_EZX_ERROR:
+            if (!line_get_argument (line, line_len, token_len, &arg, &arg_len) ||
+                !argument_is_numeric (arg, arg_len))
+                return RESPONSE_CLASS_NONE;
+            return code->klass;
+        default:
+            return code->klass;
+        }
+    }
+
+    return RESPONSE_CLASS_NONE;
+}
+
+static void
+line_scanner_update (LineScanner *scanner,
+                     GString     *response)
+{
+    gsize crlf;
+
+    /* If the previously scanned contents are no longer the prefix of the
+     * response, we need to scan everything again */
+    if ((response->len < scanner->scanned->len) ||
+        (memcmp (response->str, scanner->scanned->data, scanner->scanned->len) != 0))
+        line_scanner_reset (scanner);
+
+    g_byte_array_append (scanner->scanned,
+                         (const guint8 *) &response->str[scanner->scanned->len],
+                         response->len - scanner->scanned->len);
+
+    /* Only lines completed since the last update are classified */
+    while (find_crlf (response->str, response->len, scanner->search_from, &crlf)) {
+        if (scanner->line_started) {
+            ResponseClass klass;
+
+            klass = classify_line (&response->str[scanner->line_start],
+                                   crlf - scanner->line_start,
+                                   TRUE);
+            if (klass != RESPONSE_CLASS_NONE && !scanner->found[klass]) {
+                scanner->found[klass] = TRUE;
+                scanner->lines[klass].start = scanner->line_start;
+                scanner->lines[klass].len = crlf - scanner->line_start;
+            }
+        }
+        scanner->line_started = TRUE;
+        scanner->line_start = crlf + 2;
+        scanner->search_from = crlf + 2;
+    }
+
+    /* The last character may be the <CR> of a <CR><LF> not yet received */
+    if (response->len > 0)
+        scanner->search_from = MAX (scanner->search_from, response->len - 1);
+}
+
+/* Like "\r\n>\s*$" */
+static gboolean
+response_has_sms_prompt (GString *response)
+{
+    gssize i;
+
+    for (i = (gssize) response->len - 1; i >= 0 && is_regex_space (response->str[i]); i--);
+
+    return (i >= 2 &&
+            response->str[i] == '>' &&
+            response->str[i - 1] == '\n' &&
+            response->str[i - 2] == '\r');
+}
+
+/* Like removing all matches of "\r\nOK(\r\n)+" */
+static void
+remove_ok_lines (GString *response)
+{
+    gsize i = 0;
+
+    while (i + 6 <= response->len) {
+        gsize end;
+
+        if (memcmp (&response->str[i], "\r\nOK\r\n", 6) != 0) {
+            i++;
+            continue;
+        }
+
+        end = i + 6;
+        while ((end + 2 <= response->len) && response->str[end] == '\r' && response->str[end + 1] == '\n')
+            end += 2;
+        g_string_erase (response, i, end - i);
+    }
+}
+
+/*****************************************************************************/
+
 typedef struct {
     /* Regular expressions for successful replies */
     GRegex *regex_ok;
@@ -98,6 +391,9 @@ typedef struct {
     /* User-provided parser filter */
     mm_serial_parser_v1_filter_fn filter_callback;
     gpointer                      filter_user_data;
+    /* Line scanner, used instead of the builtin regexes if enabled */
+    gboolean    line_scanner_enabled;
+    LineScanner line_scanner;
 } MMSerialParserV1;
 
 gpointer
@@ -108,24 +404,28 @@ mm_serial_parser_v1_new (void)
 
     parser = g_slice_new (MMSerialParserV1);
 
-    parser->regex_ok = g_regex_new ("\\r\\nOK(\\r\\n)+", flags, 0, NULL);
-    parser->regex_connect = g_regex_new ("\\r\\nCONNECT.*\\r\\n", flags, 0, NULL);
-    parser->regex_sms = g_regex_new ("\\r\\n>\\s*$", flags, 0, NULL);
-    parser->regex_cme_error = g_regex_new ("\\r\\n\\+CME ERROR:\\s*(\\d+)\\r\\n", flags, 0, NULL);
-    parser->regex_cms_error = g_regex_new ("\\r\\n\\+CMS ERROR:\\s*(\\d+)\\r\\n", flags, 0, NULL);
-    parser->regex_cme_error_str = g_regex_new ("\\r\\n\\+CME ERROR:\\s*([^\\n\\r]+)\\r\\n", flags, 0, NULL);
-    parser->regex_cms_error_str = g_regex_new ("\\r\\n\\+CMS ERROR:\\s*([^\\n\\r]+)\\r\\n", flags, 0, NULL);
-    parser->regex_ezx_error = g_regex_new ("\\r\\nMODEM ERROR:\\s*(\\d+)\\r\\n", flags, 0, NULL);
-    parser->regex_unknown_error = g_regex_new ("\\r\\n(ERROR)|(COMMAND NOT SUPPORT)\\r\\n", flags, 0, NULL);
-    parser->regex_connect_failed = g_regex_new ("\\r\\n(NO CARRIER)|(BUSY)|(NO ANSWER)|(NO DIALTONE)\\r\\n", flags, 0, NULL);
+    parser->regex_ok = mm_regex_cache_get ("\\r\\nOK(\\r\\n)+", flags, 0, NULL);
+    parser->regex_connect = mm_regex_cache_get ("\\r\\nCONNECT.*\\r\\n", flags, 0, NULL);
+    parser->regex_sms = mm_regex_cache_get ("\\r\\n>\\s*$", flags, 0, NULL);
+    parser->regex_cme_error = mm_regex_cache_get ("\\r\\n\\+CME ERROR:\\s*(\\d+)\\r\\n", flags, 0, NULL);
+    parser->regex_cms_error = mm_regex_cache_get ("\\r\\n\\+CMS ERROR:\\s*(\\d+)\\r\\n", flags, 0, NULL);
+    parser->regex_cme_error_str = mm_regex_cache_get ("\\r\\n\\+CME ERROR:\\s*([^\\n\\r]+)\\r\\n", flags, 0, NULL);
+    parser->regex_cms_error_str = mm_regex_cache_get ("\\r\\n\\+CMS ERROR:\\s*([^\\n\\r]+)\\r\\n", flags, 0, NULL);
+    parser->regex_ezx_error = mm_regex_cache_get ("\\r\\nMODEM ERROR:\\s*(\\d+)\\r\\n", flags, 0, NULL);
+    parser->regex_unknown_error = mm_regex_cache_get ("\\r\\n(ERROR)|(COMMAND NOT SUPPORT)\\r\\n", flags, 0, NULL);
+    parser->regex_connect_failed = mm_regex_cache_get ("\\r\\n(NO CARRIER)|(BUSY)|(NO ANSWER)|(NO DIALTONE)\\r\\n", flags, 0, NULL);
     /* Samsung Z810 may reply "NA" to report a not-available error */
-    parser->regex_na = g_regex_new ("\\r\\nNA\\r\\n", flags, 0, NULL);
+    parser->regex_na = mm_regex_cache_get ("\\r\\nNA\\r\\n", flags, 0, NULL);
 
     parser->regex_custom_successful = NULL;
     parser->regex_custom_error = NULL;
     parser->filter_callback = NULL;
     parser->filter_user_data = NULL;
 
+    parser->line_scanner_enabled = TRUE;
+    parser->line_scanner.scanned = g_byte_array_sized_new (500);
+    line_scanner_reset (&parser->line_scanner);
+
     return parser;
 }
 
@@ -160,42 +460,187 @@ mm_serial_parser_v1_add_filter (gpointer data,
     parser->filter_user_data = user_data;
 }
 
-gboolean
-mm_serial_parser_v1_parse (gpointer   data,
-                           GString   *response,
-                           gpointer   log_object,
-                           GError   **error)
+void
+mm_serial_parser_v1_set_line_scanner (gpointer data,
+                                      gboolean enable)
 {
     MMSerialParserV1 *parser = (MMSerialParserV1 *) data;
-    GMatchInfo *match_info = NULL;
-    GError *local_error = NULL;
-    gboolean found = FALSE;
-    char *str = NULL;
 
-    g_return_val_if_fail (parser != NULL, FALSE);
-    g_return_val_if_fail (response != NULL, FALSE);
+    g_return_if_fail (parser != NULL);
 
-    /* Skip NUL bytes if they are found leading the response */
-    while (response->len > 0 && response->str[0] == '\0')
-        g_string_erase (response, 0, 1);
+    parser->line_scanner_enabled = enable;
+    line_scanner_reset (&parser->line_scanner);
+}
 
-    if (G_UNLIKELY (!response->len))
-        return FALSE;
+static MMConnectionError
+connection_error_for_line (const gchar *line,
+                           gsize        line_len)
+{
+    if (line_len >= 10 && !memcmp (line, "NO CARRIER", 10))
+        return MM_CONNECTION_ERROR_NO_CARRIER;
+    if (line_len >= 4 && !memcmp (line, "BUSY", 4))
+        return MM_CONNECTION_ERROR_BUSY;
+    if (line_len >= 9 && !memcmp (line, "NO ANSWER", 9))
+        return MM_CONNECTION_ERROR_NO_ANSWER;
+    if (line_len >= 11 && !memcmp (line + line_len - 11, "NO DIALTONE", 11))
+        return MM_CONNECTION_ERROR_NO_DIALTONE;
+    /* uhm... make something up (yes, ok, lie!). */
+    return MM_CONNECTION_ERROR_NO_CARRIER;
+}
 
-    /* First, apply custom filter if any */
-    if (parser->filter_callback &&
-        !parser->filter_callback (parser,
-                                  parser->filter_user_data,
-                                  response,
-                                  &local_error)) {
-        g_assert (local_error != NULL);
-        mm_obj_dbg (log_object, "response filtered in serial port: %s", local_error->message);
-        g_propagate_error (error, local_error);
+static gboolean
+parse_line_scanner (MMSerialParserV1  *parser,
+                    GString           *response,
+                    gpointer           log_object,
+                    GError           **error)
+{
+    LineScanner   *scanner = &parser->line_scanner;
+    GMatchInfo    *match_info = NULL;
+    GError        *local_error = NULL;
+    gboolean       found = FALSE;
+    ResponseClass  tail_class = RESPONSE_CLASS_NONE;
+    ResponseClass  klass;
+    gchar         *str = NULL;
+    const gchar   *line;
+    gsize          line_len;
+    static const ResponseClass error_classes[] = {
+        RESPONSE_CLASS_CME_ERROR,
+        RESPONSE_CLASS_CMS_ERROR,
+        RESPONSE_CLASS_CME_ERROR_STR,
+        RESPONSE_CLASS_CMS_ERROR_STR,
+        RESPONSE_CLASS_EZX_ERROR,
+        RESPONSE_CLASS_UNKNOWN_ERROR,
+        RESPONSE_CLASS_CONNECT_FAILED,
+        RESPONSE_CLASS_NA,
+    };
+    guint          i;
+
+    line_scanner_update (scanner, response);
+
+    /* The line not yet completed may already be a final error */
+    if (scanner->line_started && scanner->line_start < response->len)
+        tail_class = classify_line (&response->str[scanner->line_start],
+                                    response->len - scanner->line_start,
+                                    FALSE);
+
+    /* Custom successful replies first, if any */
+    if (parser->regex_custom_successful) {
+        found = g_regex_match_full (parser->regex_custom_successful,
+                                    response->str, response->len,
+                                    0, 0, NULL, NULL);
+    }
+
+    if (!found && scanner->found[RESPONSE_CLASS_OK]) {
+        remove_ok_lines (response);
+        found = TRUE;
+    }
+
+    if (!found)
+        found = scanner->found[RESPONSE_CLASS_CONNECT];
+
+    if (!found)
+        found = response_has_sms_prompt (response);
+
+    if (found) {
+        line_scanner_reset (scanner);
         response_clean (response);
         return TRUE;
     }
 
-    /* Then, check for successful responses */
+    /* Custom error matches first, if any */
+    if (parser->regex_custom_error) {
+        found = g_regex_match_full (parser->regex_custom_error,
+                                    response->str, response->len,
+                                    0, 0, &match_info, NULL);
+        if (found) {
+            str = g_match_info_fetch (match_info, 1);
+            g_assert (str);
+            local_error = mm_mobile_equipment_error_for_code (atoi (str), log_object);
+            goto done;
+        }
+        g_clear_pointer (&match_info, g_match_info_free);
+    }
+
+    for (i = 0; i < G_N_ELEMENTS (error_classes); i++) {
+        const gchar *arg;
+        gsize        arg_len;
+
+        klass = error_classes[i];
+        if (scanner->found[klass]) {
+            line = &response->str[scanner->lines[klass].start];
+            line_len = scanner->lines[klass].len;
+        } else if (tail_class == klass) {
+            line = &response->str[scanner->line_start];
+            line_len = response->len - scanner->line_start;
+        } else
+            continue;
+
+        found = TRUE;
+        switch (klass) {
+        case RESPONSE_CLASS_CME_ERROR:
+        case RESPONSE_CLASS_CMS_ERROR:
+        case RESPONSE_CLASS_CME_ERROR_STR:
+        case RESPONSE_CLASS_CMS_ERROR_STR:
+            /* All these prefixes have the same length */
+            line_get_argument (line, line_len, strlen ("+CME ERROR:"), &arg, &arg_len);
+            str = g_strndup (arg, arg_len);
+            if (klass == RESPONSE_CLASS_CME_ERROR)
+                local_error = mm_mobile_equipment_error_for_code (atoi (str), log_object);
+            else if (klass == RESPONSE_CLASS_CMS_ERROR)
+                local_error = mm_message_error_for_code (atoi (str), log_object);
+            else if (klass == RESPONSE_CLASS_CME_ERROR_STR)
+                local_error = mm_mobile_equipment_error_for_string (str, log_object);
+            else
+                local_error = mm_message_error_for_string (str, log_object);
+            break;
+        case RESPONSE_CLASS_EZX_ERROR:
+        case RESPONSE_CLASS_UNKNOWN_ERROR:
+            local_error = mm_mobile_equipment_error_for_code (MM_MOBILE_EQUIPMENT_ERROR_UNKNOWN, log_object);
+            break;
+        case RESPONSE_CLASS_CONNECT_FAILED:
+            local_error = mm_connection_error_for_code (connection_error_for_line (line, line_len), log_object);
+            break;
+        case RESPONSE_CLASS_NA:
+            /* Assume NA means 'Not Allowed' :) */
+            local_error = g_error_new (MM_MOBILE_EQUIPMENT_ERROR,
+                                       MM_MOBILE_EQUIPMENT_ERROR_NOT_ALLOWED,
+                                       "Not Allowed");
+            break;
+        default:
+            g_assert_not_reached ();
+        }
+        break;
+    }
+
+done:
+    g_free (str);
+    g_clear_pointer (&match_info, g_match_info_free);
+
+    if (found) {
+        line_scanner_reset (scanner);
+        response_clean (response);
+    }
+
+    if (local_error) {
+        mm_obj_dbg (log_object, "operation failure: %d (%s)", local_error->code, local_error->message);
+        g_propagate_error (error, local_error);
+    }
+
+    return found;
+}
+
+static gboolean
+parse_regex (MMSerialParserV1  *parser,
+             GString           *response,
+             gpointer           log_object,
+             GError           **error)
+{
+    GMatchInfo *match_info = NULL;
+    GError *local_error = NULL;
+    gboolean found = FALSE;
+    char *str = NULL;
+
+    /* Check for successful responses */
 
     /* Custom successful replies first, if any */
     if (parser->regex_custom_successful) {
@@ -370,6 +815,45 @@ done:
     return found;
 }
 
+gboolean
+mm_serial_parser_v1_parse (gpointer   data,
+                           GString   *response,
+                           gpointer   log_object,
+                           GError   **error)
+{
+    MMSerialParserV1 *parser = (MMSerialParserV1 *) data;
+    GError *local_error = NULL;
+
+    g_return_val_if_fail (parser != NULL, FALSE);
+    g_return_val_if_fail (response != NULL, FALSE);
+
+    /* Skip NUL bytes if they are found leading the response */
+    while (response->len > 0 && response->str[0] == '\0')
+        g_string_erase (response, 0, 1);
+
+    if (G_UNLIKELY (!response->len))
+        return FALSE;
+
+    /* First, apply custom filter if any */
+    if (parser->filter_callback &&
+        !parser->filter_callback (parser,
+                                  parser->filter_user_data,
+                                  response,
+                                  &local_error)) {
+        g_assert (local_error != NULL);
+        mm_obj_dbg (log_object, "response filtered in serial port: %s", local_error->message);
+        g_propagate_error (error, local_error);
+        line_scanner_reset (&parser->line_scanner);
+        response_clean (response);
+        return TRUE;
+    }
+
+    if (parser->line_scanner_enabled)
+        return parse_line_scanner (parser, response, log_object, error);
+
+    return parse_regex (parser, response, log_object, error);
+}
+
 gboolean
 mm_serial_parser_v1_is_known_error (const GError *error)
 {
@@ -404,5 +888,7 @@ mm_serial_parser_v1_destroy (gpointer data)
     if (parser->regex_custom_error)
         g_regex_unref (parser->regex_custom_error);
 
+    g_byte_array_unref (parser->line_scanner.scanned);
+
     g_slice_free (MMSerialParserV1, data);
 }
@@ -39,4 +39,10 @@ void     mm_serial_parser_v1_add_filter (gpointer data,
                                          mm_serial_parser_v1_filter_fn callback,
                                          gpointer user_data);
 
+/* The incremental line scanner is enabled by default; disabling it makes the
+ * parser fall back to matching the builtin regexes over the whole response.
+ * Just for unit tests and benchmarks. */
+void     mm_serial_parser_v1_set_line_scanner (gpointer data,
+                                               gboolean enable);
+
 #endif /* MM_SERIAL_PARSERS_H */
@@ -0,0 +1,131 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include "mm-signal-history.h"
+
+typedef struct {
+    guint64   sequence;
+    gint64    timestamp;
+    GVariant *dictionary;
+} Sample;
+
+struct _MMSignalHistory {
+    Sample  *samples;
+    guint    size;
+    guint    next;
+    guint64  sequence;
+};
+
+/*****************************************************************************/
+
+static void
+sample_builder_add_signal (GVariantBuilder *builder,
+                           const gchar     *key,
+                           MMSignal        *signal)
+{
+    g_autoptr(GVariant) dictionary = NULL;
+
+    if (!signal)
+        return;
+
+    dictionary = mm_signal_get_dictionary (signal);
+    g_variant_builder_add (builder, "{sv}", key, dictionary);
+}
+
+guint64
+mm_signal_history_add (MMSignalHistory *self,
+                       gint64           timestamp,
+                       MMSignal        *cdma,
+                       MMSignal        *evdo,
+                       MMSignal        *gsm,
+                       MMSignal        *umts,
+                       MMSignal        *lte,
+                       MMSignal        *nr5g)
+{
+    GVariantBuilder  builder;
+    Sample          *sample;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    sample_builder_add_signal (&builder, "cdma", cdma);
+    sample_builder_add_signal (&builder, "evdo", evdo);
+    sample_builder_add_signal (&builder, "gsm",  gsm);
+    sample_builder_add_signal (&builder, "umts", umts);
+    sample_builder_add_signal (&builder, "lte",  lte);
+    sample_builder_add_signal (&builder, "nr5g", nr5g);
+
+    /* Overwrite the oldest sample */
+    sample = &self->samples[self->next];
+    if (sample->dictionary)
+        g_variant_unref (sample->dictionary);
+    sample->sequence = ++self->sequence;
+    sample->timestamp = timestamp;
+    sample->dictionary = g_variant_ref_sink (g_variant_builder_end (&builder));
+
+    self->next = (self->next + 1) % self->size;
+    return sample->sequence;
+}
+
+GVariant *
+mm_signal_history_build_list (MMSignalHistory *self,
+                              guint64          since)
+{
+    GVariantBuilder builder;
+    guint           i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(txa{sv})"));
+
+    /* Walk from the oldest sample to the newest one */
+    for (i = 0; i < self->size; i++) {
+        Sample *sample;
+
+        sample = &self->samples[(self->next + i) % self->size];
+        if (!sample->dictionary || sample->sequence <= since)
+            continue;
+        g_variant_builder_add (&builder, "(tx@a{sv})",
+                               sample->sequence,
+                               sample->timestamp,
+                               sample->dictionary);
+    }
+
+    return g_variant_builder_end (&builder);
+}
+
+/*****************************************************************************/
+
+MMSignalHistory *
+mm_signal_history_new (guint size)
+{
+    MMSignalHistory *self;
+
+    g_assert (size > 0);
+
+    self = g_slice_new0 (MMSignalHistory);
+    self->size = size;
+    self->samples = g_new0 (Sample, size);
+    return self;
+}
+
+void
+mm_signal_history_free (MMSignalHistory *self)
+{
+    guint i;
+
+    for (i = 0; i < self->size; i++) {
+        if (self->samples[i].dictionary)
+            g_variant_unref (self->samples[i].dictionary);
+    }
+    g_free (self->samples);
+    g_slice_free (MMSignalHistory, self);
+}
@@ -0,0 +1,49 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_SIGNAL_HISTORY_H
+#define MM_SIGNAL_HISTORY_H
+
+#include <glib.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+/* Fixed size history of extended signal information samples, kept as a ring
+ * buffer where new samples overwrite the oldest ones. Each sample gets a
+ * sequence number, starting at 1, so that clients can ask for the samples
+ * they haven't seen yet. */
+typedef struct _MMSignalHistory MMSignalHistory;
+
+/* Number of samples kept in the modem history, e.g. 1 minute at 100ms */
+#define MM_SIGNAL_HISTORY_SIZE 600
+
+MMSignalHistory *mm_signal_history_new        (guint             size);
+void             mm_signal_history_free       (MMSignalHistory  *self);
+
+/* Returns the sequence number given to the new sample */
+guint64          mm_signal_history_add        (MMSignalHistory  *self,
+                                               gint64            timestamp,
+                                               MMSignal         *cdma,
+                                               MMSignal         *evdo,
+                                               MMSignal         *gsm,
+                                               MMSignal         *umts,
+                                               MMSignal         *lte,
+                                               MMSignal         *nr5g);
+
+/* Samples newer than the given sequence number, from the oldest to the
+ * newest one, as a floating 'a(txa{sv})' variant */
+GVariant        *mm_signal_history_build_list (MMSignalHistory  *self,
+                                               guint64           since);
+
+#endif /* MM_SIGNAL_HISTORY_H */
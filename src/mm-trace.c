@@ -0,0 +1,313 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <config.h>
+
+#include <unistd.h>
+
+#include <gio/gio.h>
+
+#include "mm-log-object.h"
+#include "mm-log.h"
+#include "mm-trace.h"
+
+/* Once the limit is reached new events are discarded, the beginning of the
+ * trace is the interesting part when looking at bring-up times */
+#define MAX_EVENTS 200000
+
+/* Events are appended to the trace file as they are recorded, through a
+ * buffered stream that is flushed periodically. The file uses the JSON array
+ * format, where the closing bracket is optional, so that it can be loaded
+ * even if the daemon didn't exit cleanly. */
+#define BUFFER_SIZE        (64 * 1024)
+#define FLUSH_TIMEOUT_SECS 2
+
+#define DAEMON_TRACK "daemon"
+
+typedef struct {
+    guint  step;
+    gint64 step_start_time;
+    gint64 start_time;
+} MachineContext;
+
+static gchar         *trace_file;
+static GOutputStream *trace_stream;
+static gint64         trace_start_time;
+static guint          trace_pid;
+static guint          n_events;
+static GHashTable    *tracks;   /* track name -> tid */
+static GHashTable    *machines; /* track|machine -> MachineContext */
+static guint          flush_id;
+static gboolean       overflow;
+
+/*****************************************************************************/
+
+static void
+append_json_string (GString     *str,
+                    const gchar *value)
+{
+    const guchar *p;
+
+    g_string_append_c (str, '"');
+    for (p = (const guchar *) value; *p; p++) {
+        if (*p == '"' || *p == '\\')
+            g_string_append_printf (str, "\\%c", *p);
+        else if (*p < 0x20 || *p >= 0x7f)
+            g_string_append_printf (str, "\\u%04x", *p);
+        else
+            g_string_append_c (str, *p);
+    }
+    g_string_append_c (str, '"');
+}
+
+static void
+trace_write (GString *str)
+{
+    g_autoptr(GError) error = NULL;
+
+    if (!trace_stream)
+        return;
+
+    /* Only copied to the buffer unless it's full */
+    if (!g_output_stream_write_all (trace_stream, str->str, str->len, NULL, NULL, &error)) {
+        mm_obj_warn (NULL, "couldn't write trace file '%s': %s", trace_file, error->message);
+        g_clear_object (&trace_stream);
+    }
+}
+
+static gboolean
+flush_cb (void)
+{
+    g_autoptr(GError) error = NULL;
+
+    flush_id = 0;
+    if (trace_stream && !g_output_stream_flush (trace_stream, NULL, &error)) {
+        mm_obj_warn (NULL, "couldn't write trace file '%s': %s", trace_file, error->message);
+        g_clear_object (&trace_stream);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_flush (void)
+{
+    if (!flush_id)
+        flush_id = g_timeout_add_seconds (FLUSH_TIMEOUT_SECS, (GSourceFunc) flush_cb, NULL);
+}
+
+static const gchar *
+get_track (gpointer obj)
+{
+    return obj ? mm_log_object_get_id (MM_LOG_OBJECT (obj)) : DAEMON_TRACK;
+}
+
+static guint
+get_tid (const gchar *track)
+{
+    gpointer tid;
+
+    tid = g_hash_table_lookup (tracks, track);
+    if (!tid) {
+        g_autoptr(GString) str = NULL;
+
+        tid = GUINT_TO_POINTER (g_hash_table_size (tracks) + 1);
+        g_hash_table_insert (tracks, g_strdup (track), tid);
+
+        str = g_string_new (NULL);
+        g_string_append_printf (str, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":",
+                                trace_pid, GPOINTER_TO_UINT (tid));
+        append_json_string (str, track);
+        g_string_append (str, "}}");
+        trace_write (str);
+    }
+    return GPOINTER_TO_UINT (tid);
+}
+
+static void
+add_event (const gchar *track,
+           const gchar *category,
+           gchar       *name,
+           gint64       start_time,
+           gint64       end_time)
+{
+    g_autoptr(GString) str = NULL;
+    guint              tid;
+
+    if (n_events >= MAX_EVENTS) {
+        if (!overflow) {
+            mm_obj_warn (NULL, "too many trace events, no more will be recorded");
+            overflow = TRUE;
+        }
+        g_free (name);
+        return;
+    }
+    n_events++;
+
+    tid = get_tid (track);
+
+    str = g_string_new (",\n{\"name\":");
+    append_json_string (str, name);
+    g_string_append_printf (str,
+                            ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%" G_GINT64_FORMAT ",\"dur\":%" G_GINT64_FORMAT "}",
+                            category, trace_pid, tid, start_time - trace_start_time, end_time - start_time);
+    g_free (name);
+
+    trace_write (str);
+    schedule_flush ();
+}
+
+/*****************************************************************************/
+
+gboolean
+mm_trace_enabled (void)
+{
+    return !!trace_file;
+}
+
+void
+mm_trace_span (gpointer     obj,
+               const gchar *category,
+               const gchar *name,
+               gint64       start_time)
+{
+    if (!trace_file)
+        return;
+
+    add_event (get_track (obj), category, g_strdup (name), start_time, g_get_monotonic_time ());
+}
+
+static gchar *
+build_steps_name (const gchar *machine,
+                  guint        first_step,
+                  guint        last_step)
+{
+    if (first_step == last_step)
+        return g_strdup_printf ("%s [%u]", machine, first_step);
+    return g_strdup_printf ("%s [%u-%u]", machine, first_step, last_step);
+}
+
+void
+mm_trace_step (gpointer     obj,
+               const gchar *machine,
+               guint        step,
+               guint        last_step)
+{
+    g_autofree gchar *key = NULL;
+    const gchar      *track;
+    MachineContext   *ctx;
+    gint64            now;
+
+    if (!trace_file)
+        return;
+
+    now = g_get_monotonic_time ();
+    track = get_track (obj);
+    key = g_strdup_printf ("%s|%s", track, machine);
+
+    ctx = g_hash_table_lookup (machines, key);
+
+    /* A step being retried is still the same span */
+    if (ctx && step == ctx->step)
+        return;
+
+    /* Going back means the previous run didn't complete */
+    if (ctx && step < ctx->step) {
+        add_event (track, "step", build_steps_name (machine, ctx->step, ctx->step), ctx->step_start_time, now);
+        add_event (track, "machine", g_strdup_printf ("%s (aborted)", machine), ctx->start_time, now);
+        g_hash_table_remove (machines, key);
+        ctx = NULL;
+    }
+
+    if (!ctx) {
+        ctx = g_slice_new0 (MachineContext);
+        ctx->start_time = now;
+        g_hash_table_insert (machines, g_strdup (key), ctx);
+    } else
+        add_event (track, "step", build_steps_name (machine, ctx->step, step - 1), ctx->step_start_time, now);
+
+    ctx->step = step;
+    ctx->step_start_time = now;
+
+    if (step >= last_step) {
+        add_event (track, "machine", g_strdup (machine), ctx->start_time, now);
+        g_hash_table_remove (machines, key);
+    }
+}
+
+/*****************************************************************************/
+
+static void
+machine_context_free (MachineContext *ctx)
+{
+    g_slice_free (MachineContext, ctx);
+}
+
+gboolean
+mm_trace_setup (const gchar  *path,
+                GError      **error)
+{
+    g_autoptr(GFile)             file = NULL;
+    g_autoptr(GFileOutputStream) file_stream = NULL;
+    g_autoptr(GString)           str = NULL;
+
+    g_assert (!trace_file);
+
+    file = g_file_new_for_path (path);
+    file_stream = g_file_replace (file, NULL, FALSE, G_FILE_CREATE_NONE, NULL, error);
+    if (!file_stream)
+        return FALSE;
+
+    trace_file = g_strdup (path);
+    trace_stream = g_buffered_output_stream_new_sized (G_OUTPUT_STREAM (file_stream), BUFFER_SIZE);
+    trace_start_time = g_get_monotonic_time ();
+    trace_pid = (guint) getpid ();
+
+    str = g_string_new (NULL);
+    g_string_append_printf (str,
+                            "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"ModemManager\"}}",
+                            trace_pid);
+    trace_write (str);
+
+    tracks = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    machines = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) machine_context_free);
+    return TRUE;
+}
+
+void
+mm_trace_shutdown (void)
+{
+    if (!trace_file)
+        return;
+
+    if (flush_id) {
+        g_source_remove (flush_id);
+        flush_id = 0;
+    }
+
+    if (trace_stream) {
+        g_autoptr(GString) str = NULL;
+        g_autoptr(GError)  error = NULL;
+
+        str = g_string_new ("\n]\n");
+        trace_write (str);
+        if (trace_stream && !g_output_stream_close (trace_stream, NULL, &error))
+            mm_obj_warn (NULL, "couldn't write trace file '%s': %s", trace_file, error->message);
+        g_clear_object (&trace_stream);
+    }
+
+    g_clear_pointer (&machines, g_hash_table_unref);
+    g_clear_pointer (&tracks, g_hash_table_unref);
+    g_clear_pointer (&trace_file, g_free);
+    n_events = 0;
+    overflow = FALSE;
+}
@@ -0,0 +1,43 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#ifndef MM_TRACE_H
+#define MM_TRACE_H
+
+#include <glib.h>
+
+/* Timing trace, written in the Chrome trace event format so that it can be
+ * loaded in chrome://tracing or Perfetto. Events are grouped in one track per
+ * log object (e.g. one per modem and one per port). */
+
+gboolean mm_trace_setup    (const gchar  *trace_file,
+                            GError      **error);
+void     mm_trace_shutdown (void);
+gboolean mm_trace_enabled  (void);
+
+/* Record an operation that started at the given monotonic time and just
+ * finished */
+void mm_trace_span (gpointer     obj,
+                    const gchar *category,
+                    const gchar *name,
+                    gint64       start_time);
+
+/* Record the progress of a step machine. To be called every time the step
+ * function is run; steps run in sequence since the previous call are recorded
+ * as a single span. Reaching the last step closes the machine. */
+void mm_trace_step (gpointer     obj,
+                    const gchar *machine,
+                    guint        step,
+                    guint        last_step);
+
+#endif /* MM_TRACE_H */
@@ -15,6 +15,10 @@
 
 #include <config.h>
 #include <string.h>
+#include <pty.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
 #include <glib.h>
 
 #include "mm-port-serial-at.h"
@@ -83,6 +87,42 @@ static const ParseResponseTest parse_error_tests[] = {
     { "\r\nNO DIALTONE\r\n\r\nSomething extra\r\n", TRUE, TRUE}
 };
 
+static void
+at_serial_buffer (void)
+{
+    MMPortSerialBuffer *buffer;
+
+    buffer = mm_port_serial_buffer_new ();
+    g_assert_cmpuint (buffer->len, ==, 0);
+
+    mm_port_serial_buffer_append (buffer, (const guint8 *) "\r\nOK\r\n\r\n+CSQ", 12);
+    g_assert_cmpuint (buffer->len, ==, 12);
+
+    /* Consuming data keeps a contiguous view of the remaining contents */
+    mm_port_serial_buffer_consume (buffer, 6);
+    g_assert_cmpuint (buffer->len, ==, 6);
+    g_assert (memcmp (buffer->data, "\r\n+CSQ", 6) == 0);
+
+    /* Appending data compacts the storage if needed */
+    mm_port_serial_buffer_append (buffer, (const guint8 *) ": 20,99\r\n", 9);
+    g_assert_cmpuint (buffer->len, ==, 15);
+    g_assert (memcmp (buffer->data, "\r\n+CSQ: 20,99\r\n", 15) == 0);
+
+    mm_port_serial_buffer_consume (buffer, 2);
+    mm_port_serial_buffer_append (buffer, (const guint8 *) "\r\nOK\r\n", 6);
+    g_assert_cmpuint (buffer->len, ==, 19);
+    g_assert (memcmp (buffer->data, "+CSQ: 20,99\r\n\r\nOK\r\n", 19) == 0);
+
+    mm_port_serial_buffer_replace (buffer, (const guint8 *) "\r\nOK\r\n", 6);
+    g_assert_cmpuint (buffer->len, ==, 6);
+    g_assert (memcmp (buffer->data, "\r\nOK\r\n", 6) == 0);
+
+    mm_port_serial_buffer_consume (buffer, buffer->len);
+    g_assert_cmpuint (buffer->len, ==, 0);
+
+    mm_port_serial_buffer_free (buffer);
+}
+
 static void
 at_serial_echo_removal (void)
 {
@@ -106,6 +146,42 @@ at_serial_echo_removal (void)
     }
 }
 
+typedef struct {
+    const gchar        *pattern;
+    GRegexCompileFlags  flags;
+    const gchar        *prefix;
+} RegexPrefixTest;
+
+static const RegexPrefixTest regex_prefix_tests[] = {
+    { "\\r\\n\\+CREG: (\\d+)\\r\\n",               G_REGEX_RAW,      "+CREG: "     },
+    { "\\r\\n\\^HCSQ:\\s*\"([a-zA-Z]*)\"\\r\\n",   G_REGEX_RAW,      "^HCSQ:"      },
+    { "(?:\\r)+\\n\\+CRING:\\s*(\\S+)(?:\\r)+\\n", G_REGEX_RAW,      "+CRING:"     },
+    { "(?:\\r\\n)?(?:\\r\\n)?(\\$G.*)\\r\\n",      G_REGEX_RAW,      NULL          },
+    { "\\r\\nRING(?:\\r)?\\r\\n",                  G_REGEX_RAW,      "RING"        },
+    { "\\r\\n\\^NDISSTAT(?:QRY)?:\\s*(\\d)\\r\\n", G_REGEX_RAW,      "^NDISSTAT"   },
+    { "_OWANCALL: (\\d),\\s*(\\d)\\r\\n",          G_REGEX_RAW,      "_OWANCALL: " },
+    { "\\r\\n(NO CARRIER|BUSY|NO ANSWER)\\r\\n",   G_REGEX_RAW,      NULL          },
+    { "\\r\\n(ERROR)|(COMMAND NOT SUPPORT)\\r\\n", G_REGEX_RAW,      NULL          },
+    { "\\r\\nABCD?:",                              G_REGEX_RAW,      "ABC"         },
+    { "\\r\\n\\+CIEV: (.*),(\\d)\\r\\n",           G_REGEX_CASELESS, NULL          },
+};
+
+static void
+at_serial_regex_prefix (void)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (regex_prefix_tests); i++) {
+        g_autoptr(GRegex)  regex = NULL;
+        g_autofree gchar  *prefix = NULL;
+
+        regex = g_regex_new (regex_prefix_tests[i].pattern, regex_prefix_tests[i].flags, 0, NULL);
+        g_assert (regex);
+        prefix = mm_port_serial_at_get_regex_literal_prefix (regex);
+        g_assert_cmpstr (prefix, ==, regex_prefix_tests[i].prefix);
+    }
+}
+
 static void
 _run_parse_test (const ParseResponseTest tests[], guint number_of_tests)
 {
@@ -137,6 +213,633 @@ _run_parse_test (const ParseResponseTest tests[], guint number_of_tests)
     }
 }
 
+static void
+at_serial_parse_compare_legacy (void)
+{
+    const ParseResponseTest *all_tests[] = { parse_ok_tests, parse_error_tests };
+    const guint              n_tests[] = { G_N_ELEMENTS (parse_ok_tests), G_N_ELEMENTS (parse_error_tests) };
+    guint                    i;
+    guint                    j;
+
+    for (i = 0; i < G_N_ELEMENTS (all_tests); i++) {
+        for (j = 0; j < n_tests[i]; j++) {
+            gpointer  scanner_parser;
+            gpointer  regex_parser;
+            GString  *scanner_response;
+            GString  *regex_response;
+            GError   *scanner_error = NULL;
+            GError   *regex_error = NULL;
+            gboolean  scanner_found;
+            gboolean  regex_found;
+
+            scanner_parser = mm_serial_parser_v1_new ();
+            regex_parser = mm_serial_parser_v1_new ();
+            mm_serial_parser_v1_set_line_scanner (regex_parser, FALSE);
+
+            scanner_response = g_string_new (all_tests[i][j].response);
+            regex_response = g_string_new (all_tests[i][j].response);
+
+            scanner_found = mm_serial_parser_v1_parse (scanner_parser, scanner_response, NULL, &scanner_error);
+            regex_found = mm_serial_parser_v1_parse (regex_parser, regex_response, NULL, &regex_error);
+
+            g_assert_cmpint (scanner_found, ==, regex_found);
+            g_assert_cmpstr (scanner_response->str, ==, regex_response->str);
+            /* Error codes are not compared, as the regex based parser reports
+             * NO CARRIER for all connection errors */
+            if (regex_error) {
+                g_assert (scanner_error != NULL);
+                g_assert_cmpuint (scanner_error->domain, ==, regex_error->domain);
+            } else
+                g_assert_no_error (scanner_error);
+
+            g_clear_error (&scanner_error);
+            g_clear_error (&regex_error);
+            g_string_free (scanner_response, TRUE);
+            g_string_free (regex_response, TRUE);
+            mm_serial_parser_v1_destroy (scanner_parser);
+            mm_serial_parser_v1_destroy (regex_parser);
+        }
+    }
+}
+
+/*****************************************************************************/
+/* Long replies, received in small chunks */
+
+static const gchar *long_cops_reply =
+    "\r\n+COPS: "
+    "(2,\"Operator A\",\"OPA\",\"21401\",7),(1,\"Operator B\",\"OPB\",\"21403\",7),"
+    "(1,\"Operator C\",\"OPC\",\"21404\",7),(3,\"Operator D\",\"OPD\",\"21407\",7),"
+    "(1,\"Operator A\",\"OPA\",\"21401\",2),(1,\"Operator B\",\"OPB\",\"21403\",2),"
+    "(1,\"Operator C\",\"OPC\",\"21404\",2),(3,\"Operator D\",\"OPD\",\"21407\",2),"
+    "(1,\"Operator A\",\"OPA\",\"21401\",0),(1,\"Operator B\",\"OPB\",\"21403\",0),"
+    "(1,\"Operator C\",\"OPC\",\"21404\",0),(3,\"Operator D\",\"OPD\",\"21407\",0),"
+    "(1,\"Operator E\",\"OPE\",\"21422\",13),(1,\"Operator F\",\"OPF\",\"21425\",13),"
+    ",(0,1,2,3,4),(0,1,2)\r\n"
+    "\r\nOK\r\n";
+
+static const gchar *long_cmgl_reply =
+    "\r\n+CMGL: 0,1,,23\r\n07914306073011F0040B914316709807F2000041907021044480044A7A1D04\r\n"
+    "\r\n+CMGL: 1,1,,23\r\n07914306073011F0040B914316709807F2000041907021044480044A7A1D04\r\n"
+    "\r\n+CMGL: 2,1,,23\r\n07914306073011F0040B914316709807F2000041907021044480044A7A1D04\r\n"
+    "\r\n+CMGL: 3,1,,23\r\n07914306073011F0040B914316709807F2000041907021044480044A7A1D04\r\n"
+    "\r\n+CMGL: 4,1,,23\r\n07914306073011F0040B914316709807F2000041907021044480044A7A1D04\r\n"
+    "\r\n+CMGL: 5,1,,23\r\n07914306073011F0040B914316709807F2000041907021044480044A7A1D04\r\n"
+    "\r\n+CMGL: 6,1,,23\r\n07914306073011F0040B914316709807F2000041907021044480044A7A1D04\r\n"
+    "\r\n+CMGL: 7,1,,23\r\n07914306073011F0040B914316709807F2000041907021044480044A7A1D04\r\n"
+    "\r\n+CMS ERROR: 321\r\n";
+
+/* Feeds the reply in chunks to the parser, the same way the serial port does,
+ * returning how many parse operations were run until a result was found */
+static guint
+parse_in_chunks (gpointer      parser,
+                 const gchar  *reply,
+                 guint         chunk_size,
+                 GString     **out_response,
+                 GError      **out_error)
+{
+    GString *buffer;
+    gsize    reply_len;
+    gsize    offset = 0;
+    guint    n_parses = 0;
+
+    reply_len = strlen (reply);
+    buffer = g_string_sized_new (reply_len);
+
+    while (offset < reply_len) {
+        GString  *response;
+        gboolean  found;
+
+        g_string_append_len (buffer, &reply[offset], MIN (chunk_size, reply_len - offset));
+        offset += MIN (chunk_size, reply_len - offset);
+
+        response = g_string_new_len (buffer->str, buffer->len);
+        found = mm_serial_parser_v1_parse (parser, response, NULL, out_error);
+        n_parses++;
+        if (found) {
+            *out_response = response;
+            g_string_free (buffer, TRUE);
+            return n_parses;
+        }
+        g_string_assign (buffer, response->str);
+        g_string_free (response, TRUE);
+    }
+
+    *out_response = NULL;
+    g_string_free (buffer, TRUE);
+    return n_parses;
+}
+
+static void
+at_serial_parse_in_chunks (void)
+{
+    const gchar *replies[] = { long_cops_reply, long_cmgl_reply };
+    guint        i;
+    guint        chunk_size;
+
+    for (i = 0; i < G_N_ELEMENTS (replies); i++) {
+        for (chunk_size = 1; chunk_size <= 64; chunk_size *= 2) {
+            gpointer  scanner_parser;
+            gpointer  regex_parser;
+            GString  *scanner_response = NULL;
+            GString  *regex_response = NULL;
+            GError   *scanner_error = NULL;
+            GError   *regex_error = NULL;
+
+            scanner_parser = mm_serial_parser_v1_new ();
+            regex_parser = mm_serial_parser_v1_new ();
+            mm_serial_parser_v1_set_line_scanner (regex_parser, FALSE);
+
+            g_assert_cmpuint (parse_in_chunks (scanner_parser, replies[i], chunk_size, &scanner_response, &scanner_error), ==,
+                              parse_in_chunks (regex_parser, replies[i], chunk_size, &regex_response, &regex_error));
+            g_assert (scanner_response);
+            g_assert (regex_response);
+            g_assert_cmpstr (scanner_response->str, ==, regex_response->str);
+            g_assert_cmpint (!!scanner_error, ==, !!regex_error);
+
+            g_clear_error (&scanner_error);
+            g_clear_error (&regex_error);
+            g_string_free (scanner_response, TRUE);
+            g_string_free (regex_response, TRUE);
+            mm_serial_parser_v1_destroy (scanner_parser);
+            mm_serial_parser_v1_destroy (regex_parser);
+        }
+    }
+}
+
+static gdouble
+benchmark_parser (gboolean     line_scanner,
+                  const gchar *reply,
+                  guint        chunk_size,
+                  guint        iterations)
+{
+    gpointer parser;
+    guint    i;
+
+    parser = mm_serial_parser_v1_new ();
+    mm_serial_parser_v1_set_line_scanner (parser, line_scanner);
+
+    g_test_timer_start ();
+    for (i = 0; i < iterations; i++) {
+        GString *response = NULL;
+        GError  *error = NULL;
+
+        parse_in_chunks (parser, reply, chunk_size, &response, &error);
+        g_clear_error (&error);
+        if (response)
+            g_string_free (response, TRUE);
+    }
+
+    mm_serial_parser_v1_destroy (parser);
+    return g_test_timer_elapsed ();
+}
+
+static void
+at_serial_parse_benchmark (void)
+{
+    const gchar *replies[] = { long_cops_reply, long_cmgl_reply };
+    guint        i;
+
+    for (i = 0; i < G_N_ELEMENTS (replies); i++) {
+        gdouble regex_time;
+        gdouble scanner_time;
+
+        regex_time = benchmark_parser (FALSE, replies[i], 16, 1000);
+        scanner_time = benchmark_parser (TRUE, replies[i], 16, 1000);
+        g_test_message ("reply #%u (%u bytes): regex parser %.3fs, line scanner %.3fs",
+                        i, (guint) strlen (replies[i]), regex_time, scanner_time);
+        g_test_minimized_result (scanner_time, "line scanner: %.3fs", scanner_time);
+    }
+}
+
+/*****************************************************************************/
+/* Receive path throughput, feeding URCs through a pty */
+
+#define THROUGHPUT_N_URCS 20000
+
+typedef struct {
+    GMainLoop *loop;
+    int        fd;
+    GString   *data;
+    gsize      written;
+    guint      n_received;
+} ThroughputContext;
+
+static void
+throughput_urc_received (MMPortSerialAt    *port,
+                         GMatchInfo        *match_info,
+                         ThroughputContext *ctx)
+{
+    if (++ctx->n_received == THROUGHPUT_N_URCS)
+        g_main_loop_quit (ctx->loop);
+}
+
+static gboolean
+throughput_write (ThroughputContext *ctx)
+{
+    ssize_t n;
+
+    n = write (ctx->fd, &ctx->data->str[ctx->written], ctx->data->len - ctx->written);
+    if (n > 0)
+        ctx->written += n;
+    return (ctx->written < ctx->data->len ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE);
+}
+
+static void
+at_serial_receive_throughput (void)
+{
+    ThroughputContext  ctx = { 0 };
+    MMPortSerialAt    *port;
+    g_autoptr(GRegex)  regex = NULL;
+    GError            *error = NULL;
+    struct termios     stbuf;
+    int                main_fd;
+    int                secondary_fd;
+    guint              i;
+    gdouble            elapsed;
+
+    g_assert_cmpint (openpty (&main_fd, &secondary_fd, NULL, NULL, NULL), ==, 0);
+    memset (&stbuf, 0, sizeof (stbuf));
+    tcgetattr (secondary_fd, &stbuf);
+    cfmakeraw (&stbuf);
+    tcsetattr (secondary_fd, TCSANOW, &stbuf);
+    fcntl (secondary_fd, F_SETFL, O_NONBLOCK);
+    fcntl (main_fd, F_SETFL, O_NONBLOCK);
+
+    ctx.loop = g_main_loop_new (NULL, FALSE);
+    ctx.fd = main_fd;
+    ctx.data = g_string_new (NULL);
+    for (i = 0; i < THROUGHPUT_N_URCS; i++)
+        g_string_append_printf (ctx.data, "\r\n+CSQ: %u,99\r\n", i % 32);
+
+    port = MM_PORT_SERIAL_AT (g_object_new (MM_TYPE_PORT_SERIAL_AT,
+                                            MM_PORT_DEVICE, "pty",
+                                            MM_PORT_SUBSYS, MM_PORT_SUBSYS_TTY,
+                                            MM_PORT_TYPE, MM_PORT_TYPE_AT,
+                                            MM_PORT_SERIAL_FD, secondary_fd,
+                                            MM_PORT_SERIAL_AT_INIT_SEQUENCE_ENABLED, FALSE,
+                                            NULL));
+    mm_port_serial_at_set_response_parser (port,
+                                           mm_serial_parser_v1_parse,
+                                           mm_serial_parser_v1_new (),
+                                           mm_serial_parser_v1_destroy);
+    regex = g_regex_new ("\\r\\n\\+CSQ:\\s*(\\d+),(\\d+)\\r\\n", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+    mm_port_serial_at_add_unsolicited_msg_handler (port,
+                                                   regex,
+                                                   (MMPortSerialAtUnsolicitedMsgFn) throughput_urc_received,
+                                                   &ctx,
+                                                   NULL);
+
+    g_assert (mm_port_serial_open (MM_PORT_SERIAL (port), &error));
+    g_assert_no_error (error);
+
+    g_test_timer_start ();
+    g_idle_add ((GSourceFunc) throughput_write, &ctx);
+    g_main_loop_run (ctx.loop);
+    elapsed = g_test_timer_elapsed ();
+
+    g_assert_cmpuint (ctx.n_received, ==, THROUGHPUT_N_URCS);
+    g_test_minimized_result (elapsed, "%u URCs (%u bytes) received in %.3fs",
+                             THROUGHPUT_N_URCS, (guint) ctx.data->len, elapsed);
+
+    mm_port_serial_close (MM_PORT_SERIAL (port));
+    g_object_unref (port);
+    g_string_free (ctx.data, TRUE);
+    g_main_loop_unref (ctx.loop);
+    close (main_fd);
+}
+
+/*****************************************************************************/
+/* Fake modem replying OK to every command */
+
+typedef struct {
+    GMainLoop *loop;
+    int        fd;
+    GString   *pending;
+    GString   *received;
+    guint      n_completed;
+    guint      n_expected;
+    /* Size of each read, if given */
+    GArray    *reads;
+} FakeModemContext;
+
+static gboolean
+fake_modem_read (FakeModemContext *ctx)
+{
+    gchar   buf[64];
+    gssize  n;
+    gchar  *eol;
+
+    n = read (ctx->fd, buf, sizeof (buf));
+    if (n > 0) {
+        g_string_append_len (ctx->pending, buf, n);
+        if (ctx->reads)
+            g_array_append_val (ctx->reads, n);
+    }
+
+    /* Reply OK to each full command line */
+    while ((eol = strchr (ctx->pending->str, '\r')) != NULL) {
+        gsize len;
+
+        len = eol - ctx->pending->str + 1;
+        g_string_append_len (ctx->received, ctx->pending->str, len);
+        g_string_erase (ctx->pending, 0, len);
+        g_assert_cmpint (write (ctx->fd, "\r\nOK\r\n", 6), ==, 6);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+fake_modem_command_ready (MMPortSerialAt   *port,
+                          GAsyncResult     *res,
+                          FakeModemContext *ctx)
+{
+    GError *error = NULL;
+
+    mm_port_serial_at_command_finish (port, res, &error);
+    g_assert_no_error (error);
+    if (++ctx->n_completed == ctx->n_expected)
+        g_main_loop_quit (ctx->loop);
+}
+
+/* Command scheduling by priority class */
+static void
+at_serial_command_priority (void)
+{
+    FakeModemContext        ctx = { 0 };
+    MMPortSerialAt         *port;
+    MMPortSerialQueueStats  stats;
+    GError                 *error = NULL;
+    struct termios          stbuf;
+    int                     main_fd;
+    int                     secondary_fd;
+    guint                   read_id;
+
+    g_assert_cmpint (openpty (&main_fd, &secondary_fd, NULL, NULL, NULL), ==, 0);
+    memset (&stbuf, 0, sizeof (stbuf));
+    tcgetattr (secondary_fd, &stbuf);
+    cfmakeraw (&stbuf);
+    tcsetattr (secondary_fd, TCSANOW, &stbuf);
+    fcntl (secondary_fd, F_SETFL, O_NONBLOCK);
+    fcntl (main_fd, F_SETFL, O_NONBLOCK);
+
+    ctx.loop = g_main_loop_new (NULL, FALSE);
+    ctx.fd = main_fd;
+    ctx.pending = g_string_new (NULL);
+    ctx.received = g_string_new (NULL);
+    ctx.n_expected = 4;
+
+    port = MM_PORT_SERIAL_AT (g_object_new (MM_TYPE_PORT_SERIAL_AT,
+                                            MM_PORT_DEVICE, "pty",
+                                            MM_PORT_SUBSYS, MM_PORT_SUBSYS_TTY,
+                                            MM_PORT_TYPE, MM_PORT_TYPE_AT,
+                                            MM_PORT_SERIAL_FD, secondary_fd,
+                                            MM_PORT_SERIAL_AT_INIT_SEQUENCE_ENABLED, FALSE,
+                                            NULL));
+    mm_port_serial_at_set_response_parser (port,
+                                           mm_serial_parser_v1_parse,
+                                           mm_serial_parser_v1_new (),
+                                           mm_serial_parser_v1_destroy);
+
+    g_assert (mm_port_serial_open (MM_PORT_SERIAL (port), &error));
+    g_assert_no_error (error);
+
+    /* Nothing sent yet, so the critical command goes first, and the
+     * duplicate background command just waits for the same reply */
+    mm_port_serial_at_command_full (port, "+A", 3, FALSE, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_INTERACTIVE,
+                                    NULL, (GAsyncReadyCallback) fake_modem_command_ready, &ctx);
+    mm_port_serial_at_command_full (port, "+B", 3, FALSE, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND,
+                                    NULL, (GAsyncReadyCallback) fake_modem_command_ready, &ctx);
+    mm_port_serial_at_command_full (port, "+C", 3, FALSE, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL,
+                                    NULL, (GAsyncReadyCallback) fake_modem_command_ready, &ctx);
+    mm_port_serial_at_command_full (port, "+B", 3, FALSE, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND,
+                                    NULL, (GAsyncReadyCallback) fake_modem_command_ready, &ctx);
+
+    read_id = g_timeout_add (1, (GSourceFunc) fake_modem_read, &ctx);
+    g_main_loop_run (ctx.loop);
+    g_source_remove (read_id);
+
+    g_assert_cmpstr (ctx.received->str, ==, "AT+C\rAT+A\rAT+B\r");
+
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (port), &stats);
+    g_assert_cmpuint (stats.coalesced, ==, 1);
+    g_assert_cmpuint (stats.aborted, ==, 0);
+    g_assert_cmpuint (stats.queue_depth[0], ==, 1);
+    g_assert_cmpuint (stats.queue_depth[1], ==, 1);
+    g_assert_cmpuint (stats.queue_depth[2], ==, 2);
+
+    mm_port_serial_close (MM_PORT_SERIAL (port));
+    g_object_unref (port);
+    g_string_free (ctx.pending, TRUE);
+    g_string_free (ctx.received, TRUE);
+    g_main_loop_unref (ctx.loop);
+    close (main_fd);
+}
+
+/* Critical command aborting a long running background one */
+
+typedef struct {
+    GMainLoop      *loop;
+    int             fd;
+    MMPortSerialAt *port;
+    GString        *received;
+    guint           step;
+    GError         *background_error;
+    gchar          *critical_response;
+} AbortContext;
+
+static void
+abort_background_ready (MMPortSerialAt *port,
+                        GAsyncResult   *res,
+                        AbortContext   *ctx)
+{
+    g_assert (!mm_port_serial_at_command_finish (port, res, &ctx->background_error));
+}
+
+static void
+abort_critical_ready (MMPortSerialAt *port,
+                      GAsyncResult   *res,
+                      AbortContext   *ctx)
+{
+    GError *error = NULL;
+
+    ctx->critical_response = g_strdup (mm_port_serial_at_command_finish (port, res, &error));
+    g_assert_no_error (error);
+    g_main_loop_quit (ctx->loop);
+}
+
+static gboolean
+abort_modem_read (AbortContext *ctx)
+{
+    gchar  buf[64];
+    gssize n;
+
+    n = read (ctx->fd, buf, sizeof (buf));
+    if (n > 0)
+        g_string_append_len (ctx->received, buf, n);
+
+    switch (ctx->step) {
+    case 0:
+        /* Background command sent, never replied before the abort */
+        if (g_str_equal (ctx->received->str, "AT+LONG\r")) {
+            ctx->step++;
+            mm_port_serial_at_command_full (ctx->port, "+CRIT", 3, FALSE, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_CRITICAL,
+                                            NULL, (GAsyncReadyCallback) abort_critical_ready, ctx);
+        }
+        break;
+    case 1:
+        /* Abort sequence received; the critical command must not be sent
+         * until the late reply of the aborted one is discarded */
+        if (g_str_equal (ctx->received->str, "AT+LONG\r\r")) {
+            ctx->step++;
+            g_assert_cmpint (write (ctx->fd, "\r\nOK\r\n", 6), ==, 6);
+        }
+        break;
+    case 2:
+        if (g_str_equal (ctx->received->str, "AT+LONG\r\rAT+CRIT\r")) {
+            ctx->step++;
+            g_assert_cmpint (write (ctx->fd, "\r\n+CRIT: 1\r\n\r\nOK\r\n", 19), ==, 19);
+        }
+        break;
+    default:
+        break;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+at_serial_command_abort (void)
+{
+    AbortContext            ctx = { 0 };
+    MMPortSerialQueueStats  stats;
+    GError                 *error = NULL;
+    struct termios          stbuf;
+    int                     main_fd;
+    int                     secondary_fd;
+    guint                   read_id;
+
+    g_assert_cmpint (openpty (&main_fd, &secondary_fd, NULL, NULL, NULL), ==, 0);
+    memset (&stbuf, 0, sizeof (stbuf));
+    tcgetattr (secondary_fd, &stbuf);
+    cfmakeraw (&stbuf);
+    tcsetattr (secondary_fd, TCSANOW, &stbuf);
+    fcntl (secondary_fd, F_SETFL, O_NONBLOCK);
+    fcntl (main_fd, F_SETFL, O_NONBLOCK);
+
+    ctx.loop = g_main_loop_new (NULL, FALSE);
+    ctx.fd = main_fd;
+    ctx.received = g_string_new (NULL);
+
+    ctx.port = MM_PORT_SERIAL_AT (g_object_new (MM_TYPE_PORT_SERIAL_AT,
+                                                MM_PORT_DEVICE, "pty",
+                                                MM_PORT_SUBSYS, MM_PORT_SUBSYS_TTY,
+                                                MM_PORT_TYPE, MM_PORT_TYPE_AT,
+                                                MM_PORT_SERIAL_FD, secondary_fd,
+                                                MM_PORT_SERIAL_AT_INIT_SEQUENCE_ENABLED, FALSE,
+                                                NULL));
+    mm_port_serial_at_set_response_parser (ctx.port,
+                                           mm_serial_parser_v1_parse,
+                                           mm_serial_parser_v1_new (),
+                                           mm_serial_parser_v1_destroy);
+
+    g_assert (mm_port_serial_open (MM_PORT_SERIAL (ctx.port), &error));
+    g_assert_no_error (error);
+
+    mm_port_serial_at_command_full (ctx.port, "+LONG", 30, FALSE, FALSE, MM_PORT_SERIAL_COMMAND_PRIORITY_BACKGROUND,
+                                    NULL, (GAsyncReadyCallback) abort_background_ready, &ctx);
+
+    read_id = g_timeout_add (1, (GSourceFunc) abort_modem_read, &ctx);
+    g_main_loop_run (ctx.loop);
+    g_source_remove (read_id);
+
+    /* The late reply of the aborted command is not taken as the reply of the
+     * critical one */
+    g_assert_error (ctx.background_error, MM_CORE_ERROR, MM_CORE_ERROR_ABORTED);
+    g_assert_cmpstr (ctx.critical_response, ==, "+CRIT: 1");
+
+    mm_port_serial_get_queue_stats (MM_PORT_SERIAL (ctx.port), &stats);
+    g_assert_cmpuint (stats.aborted, ==, 1);
+
+    mm_port_serial_close (MM_PORT_SERIAL (ctx.port));
+    g_object_unref (ctx.port);
+    g_clear_error (&ctx.background_error);
+    g_free (ctx.critical_response);
+    g_string_free (ctx.received, TRUE);
+    g_main_loop_unref (ctx.loop);
+    close (main_fd);
+}
+
+/* Paced writes in chunks of more than one byte */
+static void
+at_serial_send_chunks (void)
+{
+    FakeModemContext  ctx = { 0 };
+    MMPortSerialAt   *port;
+    GError           *error = NULL;
+    struct termios    stbuf;
+    int               main_fd;
+    int               secondary_fd;
+    guint             read_id;
+
+    g_assert_cmpint (openpty (&main_fd, &secondary_fd, NULL, NULL, NULL), ==, 0);
+    memset (&stbuf, 0, sizeof (stbuf));
+    tcgetattr (secondary_fd, &stbuf);
+    cfmakeraw (&stbuf);
+    tcsetattr (secondary_fd, TCSANOW, &stbuf);
+    fcntl (secondary_fd, F_SETFL, O_NONBLOCK);
+    fcntl (main_fd, F_SETFL, O_NONBLOCK);
+
+    ctx.loop = g_main_loop_new (NULL, FALSE);
+    ctx.fd = main_fd;
+    ctx.pending = g_string_new (NULL);
+    ctx.received = g_string_new (NULL);
+    ctx.reads = g_array_new (FALSE, FALSE, sizeof (gssize));
+    ctx.n_expected = 1;
+
+    /* The delay between chunks is much longer than the modem polling
+     * interval, so that each read gets exactly one chunk */
+    port = MM_PORT_SERIAL_AT (g_object_new (MM_TYPE_PORT_SERIAL_AT,
+                                            MM_PORT_DEVICE, "pty",
+                                            MM_PORT_SUBSYS, MM_PORT_SUBSYS_TTY,
+                                            MM_PORT_TYPE, MM_PORT_TYPE_AT,
+                                            MM_PORT_SERIAL_FD, secondary_fd,
+                                            MM_PORT_SERIAL_SEND_DELAY, (guint64) 20000,
+                                            MM_PORT_SERIAL_SEND_CHUNK_SIZE, 8,
+                                            MM_PORT_SERIAL_AT_INIT_SEQUENCE_ENABLED, FALSE,
+                                            NULL));
+    mm_port_serial_at_set_response_parser (port,
+                                           mm_serial_parser_v1_parse,
+                                           mm_serial_parser_v1_new (),
+                                           mm_serial_parser_v1_destroy);
+
+    g_assert (mm_port_serial_open (MM_PORT_SERIAL (port), &error));
+    g_assert_no_error (error);
+
+    /* Command length not a multiple of the chunk size */
+    mm_port_serial_at_command (port, "+CGDCONT=1,\"IP\",\"internet\"", 3, FALSE, FALSE,
+                               NULL, (GAsyncReadyCallback) fake_modem_command_ready, &ctx);
+
+    read_id = g_timeout_add (1, (GSourceFunc) fake_modem_read, &ctx);
+    g_main_loop_run (ctx.loop);
+    g_source_remove (read_id);
+
+    g_assert_cmpstr (ctx.received->str, ==, "AT+CGDCONT=1,\"IP\",\"internet\"\r");
+
+    /* 29 bytes, in three full chunks and a last partial one */
+    g_assert_cmpuint (ctx.reads->len, ==, 4);
+    g_assert_cmpint (g_array_index (ctx.reads, gssize, 0), ==, 8);
+    g_assert_cmpint (g_array_index (ctx.reads, gssize, 1), ==, 8);
+    g_assert_cmpint (g_array_index (ctx.reads, gssize, 2), ==, 8);
+    g_assert_cmpint (g_array_index (ctx.reads, gssize, 3), ==, 5);
+
+    mm_port_serial_close (MM_PORT_SERIAL (port));
+    g_object_unref (port);
+    g_array_unref (ctx.reads);
+    g_string_free (ctx.pending, TRUE);
+    g_string_free (ctx.received, TRUE);
+    g_main_loop_unref (ctx.loop);
+    close (main_fd);
+}
+
 static void
 at_serial_parse_ok (void)
 {
@@ -153,9 +856,20 @@ int main (int argc, char **argv)
 {
     g_test_init (&argc, &argv, NULL);
 
+    g_test_add_func ("/ModemManager/AT-serial/buffer", at_serial_buffer);
     g_test_add_func ("/ModemManager/AT-serial/echo-removal", at_serial_echo_removal);
+    g_test_add_func ("/ModemManager/AT-serial/regex-prefix", at_serial_regex_prefix);
     g_test_add_func ("/ModemManager/AT-serial/parse-ok", at_serial_parse_ok);
     g_test_add_func ("/ModemManager/AT-serial/parse-error", at_serial_parse_error);
+    g_test_add_func ("/ModemManager/AT-serial/parse-compare-legacy", at_serial_parse_compare_legacy);
+    g_test_add_func ("/ModemManager/AT-serial/parse-in-chunks", at_serial_parse_in_chunks);
+    g_test_add_func ("/ModemManager/AT-serial/command-priority", at_serial_command_priority);
+    g_test_add_func ("/ModemManager/AT-serial/command-abort", at_serial_command_abort);
+    g_test_add_func ("/ModemManager/AT-serial/send-chunks", at_serial_send_chunks);
+    if (g_test_perf ()) {
+        g_test_add_func ("/ModemManager/AT-serial/parse-benchmark", at_serial_parse_benchmark);
+        g_test_add_func ("/ModemManager/AT-serial/receive-throughput", at_serial_receive_throughput);
+    }
 
     return g_test_run ();
 }
@@ -0,0 +1,113 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+#include <string.h>
+#include <locale.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-kernel-device-generic.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static const gchar *physdev_attributes[] = { "idVendor", "idProduct", "", "bcdDevice", NULL };
+
+static void
+write_attribute (const gchar *dir,
+                 const gchar *attribute,
+                 const gchar *value)
+{
+    g_autofree gchar *path = NULL;
+    GError           *error = NULL;
+
+    path = g_build_filename (dir, attribute, NULL);
+    g_file_set_contents (path, value, -1, &error);
+    g_assert_no_error (error);
+}
+
+static void
+remove_attribute (const gchar *dir,
+                  const gchar *attribute)
+{
+    g_autofree gchar *path = NULL;
+
+    path = g_build_filename (dir, attribute, NULL);
+    g_assert_cmpint (g_remove (path), ==, 0);
+}
+
+static void
+test_physdev_cache (void)
+{
+    g_autofree gchar  *physdev = NULL;
+    GError            *error = NULL;
+    gchar            **values;
+
+    physdev = g_dir_make_tmp ("mm-test-physdev-XXXXXX", &error);
+    g_assert_no_error (error);
+
+    write_attribute (physdev, "idVendor", "1199\n");
+    write_attribute (physdev, "idProduct", "9071\n");
+
+    /* First lookup reads sysfs; missing and empty attributes are NULL */
+    values = mm_kernel_device_generic_lookup_physdev_attributes ("tty", "ttyUSB0", physdev, physdev_attributes);
+    g_assert (values);
+    g_assert_cmpstr (values[0], ==, "1199");
+    g_assert_cmpstr (values[1], ==, "9071");
+    g_assert_null (values[2]);
+    g_assert_null (values[3]);
+
+    /* Lookups from other ports of the same device are served from the cache,
+     * even if the attributes change */
+    write_attribute (physdev, "idProduct", "9091\n");
+    values = mm_kernel_device_generic_lookup_physdev_attributes ("net", "wwan0", physdev, physdev_attributes);
+    g_assert (values);
+    g_assert_cmpstr (values[1], ==, "9071");
+
+    /* Forgetting an unknown port keeps the cache */
+    mm_kernel_device_generic_forget_port ("tty", "ttyUSB9");
+    values = mm_kernel_device_generic_lookup_physdev_attributes ("tty", "ttyUSB1", physdev, physdev_attributes);
+    g_assert (values);
+    g_assert_cmpstr (values[1], ==, "9071");
+
+    /* Forgetting any of the ports drops the cached attributes */
+    mm_kernel_device_generic_forget_port ("net", "wwan0");
+    values = mm_kernel_device_generic_lookup_physdev_attributes ("tty", "ttyUSB0", physdev, physdev_attributes);
+    g_assert (values);
+    g_assert_cmpstr (values[1], ==, "9091");
+
+    remove_attribute (physdev, "idVendor");
+    remove_attribute (physdev, "idProduct");
+    g_assert_cmpint (g_rmdir (physdev), ==, 0);
+
+    /* Cached entries of a device that is gone are not used */
+    values = mm_kernel_device_generic_lookup_physdev_attributes ("tty", "ttyUSB0", physdev, physdev_attributes);
+    g_assert_null (values);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/kernel-device-generic/physdev-cache", test_physdev_cache);
+
+    return g_test_run ();
+}
@@ -114,6 +114,135 @@ test_ifc_response_all_groups_and_unknown (void)
     test_ifc_response ("+IFC (0-3),(0-2)", (MM_FLOW_CONTROL_NONE | MM_FLOW_CONTROL_XON_XOFF | MM_FLOW_CONTROL_RTS_CTS));
 }
 
+/*****************************************************************************/
+/* Test concatenated AT command responses */
+
+static void
+test_concatenated_response (const gchar  *response,
+                            const gchar **commands,
+                            const gchar **expected)
+{
+    g_auto(GStrv)      responses = NULL;
+    g_autoptr(GError)  error = NULL;
+    guint              i;
+
+    responses = mm_split_concatenated_at_response (response, commands, &error);
+    g_assert_no_error (error);
+    g_assert (responses);
+    g_assert_cmpuint (g_strv_length (responses), ==, g_strv_length ((GStrv) expected));
+    for (i = 0; expected[i]; i++)
+        g_assert_cmpstr (responses[i], ==, expected[i]);
+}
+
+static void
+test_concatenated_response_simple (void)
+{
+    const gchar *commands[] = { "+CPIN?", "+CREG?", "+CSQ", NULL };
+    const gchar *expected[] = { "+CPIN: READY", "+CREG: 0,1", "+CSQ: 20,99", NULL };
+
+    test_concatenated_response ("\r\n+CPIN: READY\r\n\r\n+CREG: 0,1\r\n\r\n+CSQ: 20,99\r\n",
+                                commands, expected);
+}
+
+static void
+test_concatenated_response_multiline (void)
+{
+    const gchar *commands[] = { "AT+CGDCONT?", "+CGACT?", NULL };
+    const gchar *expected[] = { "+CGDCONT: 1,\"IP\",\"internet\"\r\n+CGDCONT: 2,\"IPV6\",\"ims\"", "+CGACT: 1,1\r\n+CGACT: 2,0", NULL };
+
+    test_concatenated_response ("+CGDCONT: 1,\"IP\",\"internet\"\r\n"
+                                "+CGDCONT: 2,\"IPV6\",\"ims\"\r\n"
+                                "+CGACT: 1,1\r\n"
+                                "+CGACT: 2,0\r\n",
+                                commands, expected);
+}
+
+static void
+test_concatenated_response_empty (void)
+{
+    const gchar *commands[] = { "+CNUM", "+CPIN?", NULL };
+    const gchar *expected[] = { "", "+CPIN: SIM PIN", NULL };
+
+    test_concatenated_response ("\r\n+CPIN: SIM PIN\r\n", commands, expected);
+}
+
+static void
+test_concatenated_response_errors (void)
+{
+    const gchar *commands[] = { "+CPIN?", "+CREG?", NULL };
+    const gchar *not_extended[] = { "+CPIN?", "I", NULL };
+    const gchar *repeated[] = { "+CREG?", "+CREG=?", NULL };
+    g_auto(GStrv) responses = NULL;
+    GError       *error = NULL;
+
+    /* Unprefixed line */
+    responses = mm_split_concatenated_at_response ("+CPIN: READY\r\nfoo\r\n+CREG: 0,1", commands, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED);
+    g_assert (!responses);
+    g_clear_error (&error);
+
+    /* Out of order */
+    responses = mm_split_concatenated_at_response ("+CREG: 0,1\r\n+CPIN: READY", commands, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED);
+    g_assert (!responses);
+    g_clear_error (&error);
+
+    responses = mm_split_concatenated_at_response ("+CPIN: READY", not_extended, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_assert (!responses);
+    g_clear_error (&error);
+
+    responses = mm_split_concatenated_at_response ("+CREG: 0,1", repeated, &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+    g_assert (!responses);
+    g_clear_error (&error);
+}
+
+/*****************************************************************************/
+/* Test regex cache */
+
+static void
+test_regex_cache (void)
+{
+    g_autoptr(GRegex) r1 = NULL;
+    g_autoptr(GRegex) r2 = NULL;
+    g_autoptr(GRegex) r3 = NULL;
+    g_autoptr(GRegex) r4 = NULL;
+    GError            *error = NULL;
+    MMRegexCacheStats  stats;
+
+    mm_regex_cache_clear ();
+
+    r1 = mm_regex_cache_get ("\\+CSQ:\\s*(\\d+),(\\d+)", G_REGEX_RAW, 0, &error);
+    g_assert_no_error (error);
+    g_assert (r1);
+
+    /* Same pattern and flags, shared regex */
+    r2 = mm_regex_cache_get ("\\+CSQ:\\s*(\\d+),(\\d+)", G_REGEX_RAW, 0, &error);
+    g_assert_no_error (error);
+    g_assert (r2 == r1);
+
+    /* Same pattern, different flags */
+    r3 = mm_regex_cache_get ("\\+CSQ:\\s*(\\d+),(\\d+)", G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, &error);
+    g_assert_no_error (error);
+    g_assert (r3 != r1);
+    g_assert_cmpuint (g_regex_get_compile_flags (r3) & G_REGEX_OPTIMIZE, !=, 0);
+
+    /* Invalid patterns are not cached */
+    r4 = mm_regex_cache_get ("(\\d+", 0, 0, &error);
+    g_assert_error (error, G_REGEX_ERROR, G_REGEX_ERROR_UNMATCHED_PARENTHESIS);
+    g_assert (!r4);
+    g_clear_error (&error);
+
+    mm_regex_cache_get_stats (&stats);
+    g_assert_cmpuint (stats.hits, ==, 1);
+    g_assert_cmpuint (stats.misses, ==, 3);
+    g_assert_cmpuint (stats.entries, ==, 2);
+    g_assert_cmpuint (stats.uncached, ==, 0);
+
+    mm_regex_cache_clear ();
+}
+
 /*****************************************************************************/
 /* Test WS46=? responses */
 
@@ -4632,6 +4761,13 @@ int main (int argc, char **argv)
     g_test_suite_add (suite, TESTCASE (test_ifc_response_all_simple_and_unknown, NULL));
     g_test_suite_add (suite, TESTCASE (test_ifc_response_all_groups_and_unknown, NULL));
 
+    g_test_suite_add (suite, TESTCASE (test_concatenated_response_simple, NULL));
+    g_test_suite_add (suite, TESTCASE (test_concatenated_response_multiline, NULL));
+    g_test_suite_add (suite, TESTCASE (test_concatenated_response_empty, NULL));
+    g_test_suite_add (suite, TESTCASE (test_concatenated_response_errors, NULL));
+
+    g_test_suite_add (suite, TESTCASE (test_regex_cache, NULL));
+
     g_test_suite_add (suite, TESTCASE (test_ws46_response_generic_2g3g4g, NULL));
     g_test_suite_add (suite, TESTCASE (test_ws46_response_generic_2g3g, NULL));
     g_test_suite_add (suite, TESTCASE (test_ws46_response_generic_2g3g_v2, NULL));
@@ -0,0 +1,349 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <string.h>
+#include <locale.h>
+
+#include "mm-plugin-index.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+typedef struct {
+    const gchar    *name;
+    guint16        *vendor_ids;
+    mm_uint16_pair *product_ids;
+    mm_uint16_pair *subsystem_vendor_ids;
+    gchar         **drivers;
+    gchar         **udev_tags;
+} TestPlugin;
+
+typedef struct {
+    guint16      vendor;
+    guint16      product;
+    guint16      subsystem_vendor;
+    const gchar *drivers[3];
+    const gchar *udev_tags[2];
+} TestPort;
+
+static void
+test_plugin_clear (TestPlugin *plugin)
+{
+    g_free (plugin->vendor_ids);
+    g_free (plugin->product_ids);
+    g_free (plugin->subsystem_vendor_ids);
+    g_strfreev (plugin->drivers);
+    g_strfreev (plugin->udev_tags);
+}
+
+static MMPluginIndex *
+build_index (TestPlugin *plugins,
+             guint       n_plugins)
+{
+    MMPluginIndex *index;
+    guint          i;
+
+    index = mm_plugin_index_new ();
+    for (i = 0; i < n_plugins; i++)
+        mm_plugin_index_add (index,
+                             &plugins[i],
+                             plugins[i].vendor_ids,
+                             plugins[i].product_ids,
+                             plugins[i].subsystem_vendor_ids,
+                             (const gchar **) plugins[i].drivers,
+                             (const gchar **) plugins[i].udev_tags);
+    return index;
+}
+
+/* Whether the plugin filters would accept the port, as applied by MMPlugin
+ * when the plugin doesn't filter by vendor or product strings */
+static gboolean
+plugin_filters_match (TestPlugin *plugin,
+                      TestPort   *port)
+{
+    gboolean vendor_filtered;
+    gboolean product_filtered;
+    gboolean subsystem_vendor_filtered;
+    guint    i;
+    guint    j;
+
+    if (plugin->drivers && !mm_plugin_index_match_drivers ((const gchar **) plugin->drivers, port->drivers))
+        return FALSE;
+
+    mm_plugin_index_filter_ids (plugin->vendor_ids,
+                                plugin->product_ids,
+                                plugin->subsystem_vendor_ids,
+                                port->vendor,
+                                port->product,
+                                port->subsystem_vendor,
+                                &vendor_filtered,
+                                &product_filtered,
+                                &subsystem_vendor_filtered);
+    if (vendor_filtered || product_filtered || subsystem_vendor_filtered)
+        return FALSE;
+
+    if (plugin->udev_tags) {
+        gboolean found = FALSE;
+
+        for (i = 0; plugin->udev_tags[i] && !found; i++)
+            for (j = 0; port->udev_tags[j] && !found; j++)
+                found = g_str_equal (plugin->udev_tags[i], port->udev_tags[j]);
+        if (!found)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* The index may only select more plugins than the ones accepted by their
+ * filters when the vendor/subsystem vendor pair filter is used, as the
+ * subsystem vendor isn't known in the lookup */
+static void
+check_lookup (TestPlugin *plugins,
+              guint       n_plugins,
+              TestPort   *port,
+              GPtrArray  *items)
+{
+    guint i;
+    guint j = 0;
+
+    for (i = 0; i < n_plugins; i++) {
+        gboolean selected;
+
+        selected = (j < items->len && g_ptr_array_index (items, j) == &plugins[i]);
+        if (selected)
+            j++;
+
+        if (plugin_filters_match (&plugins[i], port))
+            g_assert (selected);
+        else if (selected)
+            g_assert (plugins[i].subsystem_vendor_ids);
+    }
+
+    /* All items selected, in order */
+    g_assert_cmpuint (j, ==, items->len);
+}
+
+static GPtrArray *
+index_lookup (MMPluginIndex *index,
+              TestPort      *port)
+{
+    return mm_plugin_index_lookup (index,
+                                   port->vendor,
+                                   port->product,
+                                   port->drivers,
+                                   port->udev_tags);
+}
+
+static gchar *
+build_names (GPtrArray *items)
+{
+    GString *str;
+    guint    i;
+
+    str = g_string_new ("");
+    for (i = 0; i < items->len; i++)
+        g_string_append_printf (str, "%s%s", i ? "," : "", ((TestPlugin *) g_ptr_array_index (items, i))->name);
+    return g_string_free (str, FALSE);
+}
+
+/*****************************************************************************/
+
+static guint16 *
+build_ids (guint16 first, ...)
+{
+    GArray  *array;
+    va_list  args;
+    guint16  id;
+
+    array = g_array_new (TRUE, TRUE, sizeof (guint16));
+    va_start (args, first);
+    for (id = first; id; id = (guint16) va_arg (args, guint))
+        g_array_append_val (array, id);
+    va_end (args);
+    return (guint16 *) g_array_free (array, FALSE);
+}
+
+static mm_uint16_pair *
+build_pairs (guint16 l,
+             guint16 r)
+{
+    mm_uint16_pair *pairs;
+
+    pairs = g_new0 (mm_uint16_pair, 2);
+    pairs[0].l = l;
+    pairs[0].r = r;
+    return pairs;
+}
+
+static void
+test_lookup (void)
+{
+    g_autoptr(MMPluginIndex) index = NULL;
+    TestPlugin               plugins[6] = { { 0 } };
+    guint                    i;
+
+    static TestPort ports[] = {
+        { 0x1199, 0x9091, 0x0000, { "qcserial", NULL }, { NULL } },
+        { 0x2c7c, 0x0125, 0x0000, { "option", "qmi_wwan", NULL }, { NULL } },
+        { 0x2c7c, 0x0801, 0x0000, { "option", NULL }, { NULL } },
+        { 0x8086, 0x7560, 0x1234, { "iosm", NULL }, { "ID_MM_SAMPLE", NULL } },
+        { 0x0000, 0x0000, 0x0000, { NULL }, { NULL } },
+    };
+    static const gchar *expected[] = {
+        "generic-like,sierra",
+        "generic-like,quectel,quectel-qmi",
+        "generic-like,quectel,quectel-0801",
+        "generic-like,tagged",
+        "generic-like",
+    };
+
+    plugins[0].name = "generic-like";
+    plugins[1].name = "sierra";
+    plugins[1].vendor_ids = build_ids (0x1199, 0x0f3d, 0);
+    plugins[2].name = "quectel";
+    plugins[2].vendor_ids = build_ids (0x2c7c, 0);
+    plugins[3].name = "quectel-qmi";
+    plugins[3].vendor_ids = build_ids (0x2c7c, 0);
+    plugins[3].drivers = g_strsplit ("qmi_wwan", ",", -1);
+    plugins[4].name = "quectel-0801";
+    plugins[4].product_ids = build_pairs (0x2c7c, 0x0801);
+    plugins[5].name = "tagged";
+    plugins[5].subsystem_vendor_ids = build_pairs (0x8086, 0x1234);
+    plugins[5].udev_tags = g_strsplit ("ID_MM_SAMPLE", ",", -1);
+
+    index = build_index (plugins, G_N_ELEMENTS (plugins));
+    g_assert_cmpstr (mm_plugin_index_get_udev_tags (index)[0], ==, "ID_MM_SAMPLE");
+    g_assert_null (mm_plugin_index_get_udev_tags (index)[1]);
+
+    for (i = 0; i < G_N_ELEMENTS (ports); i++) {
+        g_autoptr(GPtrArray)  items = NULL;
+        g_autofree gchar     *names = NULL;
+
+        items = index_lookup (index, &ports[i]);
+        names = build_names (items);
+        g_assert_cmpstr (names, ==, expected[i]);
+        check_lookup (plugins, G_N_ELEMENTS (plugins), &ports[i], items);
+    }
+
+    for (i = 0; i < G_N_ELEMENTS (plugins); i++)
+        test_plugin_clear (&plugins[i]);
+}
+
+/*****************************************************************************/
+/* Replay synthetic hotplug events, comparing against the plugin filters */
+
+#define N_SYNTHETIC_PLUGINS 60
+#define N_SYNTHETIC_EVENTS  400
+
+static const gchar *synthetic_drivers[] = { "option", "qcserial", "qmi_wwan", "cdc_mbim", "cdc_acm", "cdc_ether", "mhi_wwan", "sierra" };
+static const gchar *synthetic_tags[] = { "ID_MM_TAG_A", "ID_MM_TAG_B" };
+
+static guint16
+synthetic_vendor (void)
+{
+    /* Small range so that events hit plugins */
+    return (guint16) g_test_rand_int_range (0x1000, 0x1000 + N_SYNTHETIC_PLUGINS);
+}
+
+static void
+build_synthetic_plugin (TestPlugin *plugin,
+                        guint       i)
+{
+    plugin->name = "synthetic";
+
+    /* Roughly like the real plugins: most filter by vendor id, some by
+     * product id, a few by drivers or udev tags, some by nothing */
+    switch (i % 6) {
+    case 0:
+    case 1:
+    case 2:
+        plugin->vendor_ids = build_ids (synthetic_vendor (), synthetic_vendor (), 0);
+        break;
+    case 3:
+        plugin->product_ids = build_pairs (synthetic_vendor (), (guint16) g_test_rand_int_range (1, 8));
+        break;
+    case 4:
+        plugin->vendor_ids = build_ids (synthetic_vendor (), 0);
+        plugin->subsystem_vendor_ids = build_pairs (synthetic_vendor (), 1);
+        break;
+    default:
+        break;
+    }
+
+    if (i % 5 == 0) {
+        plugin->drivers = g_new0 (gchar *, 3);
+        plugin->drivers[0] = g_strdup (synthetic_drivers[g_test_rand_int_range (0, G_N_ELEMENTS (synthetic_drivers))]);
+        plugin->drivers[1] = g_strdup (synthetic_drivers[g_test_rand_int_range (0, G_N_ELEMENTS (synthetic_drivers))]);
+    }
+
+    if (i % 13 == 0) {
+        plugin->udev_tags = g_new0 (gchar *, 2);
+        plugin->udev_tags[0] = g_strdup (synthetic_tags[g_test_rand_int_range (0, G_N_ELEMENTS (synthetic_tags))]);
+    }
+}
+
+static void
+build_synthetic_port (TestPort *port)
+{
+    port->vendor = g_test_rand_bit () ? synthetic_vendor () : (guint16) g_test_rand_int_range (1, 0xffff);
+    port->product = (guint16) g_test_rand_int_range (1, 8);
+    port->subsystem_vendor = g_test_rand_bit () ? (guint16) g_test_rand_int_range (0, 3) : 0;
+    port->drivers[0] = synthetic_drivers[g_test_rand_int_range (0, G_N_ELEMENTS (synthetic_drivers))];
+    port->drivers[1] = g_test_rand_bit () ? synthetic_drivers[g_test_rand_int_range (0, G_N_ELEMENTS (synthetic_drivers))] : NULL;
+    port->drivers[2] = NULL;
+    port->udev_tags[0] = (g_test_rand_int_range (0, 10) == 0) ? synthetic_tags[g_test_rand_int_range (0, G_N_ELEMENTS (synthetic_tags))] : NULL;
+    port->udev_tags[1] = NULL;
+}
+
+static void
+test_replay (void)
+{
+    g_autoptr(MMPluginIndex) index = NULL;
+    TestPlugin               plugins[N_SYNTHETIC_PLUGINS] = { { 0 } };
+    TestPort                 ports[N_SYNTHETIC_EVENTS] = { { 0 } };
+    guint                    i;
+
+    for (i = 0; i < N_SYNTHETIC_PLUGINS; i++)
+        build_synthetic_plugin (&plugins[i], i);
+    for (i = 0; i < N_SYNTHETIC_EVENTS; i++)
+        build_synthetic_port (&ports[i]);
+
+    index = build_index (plugins, N_SYNTHETIC_PLUGINS);
+
+    for (i = 0; i < N_SYNTHETIC_EVENTS; i++) {
+        g_autoptr(GPtrArray) items = NULL;
+
+        items = index_lookup (index, &ports[i]);
+        check_lookup (plugins, N_SYNTHETIC_PLUGINS, &ports[i], items);
+    }
+
+    for (i = 0; i < N_SYNTHETIC_PLUGINS; i++)
+        test_plugin_clear (&plugins[i]);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/plugin-index/lookup", test_lookup);
+    g_test_add_func ("/MM/plugin-index/replay", test_replay);
+
+    return g_test_run ();
+}
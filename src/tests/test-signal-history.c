@@ -0,0 +1,195 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <locale.h>
+
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-signal-history.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+/* Adds a sample with a LTE RSRP equal to the sample index */
+static guint64
+add_lte_sample (MMSignalHistory *history,
+                guint            i)
+{
+    g_autoptr(MMSignal) lte = NULL;
+
+    lte = mm_signal_new ();
+    mm_signal_set_rsrp (lte, -(gdouble) i);
+    return mm_signal_history_add (history, 1000 * (gint64) i, NULL, NULL, NULL, NULL, lte, NULL);
+}
+
+/* Checks that the samples newer than 'since' are the ones with sequence
+ * numbers first..last, in order */
+static void
+check_samples (MMSignalHistory *history,
+               guint64          since,
+               guint64          first,
+               guint64          last)
+{
+    g_autoptr(GVariant) list = NULL;
+    GVariantIter        iter;
+    GVariant           *item;
+    guint64             expected;
+
+    list = g_variant_ref_sink (mm_signal_history_build_list (history, since));
+    g_assert (g_variant_is_of_type (list, G_VARIANT_TYPE ("a(txa{sv})")));
+    g_assert_cmpuint (g_variant_n_children (list), ==, (first <= last) ? (last - first + 1) : 0);
+
+    expected = first;
+    g_variant_iter_init (&iter, list);
+    while ((item = g_variant_iter_next_value (&iter))) {
+        g_autoptr(MMSignalSample) sample = NULL;
+        GError                   *error = NULL;
+
+        sample = mm_signal_sample_new_from_variant (item, &error);
+        g_assert_no_error (error);
+        g_assert (sample);
+
+        /* Sample i was added with sequence i + 1 */
+        g_assert_cmpuint (mm_signal_sample_get_sequence (sample), ==, expected);
+        g_assert_cmpint (mm_signal_sample_get_timestamp (sample), ==, 1000 * (gint64) (expected - 1));
+        g_assert (mm_signal_sample_peek_lte (sample));
+        g_assert_cmpfloat (mm_signal_get_rsrp (mm_signal_sample_peek_lte (sample)), ==, -(gdouble) (expected - 1));
+        g_assert_null (mm_signal_sample_peek_gsm (sample));
+        g_assert_null (mm_signal_sample_peek_nr5g (sample));
+
+        g_variant_unref (item);
+        expected++;
+    }
+}
+
+static void
+test_empty (void)
+{
+    MMSignalHistory *history;
+
+    history = mm_signal_history_new (MM_SIGNAL_HISTORY_SIZE);
+    check_samples (history, 0, 1, 0);
+    mm_signal_history_free (history);
+}
+
+static void
+test_partial (void)
+{
+    MMSignalHistory *history;
+    guint            i;
+
+    history = mm_signal_history_new (MM_SIGNAL_HISTORY_SIZE);
+    for (i = 0; i < 10; i++)
+        g_assert_cmpuint (add_lte_sample (history, i), ==, i + 1);
+
+    check_samples (history, 0,  1, 10);
+    check_samples (history, 4,  5, 10);
+    check_samples (history, 10, 1, 0);
+    mm_signal_history_free (history);
+}
+
+static void
+test_wrap_around (void)
+{
+    MMSignalHistory *history;
+    guint            i;
+
+    history = mm_signal_history_new (MM_SIGNAL_HISTORY_SIZE);
+
+    /* Exactly full */
+    for (i = 0; i < MM_SIGNAL_HISTORY_SIZE; i++)
+        add_lte_sample (history, i);
+    check_samples (history, 0, 1, MM_SIGNAL_HISTORY_SIZE);
+
+    /* Oldest samples overwritten, still from oldest to newest */
+    for (; i < MM_SIGNAL_HISTORY_SIZE + 10; i++)
+        add_lte_sample (history, i);
+    check_samples (history, 0, 11, MM_SIGNAL_HISTORY_SIZE + 10);
+    check_samples (history, 5, 11, MM_SIGNAL_HISTORY_SIZE + 10);
+    check_samples (history, MM_SIGNAL_HISTORY_SIZE + 5, MM_SIGNAL_HISTORY_SIZE + 6, MM_SIGNAL_HISTORY_SIZE + 10);
+
+    /* Several full laps */
+    for (; i < 3 * MM_SIGNAL_HISTORY_SIZE + 7; i++)
+        add_lte_sample (history, i);
+    check_samples (history, 0, 2 * MM_SIGNAL_HISTORY_SIZE + 8, 3 * MM_SIGNAL_HISTORY_SIZE + 7);
+
+    mm_signal_history_free (history);
+}
+
+static void
+test_all_technologies (void)
+{
+    MMSignalHistory           *history;
+    g_autoptr(GVariant)        list = NULL;
+    g_autoptr(GVariant)        item = NULL;
+    g_autoptr(MMSignalSample)  sample = NULL;
+    g_autoptr(MMSignal)        cdma = NULL;
+    g_autoptr(MMSignal)        evdo = NULL;
+    g_autoptr(MMSignal)        gsm = NULL;
+    g_autoptr(MMSignal)        umts = NULL;
+    g_autoptr(MMSignal)        lte = NULL;
+    g_autoptr(MMSignal)        nr5g = NULL;
+    GError                    *error = NULL;
+
+    cdma = mm_signal_new ();
+    mm_signal_set_ecio (cdma, -1.5);
+    evdo = mm_signal_new ();
+    mm_signal_set_io (evdo, -2.5);
+    gsm = mm_signal_new ();
+    mm_signal_set_rssi (gsm, -70.0);
+    umts = mm_signal_new ();
+    mm_signal_set_rscp (umts, -80.0);
+    lte = mm_signal_new ();
+    mm_signal_set_rsrq (lte, -9.0);
+    nr5g = mm_signal_new ();
+    mm_signal_set_snr (nr5g, 20.5);
+
+    history = mm_signal_history_new (1);
+    mm_signal_history_add (history, 42, cdma, evdo, gsm, umts, lte, nr5g);
+
+    list = g_variant_ref_sink (mm_signal_history_build_list (history, 0));
+    g_assert_cmpuint (g_variant_n_children (list), ==, 1);
+    item = g_variant_get_child_value (list, 0);
+
+    sample = mm_signal_sample_new_from_variant (item, &error);
+    g_assert_no_error (error);
+    g_assert_cmpuint (mm_signal_sample_get_sequence (sample), ==, 1);
+    g_assert_cmpint (mm_signal_sample_get_timestamp (sample), ==, 42);
+    g_assert_cmpfloat (mm_signal_get_ecio (mm_signal_sample_peek_cdma (sample)), ==, -1.5);
+    g_assert_cmpfloat (mm_signal_get_io (mm_signal_sample_peek_evdo (sample)), ==, -2.5);
+    g_assert_cmpfloat (mm_signal_get_rssi (mm_signal_sample_peek_gsm (sample)), ==, -70.0);
+    g_assert_cmpfloat (mm_signal_get_rscp (mm_signal_sample_peek_umts (sample)), ==, -80.0);
+    g_assert_cmpfloat (mm_signal_get_rsrq (mm_signal_sample_peek_lte (sample)), ==, -9.0);
+    g_assert_cmpfloat (mm_signal_get_snr (mm_signal_sample_peek_nr5g (sample)), ==, 20.5);
+
+    mm_signal_history_free (history);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/signal-history/empty",            test_empty);
+    g_test_add_func ("/MM/signal-history/partial",          test_partial);
+    g_test_add_func ("/MM/signal-history/wrap-around",      test_wrap_around);
+    g_test_add_func ("/MM/signal-history/all-technologies", test_all_technologies);
+
+    return g_test_run ();
+}
@@ -41,6 +41,187 @@ test_load_cleanup_core (void)
     g_array_unref (rules);
 }
 
+static void
+test_compile_core (void)
+{
+    GArray *rules;
+    GError *error = NULL;
+    guint   i;
+
+    rules = mm_kernel_device_generic_rules_load (TESTUDEVRULESDIR, &error);
+    g_assert_no_error (error);
+    g_assert (rules);
+
+    for (i = 0; i < rules->len; i++) {
+        MMUdevRule *rule;
+        guint       j;
+
+        rule = &g_array_index (rules, MMUdevRule, i);
+
+        /* All parameters are known */
+        for (j = 0; rule->conditions && j < rule->conditions->len; j++)
+            g_assert_cmpuint (g_array_index (rule->conditions, MMUdevRuleMatch, j).parameter_id, !=, MM_UDEV_RULE_PARAMETER_UNKNOWN);
+
+        /* Skipped rules all share the same guard */
+        g_assert_cmpuint (rule->guard.subsystem_skip, >, i);
+        g_assert_cmpuint (rule->guard.subsystem_skip, <=, rules->len);
+        for (j = i + 1; j < rule->guard.subsystem_skip; j++)
+            g_assert (g_array_index (rules, MMUdevRule, j).guard.subsystem == rule->guard.subsystem);
+        g_assert_cmpuint (rule->guard.vendor_skip, >, i);
+        g_assert_cmpuint (rule->guard.product_skip, >, i);
+    }
+
+    g_array_unref (rules);
+}
+
+/************************************************************/
+
+/* Synthetic device, where conditions other than the ones used in the rule
+ * guards are decided with a hash of the match, so that both evaluations see
+ * the same device */
+typedef struct {
+    const gchar *subsystem;
+    guint16      vendor;
+    guint16      product;
+    GHashTable  *properties;
+} SyntheticDevice;
+
+static gboolean
+synthetic_check_uint (MMUdevRuleMatch *match,
+                      guint            value,
+                      gboolean         condition_equal)
+{
+    return (match->value_uint_valid && ((value == match->value_uint) == condition_equal));
+}
+
+static gboolean
+synthetic_condition_cb (MMUdevRuleMatch *match,
+                        SyntheticDevice *device)
+{
+    gboolean condition_equal;
+
+    condition_equal = (match->type == MM_UDEV_RULE_MATCH_TYPE_EQUAL);
+
+    switch (match->parameter_id) {
+    case MM_UDEV_RULE_PARAMETER_ACTION:
+        return ((!!strstr (match->value, "add")) == condition_equal);
+    case MM_UDEV_RULE_PARAMETER_SUBSYSTEM:
+    case MM_UDEV_RULE_PARAMETER_SUBSYSTEMS:
+        return ((!g_strcmp0 (device->subsystem, match->value)) == condition_equal);
+    case MM_UDEV_RULE_PARAMETER_ATTR_VENDOR:
+        return synthetic_check_uint (match, device->vendor, condition_equal);
+    case MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT:
+        return synthetic_check_uint (match, device->product, condition_equal);
+    case MM_UDEV_RULE_PARAMETER_ENV:
+        return ((!g_strcmp0 (g_hash_table_lookup (device->properties, match->name), match->value)) == condition_equal);
+    case MM_UDEV_RULE_PARAMETER_UNKNOWN:
+    case MM_UDEV_RULE_PARAMETER_DRIVER:
+    case MM_UDEV_RULE_PARAMETER_DRIVERS:
+    case MM_UDEV_RULE_PARAMETER_KERNEL:
+    case MM_UDEV_RULE_PARAMETER_DEVPATH:
+    case MM_UDEV_RULE_PARAMETER_ATTR_SUBSYSTEM_VENDOR:
+    case MM_UDEV_RULE_PARAMETER_ATTR_MANUFACTURER:
+    case MM_UDEV_RULE_PARAMETER_ATTR_PRODUCT_NAME:
+    case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_CLASS:
+    case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_SUBCLASS:
+    case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_PROTOCOL:
+    case MM_UDEV_RULE_PARAMETER_ATTR_INTERFACE_NUMBER:
+    case MM_UDEV_RULE_PARAMETER_ATTR_OTHER:
+    default:
+        return (((g_str_hash (match->value) ^ device->product) % 2) == 0) == condition_equal;
+    }
+}
+
+static void
+synthetic_property_cb (MMUdevRuleResultProperty *property,
+                       SyntheticDevice          *device)
+{
+    g_hash_table_insert (device->properties, property->name, property->value);
+}
+
+static GHashTable *
+synthetic_device_apply_rules (GArray      *rules,
+                              const gchar *subsystem,
+                              guint16      vendor,
+                              guint16      product,
+                              gboolean     use_guards)
+{
+    SyntheticDevice device = {
+        .subsystem  = subsystem,
+        .vendor     = vendor,
+        .product    = product,
+        .properties = g_hash_table_new (g_str_hash, g_str_equal),
+    };
+
+    mm_kernel_device_generic_rules_apply (rules, subsystem, vendor, product, use_guards,
+                                          (MMUdevRuleConditionFunc) synthetic_condition_cb,
+                                          (MMUdevRulePropertyFunc) synthetic_property_cb,
+                                          &device);
+    return device.properties;
+}
+
+static gboolean
+compare_guarded_linear (GArray      *rules,
+                        const gchar *subsystem,
+                        guint16      vendor,
+                        guint16      product)
+{
+    g_autoptr(GHashTable) guarded = NULL;
+    g_autoptr(GHashTable) linear = NULL;
+    GHashTableIter        iter;
+    gpointer              key;
+    gpointer              value;
+
+    guarded = synthetic_device_apply_rules (rules, subsystem, vendor, product, TRUE);
+    linear = synthetic_device_apply_rules (rules, subsystem, vendor, product, FALSE);
+
+    g_debug ("%s %04x:%04x: %u properties", subsystem ? subsystem : "none", vendor, product, g_hash_table_size (linear));
+
+    g_assert_cmpuint (g_hash_table_size (guarded), ==, g_hash_table_size (linear));
+    g_hash_table_iter_init (&iter, linear);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+        g_assert_cmpstr (g_hash_table_lookup (guarded, key), ==, value);
+
+    return (g_hash_table_size (linear) > 0);
+}
+
+static void
+test_guards_core (void)
+{
+    GArray   *rules;
+    GError   *error = NULL;
+    gboolean  any_property = FALSE;
+    guint     i;
+
+    rules = mm_kernel_device_generic_rules_load (TESTUDEVRULESDIR, &error);
+    g_assert_no_error (error);
+    g_assert (rules);
+
+    /* Devices not matching any specific vendor */
+    compare_guarded_linear (rules, NULL, 0x0000, 0x0000);
+    compare_guarded_linear (rules, "usb", 0x0000, 0x0000);
+    compare_guarded_linear (rules, "pci", 0xffff, 0xffff);
+
+    /* Every vendor and product in the rules, with and without the expected
+     * subsystem, and with a different product */
+    for (i = 0; i < rules->len; i++) {
+        MMUdevRuleGuard *guard;
+
+        guard = &g_array_index (rules, MMUdevRule, i).guard;
+        if (!guard->has_vendor)
+            continue;
+
+        any_property |= compare_guarded_linear (rules, guard->subsystem ? guard->subsystem : "usb", guard->vendor, guard->product);
+        compare_guarded_linear (rules, "platform", guard->vendor, guard->product);
+        compare_guarded_linear (rules, guard->subsystem ? guard->subsystem : "usb", guard->vendor, guard->product + 1);
+    }
+
+    /* Make sure the comparisons weren't all empty */
+    g_assert (any_property);
+
+    g_array_unref (rules);
+}
+
 /************************************************************/
 
 int main (int argc, char **argv)
@@ -50,6 +231,8 @@ int main (int argc, char **argv)
     g_test_init (&argc, &argv, NULL);
 
     g_test_add_func ("/MM/test-udev-rules/load-cleanup-core", test_load_cleanup_core);
+    g_test_add_func ("/MM/test-udev-rules/compile-core", test_compile_core);
+    g_test_add_func ("/MM/test-udev-rules/guards-core", test_guards_core);
 
     return g_test_run ();
 }